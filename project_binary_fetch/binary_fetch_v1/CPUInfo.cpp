@@ -12,15 +12,16 @@ give everything in one place (classic Windows moment).
 
 What we use:
 -------------
-1) CPUID (intrinsics)
+1) CPUID (intrinsics, via CPUTopology)
    - For CPU brand / model name
-   - Fast, direct, and very reliable
+   - Sockets, physical cores, logical processors, hybrid P/E cores
+   - Cache sizes (L1, L2, L3) and instruction set extensions
+   - Read once per run on every logical processor, shared with CompactCPU
 
 2) WMI (Windows Management Instrumentation)
    - Used for:
      • Base clock speed
      • Current clock speed
-     • Socket count
      • Process count
      • Thread count
      • Handle count
@@ -33,11 +34,9 @@ What we use:
    - Needs warm-up or it gives garbage data
 
 4) WinAPI system calls
-   - Core count
-   - Logical processors (threads)
-   - Cache sizes (L1, L2, L3)
    - System uptime
    - Virtualization status
+   - Core / thread counts when CPUID can't be used
 
 Why this looks complicated:
 ----------------------------
@@ -53,10 +52,10 @@ So yeah… we stitched it all together manually :)))
  Function overview
 ================================================================================
 
-wmi_querysingle_value()
-----------------------
-A helper that runs a WMI query and returns ONE value as a string.
-Used everywhere to avoid rewriting the same COM + WMI boilerplate.
+processor_field() / process_total_field()
+-----------------------------------------
+Thin wrappers over WMIQuery: each WMI class is fetched with ONE merged
+SELECT per run and every field is served from that cached result.
 
 get_cpu_info()
 --------------
@@ -78,14 +77,22 @@ Reads CurrentClockSpeed from WMI (current boost clock).
 
 get_cpu_sockets()
 -----------------
-Counts how many physical CPU sockets exist.
+Counts how many physical CPU sockets exist (distinct CPUID package IDs).
 Usually 1 unless you’re running a server monster.
 
 get_cpu_cores()
 ---------------
-Counts PHYSICAL cores using GetLogicalProcessorInformation.
+Counts PHYSICAL cores from the CPUID topology.
 Does NOT count hyperthreads.
 
+get_cpu_core_types()
+--------------------
+"8P + 16E" on hybrid CPUs, empty otherwise.
+
+get_cpu_instruction_sets()
+--------------------------
+SSE4.2 / AVX / AVX2 / AVX-512 / AMX, as far as both CPU and OS support them.
+
 get_cpu_logical_processors()
 ----------------------------
 Returns total logical processors (threads).
@@ -99,7 +106,7 @@ get_cpu_l1_cache()
 get_cpu_l2_cache()
 get_cpu_l3_cache()
 ------------------
-Reads cache sizes using processor topology info.
+Reads cache sizes from the CPUID cache leaves (every instance counted once).
 Automatically formats KB / MB.
 
 get_system_uptime()
@@ -135,188 +142,59 @@ But it WORKS — and that’s a win :)
 */
 
 #include "include\CPUInfo.h"
+#include "include\Probe.h"  // Record/replay of raw PDH inputs
+#include "include\WMIQuery.h" // Coalesced WMI reads (one SELECT per class)
+#include "include\CPUTopology.h" // CPUID topology / caches / features, read once
 
 #include <windows.h>   // Core Windows API — sometimes pain, sometimes power
 #include <intrin.h>    // CPUID and low-level CPU instructions
 #include <vector>      // Dynamic storage (because life isn't fixed-size)
 #include <sstream>     // Turning numbers into pretty strings
-#include <wbemidl.h>   // WMI — Windows answering deep existential questions
 #include <pdh.h>       // Performance counters (Task Manager vibes)
-#include <comdef.h>    // COM helpers so we don't lose our sanity
 #include <iomanip>     // Formatting polish (decimals, padding, alignment)
 using namespace std;
 
 #pragma comment(lib, "pdh.lib")      
 // Auto-link PDH so CPU usage works without linker drama
 
-#pragma comment(lib, "wbemuuid.lib") 
-// Required for WMI / COM UUIDs — Windows won't talk without this
-
 using namespace std; // If this confuses you… we need to talk 😄
 
 /*
-documentation (1) : WMI helper function for single-value queries
-
-    WMI Helper Function — the reliable messenger between you and Windows internals
-
-    This function handles all the COM/WMI boilerplate so we don't have to repeat
-    the same 50 lines of code for every single WMI query.
-
-    How it works:
-    -------------
-    1. Initialize COM (Windows' component system)
-    2. Set up security so we can read system data
-    3. Connect to the WMI service (specifically ROOT\CIMV2, where hardware info lives)
-    4. Execute a WQL query (WMI's version of SQL)
-    5. Extract ONE property value from the first result
-    6. Clean up everything properly (no memory leaks!)
-
-    Why so much ceremony?
-    ---------------------
-    WMI is built on COM (Component Object Model), which is Microsoft's 90s-era
-    technology for software components talking to each other. COM requires:
-    - Explicit initialization
-    - Security configuration
-    - Manual reference counting
-    - Careful cleanup
-
-    This function encapsulates all that complexity so our other functions can
-    just ask for data and get a simple string back.
-
-    The alternative would be repeating this 50-line dance 15 times...
-    and nobody wants that :)
-*/
-
-// Section (1) : WMI helper function for single-value queries
-string wmi_querysingle_value(const wchar_t* query, const wchar_t* property_name)
-{
-    HRESULT hres;
-    IWbemLocator* locator = NULL;
-    IWbemServices* services = NULL;
-    IEnumWbemClassObject* enumerator = NULL;
-    IWbemClassObject* clsObj = NULL;
-    ULONG uReturn = 0;
-
-    string result = "Unknown";
-
-    hres = CoInitializeEx(0, COINIT_MULTITHREADED);
-    if (FAILED(hres))
-    {
-        hres = CoInitializeEx(0, COINIT_APARTMENTTHREADED);
-        if (FAILED(hres))
-            return result;
-    }
-
-    hres = CoInitializeSecurity(
-        NULL,
-        -1,
-        NULL,
-        NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL,
-        EOAC_NONE,
-        NULL
-    );
-
-    if (FAILED(hres) && hres != RPC_E_TOO_LATE)
-    {
-        CoUninitialize();
-        return result;
-    }
+documentation (1) : WMI access
 
-    hres = CoCreateInstance(
-        CLSID_WbemLocator,
-        0,
-        CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator,
-        (LPVOID*)&locator
-    );
-    if (FAILED(hres))
-    {
-        CoUninitialize();
-        return result;
-    }
+    All WMI reads in this file go through WMIQuery (WMIQuery.h).
 
-    hres = locator->ConnectServer(
-        _bstr_t(L"ROOT\\CIMV2"),
-        NULL, NULL, 0, NULL, 0, 0,
-        &services
-    );
-    if (FAILED(hres))
-    {
-        locator->Release();
-        CoUninitialize();
-        return result;
-    }
+    Instead of building a locator + connection and running one SELECT per field,
+    we tell WMIQuery up front which properties each class will be asked for.
+    The first getter that touches a class runs ONE merged SELECT over a shared
+    connection, and every later getter is served from that cached result.
 
-    hres = CoSetProxyBlanket(
-        services,
-        RPC_C_AUTHN_WINNT,
-        RPC_C_AUTHZ_NONE,
-        NULL,
-        RPC_C_AUTHN_LEVEL_CALL,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL,
-        EOAC_NONE
-    );
-    if (FAILED(hres))
-    {
-        services->Release();
-        locator->Release();
-        CoUninitialize();
-        return result;
-    }
+    Win32_Processor                     -> MaxClockSpeed, CurrentClockSpeed (+ socket count
+                                           when CPUID topology isn't available)
+    Win32_PerfFormattedData_PerfProc_Process WHERE Name='_Total'
+                                        -> ThreadCount, HandleCount
+    Win32_Process                       -> process count
 
-    hres = services->ExecQuery(
-        _bstr_t(L"WQL"),
-        _bstr_t(query),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL,
-        &enumerator
-    );
-    if (FAILED(hres))
-    {
-        services->Release();
-        locator->Release();
-        CoUninitialize();
-        return result;
-    }
+    WQL has no COUNT(*), so counts are the number of rows returned.
+*/
 
-    if (enumerator)
-    {
-        while (enumerator->Next(WBEM_INFINITE, 1, &clsObj, &uReturn) == S_OK && uReturn > 0)
-        {
-            VARIANT vtProp;
-            VariantInit(&vtProp);
-
-            hres = clsObj->Get(property_name, 0, &vtProp, 0, 0);
-            if (SUCCEEDED(hres))
-            {
-                if (vtProp.vt == VT_BSTR && vtProp.bstrVal)
-                    result = _bstr_t(vtProp.bstrVal);
-                else if (vtProp.vt == VT_I4)
-                    result = to_string(vtProp.intVal);
-                else if (vtProp.vt == VT_UI4)
-                    result = to_string(vtProp.uintVal);
-                else if (vtProp.vt == VT_UI2)
-                    result = to_string(vtProp.uiVal);
-
-                VariantClear(&vtProp);
-            }
-
-            clsObj->Release();
-            break;
-        }
+// Section (1) : WMI fields used by this file, declared once so they coalesce
+static const char* const PROCESS_TOTAL = "Name='_Total'";
 
-        enumerator->Release();
-    }
+void CPUInfo::plan_wmi()
+{
+    WMIQuery::want("Win32_Processor", { "MaxClockSpeed", "CurrentClockSpeed" });
+    WMIQuery::want("Win32_PerfFormattedData_PerfProc_Process", { "ThreadCount", "HandleCount" }, PROCESS_TOTAL);
+}
 
-    if (services) services->Release();
-    if (locator) locator->Release();
-    CoUninitialize();
+static string processor_field(const string& property)
+{
+    return WMIQuery::get("Win32_Processor", property);
+}
 
-    return result;
+static string process_total_field(const string& property)
+{
+    return WMIQuery::get("Win32_PerfFormattedData_PerfProc_Process", property, PROCESS_TOTAL);
 }
 
 /*
@@ -357,6 +235,11 @@ documentation (2) : CPU brand string extraction using CPUID
 // Section (2) : CPU brand string extraction using CPUID
 string CPUInfo::get_cpu_info()
 {
+    // Already read (and recorded) with the rest of the CPUID leaves
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok && !topology.brand.empty()) return topology.brand;
+
+    Probe::unrouted("CPUID brand fallback (CPUInfo)");
     int cpu_data[4] = { -1 };
     char cpu_brand[0x40] = { 0 };
 
@@ -409,21 +292,24 @@ float CPUInfo::get_cpu_utilization()
     static PDH_HCOUNTER counter = NULL;
     static bool initialized = false;
 
-    if (!initialized)
-    {
-        PdhOpenQuery(NULL, 0, &query);
-        PdhAddCounter(query, TEXT("\\Processor(_Total)\\% Processor Time"), 0, &counter);
-        PdhCollectQueryData(query);
-        initialized = true;
+    double usage = Probe::number("pdh:\\Processor(_Total)\\% Processor Time", []() {
+        if (!initialized)
+        {
+            PdhOpenQuery(NULL, 0, &query);
+            PdhAddCounter(query, TEXT("\\Processor(_Total)\\% Processor Time"), 0, &counter);
+            PdhCollectQueryData(query);
+            initialized = true;
 
-        Sleep(100);
-    }
+            Sleep(100);
+        }
 
-    PDH_FMT_COUNTERVALUE value;
-    PdhCollectQueryData(query);
-    PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE, NULL, &value);
+        PDH_FMT_COUNTERVALUE value;
+        PdhCollectQueryData(query);
+        PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE, NULL, &value);
+        return value.doubleValue;
+    });
 
-    return static_cast<float>(value.doubleValue);
+    return static_cast<float>(usage);
 }
 
 /*
@@ -462,10 +348,7 @@ documentation (4) : Maximum rated CPU speed (base clock)
 // Section (4) : Maximum rated CPU speed (base clock)
 string CPUInfo::get_cpu_base_speed()
 {
-    string value = wmi_querysingle_value(
-        L"SELECT MaxClockSpeed FROM Win32_Processor",
-        L"MaxClockSpeed"
-    );
+    string value = processor_field("MaxClockSpeed");
 
     if (value == "Unknown" || value.empty()) return "N/A";
 
@@ -516,11 +399,7 @@ documentation (5) : Current CPU speed (real-time boost clock)
 // Section (5) : Current CPU speed (real-time boost clock)
 string CPUInfo::get_cpu_speed()
 {
-    string value = wmi_querysingle_value
-    (
-        L"SELECT CurrentClockSpeed FROM Win32_Processor",
-        L"CurrentClockSpeed"
-    );
+    string value = processor_field("CurrentClockSpeed");
 
     if (value == "Unknown" || value.empty()) return "N/A";
 
@@ -554,16 +433,16 @@ documentation (6) : Physical CPU socket count
 
     How we count them:
     ------------------
-    Simple WMI query: SELECT COUNT(*) FROM Win32_Processor
-
-    Win32_Processor enumerates each physical CPU package.
+    CPUTopology reads every logical processor's x2APIC ID (CPUID 0x1F/0xB).
+    The bits above the core level are the package ID, so the number of
+    distinct package IDs is the socket count.
     If you have a dual-socket Xeon system, this returns 2.
     If you have a normal desktop, this returns 1.
 
     Edge case handling:
-    - Invalid result → default to 1 (safe assumption for consumer hardware)
-    - Conversion failure → default to 1
-    - WMI failure → default to 1
+    - No CPUID topology → count the Win32_Processor rows instead
+      (shares the SELECT used for clock speeds)
+    - Nothing at all → default to 1 (safe assumption for consumer hardware)
 
     Because honestly, if you're running multi-socket, you probably know it :)
 */
@@ -571,14 +450,12 @@ documentation (6) : Physical CPU socket count
 // Section (6) : Physical CPU socket count
 int CPUInfo::get_cpu_sockets()
 {
-    string value = wmi_querysingle_value
-    (
-        L"SELECT COUNT(*) FROM Win32_Processor",
-        L"COUNT(*)"
-    );
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok) return topology.packages;
 
-    try { return stoi(value); }
-    catch (...) { return 1; }
+    // One Win32_Processor instance per socket
+    size_t sockets = WMIQuery::count("Win32_Processor");
+    return sockets > 0 ? static_cast<int>(sockets) : 1;
 }
 
 /*
@@ -593,22 +470,17 @@ documentation (7) : Physical CPU core count
     Why not just use GetSystemInfo()?
     --------------------------------
     GetSystemInfo() returns LOGICAL processors (threads).
-    We need GetLogicalProcessorInformation() to distinguish:
-    - Physical cores (RelationProcessorCore)
-    - NUMA nodes (RelationNumaNode)
-    - Cache (RelationCache)
-    - Processor packages (RelationProcessorPackage)
+    We need the topology to tell SMT siblings apart.
 
     How it works:
     -------------
-    1. Call GetLogicalProcessorInformation() twice:
-       - First call: get required buffer size
-       - Second call: fill buffer with actual data
-    2. Walk through the array
-    3. Count only RelationProcessorCore entries
-    4. Return the total
-
-    This is the same method Task Manager uses for "Cores" display.
+    1. CPUTopology pins a thread to each logical processor and reads its
+       x2APIC ID plus the SMT / core bit widths (CPUID 0x1F or 0xB)
+    2. Dropping the SMT bits leaves (package, core)
+    3. Count the distinct pairs
+
+    If CPUID can't be used, GetLogicalProcessorInformationEx
+    (RelationProcessorCore) is the fallback (RelationCache for the caches).
     It's accurate even with:
     - Hybrid architectures (P-cores + E-cores)
     - Disabled cores
@@ -620,27 +492,40 @@ documentation (7) : Physical CPU core count
 // Section (7) : Physical CPU core count
 int CPUInfo::get_cpu_cores()
 {
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok) return topology.cores;
+
+    Probe::unrouted("GetLogicalProcessorInformationEx fallback (CPUInfo)");
     DWORD length = 0;
-    GetLogicalProcessorInformation(NULL, &length);
+    GetLogicalProcessorInformationEx(RelationProcessorCore, NULL, &length);
 
     if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
         return -1;
 
-    vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer(
-        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION)
-    );
-
-    if (!GetLogicalProcessorInformation(buffer.data(), &length))
+    vector<BYTE> buffer(length);
+    if (!GetLogicalProcessorInformationEx(RelationProcessorCore,
+        reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
         return -1;
 
+    // Variable-size records, one per physical core
     int cores = 0;
-    for (auto& info : buffer)
-        if (info.Relationship == RelationProcessorCore)
-            cores++;
+    for (DWORD offset = 0; offset < length; cores++)
+        offset += reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data() + offset)->Size;
 
     return cores;
 }
 
+// Section (7b) : Hybrid core types ("8P + 16E", empty if not hybrid)
+string CPUInfo::get_cpu_core_types()
+{
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.performanceCores == 0 && topology.efficientCores == 0) return "";
+
+    ostringstream ss;
+    ss << topology.performanceCores << "P + " << topology.efficientCores << "E";
+    return ss.str();
+}
+
 /*
 documentation (8) : Logical processor count (threads)
 
@@ -655,10 +540,11 @@ documentation (8) : Logical processor count (threads)
     - 6 cores, with HT = 12 logical processors
     - 8P + 8E cores, with HT = 24 logical processors
 
-    Why use GetSystemInfo()?
-    ------------------------
-    Simple, reliable, and always accurate.
-    dwNumberOfProcessors in SYSTEM_INFO = total threads Windows sees.
+    Where it comes from:
+    --------------------
+    The number of logical processors CPUTopology visited, across every
+    processor group. GetSystemInfo() is the fallback, but its
+    dwNumberOfProcessors only covers the calling thread's group (max 64).
 
     This matches:
     - Task Manager "Logical processors"
@@ -679,6 +565,10 @@ documentation (8) : Logical processor count (threads)
 // Section (8) : Logical processor count (threads)
 int CPUInfo::get_cpu_logical_processors()
 {
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok) return topology.logical;
+
+    Probe::unrouted("GetSystemInfo fallback (CPUInfo)");
     SYSTEM_INFO info;
     GetSystemInfo(&info);
     return info.dwNumberOfProcessors;
@@ -721,9 +611,36 @@ documentation (9) : CPU virtualization status (BIOS/firmware)
 // Section (9) : CPU virtualization status (BIOS/firmware)
 string CPUInfo::get_cpu_virtualization()
 {
-    return IsProcessorFeaturePresent(PF_VIRT_FIRMWARE_ENABLED)
-        ? "Enabled"
-        : "Disabled";
+    bool enabled = Probe::number("kernel32:pf-virt-firmware-enabled", []() -> double {
+        return IsProcessorFeaturePresent(PF_VIRT_FIRMWARE_ENABLED) ? 1.0 : 0.0;
+    }) != 0.0;
+    return enabled ? "Enabled" : "Disabled";
+}
+
+// Section (10a) : Cache bytes at one level, CPUID first, OS topology as the fallback
+static uint64_t cache_bytes(int level)
+{
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok && !topology.caches.empty()) return topology.cacheBytes(level);
+
+    Probe::unrouted("GetLogicalProcessorInformationEx fallback (CPUInfo)");
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationCache, NULL, &length);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) return 0;
+
+    vector<BYTE> buffer(length);
+    if (!GetLogicalProcessorInformationEx(RelationCache,
+        reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+        return 0;
+
+    // One record per cache instance
+    uint64_t size = 0;
+    for (DWORD offset = 0; offset < length;) {
+        auto* info = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data() + offset);
+        if (info->Cache.Level == level) size += info->Cache.CacheSize;
+        offset += info->Size;
+    }
+    return size;
 }
 
 /*
@@ -745,16 +662,13 @@ documentation (10) : L1 cache size per core
 
     How we calculate it:
     -------------------
-    1. GetLogicalProcessorInformation() returns cache topology
-    2. Filter for Level == 1 (L1 cache)
-    3. Sum Size across all L1 cache entries
+    1. CPUTopology reads the cache leaves (CPUID 0x4 on Intel, 0x8000001D
+       on AMD) on every logical processor
+    2. Each leaf says how many logical processors share that cache, so
+       SMT siblings land on the same instance and it's counted once
+    3. Sum L1 data + instruction across all instances
     4. Convert bytes to KB
 
-    Why sum across entries?
-    Because GetLogicalProcessorInformation reports cache PER LOGICAL PROCESSOR.
-    But L1 is usually per PHYSICAL core.
-    We sum to get total L1 across all cores.
-
     Output format: "XXX KB"
     Example: "256 KB" (for 4 cores × 64 KB L1 each)
 */
@@ -762,24 +676,7 @@ documentation (10) : L1 cache size per core
 // Section (10) : L1 cache size per core
 string CPUInfo::get_cpu_l1_cache()
 {
-    DWORD length = 0;
-    GetLogicalProcessorInformation(NULL, &length);
-
-    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-        return "N/A";
-
-    vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer
-    (
-        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION)
-    );
-
-    if (!GetLogicalProcessorInformation(buffer.data(), &length))
-        return "N/A";
-
-    DWORD size = 0;
-    for (auto& info : buffer)
-        if (info.Relationship == RelationCache && info.Cache.Level == 1)
-            size += info.Cache.Size;
+    uint64_t size = cache_bytes(1);
 
     if (!size) return "N/A";
 
@@ -809,9 +706,10 @@ documentation (11) : L2 cache size
 
     How we handle it:
     -----------------
-    1. Get all cache information from Windows
+    1. Get all cache instances from CPUTopology (P-core and E-cluster L2
+       slices each keep their own size)
     2. Filter for Level == 2 (L2 cache)
-    3. Sum all L2 cache sizes
+    3. Sum all L2 instances
     4. Smart formatting:
        - < 1 MB → show as KB
        - ≥ 1 MB → show as MB
@@ -829,23 +727,7 @@ documentation (11) : L2 cache size
 // Section (11) : L2 cache size
 string CPUInfo::get_cpu_l2_cache()
 {
-    DWORD length = 0;
-    GetLogicalProcessorInformation(NULL, &length);
-
-    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-        return "N/A";
-
-    vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer(
-        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION)
-    );
-
-    if (!GetLogicalProcessorInformation(buffer.data(), &length))
-        return "N/A";
-
-    DWORD size = 0;
-    for (auto& info : buffer)
-        if (info.Relationship == RelationCache && info.Cache.Level == 2)
-            size += info.Cache.Size;
+    uint64_t size = cache_bytes(2);
 
     if (!size) return "N/A";
 
@@ -879,11 +761,10 @@ documentation (12) : L3 cache size (shared, last-level cache)
     ----------------
     Same as L1/L2 but filtering for Level == 3.
 
-    Important: We SUM across all entries because:
-    - Some CPUs report L3 per NUMA node
-    - Some report L3 per CCX (AMD)
-    - Some report total L3 once
-    Summing ensures we get the correct total.
+    Important: We SUM across instances because:
+    - Multi-socket systems have one L3 per package
+    - AMD has one L3 per CCX
+    Every instance is counted exactly once, so the sum is the real total.
 
     Smart formatting:
     ----------------
@@ -896,24 +777,7 @@ documentation (12) : L3 cache size (shared, last-level cache)
 // Section (12) : L3 cache size (shared, last-level cache)
 string CPUInfo::get_cpu_l3_cache()
 {
-    DWORD length = 0;
-    GetLogicalProcessorInformation(NULL, &length);
-
-    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-        return "N/A";
-
-    vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer
-    (
-        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION)
-    );
-
-    if (!GetLogicalProcessorInformation(buffer.data(), &length))
-        return "N/A";
-
-    DWORD size = 0;
-    for (auto& info : buffer)
-        if (info.Relationship == RelationCache && info.Cache.Level == 3)
-            size += info.Cache.Size;
+    uint64_t size = cache_bytes(3);
 
     if (!size) return "N/A";
 
@@ -923,6 +787,13 @@ string CPUInfo::get_cpu_l3_cache()
     return ss.str();
 }
 
+// Section (12b) : Instruction set extensions ("SSE4.2 AVX AVX2 FMA AVX-512 (F DQ BW VL VNNI)")
+string CPUInfo::get_cpu_instruction_sets()
+{
+    string sets = CPUTopology::get().instructionSets();
+    return sets.empty() ? "N/A" : sets;
+}
+
 /*
 documentation (13) : System uptime calculation
 
@@ -967,7 +838,9 @@ documentation (13) : System uptime calculation
 // Section (13) : System uptime calculation
 string CPUInfo::get_system_uptime()
 {
-    ULONGLONG ms = GetTickCount64();
+    ULONGLONG ms = static_cast<ULONGLONG>(Probe::number("kernel32:tick-count64", []() -> double {
+        return static_cast<double>(GetTickCount64());
+    }));
 
     ULONGLONG seconds = ms / 1000;
     ULONGLONG minutes = seconds / 60;
@@ -1003,7 +876,7 @@ documentation (14) : Running process count
 
     How it works:
     -------------
-    Simple WMI query: SELECT COUNT(*) FROM Win32_Process
+    Count the Win32_Process rows via WMIQuery::count
 
     Win32_Process includes EVERY process, regardless of:
     - Session (console, service, user)
@@ -1024,14 +897,7 @@ documentation (14) : Running process count
 // Section (14) : Running process count
 int CPUInfo::get_process_count()
 {
-    string value = wmi_querysingle_value
-    (
-        L"SELECT COUNT(*) FROM Win32_Process",
-        L"COUNT(*)"
-    );
-
-    try { return stoi(value); }
-    catch (...) { return 0; }
+    return static_cast<int>(WMIQuery::count("Win32_Process"));
 }
 
 /*
@@ -1075,11 +941,7 @@ documentation (15) : Total system thread count
 // Section (15) : Total system thread count
 int CPUInfo::get_thread_count()
 {
-    string value = wmi_querysingle_value
-    (
-        L"SELECT ThreadCount FROM Win32_PerfFormattedData_PerfProc_Process WHERE Name='_Total'",
-        L"ThreadCount"
-    );
+    string value = process_total_field("ThreadCount");
 
     try { return stoi(value); }
     catch (...) { return 0; }
@@ -1127,11 +989,7 @@ documentation (16) : Total system handle count
 // Section (16) : Total system handle count
 int CPUInfo::get_handle_count()
 {
-    string value = wmi_querysingle_value
-    (
-        L"SELECT HandleCount FROM Win32_PerfFormattedData_PerfProc_Process WHERE Name='_Total'",
-        L"HandleCount"
-    );
+    string value = process_total_field("HandleCount");
 
     try { return stoi(value); }
     catch (...) { return 0; }
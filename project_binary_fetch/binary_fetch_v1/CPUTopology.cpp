@@ -0,0 +1,456 @@
+#include "include\CPUTopology.h"
+#include "include\Probe.h"
+
+#include <map>
+#include <set>
+#include <array>
+#include <tuple>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPUTOPOLOGY_HAS_CPUID 1
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#ifdef CPUTOPOLOGY_HAS_CPUID
+#include <cpuid.h>
+#endif
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+// ----------------- Raw registers -----------------
+
+namespace {
+    typedef array<uint32_t, 4> Regs;     // eax, ebx, ecx, edx
+
+    string leaf_key(uint32_t leaf, uint32_t sub)
+    {
+        char key[32];
+        snprintf(key, sizeof(key), "%x.%x", leaf, sub);
+        return key;
+    }
+
+#ifdef CPUTOPOLOGY_HAS_CPUID
+    Regs cpuid(uint32_t leaf, uint32_t sub)
+    {
+        Regs r = {};
+#ifdef _WIN32
+        int out[4];
+        __cpuidex(out, static_cast<int>(leaf), static_cast<int>(sub));
+        for (int i = 0; i < 4; i++) r[i] = static_cast<uint32_t>(out[i]);
+#else
+        __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+        return r;
+    }
+
+    uint64_t xcr0()
+    {
+#ifdef _WIN32
+        return _xgetbv(0);
+#else
+        uint32_t lo = 0, hi = 0;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+    }
+
+    // Every leaf decode() looks at, as seen from the processor we're on
+    json read_leaves(bool first)
+    {
+        json regs = json::object();
+        auto put = [&](uint32_t leaf, uint32_t sub) {
+            Regs r = cpuid(leaf, sub);
+            regs[leaf_key(leaf, sub)] = r;
+            return r;
+        };
+        // Sub-leaves end with a null entry: type in EAX[4:0] (caches) or ECX[15:8] (levels)
+        auto put_caches = [&](uint32_t leaf) {
+            for (uint32_t sub = 0; sub < 16; sub++) if ((put(leaf, sub)[0] & 0x1f) == 0) break;
+        };
+        auto put_levels = [&](uint32_t leaf) {
+            for (uint32_t sub = 0; sub < 8; sub++) if (((put(leaf, sub)[2] >> 8) & 0xff) == 0) break;
+        };
+
+        uint32_t maxBasic = put(0, 0)[0];
+        put(1, 0);
+        if (maxBasic >= 0x4) put_caches(0x4);
+        if (maxBasic >= 0x7) put(0x7, 0);
+        if (maxBasic >= 0xB) put_levels(0xB);
+        if (maxBasic >= 0x1A) put(0x1A, 0);
+        if (maxBasic >= 0x1F) put_levels(0x1F);
+
+        uint32_t maxExtended = put(0x80000000, 0)[0];
+        if (maxExtended >= 0x80000001) put(0x80000001, 0);
+        if (first && maxExtended >= 0x80000004) {
+            for (uint32_t leaf = 0x80000002; leaf <= 0x80000004; leaf++) put(leaf, 0);
+        }
+        if (maxExtended >= 0x80000008) put(0x80000008, 0);
+        if (maxExtended >= 0x8000001D) put_caches(0x8000001D);
+        if (maxExtended >= 0x8000001E) put(0x8000001E, 0);
+        return regs;
+    }
+
+    // Runs on its own thread so the caller's affinity is never touched
+    json read_all()
+    {
+        json cpus = json::array();
+        json doc = json::object();
+
+        thread worker([&]() {
+#ifdef _WIN32
+            WORD groups = GetActiveProcessorGroupCount();
+            for (WORD g = 0; g < groups; g++) {
+                DWORD count = GetActiveProcessorCount(g);
+                for (DWORD i = 0; i < count && i < 64; i++) {
+                    if (!CPUTopology::pinThread(g * 64 + i)) continue;
+                    cpus.push_back({ { "os", g * 64 + i }, { "regs", read_leaves(cpus.empty()) } });
+                }
+            }
+#else
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (!CPU_ISSET(cpu, &allowed) || !CPUTopology::pinThread(cpu)) continue;
+                cpus.push_back({ { "os", cpu }, { "regs", read_leaves(cpus.empty()) } });
+            }
+#endif
+        });
+        worker.join();
+
+        // OSXSAVE: the OS manages XCR0, so XGETBV is allowed
+        bool osxsave = (cpuid(1, 0)[2] >> 27) & 1;
+        doc["xcr0"] = osxsave ? xcr0() : 0;
+        doc["cpus"] = cpus;
+        return doc;
+    }
+#endif
+
+    int ceil_log2(uint32_t n)
+    {
+        int bits = 0;
+        while ((1ULL << bits) < n) bits++;
+        return bits;
+    }
+
+    uint32_t bits(uint32_t value, int low, int count)
+    {
+        return (value >> low) & ((count >= 32) ? 0xffffffffu : ((1u << count) - 1));
+    }
+
+    struct Leaves {
+        const json* regs = nullptr;
+
+        bool has(uint32_t leaf, uint32_t sub = 0) const { return regs->contains(leaf_key(leaf, sub)); }
+
+        Regs at(uint32_t leaf, uint32_t sub = 0) const
+        {
+            auto it = regs->find(leaf_key(leaf, sub));
+            return it == regs->end() ? Regs{} : it->get<Regs>();
+        }
+    };
+}
+
+// ----------------- Decoding -----------------
+
+string CPUTopology::dump()
+{
+    return Probe::text("cpuid:dump", []() -> string {
+#ifdef CPUTOPOLOGY_HAS_CPUID
+        json doc = read_all();
+        return doc["cpus"].empty() ? "" : doc.dump();
+#else
+        return "";
+#endif
+    });
+}
+
+const CPUTopology& CPUTopology::get()
+{
+    static const CPUTopology topology = decode(dump());
+    return topology;
+}
+
+CPUTopology CPUTopology::decode(const string& dump)
+{
+    CPUTopology t;
+    json doc;
+    try {
+        doc = json::parse(dump);
+    }
+    catch (...) {
+        return t;
+    }
+    if (!doc.contains("cpus") || !doc["cpus"].is_array() || doc["cpus"].empty()) return t;
+
+    const json& cpus = doc["cpus"];
+    uint64_t xcr0 = doc.value("xcr0", (uint64_t)0);
+    Leaves first{ &cpus[0]["regs"] };
+
+    // Vendor: EBX EDX ECX of leaf 0
+    Regs l0 = first.at(0);
+    const uint32_t order[3] = { l0[1], l0[3], l0[2] };
+    for (uint32_t reg : order) for (int i = 0; i < 4; i++) t.vendor += static_cast<char>((reg >> (8 * i)) & 0xff);
+    t.vendor.erase(t.vendor.find_last_not_of('\0') + 1);
+    bool amd = t.vendor == "AuthenticAMD" || t.vendor == "HygonGenuine";
+
+    for (uint32_t leaf = 0x80000002; leaf <= 0x80000004; leaf++) {
+        Regs b = first.at(leaf);
+        for (uint32_t reg : b) for (int i = 0; i < 4; i++) t.brand += static_cast<char>((reg >> (8 * i)) & 0xff);
+    }
+    t.brand = t.brand.substr(0, t.brand.find('\0'));
+    size_t begin = t.brand.find_first_not_of(' ');
+    t.brand = begin == string::npos ? "" : t.brand.substr(begin, t.brand.find_last_not_of(' ') - begin + 1);
+
+    // ISA extensions: CPU support, and for vector state the OS saving it too
+    Regs l1 = first.at(1);
+    Regs l7 = first.at(7);
+    Regs e1 = first.at(0x80000001);
+    bool osAvx = ((l1[2] >> 27) & 1) && (xcr0 & 0x6) == 0x6;               // XMM + YMM
+    bool osAvx512 = osAvx && (xcr0 & 0xe0) == 0xe0;                         // opmask, ZMM_Hi256, Hi16_ZMM
+    bool osAmx = (xcr0 & 0x60000) == 0x60000;                               // XTILECFG + XTILEDATA
+    CpuFeatures& f = t.features;
+    f.sse42 = (l1[2] >> 20) & 1;
+    f.avx = osAvx && ((l1[2] >> 28) & 1);
+    f.fma = osAvx && ((l1[2] >> 12) & 1);
+    f.avx2 = osAvx && ((l7[1] >> 5) & 1);
+    f.avx512f = osAvx512 && ((l7[1] >> 16) & 1);
+    f.avx512dq = osAvx512 && ((l7[1] >> 17) & 1);
+    f.avx512bw = osAvx512 && ((l7[1] >> 30) & 1);
+    f.avx512vl = osAvx512 && ((l7[1] >> 31) & 1);
+    f.avx512vnni = osAvx512 && ((l7[2] >> 11) & 1);
+    f.amxTile = osAmx && ((l7[3] >> 24) & 1);
+    f.amxBf16 = osAmx && ((l7[3] >> 22) & 1);
+    f.amxInt8 = osAmx && ((l7[3] >> 25) & 1);
+    f.hypervisor = (l1[2] >> 31) & 1;
+    f.vmx = (l1[2] >> 5) & 1;
+    f.svm = (e1[2] >> 2) & 1;
+
+    Regs e8 = first.at(0x80000008);
+    t.physicalAddressBits = static_cast<int>(bits(e8[0], 0, 8));
+    t.linearAddressBits = static_cast<int>(bits(e8[0], 8, 8));
+
+    // Per processor: APIC ID split into package / core / thread
+    uint32_t cacheLeaf = amd ? 0x8000001D : 0x4;
+    map<tuple<int, char, int, uint32_t>, pair<CpuCache, int>> cacheInstances;  // (level, type, width, id) -> params, processors
+
+    for (const auto& cpu : cpus) {
+        Leaves leaves{ &cpu["regs"] };
+        CpuLogicalProcessor p;
+        p.os = cpu.value("os", 0);
+
+        int smtShift = 0;
+        int packageShift = 0;
+        uint32_t levelLeaf = 0;
+        if (leaves.at(0x1F)[1] != 0) levelLeaf = 0x1F;
+        else if (leaves.at(0xB)[1] != 0) levelLeaf = 0xB;
+
+        if (levelLeaf) {
+            p.apicId = leaves.at(levelLeaf)[3];
+            for (uint32_t sub = 0; leaves.has(levelLeaf, sub); sub++) {
+                Regs r = leaves.at(levelLeaf, sub);
+                uint32_t type = bits(r[2], 8, 8);
+                if (type == 0) break;
+                int shift = static_cast<int>(bits(r[0], 0, 5));
+                if (type == 1) smtShift = shift;
+                packageShift = shift;       // the last level's width covers the package
+            }
+        }
+        else {
+            // Legacy: logical processors per package (leaf 1) and cores per package
+            Regs r1 = leaves.at(1);
+            p.apicId = bits(r1[1], 24, 8);
+            uint32_t perPackage = ((r1[3] >> 28) & 1) ? max(1u, bits(r1[1], 16, 8)) : 1;
+            packageShift = ceil_log2(perPackage);
+            int coreBits = 0;
+            if (amd) {
+                Regs r8 = leaves.at(0x80000008);
+                uint32_t idSize = bits(r8[2], 12, 4);
+                coreBits = idSize ? static_cast<int>(idSize) : ceil_log2(bits(r8[2], 0, 8) + 1);
+                uint32_t perCore = leaves.has(0x8000001E) ? bits(leaves.at(0x8000001E)[1], 8, 8) + 1 : 1;
+                smtShift = ceil_log2(perCore);
+                packageShift = max(packageShift, coreBits);
+            }
+            else {
+                coreBits = ceil_log2(bits(leaves.at(4)[0], 26, 6) + 1);
+                smtShift = max(0, packageShift - coreBits);
+            }
+        }
+
+        p.package = packageShift >= 32 ? 0 : p.apicId >> packageShift;
+        p.core = bits(p.apicId, 0, packageShift) >> smtShift;
+        p.thread = bits(p.apicId, 0, smtShift);
+
+        // Hybrid flag (leaf 7 EDX[15]), then this processor's core type
+        if ((leaves.at(7)[3] >> 15) & 1) {
+            uint32_t type = bits(leaves.at(0x1A)[0], 24, 8);
+            if (type == 0x40) p.type = CoreType::Performance;
+            else if (type == 0x20) p.type = CoreType::Efficient;
+        }
+        t.processors.push_back(p);
+
+        // Cache instances: processors whose APIC IDs agree above the sharing width
+        // (the width is part of the key: a P core's L2 and an E cluster's can share an ID)
+        for (uint32_t sub = 0; leaves.has(cacheLeaf, sub); sub++) {
+            Regs r = leaves.at(cacheLeaf, sub);
+            uint32_t kind = bits(r[0], 0, 5);
+            if (kind == 0) break;
+            if (kind > 3) continue;
+
+            CpuCache c;
+            c.level = static_cast<int>(bits(r[0], 5, 3));
+            c.type = kind == 1 ? 'D' : kind == 2 ? 'I' : 'U';
+            c.ways = static_cast<int>(bits(r[1], 22, 10) + 1);
+            c.lineSize = static_cast<int>(bits(r[1], 0, 12) + 1);
+            uint64_t partitions = bits(r[1], 12, 10) + 1;
+            uint64_t sets = static_cast<uint64_t>(r[2]) + 1;
+            c.sizeBytes = static_cast<uint64_t>(c.ways) * partitions * c.lineSize * sets;
+
+            int shareShift = ceil_log2(bits(r[0], 14, 12) + 1);
+            uint32_t id = shareShift >= 32 ? 0 : p.apicId >> shareShift;
+            auto& slot = cacheInstances[make_tuple(c.level, c.type, shareShift, id)];
+            if (slot.second == 0) slot.first = c;
+            slot.second++;
+        }
+    }
+
+    set<uint32_t> packages;
+    map<pair<uint32_t, uint32_t>, CoreType> cores;
+    for (const auto& p : t.processors) {
+        packages.insert(p.package);
+        cores.insert({ { p.package, p.core }, p.type });
+    }
+    t.packages = static_cast<int>(packages.size());
+    t.cores = static_cast<int>(cores.size());
+    t.logical = static_cast<int>(t.processors.size());
+    for (const auto& c : cores) {
+        if (c.second == CoreType::Performance) t.performanceCores++;
+        else if (c.second == CoreType::Efficient) t.efficientCores++;
+    }
+
+    // Same level, type, size and sharing = one line with an instance count
+    map<tuple<int, int, uint64_t, int>, CpuCache> grouped;
+    const string typeOrder = "DIU";
+    for (const auto& kv : cacheInstances) {
+        const CpuCache& c = kv.second.first;
+        auto key = make_tuple(c.level, static_cast<int>(typeOrder.find(c.type)), c.sizeBytes, kv.second.second);
+        auto it = grouped.find(key);
+        if (it == grouped.end()) {
+            CpuCache g = c;
+            g.sharedBy = kv.second.second;
+            g.instances = 1;
+            grouped[key] = g;
+        }
+        else {
+            it->second.instances++;
+        }
+    }
+    for (const auto& kv : grouped) t.caches.push_back(kv.second);
+
+    t.ok = t.logical > 0;
+    return t;
+}
+
+uint64_t CPUTopology::cacheBytes(int level) const
+{
+    uint64_t total = 0;
+    for (const auto& c : caches) {
+        if (c.level == level) total += c.sizeBytes * c.instances;
+    }
+    return total;
+}
+
+vector<int> CPUTopology::pinOrder() const
+{
+    vector<const CpuLogicalProcessor*> order;
+    for (const auto& p : processors) order.push_back(&p);
+
+    // Every core's first thread before any SMT sibling, P-cores before E-cores
+    auto rank = [](const CpuLogicalProcessor* p) {
+        return make_tuple(p->thread, p->type == CoreType::Efficient, p->package, p->core, p->os);
+    };
+    sort(order.begin(), order.end(), [&](const CpuLogicalProcessor* a, const CpuLogicalProcessor* b) { return rank(a) < rank(b); });
+
+    vector<int> out;
+    for (const auto* p : order) out.push_back(p->os);
+    return out;
+}
+
+bool CPUTopology::pinThread(int os)
+{
+    if (os < 0) return false;
+#ifdef _WIN32
+    GROUP_AFFINITY affinity = {};
+    affinity.Group = static_cast<WORD>(os / 64);
+    affinity.Mask = static_cast<KAFFINITY>(1) << (os % 64);
+    return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+    if (os >= CPU_SETSIZE) return false;
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(os, &one);
+    return sched_setaffinity(0, sizeof(one), &one) == 0;
+#endif
+}
+
+vector<int> CPUTopology::parseCpuList(const string& text)
+{
+    vector<int> cpus;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == string::npos) end = text.size();
+        string range = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (range.empty() || range[0] < '0' || range[0] > '9') continue;
+        int first = atoi(range.c_str());
+        size_t dash = range.find('-');
+        int last = dash == string::npos ? first : atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+string CPUTopology::instructionSets() const
+{
+    const CpuFeatures& f = features;
+    string out;
+    auto add = [&](bool present, const string& name) {
+        if (!present) return;
+        if (!out.empty()) out += ' ';
+        out += name;
+    };
+
+    add(f.sse42, "SSE4.2");
+    add(f.avx, "AVX");
+    add(f.avx2, "AVX2");
+    add(f.fma, "FMA");
+
+    if (f.avx512f) {
+        string parts = "F";
+        if (f.avx512dq) parts += " DQ";
+        if (f.avx512bw) parts += " BW";
+        if (f.avx512vl) parts += " VL";
+        if (f.avx512vnni) parts += " VNNI";
+        add(true, "AVX-512 (" + parts + ")");
+    }
+    if (f.amxTile) {
+        string parts;
+        if (f.amxBf16) parts += "BF16";
+        if (f.amxInt8) parts += parts.empty() ? "INT8" : " INT8";
+        add(true, parts.empty() ? "AMX" : "AMX (" + parts + ")");
+    }
+    return out;
+}
@@ -1,4 +1,5 @@
 #include "include\CompactAudio.h"
+#include "include\Probe.h"
 #include <windows.h>
 #include <mmdeviceapi.h>
 #include <functiondiscoverykeys_devpkey.h>
@@ -35,8 +36,9 @@ string get_audio_device_name(EDataFlow flow) {
 }
 
 
+// Default endpoints go through Probe so --replay shows the recorded devices
 string CompactAudio::active_audio_output() {
-    return get_audio_device_name(eRender);
+    return Probe::text("mmdevice:default-render", []() { return get_audio_device_name(eRender); });
 }
 
 string CompactAudio::active_audio_output_status() {
@@ -44,7 +46,7 @@ string CompactAudio::active_audio_output_status() {
 }
 
 string CompactAudio::active_audio_input() {
-    return get_audio_device_name(eCapture);
+    return Probe::text("mmdevice:default-capture", []() { return get_audio_device_name(eCapture); });
 }
 
 string CompactAudio::active_audio_input_status() {
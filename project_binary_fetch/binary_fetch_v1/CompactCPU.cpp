@@ -1,4 +1,6 @@
 #include "include\CompactCPU.h"
+#include "include\Probe.h"
+#include "include\CPUTopology.h"
 #include <windows.h>
 #include <pdh.h>
 #include <pdhmsg.h>
@@ -15,6 +17,10 @@ using namespace std;
 //---------------- Get CPU Name ------------------
 string CompactCPU::getCPUName()
 {
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok && !topology.brand.empty()) return topology.brand;
+
+    Probe::unrouted("CPUID brand fallback (CompactCPU)");
     int cpuInfo[4] = { -1 };
     char cpuBrand[0x40];
     __cpuid(cpuInfo, 0x80000000);
@@ -37,18 +43,20 @@ string CompactCPU::getCPUName()
 //---------------- Get CPU Core Count ------------------
 string CompactCPU::getCPUCores()
 {
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok) return to_string(topology.cores);
+
+    Probe::unrouted("GetLogicalProcessorInformationEx fallback (CompactCPU)");
     DWORD coreCount = 0;
     DWORD returnLength = 0;
-    GetLogicalProcessorInformation(nullptr, &returnLength);
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &returnLength);
     vector<uint8_t> buffer(returnLength);
-    PSYSTEM_LOGICAL_PROCESSOR_INFORMATION info =
-        reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION>(buffer.data());
 
-    if (GetLogicalProcessorInformation(info, &returnLength))
+    if (GetLogicalProcessorInformationEx(RelationProcessorCore,
+        reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &returnLength))
     {
-        size_t count = returnLength / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
-        for (size_t i = 0; i < count; ++i)
-            if (info[i].Relationship == RelationProcessorCore) coreCount++;
+        for (DWORD offset = 0; offset < returnLength; ++coreCount)
+            offset += reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data() + offset)->Size;
     }
     return to_string(coreCount);
 }
@@ -56,41 +64,50 @@ string CompactCPU::getCPUCores()
 //---------------- Get CPU Thread Count ------------------
 string CompactCPU::getCPUThreads()
 {
+    const CPUTopology& topology = CPUTopology::get();
+    if (topology.ok) return to_string(topology.logical);
+
+    Probe::unrouted("GetActiveProcessorCount fallback (CompactCPU)");
     return to_string(GetActiveProcessorCount(ALL_PROCESSOR_GROUPS));
 }
 
 //---------------- Get CPU Clock Speed (GHz) ------------------
 double CompactCPU::getClockSpeed()
 {
-    DWORD mhz = 0;
-    DWORD bufSize = sizeof(DWORD);
-    HKEY hKey;
+    double mhz = Probe::number("reg:HKLM\\HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0\\~MHz", []() -> double {
+        DWORD mhz = 0;
+        DWORD bufSize = sizeof(DWORD);
+        HKEY hKey;
 
-    if (RegOpenKeyExA(HKEY_LOCAL_MACHINE,
-        "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
-        0, KEY_READ, &hKey) == ERROR_SUCCESS)
-    {
-        RegQueryValueExA(hKey, "~MHz", nullptr, nullptr, (LPBYTE)&mhz, &bufSize);
-        RegCloseKey(hKey);
-    }
+        if (RegOpenKeyExA(HKEY_LOCAL_MACHINE,
+            "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
+            0, KEY_READ, &hKey) == ERROR_SUCCESS)
+        {
+            RegQueryValueExA(hKey, "~MHz", nullptr, nullptr, (LPBYTE)&mhz, &bufSize);
+            RegCloseKey(hKey);
+        }
+        return mhz;
+    });
 
-    return static_cast<double>(mhz) / 1000.0;
+    return mhz / 1000.0;
 }
 
 //---------------- Get CPU Usage (%) Using PDH ------------------
 double CompactCPU::getUsagePercent()
 {
-    PDH_HQUERY query;
-    PDH_HCOUNTER counter;
-    PDH_FMT_COUNTERVALUE counterVal;
+    return Probe::number("pdh:\\Processor(_Total)\\% Processor Time", []() {
+        PDH_HQUERY query;
+        PDH_HCOUNTER counter;
+        PDH_FMT_COUNTERVALUE counterVal;
 
-    PdhOpenQuery(nullptr, 0, &query);
-    PdhAddCounter(query, L"\\Processor(_Total)\\% Processor Time", 0, &counter);
-    PdhCollectQueryData(query);
-    this_thread::sleep_for(chrono::milliseconds(500));
-    PdhCollectQueryData(query);
-    PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE, nullptr, &counterVal);
-    double usage = counterVal.doubleValue;
-    PdhCloseQuery(query);
-    return usage;
+        PdhOpenQuery(nullptr, 0, &query);
+        PdhAddCounter(query, L"\\Processor(_Total)\\% Processor Time", 0, &counter);
+        PdhCollectQueryData(query);
+        this_thread::sleep_for(chrono::milliseconds(500));
+        PdhCollectQueryData(query);
+        PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE, nullptr, &counterVal);
+        double usage = counterVal.doubleValue;
+        PdhCloseQuery(query);
+        return usage;
+    });
 }
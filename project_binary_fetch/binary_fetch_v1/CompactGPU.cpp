@@ -1,7 +1,7 @@
 #include "include\CompactGPU.h"
+#include "include\WMIQuery.h"
+#include "include\Probe.h"
 #include <windows.h>
-#include <wbemidl.h>
-#include <comdef.h>
 #include <iostream>
 #include <string>
 #include <dxgi.h>
@@ -9,7 +9,6 @@
 #include "nvapi.h"
 using namespace std;
 
-#pragma comment(lib, "wbemuuid.lib")
 #pragma comment(lib, "nvapi64.lib")
 
 // -------------------- Helpers --------------------
@@ -20,59 +19,22 @@ static bool isNvapiAvailable() {
     return true;
 }
 
-// WMI helper for float values
-static bool queryWMIFloat(const wchar_t* wql, const wchar_t* field, float& outVal) {
-    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    if (FAILED(hr)) return false;
-
-    hr = CoInitializeSecurity(NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL);
-
-    if (FAILED(hr) && hr != RPC_E_TOO_LATE) {
-        CoUninitialize();
-        return false;
-    }
-
-    IWbemLocator* locator = nullptr;
-    IWbemServices* services = nullptr;
-    hr = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&locator);
-    if (FAILED(hr)) { CoUninitialize(); return false; }
-
-    hr = locator->ConnectServer(_bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0, NULL, 0, 0, &services);
-    locator->Release();
-    if (FAILED(hr)) { CoUninitialize(); return false; }
-
-    CoSetProxyBlanket(services, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-        RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-
-    IEnumWbemClassObject* enumerator = nullptr;
-    hr = services->ExecQuery(bstr_t("WQL"), bstr_t(wql),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, NULL, &enumerator);
-    if (FAILED(hr)) { services->Release(); CoUninitialize(); return false; }
-
-    IWbemClassObject* obj = nullptr;
-    ULONG returned = 0;
-    bool ok = false;
+void CompactGPU::planWmi() {
+    WMIQuery::want("MSAcpi_ThermalZoneTemperature", { "CurrentTemperature" }, "", "ROOT\\WMI");
+}
 
-    while (enumerator && SUCCEEDED(enumerator->Next(WBEM_INFINITE, 1, &obj, &returned)) && returned) {
-        VARIANT val;
-        if (SUCCEEDED(obj->Get(field, 0, &val, 0, 0)) && (val.vt == VT_R8 || val.vt == VT_I4)) {
-            outVal = (val.vt == VT_R8) ? (float)val.dblVal : (float)val.intVal;
-            ok = true;
-            VariantClear(&val);
-            obj->Release();
-            break;
+// WMI helper for float values (served from WMIQuery's per-run cache)
+static bool queryWMIFloat(const string& cls, const string& field, const string& ns, float& outVal) {
+    for (const auto& row : WMIQuery::rows(cls, { field }, "", ns)) {
+        auto it = row.find(field);
+        if (it == row.end()) continue;
+        try {
+            outVal = stof(it->second);
+            return true;
         }
-        VariantClear(&val);
-        obj->Release();
+        catch (...) {}
     }
-
-    if (enumerator) enumerator->Release();
-    services->Release();
-    CoUninitialize();
-    return ok;
+    return false;
 }
 
 // -------------------- NVAPI Utilization Enum (for older headers) --------------------
@@ -89,6 +51,7 @@ enum NV_GPU_UTILIZATION {
 // -------------------- CompactGPU Implementations --------------------
 
 string CompactGPU::getGPUName() {
+    Probe::unrouted("NvAPI / display registry (CompactGPU)");
     if (isNvapiAvailable() && NvAPI_Initialize() == NVAPI_OK) {
         NvPhysicalGpuHandle nvGPU[64];
         NvU32 count = 0;
@@ -138,6 +101,7 @@ string CompactGPU::getGPUName() {
 }
 
 double CompactGPU::getVRAMGB() {
+    Probe::unrouted("NvAPI / display registry (CompactGPU)");
     if (isNvapiAvailable() && NvAPI_Initialize() == NVAPI_OK) {
         NvPhysicalGpuHandle nvGPU[64];
         NvU32 count = 0;
@@ -155,6 +119,7 @@ double CompactGPU::getVRAMGB() {
 }
 
 int CompactGPU::getGPUUsagePercent() {
+    Probe::unrouted("NvAPI / display registry (CompactGPU)");
     // NVIDIA-only GPU usage
     if (!isNvapiAvailable() || NvAPI_Initialize() != NVAPI_OK) return -1;
 
@@ -179,6 +144,7 @@ int CompactGPU::getGPUUsagePercent() {
 
 string CompactGPU::getGPUFrequency()
 {
+    Probe::unrouted("NvAPI / display registry (CompactGPU)");
     // ----------------------------
     // 1. Try NVIDIA NVAPI first
     // ----------------------------
@@ -211,74 +177,22 @@ string CompactGPU::getGPUFrequency()
     //    (DXGI + WMI query for Base Clock)
     // -----------------------------------------
 
-    HRESULT hr;
-    IWbemLocator* pLoc = nullptr;
-    IWbemServices* pSvc = nullptr;
-
-    hr = CoInitializeEx(0, COINIT_MULTITHREADED);
-    if (FAILED(hr)) return "Unknown";
-
-    hr = CoInitializeSecurity(NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL);
-
-    if (FAILED(hr)) return "Unknown";
-
-    hr = CoCreateInstance(
-        CLSID_WbemLocator, 0,
-        CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&pLoc);
-
-    if (FAILED(hr)) return "Unknown";
-
-    hr = pLoc->ConnectServer(
-        _bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0, NULL, 0, 0, &pSvc);
-
-    if (FAILED(hr)) return "Unknown";
-
-    hr = CoSetProxyBlanket(
-        pSvc, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE,
-        NULL, RPC_C_AUTHN_LEVEL_CALL,
-        RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-
-    if (FAILED(hr)) return "Unknown";
-
-    IEnumWbemClassObject* pEnumerator = nullptr;
-    hr = pSvc->ExecQuery(
-        bstr_t("WQL"),
-        bstr_t("SELECT * FROM Win32_VideoController"),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL, &pEnumerator);
-
-    if (FAILED(hr)) return "Unknown";
-
-    IWbemClassObject* pObj = nullptr;
-    ULONG returned = 0;
-
-    if (pEnumerator)
+    // Any Win32_VideoController present -> fallback approximation
+    // (Not truly GPU clock; more reliable fallback is AdapterRAM or name matching)
+    if (WMIQuery::count("Win32_VideoController") > 0)
     {
-        hr = pEnumerator->Next(WBEM_INFINITE, 1, &pObj, &returned);
-        if (returned)
-        {
-            VARIANT vtProp;
-            hr = pObj->Get(L"CurrentRefreshRate", 0, &vtProp, 0, 0);
+        int approxFreq = 1400; // Safe default for modern GPUs
+        stringstream ss;
+        ss << approxFreq << " MHz";
 
-            // Not truly GPU clock, but fallback approximation
-            // More reliable fallback is AdapterRAM or name matching
-
-            int approxFreq = 1400; // Safe default for modern GPUs
-            stringstream ss;
-            ss << approxFreq << " MHz";
-
-            return ss.str();
-        }
+        return ss.str();
     }
 
     return "Unknown";
 }
 
 double CompactGPU::getGPUTemperature() {
+    Probe::unrouted("NvAPI / display registry (CompactGPU)");
     if (isNvapiAvailable() && NvAPI_Initialize() == NVAPI_OK) {
         NvPhysicalGpuHandle nvGPU[64];
         NvU32 count = 0;
@@ -294,8 +208,8 @@ double CompactGPU::getGPUTemperature() {
     }
 
     float tempC = 0.0f;
-    if (queryWMIFloat(L"SELECT CurrentTemperature FROM MSAcpi_ThermalZoneTemperature",
-        L"CurrentTemperature", tempC)) {
+    // Thermal zones live in ROOT\WMI, not ROOT\CIMV2
+    if (queryWMIFloat("MSAcpi_ThermalZoneTemperature", "CurrentTemperature", "ROOT\\WMI", tempC)) {
         return (tempC > 2732.0f) ? (tempC / 10.0f - 273.15f) : tempC;
     }
 
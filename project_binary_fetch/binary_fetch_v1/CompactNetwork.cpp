@@ -3,6 +3,12 @@
 // Likely contains declarations for the CompactNetwork class,
 // function prototypes, constants, and internal networking logic.
 
+#include "include\NetIdentityCache.h"
+// Per-network cache for the SSID (skips the WLAN API on repeat runs).
+
+#include "include\Probe.h"
+// Record / replay of the answers below (--record / --replay).
+
 #include <string>  
 // Provides std::string for safe and flexible text handling.
 // Useful for storing IP addresses, SSIDs, adapter names, etc.
@@ -83,54 +89,56 @@ std::string CompactNetwork::get_network_type() {
 
 // Retrieves the system's IPv4 address.
 // Uses Winsock to resolve hostname into IP address.
+// The answer goes through Probe so --replay shows the recorded machine.
 std::string CompactNetwork::get_network_ip() {
+    return Probe::text("winsock:host-ipv4", []() -> std::string {
+        // Step 1: Initialize Winsock (required before using socket functions)
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+            return "Unknown";  // If initialization fails
+
+        // Step 2: Get local machine hostname
+        char hostname[256];
+        if (gethostname(hostname, sizeof(hostname)) != 0) {
+            WSACleanup();  // Always cleanup before returning
+            return "Unknown";
+        }
 
-    // Step 1: Initialize Winsock (required before using socket functions)
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
-        return "Unknown";  // If initialization fails
-
-    // Step 2: Get local machine hostname
-    char hostname[256];
-    if (gethostname(hostname, sizeof(hostname)) != 0) {
-        WSACleanup();  // Always cleanup before returning
-        return "Unknown";
-    }
-
-    // Step 3: Prepare address lookup settings
-    addrinfo hints = {}, * res = nullptr;
-    hints.ai_family = AF_INET; // Restrict to IPv4 only
+        // Step 3: Prepare address lookup settings
+        addrinfo hints = {}, * res = nullptr;
+        hints.ai_family = AF_INET; // Restrict to IPv4 only
 
-    // Step 4: Convert hostname into IP address info
-    if (getaddrinfo(hostname, nullptr, &hints, &res) != 0) {
-        WSACleanup();
-        return "Unknown";
-    }
+        // Step 4: Convert hostname into IP address info
+        if (getaddrinfo(hostname, nullptr, &hints, &res) != 0) {
+            WSACleanup();
+            return "Unknown";
+        }
 
-    std::string ip = "Unknown";
+        std::string ip = "Unknown";
 
-    // Step 5: Loop through returned addresses (if multiple exist)
-    for (addrinfo* p = res; p != nullptr; p = p->ai_next) {
+        // Step 5: Loop through returned addresses (if multiple exist)
+        for (addrinfo* p = res; p != nullptr; p = p->ai_next) {
 
-        // Convert generic address structure into IPv4 structure
-        sockaddr_in* ipv4 = reinterpret_cast<sockaddr_in*>(p->ai_addr);
+            // Convert generic address structure into IPv4 structure
+            sockaddr_in* ipv4 = reinterpret_cast<sockaddr_in*>(p->ai_addr);
 
-        char ipStr[INET_ADDRSTRLEN];
+            char ipStr[INET_ADDRSTRLEN];
 
-        // Convert binary IP into readable string format (e.g., "192.168.0.1")
-        if (InetNtopA(AF_INET, &ipv4->sin_addr, ipStr, INET_ADDRSTRLEN)) {
-            ip = ipStr;
-            break;  // Stop after first valid IP
+            // Convert binary IP into readable string format (e.g., "192.168.0.1")
+            if (InetNtopA(AF_INET, &ipv4->sin_addr, ipStr, INET_ADDRSTRLEN)) {
+                ip = ipStr;
+                break;  // Stop after first valid IP
+            }
         }
-    }
 
-    // Step 6: Free allocated memory
-    freeaddrinfo(res);
+        // Step 6: Free allocated memory
+        freeaddrinfo(res);
 
-    // Step 7: Shutdown Winsock properly
-    WSACleanup();
+        // Step 7: Shutdown Winsock properly
+        WSACleanup();
 
-    return ip;
+        return ip;
+    });
 }
 
 
@@ -139,8 +147,14 @@ std::string CompactNetwork::get_network_ip() {
 
 
 // Retrieves the currently connected WiFi SSID.
-// Uses Windows WLAN API.
+// Served from NetIdentityCache while the network fingerprint is unchanged;
+// otherwise asks the WLAN API ("" = not on WiFi, cached too).
 std::string CompactNetwork::get_wifi_ssid() {
+    return Probe::text("wlan:ssid", []() { return NetIdentityCache::get("ssid", query_wifi_ssid); });
+}
+
+// Uses Windows WLAN API.
+std::string CompactNetwork::query_wifi_ssid() {
 
     HANDLE hClient = NULL;
     DWORD dwMaxClient = 2;        // WLAN API version
@@ -208,30 +222,31 @@ std::string CompactNetwork::get_wifi_ssid() {
 // Retrieves the Ethernet adapter name.
 // Uses Windows IP Helper API.
 std::string CompactNetwork::get_ethernet_name() {
+    return Probe::text("iphlp:ethernet-name", []() -> std::string {
+        ULONG size = 0;
 
-    ULONG size = 0;
+        // Step 1: First call to determine required buffer size
+        if (GetAdaptersInfo(nullptr, &size) != ERROR_BUFFER_OVERFLOW)
+            return "";
 
-    // Step 1: First call to determine required buffer size
-    if (GetAdaptersInfo(nullptr, &size) != ERROR_BUFFER_OVERFLOW)
-        return "";
+        // Step 2: Allocate buffer dynamically
+        std::vector<BYTE> buffer(size);
+        PIP_ADAPTER_INFO pAdapterInfo = (PIP_ADAPTER_INFO)buffer.data();
 
-    // Step 2: Allocate buffer dynamically
-    std::vector<BYTE> buffer(size);
-    PIP_ADAPTER_INFO pAdapterInfo = (PIP_ADAPTER_INFO)buffer.data();
+        // Step 3: Retrieve adapter information
+        if (GetAdaptersInfo(pAdapterInfo, &size) != ERROR_SUCCESS)
+            return "";
 
-    // Step 3: Retrieve adapter information
-    if (GetAdaptersInfo(pAdapterInfo, &size) != ERROR_SUCCESS)
-        return "";
-
-    // Step 4: Iterate through adapter linked list
-    while (pAdapterInfo) {
+        // Step 4: Iterate through adapter linked list
+        while (pAdapterInfo) {
 
-        // Check if adapter type is Ethernet
-        if (pAdapterInfo->Type == MIB_IF_TYPE_ETHERNET)
-            return pAdapterInfo->Description;
+            // Check if adapter type is Ethernet
+            if (pAdapterInfo->Type == MIB_IF_TYPE_ETHERNET)
+                return pAdapterInfo->Description;
 
-        pAdapterInfo = pAdapterInfo->Next;  // Move to next adapter
-    }
+            pAdapterInfo = pAdapterInfo->Next;  // Move to next adapter
+        }
 
-    return "";
+        return "";
+    });
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "include\CompactOS.h"
+#include "include\Probe.h"
 #include <sstream>
 #include <iomanip>
 #include <Windows.h>
@@ -8,18 +9,33 @@ using namespace std;
 // Typedef for RtlGetVersion
 typedef LONG(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOEXW);
 
-//---------------- Get OS Name ------------------
-string CompactOS::getOSName()
+// RtlGetVersion through Probe ("major minor build") so --replay shows the recorded OS
+static RTL_OSVERSIONINFOEXW os_version()
 {
+    string recorded = Probe::text("ntdll:rtl-get-version", []() -> string {
+        RTL_OSVERSIONINFOEXW rovi = { 0 };
+        rovi.dwOSVersionInfoSize = sizeof(rovi);
+
+        HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
+        if (hMod)
+        {
+            RtlGetVersionPtr fx = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
+            if (fx) fx(&rovi);
+        }
+        return to_string(rovi.dwMajorVersion) + " " + to_string(rovi.dwMinorVersion) + " " + to_string(rovi.dwBuildNumber);
+    });
+
     RTL_OSVERSIONINFOEXW rovi = { 0 };
     rovi.dwOSVersionInfoSize = sizeof(rovi);
+    istringstream in(recorded);
+    in >> rovi.dwMajorVersion >> rovi.dwMinorVersion >> rovi.dwBuildNumber;
+    return rovi;
+}
 
-    HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
-    if (hMod)
-    {
-        RtlGetVersionPtr fx = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
-        if (fx) fx(&rovi);
-    }
+//---------------- Get OS Name ------------------
+string CompactOS::getOSName()
+{
+    RTL_OSVERSIONINFOEXW rovi = os_version();
 
     // Only return OS name, without version/build
     if (rovi.dwMajorVersion == 10 && rovi.dwBuildNumber >= 22000)
@@ -45,15 +61,7 @@ string CompactOS::getOSName()
 //---------------- Get OS Build ------------------
 string CompactOS::getOSBuild()
 {
-    RTL_OSVERSIONINFOEXW rovi = { 0 };
-    rovi.dwOSVersionInfoSize = sizeof(rovi);
-
-    HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
-    if (hMod)
-    {
-        RtlGetVersionPtr fx = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
-        if (fx) fx(&rovi);
-    }
+    RTL_OSVERSIONINFOEXW rovi = os_version();
 
     ostringstream oss;
     oss << rovi.dwMajorVersion << "." << rovi.dwMinorVersion
@@ -64,7 +72,9 @@ string CompactOS::getOSBuild()
 //---------------- Get OS Uptime -----------------
 string CompactOS::getUptime()
 {
-    ULONGLONG ms = GetTickCount64();
+    ULONGLONG ms = static_cast<ULONGLONG>(Probe::number("kernel32:tick-count64", []() -> double {
+        return static_cast<double>(GetTickCount64());
+    }));
     ULONGLONG seconds = ms / 1000;
     int days = (int)(seconds / 86400);
     int hours = (int)((seconds % 86400) / 3600);
@@ -80,10 +90,13 @@ string CompactOS::getUptime()
 //---------------- Get System Architecture -------
 string CompactOS::getArchitecture()
 {
-    SYSTEM_INFO si = { 0 };
-    GetNativeSystemInfo(&si);
+    int arch = static_cast<int>(Probe::number("kernel32:native-arch", []() -> double {
+        SYSTEM_INFO si = { 0 };
+        GetNativeSystemInfo(&si);
+        return si.wProcessorArchitecture;
+    }));
 
-    switch (si.wProcessorArchitecture)
+    switch (arch)
     {
     case PROCESSOR_ARCHITECTURE_AMD64: return "64-bit";
     case PROCESSOR_ARCHITECTURE_INTEL: return "32-bit";
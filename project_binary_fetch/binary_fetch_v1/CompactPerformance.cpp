@@ -1,4 +1,5 @@
 #include "include\CompactPerformance.h"
+#include "include\Probe.h"
 #include <pdh.h>
 #include <pdhmsg.h>
 #include <thread>
@@ -31,48 +32,67 @@ enum NV_GPU_UTILIZATION {
 
 // -------------------- CPU Usage --------------------
 int CompactPerformance::getCPUUsage() {
-    PDH_HQUERY query;
-    PDH_HCOUNTER counter;
-    PDH_FMT_COUNTERVALUE counterVal;
+    double usage = Probe::number("pdh:\\Processor(_Total)\\% Processor Time", []() -> double {
+        PDH_HQUERY query;
+        PDH_HCOUNTER counter;
+        PDH_FMT_COUNTERVALUE counterVal;
+
+        if (PdhOpenQuery(nullptr, 0, &query) != ERROR_SUCCESS) return -1;
+        if (PdhAddCounter(query, L"\\Processor(_Total)\\% Processor Time", 0, &counter) != ERROR_SUCCESS) {
+            PdhCloseQuery(query);
+            return -1;
+        }
 
-    if (PdhOpenQuery(nullptr, 0, &query) != ERROR_SUCCESS) return -1;
-    if (PdhAddCounter(query, L"\\Processor(_Total)\\% Processor Time", 0, &counter) != ERROR_SUCCESS) {
-        PdhCloseQuery(query);
-        return -1;
-    }
+        // Sample twice for accurate reading
+        PdhCollectQueryData(query);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        PdhCollectQueryData(query);
 
-    // Sample twice for accurate reading
-    PdhCollectQueryData(query);
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    PdhCollectQueryData(query);
+        if (PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE, nullptr, &counterVal) != ERROR_SUCCESS) {
+            PdhCloseQuery(query);
+            return -1;
+        }
 
-    if (PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE, nullptr, &counterVal) != ERROR_SUCCESS) {
+        double value = counterVal.doubleValue;
         PdhCloseQuery(query);
-        return -1;
-    }
-
-    double usage = counterVal.doubleValue;
-    PdhCloseQuery(query);
+        return value;
+    });
     return static_cast<int>(usage);
 }
 
 // -------------------- RAM Usage --------------------
 int CompactPerformance::getRAMUsage() {
-    MEMORYSTATUSEX memInfo;
+    // Same keys as MemoryInfo / CompactMemory
+    MEMORYSTATUSEX memInfo = {};
     memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    if (!GlobalMemoryStatusEx(&memInfo)) return -1;
-    return static_cast<int>(100.0 * (memInfo.ullTotalPhys - memInfo.ullAvailPhys) / memInfo.ullTotalPhys);
+    bool ok = false;
+    double total = Probe::number("mem:total-phys", [&]() -> double {
+        ok = GlobalMemoryStatusEx(&memInfo) != 0;
+        return ok ? static_cast<double>(memInfo.ullTotalPhys) : 0.0;
+    });
+    double avail = Probe::number("mem:avail-phys", [&]() -> double {
+        return ok ? static_cast<double>(memInfo.ullAvailPhys) : 0.0;
+    });
+    if (total <= 0.0) return -1;
+    return static_cast<int>(100.0 * (total - avail) / total);
 }
 
 // -------------------- Disk Usage --------------------
 int CompactPerformance::getDiskUsage() {
-    ULARGE_INTEGER freeBytesAvailable, totalBytes, totalFreeBytes;
-    if (!GetDiskFreeSpaceEx(L"C:", &freeBytesAvailable, &totalBytes, &totalFreeBytes)) return -1;
-    return static_cast<int>(100.0 * (totalBytes.QuadPart - totalFreeBytes.QuadPart) / totalBytes.QuadPart);
+    // Same key as PerformanceInfo::get_disk_usage_percent (-1 = the call failed)
+    double used = Probe::number("kernel32:disk-used-fraction:C:", []() -> double {
+        ULARGE_INTEGER freeBytesAvailable, totalBytes, totalFreeBytes;
+        if (!GetDiskFreeSpaceEx(L"C:", &freeBytesAvailable, &totalBytes, &totalFreeBytes)) return -1.0;
+        if (totalBytes.QuadPart == 0) return -1.0;
+        return static_cast<double>(totalBytes.QuadPart - totalFreeBytes.QuadPart) / totalBytes.QuadPart;
+    });
+    if (used < 0.0) return -1;
+    return static_cast<int>(100.0 * used);
 }
 
 // -------------------- GPU Usage --------------------
 int CompactPerformance::getGPUUsage() {
+    Probe::unrouted("NvAPI / PDH GPU engine (CompactPerformance)");
     // --- NVIDIA GPU via NVAPI ---
     if (isNvapiAvailable() && NvAPI_Initialize() == NVAPI_OK) {
         NvPhysicalGpuHandle nvGPU[64];
@@ -1,4 +1,6 @@
 ﻿#include "include\CompactScreen.h"
+#include "include\Probe.h"
+#include "nlohmann/json.hpp"
 
 #include <windows.h>
 #include <dxgi1_6.h>
@@ -12,6 +14,7 @@
 #include <algorithm>
 #include <cwctype>
 using namespace std;
+using json = nlohmann::json;
 
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "Shcore.lib")
@@ -33,11 +36,28 @@ CompactScreen::CompactScreen() {
     refresh();
 }
 
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(ScreenInfo,
+    name, native_width, native_height, current_width, current_height, refresh_rate,
+    scale_percent, scale_mul, upscale)
+
 bool CompactScreen::refresh() {
+    // Finished screens go through Probe as one JSON value (see DisplayInfo::refresh)
+    string recorded = Probe::text("dxgi:screens", [this]() -> string {
+        screens.clear();
+        if (populateFromDXGI()) {
+            enrichWithNVAPI();
+            enrichWithADL();
+        }
+        return json(screens).dump(-1, ' ', false, json::error_handler_t::replace);
+    });
+
     screens.clear();
-    if (!populateFromDXGI()) return false;
-    enrichWithNVAPI();
-    enrichWithADL();
+    try {
+        if (!recorded.empty()) screens = json::parse(recorded).get<vector<ScreenInfo>>();
+    }
+    catch (...) {
+        screens.clear();
+    }
     return !screens.empty();
 }
 
@@ -90,50 +110,10 @@ bool CompactScreen::isAMDPresent() {
     return false;
 }
 
-CompactScreen::EDIDInfo CompactScreen::parseEDID(const unsigned char* edid, size_t size) {
-    EDIDInfo info = { "", 0, 0, false };
-    if (!edid || size < 128) return info;
-
-    // Validate EDID header
-    if (edid[0] != 0x00 || edid[1] != 0xFF || edid[7] != 0x00) return info;
-
-    // Extract native resolution from first detailed timing descriptor (bytes 54-71)
-    if (size >= 72) {
-        unsigned short hActive = ((edid[58] >> 4) << 8) | edid[56];
-        unsigned short vActive = ((edid[61] >> 4) << 8) | edid[59];
-        if (hActive > 0 && vActive > 0) {
-            info.nativeWidth = hActive;
-            info.nativeHeight = vActive;
-            info.valid = true;
-        }
-    }
-
-    // Extract monitor name from descriptor blocks (0xFC descriptor type)
-    for (int i = 54; i < 126; i += 18) {
-        if (i + 17 >= size) break;
-        if (edid[i] == 0x00 && edid[i + 1] == 0x00 && edid[i + 3] == 0xFC) {
-            string name;
-            for (int j = 5; j < 18; ++j) {
-                if (edid[i + j] == 0x0A || edid[i + j] == 0x00) break;
-                if (edid[i + j] >= 0x20 && edid[i + j] <= 0x7E) {
-                    name += static_cast<char>(edid[i + j]);
-                }
-            }
-            while (!name.empty() && name.back() == ' ') name.pop_back();
-            if (!name.empty()) {
-                info.friendlyName = name;
-            }
-            break;
-        }
-    }
-    return info;
-}
-
-string CompactScreen::getFriendlyNameFromEDID(const wstring& deviceName) {
-    // Attempt to derive the monitor hardware ID for this DXGI device name.
-    // This improves matching against the registry entries under
-    // SYSTEM\\CurrentControlSet\\Enum\\DISPLAY\\<vendor>\\<instance>\\Device Parameters\\EDID
-    wstring monitorHardwareId; // e.g., L"MONITOR\\DEL4067\\{...}"
+EDIDData CompactScreen::getEDIDForDevice(const wstring& deviceName, const vector<EDIDBlob>& blobs) {
+    // Resolve the monitor hardware ID for this DXGI device name (e.g. MONITOR\DEL4067\{...})
+    // and use its vendor part to pick the matching blob under Enum\DISPLAY.
+    wstring monitorHardwareId;
     DISPLAY_DEVICEW ddMon{};
     ddMon.cb = sizeof(ddMon);
     for (DWORD iMon = 0; EnumDisplayDevicesW(deviceName.c_str(), iMon, &ddMon, 0); ++iMon) {
@@ -143,19 +123,6 @@ string CompactScreen::getFriendlyNameFromEDID(const wstring& deviceName) {
         }
     }
 
-    HKEY hKeyMonitors;
-    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-        L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY",
-        0, KEY_READ, &hKeyMonitors) != ERROR_SUCCESS) {
-        return "Generic PnP Monitor";
-    }
-
-    string friendlyName = "Generic PnP Monitor";
-    WCHAR subKeyName[256];
-    DWORD subKeyIndex = 0;
-
-    // Extract vendor part from monitorHardwareId (between first and second backslash):
-    // MONITOR\DEL4067\{...}  -> vendorPart = DEL4067
     wstring vendorPart;
     if (!monitorHardwareId.empty()) {
         size_t p1 = monitorHardwareId.find(L'\\');
@@ -167,99 +134,10 @@ string CompactScreen::getFriendlyNameFromEDID(const wstring& deviceName) {
                 vendorPart = monitorHardwareId.substr(p1 + 1);
         }
     }
+    string vendor = WideToUtf8(vendorPart.c_str());
 
-    // Normalize vendorPart to lowercase for comparisons
-    wstring vendLower;
-    if (!vendorPart.empty()) {
-        vendLower = vendorPart;
-        transform(vendLower.begin(), vendLower.end(), vendLower.begin(), towlower);
-    }
-
-    // First pass: try to find a matching vendor key and read EDID from instances under it.
-    while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
-        wstring subKeyStr(subKeyName);
-
-        // If we have a vendorPart, only consider keys that begin with that vendorPart (case-insensitive).
-        if (!vendLower.empty()) {
-            wstring subLower = subKeyStr;
-            transform(subLower.begin(), subLower.end(), subLower.begin(), towlower);
-            if (subLower.find(vendLower) != 0) {
-                continue; // skip non-matching vendor keys
-            }
-        }
-
-        HKEY hKeyMonitor;
-        if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) == ERROR_SUCCESS) {
-            WCHAR deviceKeyName[256];
-            DWORD deviceKeyIndex = 0;
-
-            while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
-                HKEY hKeyDevice;
-                if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) == ERROR_SUCCESS) {
-                    HKEY hKeyDeviceParams;
-                    if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
-                        BYTE edidData[256];
-                        DWORD edidSize = sizeof(edidData);
-
-                        if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, edidData, &edidSize) == ERROR_SUCCESS) {
-                            EDIDInfo edidInfo = parseEDID(edidData, edidSize);
-                            if (!edidInfo.friendlyName.empty()) {
-                                friendlyName = edidInfo.friendlyName;
-                                RegCloseKey(hKeyDeviceParams);
-                                RegCloseKey(hKeyDevice);
-                                RegCloseKey(hKeyMonitor);
-                                RegCloseKey(hKeyMonitors);
-                                return friendlyName;
-                            }
-                        }
-                        RegCloseKey(hKeyDeviceParams);
-                    }
-                    RegCloseKey(hKeyDevice);
-                }
-            }
-            RegCloseKey(hKeyMonitor);
-        }
-    }
-
-    // If vendor-specific match failed or vendorPart was empty, do a fallback full scan (original behavior).
-    // Reset enumeration and scan everything once more to find any EDID name.
-    subKeyIndex = 0;
-    while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
-        HKEY hKeyMonitor;
-        if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) == ERROR_SUCCESS) {
-            WCHAR deviceKeyName[256];
-            DWORD deviceKeyIndex = 0;
-
-            while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
-                HKEY hKeyDevice;
-                if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) == ERROR_SUCCESS) {
-                    HKEY hKeyDeviceParams;
-                    if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
-                        BYTE edidData[256];
-                        DWORD edidSize = sizeof(edidData);
-
-                        if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, edidData, &edidSize) == ERROR_SUCCESS) {
-                            EDIDInfo edidInfo = parseEDID(edidData, edidSize);
-                            if (!edidInfo.friendlyName.empty()) {
-                                friendlyName = edidInfo.friendlyName;
-                                RegCloseKey(hKeyDeviceParams);
-                                RegCloseKey(hKeyDevice);
-                                RegCloseKey(hKeyMonitor);
-                                RegCloseKey(hKeyMonitors);
-                                return friendlyName;
-                            }
-                        }
-                        RegCloseKey(hKeyDeviceParams);
-                    }
-                    RegCloseKey(hKeyDevice);
-                }
-            }
-            RegCloseKey(hKeyMonitor);
-        }
-    }
-
-    RegCloseKey(hKeyMonitors);
-    return friendlyName;
+    // This monitor's own key first, named or not, before any other monitor's EDID
+    return EDIDParser::forMonitor(blobs, vendor);
 }
 
 bool CompactScreen::populateFromDXGI() {
@@ -269,6 +147,9 @@ bool CompactScreen::populateFromDXGI() {
     bool hasNvidia = isNvidiaPresent();
     bool hasAMD = isAMDPresent();
 
+    // Read every EDID blob once per refresh instead of rescanning the registry per output
+    vector<EDIDBlob> edidBlobs = EDIDParser::readAll();
+
     IDXGIAdapter1* adapter = nullptr;
     for (UINT a = 0; factory->EnumAdapters1(a, &adapter) != DXGI_ERROR_NOT_FOUND; ++a) {
         IDXGIOutput* output = nullptr;
@@ -290,56 +171,13 @@ bool CompactScreen::populateFromDXGI() {
                         if (dm.dmDisplayFrequency > 1) refresh = dm.dmDisplayFrequency;
                     }
 
-                    // ===== GET MONITOR FRIENDLY NAME =====
-                    // Pass the full device name (e.g., \\.\DISPLAY1)
+                    // ===== READ EDID (name, native panel mode, refresh range, HDR) =====
                     wstring deviceNameW = desc1.DeviceName;
-                    string friendlyName = getFriendlyNameFromEDID(deviceNameW);
+                    EDIDData edid = getEDIDForDevice(deviceNameW, edidBlobs);
+                    string friendlyName = edid.friendlyName.empty() ? "Generic PnP Monitor" : edid.friendlyName;
 
                     // ===== GET NATIVE PANEL RESOLUTION (FROM EDID) =====
-                    int nativeW = 0, nativeH = 0;
-                    HKEY hKeyMonitors;
-                    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-                        L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY",
-                        0, KEY_READ, &hKeyMonitors) == ERROR_SUCCESS) {
-                        WCHAR subKeyName[256];
-                        DWORD subKeyIndex = 0;
-
-                        while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
-                            HKEY hKeyMonitor;
-                            if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) == ERROR_SUCCESS) {
-                                WCHAR deviceKeyName[256];
-                                DWORD deviceKeyIndex = 0;
-
-                                while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
-                                    HKEY hKeyDevice;
-                                    if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) == ERROR_SUCCESS) {
-                                        HKEY hKeyDeviceParams;
-                                        if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
-                                            BYTE edidData[256];
-                                            DWORD edidSize = sizeof(edidData);
-
-                                            if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, edidData, &edidSize) == ERROR_SUCCESS) {
-                                                EDIDInfo edidInfo = parseEDID(edidData, edidSize);
-                                                if (edidInfo.valid && edidInfo.nativeWidth > 0) {
-                                                    nativeW = edidInfo.nativeWidth;
-                                                    nativeH = edidInfo.nativeHeight;
-                                                    RegCloseKey(hKeyDeviceParams);
-                                                    RegCloseKey(hKeyDevice);
-                                                    RegCloseKey(hKeyMonitor);
-                                                    goto edid_found;
-                                                }
-                                            }
-                                            RegCloseKey(hKeyDeviceParams);
-                                        }
-                                        RegCloseKey(hKeyDevice);
-                                    }
-                                }
-                                RegCloseKey(hKeyMonitor);
-                            }
-                        }
-                    edid_found:
-                        RegCloseKey(hKeyMonitors);
-                    }
+                    int nativeW = edid.nativeWidth, nativeH = edid.nativeHeight;
 
                     // Fallback: if we can't get native resolution, assume no upscaling
                     if (nativeW <= 0 || nativeH <= 0) {
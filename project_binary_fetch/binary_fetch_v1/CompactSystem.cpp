@@ -1,28 +1,34 @@
 #include "include\CompactSystem.h"
+#include "include\Probe.h"
 #include <windows.h>
 #include <string>
 #include <iostream>
 using namespace std;
+// Only HKLM is read here; the value goes through Probe ("reg:HKLM\\<subkey>\\<value>",
+// "" when missing) so --replay shows the recorded machine
 string readRegistryValue(HKEY root, const string& subkey, const string& valueName) {
-    HKEY hKey;
-    if (RegOpenKeyExA(root, subkey.c_str(), 0, KEY_READ, &hKey) != ERROR_SUCCESS)
-        return "Unknown";
+    string value = Probe::text("reg:HKLM\\" + subkey + "\\" + valueName, [&]() -> string {
+        HKEY hKey;
+        if (RegOpenKeyExA(root, subkey.c_str(), 0, KEY_READ, &hKey) != ERROR_SUCCESS)
+            return "";
 
-    char value[256];
-    DWORD value_length = sizeof(value);
-    DWORD type = 0;
+        char value[256] = { 0 };
+        DWORD value_length = sizeof(value) - 1;
+        DWORD type = 0;
 
-    if (RegQueryValueExA(hKey, valueName.c_str(), nullptr, &type, reinterpret_cast<LPBYTE>(value), &value_length) != ERROR_SUCCESS) {
-        RegCloseKey(hKey);
-        return "Unknown";
-    }
+        if (RegQueryValueExA(hKey, valueName.c_str(), nullptr, &type, reinterpret_cast<LPBYTE>(value), &value_length) != ERROR_SUCCESS) {
+            RegCloseKey(hKey);
+            return "";
+        }
 
-    RegCloseKey(hKey);
+        RegCloseKey(hKey);
 
-    if (type == REG_SZ || type == REG_EXPAND_SZ)
-        return string(value);
-    else
-        return "Unknown";
+        if (type == REG_SZ || type == REG_EXPAND_SZ)
+            return string(value);
+        else
+            return "";
+    });
+    return value.empty() ? "Unknown" : value;
 }
 
 string CompactSystem::getBIOSInfo() {
@@ -1,4 +1,5 @@
 #include "include\CompactUser.h"
+#include "include\Probe.h"
 #include <Windows.h>
 #include <lmcons.h>
 #include <iostream>
@@ -6,52 +7,59 @@
 #include <sddl.h>
 using namespace std;
 
+// Answers go through Probe (keys shared with UserInfo) so --replay shows the recorded user
 string CompactUser::getUsername()
 {
-	char username[UNLEN + 1];
-	DWORD size = UNLEN + 1;
-	if (GetUserNameA(username, &size))
-	{
-		return string(username);
-	}else { return "Uknown User"; }
+    return Probe::text("user:name", []() -> string {
+        char username[UNLEN + 1];
+        DWORD size = UNLEN + 1;
+        if (GetUserNameA(username, &size))
+        {
+            return string(username);
+        }else { return "Uknown User"; }
+    });
 }
 
 string CompactUser::getDomain() {
-    char computerName[MAX_COMPUTERNAME_LENGTH + 1];
-    DWORD size = MAX_COMPUTERNAME_LENGTH + 1;
-    if (GetComputerNameA(computerName, &size))
-        return string(computerName);
-    return "UnknownDomain";
+    return Probe::text("user:computer-name", []() -> string {
+        char computerName[MAX_COMPUTERNAME_LENGTH + 1];
+        DWORD size = MAX_COMPUTERNAME_LENGTH + 1;
+        if (GetComputerNameA(computerName, &size))
+            return string(computerName);
+        return "UnknownDomain";
+    });
 }
 
 string CompactUser::isAdmin() {
-    BOOL isAdmin = FALSE;
-    HANDLE hToken = NULL;
-    DWORD size = 0;
+    return Probe::text("token:admin", []() -> string {
+        BOOL isAdmin = FALSE;
+        HANDLE hToken = NULL;
+        DWORD size = 0;
 
-    if (OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken)) {
-        GetTokenInformation(hToken, TokenGroups, NULL, 0, &size);
-        BYTE* buffer = new BYTE[size];
-        if (GetTokenInformation(hToken, TokenGroups, buffer, size, &size)) {
-            PTOKEN_GROUPS groups = (PTOKEN_GROUPS)buffer;
-            SID_IDENTIFIER_AUTHORITY NtAuthority = SECURITY_NT_AUTHORITY;
-            PSID AdministratorsGroup;
-            if (AllocateAndInitializeSid(&NtAuthority, 2,
-                SECURITY_BUILTIN_DOMAIN_RID, DOMAIN_ALIAS_RID_ADMINS,
-                0, 0, 0, 0, 0, 0, &AdministratorsGroup))
-            {
-                for (DWORD i = 0; i < groups->GroupCount; i++) {
-                    if (EqualSid(groups->Groups[i].Sid, AdministratorsGroup)) {
-                        isAdmin = (groups->Groups[i].Attributes & SE_GROUP_ENABLED) != 0;
-                        break;
+        if (OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken)) {
+            GetTokenInformation(hToken, TokenGroups, NULL, 0, &size);
+            BYTE* buffer = new BYTE[size];
+            if (GetTokenInformation(hToken, TokenGroups, buffer, size, &size)) {
+                PTOKEN_GROUPS groups = (PTOKEN_GROUPS)buffer;
+                SID_IDENTIFIER_AUTHORITY NtAuthority = SECURITY_NT_AUTHORITY;
+                PSID AdministratorsGroup;
+                if (AllocateAndInitializeSid(&NtAuthority, 2,
+                    SECURITY_BUILTIN_DOMAIN_RID, DOMAIN_ALIAS_RID_ADMINS,
+                    0, 0, 0, 0, 0, 0, &AdministratorsGroup))
+                {
+                    for (DWORD i = 0; i < groups->GroupCount; i++) {
+                        if (EqualSid(groups->Groups[i].Sid, AdministratorsGroup)) {
+                            isAdmin = (groups->Groups[i].Attributes & SE_GROUP_ENABLED) != 0;
+                            break;
+                        }
                     }
+                    FreeSid(AdministratorsGroup);
                 }
-                FreeSid(AdministratorsGroup);
             }
+            delete[] buffer;
+            CloseHandle(hToken);
         }
-        delete[] buffer;
-        CloseHandle(hToken);
-    }
 
-    return isAdmin ? "Admin" : "Non-Admin";
+        return isAdmin ? "Admin" : "Non-Admin";
+    });
 }
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "include\ConnectionInfo.h"
+#include "include\Probe.h"
+
+#include <set>
+#include <sstream>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#include <iphlpapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <unistd.h>
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+namespace {
+    const int STATE_SLOTS = 12;     // index = kernel TCP state (0 unused)
+
+    struct SocketSummary {
+        uint64_t counts[STATE_SLOTS] = {};
+        set<int> listening;
+    };
+
+    string encode(const string& source, const SocketSummary& s)
+    {
+        json states = json::array();
+        for (int i = 0; i < STATE_SLOTS; i++) states.push_back(s.counts[i]);
+        return json{ { "source", source }, { "states", states }, { "listen", s.listening } }.dump();
+    }
+
+    // encode() output -> the socket half of ConnectionStats
+    void decode(const string& encoded, ConnectionStats& out)
+    {
+        try {
+            if (encoded.empty()) return;
+            json j = json::parse(encoded);
+            out.source = j.value("source", "");
+            const json& states = j["states"];
+            const auto& names = ConnectionInfo::stateNames();
+            for (size_t i = 1; i < names.size() && i < states.size(); i++) {
+                uint64_t n = states[i].get<uint64_t>();
+                out.states.push_back({ names[i], n });
+                out.total += n;
+            }
+            for (const auto& port : j["listen"]) out.listeningPorts.push_back(port.get<int>());
+            out.ok = true;
+        }
+        catch (...) {
+            out = ConnectionStats();
+        }
+    }
+
+    // /proc/net/tcp{,6}: "sl local_address rem_address st ..." (hex, port after the colon)
+    void scan_proc(string_view text, SocketSummary& s)
+    {
+        istringstream in{ string(text) };
+        string line;
+        getline(in, line);
+        while (getline(in, line)) {
+            istringstream fields(line);
+            string slot, local, remote, st;
+            if (!(fields >> slot >> local >> remote >> st)) continue;
+            int state = static_cast<int>(strtol(st.c_str(), nullptr, 16));
+            if (state <= 0 || state >= STATE_SLOTS) continue;
+            s.counts[state]++;
+            size_t colon = local.rfind(':');
+            if (state == 10 && colon != string::npos) s.listening.insert(static_cast<int>(strtol(local.c_str() + colon + 1, nullptr, 16)));
+        }
+    }
+
+#ifdef _WIN32
+    // MIB_TCP_STATE -> kernel numbering
+    int kernel_state(DWORD state)
+    {
+        switch (state) {
+        case MIB_TCP_STATE_ESTAB:      return 1;
+        case MIB_TCP_STATE_SYN_SENT:   return 2;
+        case MIB_TCP_STATE_SYN_RCVD:   return 3;
+        case MIB_TCP_STATE_FIN_WAIT1:  return 4;
+        case MIB_TCP_STATE_FIN_WAIT2:  return 5;
+        case MIB_TCP_STATE_TIME_WAIT:  return 6;
+        case MIB_TCP_STATE_CLOSE_WAIT: return 8;
+        case MIB_TCP_STATE_LAST_ACK:   return 9;
+        case MIB_TCP_STATE_LISTEN:     return 10;
+        case MIB_TCP_STATE_CLOSING:    return 11;
+        default:                       return 7;    // CLOSED, DELETE_TCB
+        }
+    }
+
+    // Grows the buffer until the table fits (it can grow between calls)
+    bool tcp_table(ULONG family, vector<unsigned char>& buf)
+    {
+        DWORD size = 0;
+        DWORD rc = ERROR_INSUFFICIENT_BUFFER;
+        for (int attempt = 0; attempt < 4 && rc == ERROR_INSUFFICIENT_BUFFER; attempt++) {
+            buf.resize(size ? size + size / 8 : 64 * 1024);
+            size = static_cast<DWORD>(buf.size());
+            rc = GetExtendedTcpTable(buf.data(), &size, FALSE, family, TCP_TABLE_OWNER_PID_ALL, 0);
+        }
+        return rc == NO_ERROR;
+    }
+
+    string read_sockets()
+    {
+        return Probe::text("iphlp:tcp-table", []() -> string {
+            SocketSummary s;
+            vector<unsigned char> buf;
+            bool any = false;
+
+            if (tcp_table(AF_INET, buf)) {
+                any = true;
+                auto* table = reinterpret_cast<MIB_TCPTABLE_OWNER_PID*>(buf.data());
+                for (DWORD i = 0; i < table->dwNumEntries; i++) {
+                    int state = kernel_state(table->table[i].dwState);
+                    s.counts[state]++;
+                    if (state == 10) s.listening.insert(ntohs(static_cast<u_short>(table->table[i].dwLocalPort)));
+                }
+            }
+            if (tcp_table(AF_INET6, buf)) {
+                any = true;
+                auto* table = reinterpret_cast<MIB_TCP6TABLE_OWNER_PID*>(buf.data());
+                for (DWORD i = 0; i < table->dwNumEntries; i++) {
+                    int state = kernel_state(table->table[i].dwState);
+                    s.counts[state]++;
+                    if (state == 10) s.listening.insert(ntohs(static_cast<u_short>(table->table[i].dwLocalPort)));
+                }
+            }
+            return any ? encode("GetExtendedTcpTable", s) : "";
+        });
+    }
+
+    void read_counters(ConnectionStats& out)
+    {
+        string encoded = Probe::text("iphlp:tcp-statistics", []() -> string {
+            uint64_t outSegs = 0, retrans = 0, inErrs = 0;
+            bool any = false;
+            for (ULONG family : { (ULONG)AF_INET, (ULONG)AF_INET6 }) {
+                MIB_TCPSTATS stats = {};
+                if (GetTcpStatisticsEx(&stats, family) != NO_ERROR) continue;
+                any = true;
+                outSegs += stats.dwOutSegs;
+                retrans += stats.dwRetransSegs;
+                inErrs += stats.dwInErrs;
+            }
+            if (!any) return "";
+            return json{ { "OutSegs", outSegs }, { "RetransSegs", retrans }, { "InErrs", inErrs } }.dump();
+        });
+        try {
+            if (encoded.empty()) return;
+            json j = json::parse(encoded);
+            out.outSegments = j.value("OutSegs", (int64_t)-1);
+            out.retransSegments = j.value("RetransSegs", (int64_t)-1);
+            out.inErrors = j.value("InErrs", (int64_t)-1);
+        }
+        catch (...) {
+        }
+    }
+#else
+    // One SOCK_DIAG_BY_FAMILY dump; false if netlink isn't usable
+    bool dump_family(int fd, uint8_t family, SocketSummary& s)
+    {
+        struct {
+            nlmsghdr header;
+            inet_diag_req_v2 request;
+        } msg = {};
+        msg.header.nlmsg_len = sizeof(msg);
+        msg.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+        msg.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        msg.header.nlmsg_seq = family;
+        msg.request.sdiag_family = family;
+        msg.request.sdiag_protocol = IPPROTO_TCP;
+        msg.request.idiag_states = ~0u;         // every state, TIME_WAIT and SYN_RECV included
+        msg.request.idiag_ext = 0;              // no extensions: just the fixed header
+
+        sockaddr_nl kernel = {};
+        kernel.nl_family = AF_NETLINK;
+        if (sendto(fd, &msg, sizeof(msg), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) return false;
+
+        // 32 KiB per read like ss; each message is one socket (~72 bytes)
+        alignas(nlmsghdr) char buf[32 * 1024];
+        for (;;) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (n == 0) return false;
+
+            int len = static_cast<int>(n);
+            for (nlmsghdr* h = reinterpret_cast<nlmsghdr*>(buf); NLMSG_OK(h, len); h = NLMSG_NEXT(h, len)) {
+                if (h->nlmsg_seq != family) continue;
+                if (h->nlmsg_type == NLMSG_DONE) return true;
+                if (h->nlmsg_type == NLMSG_ERROR) return false;
+                if (h->nlmsg_type != SOCK_DIAG_BY_FAMILY) continue;
+
+                const inet_diag_msg* m = reinterpret_cast<const inet_diag_msg*>(NLMSG_DATA(h));
+                int state = m->idiag_state == 12 ? 3 : m->idiag_state;     // TCP_NEW_SYN_RECV -> SYN_RECV
+                if (state <= 0 || state >= STATE_SLOTS) continue;
+                s.counts[state]++;
+                if (state == 10) s.listening.insert(ntohs(m->id.idiag_sport));
+            }
+        }
+    }
+
+    string read_sockets()
+    {
+        return Probe::text("sockdiag:tcp", []() -> string {
+            SocketSummary s;
+            int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+            if (fd >= 0) {
+                // No IPv6 (ipv6.disable=1, module not loaded) fails only the second dump:
+                // that means no v6 sockets, not a reason to throw the v4 dump away
+                bool ok = dump_family(fd, AF_INET, s);
+                SocketSummary v6;
+                if (ok && dump_family(fd, AF_INET6, v6)) {
+                    for (int i = 0; i < STATE_SLOTS; i++) s.counts[i] += v6.counts[i];
+                    s.listening.insert(v6.listening.begin(), v6.listening.end());
+                }
+                close(fd);
+                if (ok) return encode("sock_diag", s);
+            }
+
+            s = SocketSummary();
+            string v4 = Probe::file("/proc/net/tcp");
+            string v6 = Probe::file("/proc/net/tcp6");
+            if (v4.empty() && v6.empty()) return "";
+            scan_proc(v4, s);
+            scan_proc(v6, s);
+            return encode("/proc/net/tcp", s);
+        });
+    }
+
+    void read_counters(ConnectionStats& out)
+    {
+        auto tcp = ConnectionInfo::parseSnmp(Probe::file("/proc/net/snmp"), "Tcp");
+        auto ext = ConnectionInfo::parseSnmp(Probe::file("/proc/net/netstat"), "TcpExt");
+        auto get = [](const map<string, int64_t>& m, const char* key) {
+            auto it = m.find(key);
+            return it == m.end() ? (int64_t)-1 : it->second;
+        };
+        out.outSegments = get(tcp, "OutSegs");
+        out.retransSegments = get(tcp, "RetransSegs");
+        out.inErrors = get(tcp, "InErrs");
+        out.outOfOrder = get(ext, "TCPOFOQueue");
+        out.listenOverflows = get(ext, "ListenOverflows");
+        out.listenDrops = get(ext, "ListenDrops");
+        out.timeouts = get(ext, "TCPTimeouts");
+    }
+#endif
+}
+
+const vector<string>& ConnectionInfo::stateNames()
+{
+    static const vector<string> names = {
+        "", "ESTABLISHED", "SYN_SENT", "SYN_RECV", "FIN_WAIT1", "FIN_WAIT2",
+        "TIME_WAIT", "CLOSE", "CLOSE_WAIT", "LAST_ACK", "LISTEN", "CLOSING"
+    };
+    return names;
+}
+
+map<string, int64_t> ConnectionInfo::parseSnmp(string_view text, const string& prefix)
+{
+    // "Tcp: RtoAlgorithm RtoMin ...\nTcp: 1 200 ...\n"
+    map<string, int64_t> values;
+    string tag = prefix + ":";
+    vector<string> header;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == string_view::npos) end = text.size();
+        string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.compare(0, tag.size(), tag) != 0) continue;
+
+        istringstream fields(string(line.substr(tag.size())));
+        vector<string> tokens;
+        string t;
+        while (fields >> t) tokens.push_back(t);
+
+        if (header.empty()) {
+            header = tokens;
+            continue;
+        }
+        for (size_t i = 0; i < header.size() && i < tokens.size(); i++) {
+            values[header[i]] = strtoll(tokens[i].c_str(), nullptr, 10);
+        }
+        header.clear();
+    }
+    return values;
+}
+
+ConnectionStats ConnectionInfo::collect()
+{
+    ConnectionStats out;
+    decode(read_sockets(), out);
+    read_counters(out);
+    return out;
+}
+
+ConnectionStats ConnectionInfo::parseProcTcp(string_view tcp, string_view tcp6)
+{
+    SocketSummary s;
+    scan_proc(tcp, s);
+    scan_proc(tcp6, s);
+    ConnectionStats out;
+    decode(encode("/proc/net/tcp", s), out);
+    return out;
+}
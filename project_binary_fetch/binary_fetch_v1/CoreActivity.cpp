@@ -0,0 +1,369 @@
+#include "include\CoreActivity.h"
+#include "include\CPUTopology.h"
+#include "include\Probe.h"
+#include "include\PseudoFileReader.h"
+
+#include <map>
+#include <thread>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <Pdh.h>
+#include <pdhmsg.h>
+#pragma comment(lib, "pdh.lib")
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+// ----------------- Backend state -----------------
+
+#ifdef _WIN32
+
+namespace {
+    const wchar_t* const COUNTER_PATHS[] = {
+        L"\\Processor Information(*)\\% Processor Time",
+        L"\\Processor Information(*)\\Processor Frequency",
+        L"\\Processor Information(*)\\% Processor Performance"
+    };
+    const int COUNTER_COUNT = sizeof(COUNTER_PATHS) / sizeof(COUNTER_PATHS[0]);
+
+    string narrow(const wchar_t* w)
+    {
+        int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+        if (len <= 1) return "";
+        string out(len - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, w, -1, &out[0], len, nullptr, nullptr);
+        return out;
+    }
+
+    // Instance name -> value for one wildcard counter
+    bool read_array(PDH_HCOUNTER counter, map<string, double>& out)
+    {
+        DWORD size = 0, count = 0;
+        if (PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &size, &count, nullptr) != PDH_MORE_DATA) return false;
+
+        vector<BYTE> buf(size);
+        auto* items = reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(buf.data());
+        if (PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &size, &count, items) != ERROR_SUCCESS) return false;
+
+        for (DWORD i = 0; i < count; ++i) {
+            DWORD status = items[i].FmtValue.CStatus;
+            if (status != PDH_CSTATUS_VALID_DATA && status != PDH_CSTATUS_NEW_DATA) continue;
+            out[narrow(items[i].szName)] = items[i].FmtValue.doubleValue;
+        }
+        return true;
+    }
+}
+
+struct CoreActivity::Impl {
+    PDH_HQUERY query = nullptr;
+    PDH_HCOUNTER counters[COUNTER_COUNT] = {};
+    bool ready = false;
+
+    Impl()
+    {
+        if (PdhOpenQuery(nullptr, 0, &query) != ERROR_SUCCESS) {
+            query = nullptr;
+            return;
+        }
+        ready = true;
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            if (PdhAddEnglishCounterW(query, COUNTER_PATHS[i], 0, &counters[i]) != ERROR_SUCCESS) ready = false;
+        }
+    }
+
+    ~Impl()
+    {
+        if (query) PdhCloseQuery(query);
+    }
+};
+
+#else
+
+namespace {
+    const uint32_t MSR_TSC = 0x10;
+    const uint32_t MSR_MPERF = 0xE7;
+    const uint32_t MSR_APERF = 0xE8;
+}
+
+struct CoreActivity::Impl {
+    PseudoFileReader reader;
+    int stat = -1;
+    string baseline;
+    string msrBaseline;
+    vector<int> cpus;                   // from /sys/devices/system/cpu
+    map<int, int> curFreq;              // cpu -> scaling_cur_freq handle
+    map<int, int> msr;                  // cpu -> /dev/cpu/N/msr fd
+    bool msrTried = false;
+
+    Impl()
+    {
+        stat = reader.add("/proc/stat", 16384);
+
+        for (const auto& name : Probe::dir("/sys/devices/system/cpu")) {
+            if (name.size() < 4 || name.compare(0, 3, "cpu") != 0 ||
+                name.find_first_not_of("0123456789", 3) != string::npos) continue;
+            int cpu = atoi(name.c_str() + 3);
+            cpus.push_back(cpu);
+            curFreq[cpu] = reader.add("/sys/devices/system/cpu/" + name + "/cpufreq/scaling_cur_freq");
+        }
+        sort(cpus.begin(), cpus.end());
+    }
+
+    ~Impl()
+    {
+        for (const auto& kv : msr) ::close(kv.second);
+    }
+
+    // Every cpu or none: a partial table would mix clock sources in one row
+    bool openMsr()
+    {
+        msrTried = true;
+        for (int cpu : cpus) {
+            int fd = open(("/dev/cpu/" + to_string(cpu) + "/msr").c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) break;
+            msr[cpu] = fd;
+        }
+        if (!msr.empty() && msr.size() == cpus.size()) return true;
+        for (const auto& kv : msr) ::close(kv.second);
+        msr.clear();
+        return false;
+    }
+
+    // {"ns": steady clock, "cpus": [[cpu, tsc, aperf, mperf], ...]} or ""
+    string readMsr()
+    {
+        return Probe::text("msr:aperf-mperf", [this]() -> string {
+            if (!msrTried) openMsr();
+            if (msr.empty()) return "";
+
+            json rows = json::array();
+            for (const auto& kv : msr) {
+                uint64_t tsc = 0, aperf = 0, mperf = 0;
+                // Virtual machines often refuse APERF / MPERF with EIO
+                if (pread(kv.second, &tsc, 8, MSR_TSC) != 8 ||
+                    pread(kv.second, &aperf, 8, MSR_APERF) != 8 ||
+                    pread(kv.second, &mperf, 8, MSR_MPERF) != 8) return "";
+                rows.push_back({ kv.first, tsc, aperf, mperf });
+            }
+            auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+            return json{ { "ns", ns }, { "cpus", rows } }.dump();
+        });
+    }
+};
+
+#endif
+
+// ----------------- Sampling -----------------
+
+CoreActivity::CoreActivity() : impl(new Impl()) {}
+
+CoreActivity::~CoreActivity() = default;
+
+void CoreActivity::begin()
+{
+#ifdef _WIN32
+    if (impl->ready) PdhCollectQueryData(impl->query);
+#else
+    impl->reader.refresh({ impl->stat });
+    impl->baseline = string(impl->reader.text(impl->stat));
+    impl->msrBaseline = impl->readMsr();
+#endif
+    started = chrono::steady_clock::now();
+    begun = true;
+}
+
+vector<CoreActivityStats> CoreActivity::sample(int intervalMs)
+{
+    if (!begun) begin();
+
+    auto due = started + chrono::milliseconds(intervalMs);
+    if (chrono::steady_clock::now() < due && !Probe::replaying()) this_thread::sleep_until(due);
+
+    vector<CoreActivityStats> stats;
+    source.clear();
+
+#ifdef _WIN32
+    // One snapshot value for the whole table so --record / --replay keep it together
+    string encoded = Probe::text("pdh:\\Processor Information(*)", [&]() -> string {
+        if (!impl->ready || PdhCollectQueryData(impl->query) != ERROR_SUCCESS) return "";
+
+        map<string, double> values[COUNTER_COUNT];
+        for (int i = 0; i < COUNTER_COUNT; ++i) read_array(impl->counters[i], values[i]);
+
+        json rows = json::array();
+        for (const auto& kv : values[0]) {
+            auto get = [&](int i) { auto it = values[i].find(kv.first); return it == values[i].end() ? 0.0 : it->second; };
+            rows.push_back({ { "instance", kv.first }, { "busy", get(0) }, { "mhz", get(1) * get(2) / 100.0 } });
+        }
+        return rows.dump();
+    });
+
+    try {
+        if (!encoded.empty()) {
+            for (const auto& row : json::parse(encoded)) {
+                // "<group>,<index>"; "_Total" and "<group>,_Total" are skipped
+                string instance = row.value("instance", "");
+                size_t comma = instance.find(',');
+                if (comma == string::npos || instance.find('_') != string::npos) continue;
+
+                CoreActivityStats s;
+                s.cpu = atoi(instance.c_str()) * 64 + atoi(instance.c_str() + comma + 1);
+                s.utilization = min(100.0, max(0.0, row.value("busy", 0.0)));
+                s.mhz = row.value("mhz", 0.0);
+                if (s.mhz > 0.0) source = "PDH";
+                stats.push_back(s);
+            }
+        }
+    }
+    catch (...) {
+        stats.clear();
+    }
+#else
+    impl->reader.refresh({ impl->stat });
+    for (const auto& busy : diffStat(impl->baseline, impl->reader.text(impl->stat))) {
+        CoreActivityStats s;
+        s.cpu = busy.first;
+        s.utilization = busy.second;
+        stats.push_back(s);
+    }
+
+    string msrAfter = impl->msrBaseline.empty() ? "" : impl->readMsr();
+    map<int, double> mhz;
+    try {
+        if (!msrAfter.empty()) {
+            json before = json::parse(impl->msrBaseline);
+            json after = json::parse(msrAfter);
+            double seconds = (after["ns"].get<int64_t>() - before["ns"].get<int64_t>()) / 1e9;
+
+            map<int, const json*> first;
+            for (const auto& row : before["cpus"]) first[row[0].get<int>()] = &row;
+            for (const auto& row : after["cpus"]) {
+                auto b = first.find(row[0].get<int>());
+                if (b == first.end()) continue;
+                uint64_t x[3], y[3];
+                for (int i = 0; i < 3; i++) {
+                    x[i] = (*b->second)[i + 1].get<uint64_t>();
+                    y[i] = row[i + 1].get<uint64_t>();
+                }
+                mhz[b->first] = effectiveMhz(x, y, seconds);
+            }
+            source = "APERF/MPERF";
+        }
+    }
+    catch (...) {
+        mhz.clear();
+    }
+
+    if (mhz.empty()) {
+        vector<int> handles;
+        for (const auto& s : stats) {
+            auto it = impl->curFreq.find(s.cpu);
+            if (it != impl->curFreq.end()) handles.push_back(it->second);
+        }
+        impl->reader.refresh(handles);
+        for (const auto& s : stats) {
+            auto it = impl->curFreq.find(s.cpu);
+            if (it == impl->curFreq.end()) continue;
+            long long khz = impl->reader.number(it->second, 0);
+            if (khz > 0) {
+                mhz[s.cpu] = khz / 1000.0;
+                source = "scaling_cur_freq";
+            }
+        }
+    }
+    for (auto& s : stats) {
+        auto it = mhz.find(s.cpu);
+        if (it != mhz.end()) s.mhz = it->second;
+    }
+#endif
+
+    // Socket of every processor
+    const CPUTopology& topology = CPUTopology::get();
+    map<int, int> package;
+    for (const auto& p : topology.processors) package[p.os] = static_cast<int>(p.package);
+    for (auto& s : stats) {
+        auto it = package.find(s.cpu);
+        if (it != package.end()) s.package = it->second;
+#ifndef _WIN32
+        else if (!topology.ok) {
+            string id = Probe::file("/sys/devices/system/cpu/cpu" + to_string(s.cpu) + "/topology/physical_package_id");
+            s.package = id.empty() ? 0 : max(0, atoi(id.c_str()));
+        }
+#endif
+    }
+
+    sort(stats.begin(), stats.end(), [](const CoreActivityStats& a, const CoreActivityStats& b) {
+        return a.package != b.package ? a.package < b.package : a.cpu < b.cpu;
+    });
+    return stats;
+}
+
+// ----------------- Derivations -----------------
+
+vector<pair<int, double>> CoreActivity::diffStat(string_view before, string_view after)
+{
+    //   cpuN  user nice system idle iowait irq softirq steal  guest guest_nice
+    // guest time is already part of user, so only the first eight count
+    auto parse = [](string_view text) {
+        map<int, vector<long long>> rows;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == string_view::npos) end = text.size();
+            string_view line = text.substr(pos, end - pos);
+            pos = end + 1;
+
+            // Per-cpu lines only ("cpu " is the aggregate)
+            if (line.size() < 4 || line.compare(0, 3, "cpu") != 0 || line[3] < '0' || line[3] > '9') continue;
+            size_t space = line.find(' ');
+            if (space == string_view::npos) continue;
+
+            long long cpu = 0;
+            if (!PseudoFileReader::parseNumber(line.substr(3, space - 3), cpu)) continue;
+            vector<long long> fields;
+            PseudoFileReader::parseNumbers(line.substr(space), fields);
+            if (fields.size() >= 4) rows[static_cast<int>(cpu)] = fields;
+        }
+        return rows;
+    };
+
+    vector<pair<int, double>> busy;
+    auto first = parse(before);
+    auto second = parse(after);
+    for (const auto& a : second) {
+        auto b = first.find(a.first);
+        if (b == first.end()) continue;     // came online in between
+
+        // Per field: iowait can go backwards on some kernels, and a cpu that
+        // was offlined and back resets its counters. A field that shrank
+        // counts as no time rather than eating into the others.
+        long long dt = 0, di = 0;
+        for (size_t i = 0; i < a.second.size() && i < b->second.size() && i < 8; i++) {
+            long long d = max(a.second[i] - b->second[i], 0LL);
+            dt += d;
+            if (i == 3 || i == 4) di += d;
+        }
+        double percent = dt > 0 ? 100.0 * (dt - di) / dt : 0.0;
+        busy.push_back({ a.first, percent });
+    }
+    return busy;
+}
+
+double CoreActivity::effectiveMhz(const uint64_t before[3], const uint64_t after[3], double seconds)
+{
+    // Unsigned deltas survive a wrap; a core asleep for the whole interval
+    // has no MPERF ticks and no meaningful clock
+    uint64_t tsc = after[0] - before[0];
+    uint64_t aperf = after[1] - before[1];
+    uint64_t mperf = after[2] - before[2];
+    if (seconds <= 0.0 || mperf == 0 || tsc == 0) return 0.0;
+    return tsc / seconds / 1e6 * (static_cast<double>(aperf) / mperf);
+}
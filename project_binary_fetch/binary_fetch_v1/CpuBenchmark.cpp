@@ -0,0 +1,294 @@
+#include "include\CpuBenchmark.h"
+#include "include\CPUTopology.h"
+#include "include\Probe.h"
+
+#include <set>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+using namespace std;
+
+// ----------------- Kernels -----------------
+
+namespace {
+    const int CHUNK = 4096;         // iterations between stop checks
+    const int LANES = 8;
+
+    // Results land here so the kernels can't be optimised away
+    volatile uint64_t int_sink;
+    volatile double fp_sink;
+
+    uint64_t int_chunk(uint64_t seed, int iterations)
+    {
+        const uint64_t K = 0xBF58476D1CE4E5B9ULL;
+        uint64_t l0 = seed, l1 = seed + 1, l2 = seed + 2, l3 = seed + 3;
+        uint64_t l4 = seed + 4, l5 = seed + 5, l6 = seed + 6, l7 = seed + 7;
+        for (int i = 0; i < iterations; i++) {
+            l0 = (l0 ^ (l0 >> 31)) * K; l1 = (l1 ^ (l1 >> 31)) * K;
+            l2 = (l2 ^ (l2 >> 31)) * K; l3 = (l3 ^ (l3 >> 31)) * K;
+            l4 = (l4 ^ (l4 >> 31)) * K; l5 = (l5 ^ (l5 >> 31)) * K;
+            l6 = (l6 ^ (l6 >> 31)) * K; l7 = (l7 ^ (l7 >> 31)) * K;
+        }
+        return l0 ^ l1 ^ l2 ^ l3 ^ l4 ^ l5 ^ l6 ^ l7;
+    }
+
+    // Converges towards 1.0, so values stay normal however long it runs
+    double fp_chunk(double seed, int iterations)
+    {
+        const double A = 0.999999, B = 0.000001;
+        double y0 = seed, y1 = seed + 0.1, y2 = seed + 0.2, y3 = seed + 0.3;
+        double y4 = seed + 0.4, y5 = seed + 0.5, y6 = seed + 0.6, y7 = seed + 0.7;
+        for (int i = 0; i < iterations; i++) {
+            y0 = y0 * A + B; y1 = y1 * A + B; y2 = y2 * A + B; y3 = y3 * A + B;
+            y4 = y4 * A + B; y5 = y5 * A + B; y6 = y6 * A + B; y7 = y7 * A + B;
+        }
+        return (y0 + y1 + y2 + y3 + y4 + y5 + y6 + y7) / LANES;
+    }
+
+    // Operations per second with `threads` workers, kernel 0 = integer, 1 = float
+    double run_step(int threads, int kernel, const vector<int>& order, int durationMs)
+    {
+        atomic<int> ready(0);
+        atomic<bool> go(false), stop(false);
+        vector<uint64_t> iterations(threads, 0);
+
+        vector<thread> team;
+        for (int t = 0; t < threads; t++) {
+            team.emplace_back([&, t]() {
+                if (t < static_cast<int>(order.size())) CPUTopology::pinThread(order[t]);
+                ready++;
+                while (!go.load()) this_thread::yield();
+
+                uint64_t n = 0, si = t + 1;
+                double sf = t + 1.0;
+                while (!stop.load(memory_order_relaxed)) {
+                    if (kernel == 0) si = int_chunk(si, CHUNK);
+                    else sf = fp_chunk(sf, CHUNK);
+                    n += CHUNK;
+                }
+                iterations[t] = n;
+                int_sink = si;
+                fp_sink = sf;
+            });
+        }
+
+        // Every worker pinned and waiting, then one shared start
+        while (ready.load() < threads) this_thread::yield();
+        auto start = chrono::steady_clock::now();
+        go = true;
+        this_thread::sleep_for(chrono::milliseconds(durationMs));
+        stop = true;
+        for (auto& worker : team) worker.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        uint64_t total = 0;
+        for (uint64_t n : iterations) total += n;
+        double perIteration = kernel == 0 ? LANES : LANES * 2.0;
+        return seconds > 0.0 ? total * perIteration / seconds : 0.0;
+    }
+
+#ifndef _WIN32
+    // "max 100000" / "200000 100000" -> CPUs, 0 if unlimited
+    double parse_cpu_max(const string& text)
+    {
+        istringstream in(text);
+        string quota;
+        double period = 0.0;
+        if (!(in >> quota >> period) || quota == "max" || period <= 0.0) return 0.0;
+        return atof(quota.c_str()) / period;
+    }
+#endif
+}
+
+// ----------------- OS limits -----------------
+
+int CpuBenchmark::allowedCpus()
+{
+    return static_cast<int>(Probe::number("affinity:process-cpus", []() -> double {
+#ifdef _WIN32
+        // GetProcessAffinityMask only describes one processor group (and is
+        // all zeroes once the process spans several), so past 64 CPUs it
+        // would always look restricted
+        USHORT groups[64] = {};
+        USHORT groupCount = 64;
+        if (!GetProcessGroupAffinity(GetCurrentProcess(), &groupCount, groups)) return 0;
+        DWORD_PTR process = 0, system = 0;
+        if (groupCount == 1 && GetProcessAffinityMask(GetCurrentProcess(), &process, &system) && process != system) {
+            int count = 0;
+            for (; process; process &= process - 1) count++;
+            return count;
+        }
+        // Unrestricted: threads can be placed in any group (pinThread does)
+        if (groupCount == 1 || groupCount == GetActiveProcessorGroupCount())
+            return static_cast<int>(GetActiveProcessorCount(ALL_PROCESSOR_GROUPS));
+        DWORD count = 0;
+        for (USHORT i = 0; i < groupCount; i++) count += GetActiveProcessorCount(groups[i]);
+        return static_cast<int>(count);
+#else
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return 0;
+        return CPU_COUNT(&allowed);
+#endif
+    }));
+}
+
+int CpuBenchmark::onlineCpus()
+{
+    return static_cast<int>(Probe::number("affinity:online-cpus", []() -> double {
+#ifdef _WIN32
+        return GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#else
+        // The whole machine, not just this process's cpuset (which is all
+        // CPUTopology and sched_getaffinity can see)
+        return static_cast<double>(CPUTopology::parseCpuList(Probe::file("/sys/devices/system/cpu/online")).size());
+#endif
+    }));
+}
+
+double CpuBenchmark::quotaCpus()
+{
+#ifdef _WIN32
+    return Probe::number("job:cpu-rate", []() -> double {
+        // Hard-capped job objects (containers, some CI runners)
+        JOBOBJECT_CPU_RATE_CONTROL_INFORMATION info = {};
+        if (!QueryInformationJobObject(nullptr, JobObjectCpuRateControlInformation, &info, sizeof(info), nullptr)) return 0;
+        if (!(info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_ENABLE) ||
+            !(info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP)) return 0;
+        // CpuRate is in 1/100 of a percent of the whole machine
+        return info.CpuRate / 10000.0 * GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    });
+#else
+    // cgroup v2: "0::/path"; the tightest cpu.max on the way up wins
+    string path;
+    istringstream groups(Probe::file("/proc/self/cgroup"));
+    string line;
+    while (getline(groups, line)) {
+        if (line.compare(0, 3, "0::") == 0) path = line.substr(3);
+    }
+
+    double quota = 0.0;
+    auto tighter = [&](double cpus) {
+        if (cpus > 0.0 && (quota == 0.0 || cpus < quota)) quota = cpus;
+    };
+    bool unified = false;
+    while (!path.empty()) {
+        string limit = Probe::file("/sys/fs/cgroup" + (path == "/" ? "" : path) + "/cpu.max");
+        if (!limit.empty()) {
+            unified = true;
+            tighter(parse_cpu_max(limit));
+        }
+        if (path == "/") break;
+        size_t slash = path.rfind('/');
+        path = slash == string::npos || slash == 0 ? "/" : path.substr(0, slash);
+    }
+    if (unified) return quota;
+
+    // cgroup v1 (or hybrid, where the cpu controller still lives in v1)
+    for (const string dir : { "/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct" }) {
+        string q = Probe::file(dir + "/cpu.cfs_quota_us");
+        string p = Probe::file(dir + "/cpu.cfs_period_us");
+        if (q.empty() || p.empty()) continue;
+        double us = atof(q.c_str()), period = atof(p.c_str());
+        if (us > 0.0 && period > 0.0) tighter(us / period);
+        break;
+    }
+    return quota;
+#endif
+}
+
+// ----------------- Scaling run -----------------
+
+vector<int> CpuBenchmark::threadCounts(int cores, int logical)
+{
+    set<int> counts;
+    for (int t = 1; t < logical; t *= 2) counts.insert(t);
+    if (cores > 0 && cores <= logical) counts.insert(cores);
+    counts.insert(logical > 0 ? logical : 1);
+    return vector<int>(counts.begin(), counts.end());
+}
+
+CpuBenchReport CpuBenchmark::run(const CpuBenchConfig& config)
+{
+    // Measurements can't be replayed (the affinity / quota inputs above are)
+    Probe::unrouted("CpuBenchmark");
+    CpuBenchReport report;
+    report.allowedCpus = allowedCpus();
+    report.onlineCpus = onlineCpus();
+    report.quotaCpus = quotaCpus();
+
+    const CPUTopology& topology = CPUTopology::get();
+    vector<int> order = topology.pinOrder();
+    report.pinned = !order.empty();
+    report.physicalCores = topology.ok ? topology.cores : 0;
+    int logical = report.pinned ? static_cast<int>(order.size()) : static_cast<int>(thread::hardware_concurrency());
+
+    double intBase = 0.0, fpBase = 0.0;
+    for (int threads : threadCounts(report.physicalCores, logical)) {
+        CpuBenchStep step;
+        step.threads = threads;
+        step.smt = report.physicalCores > 0 && threads > report.physicalCores;
+        step.intOps = run_step(threads, 0, order, config.durationMs);
+        step.flops = run_step(threads, 1, order, config.durationMs);
+        if (threads == 1) {
+            intBase = step.intOps;
+            fpBase = step.flops;
+        }
+        if (intBase > 0.0) {
+            step.intEfficiency = step.intOps / (threads * intBase);
+            if (step.intOps / intBase > report.intParallelism) report.intParallelism = step.intOps / intBase;
+        }
+        if (fpBase > 0.0) {
+            step.fpEfficiency = step.flops / (threads * fpBase);
+            if (step.flops / fpBase > report.fpParallelism) report.fpParallelism = step.flops / fpBase;
+        }
+        report.steps.push_back(step);
+    }
+    return report;
+}
+
+string CpuBenchmark::assess(const CpuBenchReport& report, int cores, int logical)
+{
+    if (report.steps.empty()) return "not measured";
+
+    double expected = cores > 0 ? cores : logical;
+    ostringstream limits;
+    limits << fixed << setprecision(1);
+
+    // The reported count may itself only cover the CPUs this process can see
+    int machine = report.onlineCpus > logical ? report.onlineCpus : logical;
+    if (report.allowedCpus > 0 && machine > 0 && report.allowedCpus < machine) {
+        if (report.allowedCpus < expected) expected = report.allowedCpus;
+        limits << "affinity (" << report.allowedCpus << " of " << machine << " CPUs)";
+    }
+    if (report.quotaCpus > 0.0 && report.quotaCpus < expected) {
+        expected = report.quotaCpus;
+        if (limits.tellp() > 0) limits << ", ";
+#ifdef _WIN32
+        limits << "job CPU rate (" << report.quotaCpus << " CPUs)";
+#else
+        limits << "cgroup quota (" << report.quotaCpus << " CPUs)";
+#endif
+    }
+
+    ostringstream out;
+    out << fixed << setprecision(1);
+    double measured = report.intParallelism > report.fpParallelism ? report.intParallelism : report.fpParallelism;
+    // A quarter short of the expected cores is more than SMT or turbo
+    // differences explain
+    if (measured < 0.75 * expected) out << "only " << measured << "x of " << expected << " expected: throttled or contended";
+    else if (limits.tellp() <= 0) out << "matches " << (cores > 0 ? cores : logical) << (cores > 0 ? " cores" : " CPUs");
+
+    if (limits.tellp() > 0) out << (out.tellp() > 0 ? "; limited by " : "limited by ") << limits.str();
+    return out.str();
+}
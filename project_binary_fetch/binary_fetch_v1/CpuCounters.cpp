@@ -0,0 +1,310 @@
+#include "include\CpuCounters.h"
+#include "include\CPUTopology.h"
+#include "include\Probe.h"
+
+#include <map>
+#include <thread>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+namespace {
+    const int EVENT_COUNT = 6;      // cycles, instructions, cache-misses, branches, branch-misses, stalled
+}
+
+// ----------------- Backend state -----------------
+
+#ifdef _WIN32
+
+struct CpuCounters::Impl {
+    void open() {}
+    string read(int) { return json{ { "error", "hardware counters need perf_event_open (Linux only)" } }.dump(); }
+};
+
+#else
+
+namespace {
+    // Same order as the value slots in the JSON rows; cycles leads the group
+    const uint64_t EVENTS[EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_STALLED_CYCLES_BACKEND
+    };
+
+    int open_event(uint64_t config, int cpu, int group)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group == -1;        // members follow the leader
+        attr.exclude_hv = 1;                // some hypervisors refuse to count themselves
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, -1, cpu, group, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    string why(int err)
+    {
+        switch (err) {
+        case EACCES:
+        case EPERM: {
+            string paranoid = Probe::file("/proc/sys/kernel/perf_event_paranoid");
+            while (!paranoid.empty() && isspace(static_cast<unsigned char>(paranoid.back()))) paranoid.pop_back();
+            return "perf_event_paranoid is " + (paranoid.empty() ? string("unknown") : paranoid) +
+                "; system-wide counters need 0 or lower (or CAP_PERFMON)";
+        }
+        case ENOENT:
+        case EOPNOTSUPP:
+        case ENODEV:
+            return "no hardware PMU exposed (virtual machine?)";
+        case ENOSYS:
+            return "kernel built without perf events";
+        default:
+            return string("perf_event_open failed: ") + strerror(err);
+        }
+    }
+}
+
+struct CpuCounters::Impl {
+    struct Group {
+        int cpu = 0;
+        vector<int> fds;            // [0] is the leader
+        vector<int> slots;          // EVENTS index of each value in the group read
+    };
+
+    vector<Group> groups;
+    string error;
+    string note;
+    chrono::steady_clock::time_point enabled;
+
+    ~Impl() { close(); }
+
+    void close()
+    {
+        for (const auto& g : groups) {
+            for (int fd : g.fds) ::close(fd);
+        }
+        groups.clear();
+    }
+
+    // The first `events` of EVENTS, one group per online processor
+    void open(int events = EVENT_COUNT)
+    {
+        vector<int> cpus = CPUTopology::parseCpuList(Probe::file("/sys/devices/system/cpu/online"));
+        if (cpus.empty()) {
+            for (const auto& p : CPUTopology::get().processors) cpus.push_back(p.os);
+        }
+
+        for (int cpu : cpus) {
+            Group g;
+            g.cpu = cpu;
+            int leader = open_event(EVENTS[0], cpu, -1);
+            if (leader < 0) {
+                int err = errno;
+                if (err == EMFILE || err == ENFILE) break;      // out of fds: count what we have
+                if (err == ENODEV && !groups.empty()) continue; // went offline meanwhile
+                if (groups.empty()) {
+                    error = why(err);
+                    return;
+                }
+                continue;
+            }
+            g.fds.push_back(leader);
+            g.slots.push_back(0);
+
+            // Members the PMU doesn't implement just stay out of the group
+            for (int e = 1; e < events; e++) {
+                int fd = open_event(EVENTS[e], cpu, leader);
+                if (fd < 0) continue;
+                g.fds.push_back(fd);
+                g.slots.push_back(e);
+            }
+
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            groups.push_back(g);
+        }
+        if (groups.empty() && error.empty()) error = "no online processors found";
+        enabled = chrono::steady_clock::now();
+    }
+
+    // Stops every group; one row per group that got onto the PMU
+    json collect()
+    {
+        json rows = json::array();
+        for (const auto& g : groups) {
+            ioctl(g.fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            // nr, time_enabled, time_running, one value per member
+            uint64_t buf[3 + EVENT_COUNT] = {};
+            ssize_t n = ::read(g.fds[0], buf, sizeof(buf));
+            if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buf[2] == 0) continue;   // never scheduled
+
+            // Multiplexed groups only ran for part of the window
+            double scale = static_cast<double>(buf[1]) / buf[2];
+            json row = json::array({ g.cpu });
+            double values[EVENT_COUNT];
+            fill(values, values + EVENT_COUNT, -1.0);
+            for (size_t i = 0; i < buf[0] && i < g.slots.size(); i++) values[g.slots[i]] = buf[3 + i] * scale;
+            for (double v : values) row.push_back(v);
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    // {"error": "", "note": "", "cpus": [[cpu, cycles, instructions, ...], ...]}
+    string read(int intervalMs)
+    {
+        if (!error.empty()) return json{ { "error", error } }.dump();
+
+        json rows = collect();
+        if (rows.empty()) {
+            // Every group read time_running == 0: the whole group never fit on the
+            // PMU at once (fewer counters than members, or the NMI watchdog / another
+            // perf user holding some). Count the two that matter most, for as long
+            // as the first window was but never past the sampling interval: a late
+            // sample() must not stall the caller for the whole time since begin().
+            auto window = min<chrono::steady_clock::duration>(chrono::steady_clock::now() - enabled,
+                chrono::milliseconds(intervalMs));
+            close();
+            open(2);
+            if (!error.empty()) return json{ { "error", error } }.dump();
+            this_thread::sleep_for(window);
+            rows = collect();
+            if (rows.empty()) {
+                return json{ { "error", "counters were never scheduled: the PMU is in use "
+                    "(NMI watchdog or another perf session?)" } }.dump();
+            }
+            note = "the full event group never got onto the PMU; counted cycles and instructions only, "
+                "over a second window (the NMI watchdog may be holding a counter)";
+        }
+        return json{ { "error", "" }, { "note", note }, { "cpus", rows } }.dump();
+    }
+};
+
+#endif
+
+// ----------------- Sampling -----------------
+
+CpuCounters::CpuCounters() : impl(new Impl()) {}
+
+CpuCounters::~CpuCounters() = default;
+
+void CpuCounters::begin()
+{
+    if (!Probe::replaying()) impl->open();
+    started = chrono::steady_clock::now();
+    begun = true;
+}
+
+vector<CpuCounterStats> CpuCounters::sample(int intervalMs)
+{
+    if (!begun) begin();
+
+    auto due = started + chrono::milliseconds(intervalMs);
+    if (chrono::steady_clock::now() < due && !Probe::replaying()) this_thread::sleep_until(due);
+
+    string encoded = Probe::text("perf:counters", [&]() -> string { return impl->read(intervalMs); });
+
+    vector<CpuCounterStats> stats;
+    failure.clear();
+    notice.clear();
+    try {
+        json doc = json::parse(encoded);
+        failure = doc.value("error", "");
+        notice = doc.value("note", "");
+        if (doc.contains("cpus")) {
+            for (const auto& row : doc["cpus"]) {
+                CpuCounterStats s;
+                s.cpu = row[0].get<int>();
+                s.name = "cpu" + to_string(s.cpu);
+                s.cycles = row[1].get<double>();
+                s.instructions = row[2].get<double>();
+                s.cacheMisses = row[3].get<double>();
+                s.branches = row[4].get<double>();
+                s.branchMisses = row[5].get<double>();
+                s.stalledCycles = row[6].get<double>();
+                stats.push_back(s);
+            }
+        }
+    }
+    catch (...) {
+        stats.clear();
+        if (failure.empty()) failure = "no counter data";
+    }
+    if (failure.empty() && stats.empty()) failure = "no counter data";
+
+    // Socket of every processor
+    const CPUTopology& topology = CPUTopology::get();
+    map<int, int> package;
+    for (const auto& p : topology.processors) package[p.os] = static_cast<int>(p.package);
+    for (auto& s : stats) {
+        auto it = package.find(s.cpu);
+        if (it != package.end()) s.package = it->second;
+#ifndef _WIN32
+        else if (!topology.ok) {
+            string id = Probe::file("/sys/devices/system/cpu/cpu" + to_string(s.cpu) + "/topology/physical_package_id");
+            s.package = id.empty() ? 0 : max(0, atoi(id.c_str()));
+        }
+#endif
+    }
+
+    sort(stats.begin(), stats.end(), [](const CpuCounterStats& a, const CpuCounterStats& b) {
+        return a.package != b.package ? a.package < b.package : a.cpu < b.cpu;
+    });
+    return stats;
+}
+
+// ----------------- Aggregation -----------------
+
+vector<CpuCounterStats> CpuCounters::bySocket(const vector<CpuCounterStats>& cpus)
+{
+    // An event missing on any member is missing for the sum, otherwise the
+    // ratios would mix different sets of processors
+    auto add = [](CpuCounterStats& into, const CpuCounterStats& s) {
+        into.cycles += s.cycles;
+        into.instructions += s.instructions;
+        auto merge = [](double& total, double value) { total = (total < 0 || value < 0) ? -1.0 : total + value; };
+        merge(into.cacheMisses, s.cacheMisses);
+        merge(into.branches, s.branches);
+        merge(into.branchMisses, s.branchMisses);
+        merge(into.stalledCycles, s.stalledCycles);
+    };
+    auto empty = [](const string& name, int package) {
+        CpuCounterStats s;
+        s.name = name;
+        s.package = package;
+        s.cacheMisses = s.branches = s.branchMisses = s.stalledCycles = 0.0;
+        return s;
+    };
+
+    map<int, CpuCounterStats> sockets;
+    CpuCounterStats all = empty("All", 0);
+    for (const auto& s : cpus) {
+        auto it = sockets.find(s.package);
+        if (it == sockets.end()) it = sockets.insert({ s.package, empty("Socket " + to_string(s.package), s.package) }).first;
+        add(it->second, s);
+        add(all, s);
+    }
+
+    vector<CpuCounterStats> out;
+    for (const auto& kv : sockets) out.push_back(kv.second);
+    if (out.size() > 1) out.push_back(all);
+    return out;
+}
@@ -0,0 +1,489 @@
+#include "include\DirectoryScanner.h"
+#include "include\Probe.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+namespace {
+
+    // ----------------- Platform layer -----------------
+
+    struct DirStat {
+        bool ok = false;
+        int64_t mtime = 0;      // ns (Linux) / 100ns FILETIME ticks (Windows); only compared
+        uint64_t dev = 0;       // file system id (0 on Windows, reparse points are skipped instead)
+    };
+
+    struct Listing {
+        bool ok = false;
+        uint64_t bytes = 0;     // files directly inside
+        uint64_t files = 0;
+        vector<string> subdirs; // names
+    };
+
+#ifdef _WIN32
+
+    const char SEP = '\\';
+
+    wstring widen(const string& s)
+    {
+        int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
+        if (len <= 1) return L"";
+        wstring out(len - 1, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, &out[0], len);
+        return out;
+    }
+
+    string narrow(const wchar_t* w)
+    {
+        int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+        if (len <= 1) return "";
+        string out(len - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, w, -1, &out[0], len, nullptr, nullptr);
+        return out;
+    }
+
+    DirStat stat_dir(const string& path)
+    {
+        DirStat st;
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(widen(path).c_str(), GetFileExInfoStandard, &data)) return st;
+        if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) return st;
+
+        st.ok = true;
+        st.mtime = (static_cast<int64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        return st;
+    }
+
+    Listing list_dir(const string& path)
+    {
+        Listing l;
+        string pattern = path;
+        if (pattern.empty() || (pattern.back() != '\\' && pattern.back() != '/')) pattern += SEP;
+        pattern += '*';
+
+        WIN32_FIND_DATAW fd;
+        HANDLE h = FindFirstFileExW(widen(pattern).c_str(), FindExInfoBasic, &fd,
+            FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        if (h == INVALID_HANDLE_VALUE) return l;
+
+        l.ok = true;
+        do {
+            const wchar_t* name = fd.cFileName;
+            if (name[0] == L'.' && (name[1] == 0 || (name[1] == L'.' && name[2] == 0))) continue;
+
+            // Junctions, mount points, symlinks: not followed, not counted
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                l.subdirs.push_back(narrow(name));
+            }
+            else {
+                l.bytes += (static_cast<uint64_t>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+                l.files++;
+            }
+        } while (FindNextFileW(h, &fd));
+
+        FindClose(h);
+        return l;
+    }
+
+#else
+
+    const char SEP = '/';
+
+    struct linux_dirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+
+    DirStat stat_dir(const string& path)
+    {
+        DirStat st;
+        struct statx sx;
+        if (statx(AT_FDCWD, path.c_str(), AT_STATX_DONT_SYNC, STATX_TYPE | STATX_MTIME, &sx) != 0) return st;
+        if (!S_ISDIR(sx.stx_mode)) return st;
+
+        st.ok = true;
+        st.mtime = static_cast<int64_t>(sx.stx_mtime.tv_sec) * 1000000000LL + sx.stx_mtime.tv_nsec;
+        st.dev = (static_cast<uint64_t>(sx.stx_dev_major) << 32) | sx.stx_dev_minor;
+        return st;
+    }
+
+    Listing list_dir(const string& path)
+    {
+        Listing l;
+        int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return l;
+
+        l.ok = true;
+        alignas(8) char buf[64 * 1024];
+        for (;;) {
+            long n = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+            if (n <= 0) break;
+
+            for (long off = 0; off < n;) {
+                auto* d = reinterpret_cast<linux_dirent64*>(buf + off);
+                off += d->d_reclen;
+
+                const char* name = d->d_name;
+                if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) continue;
+
+                unsigned char type = d->d_type;
+                if (type == DT_DIR) {
+                    l.subdirs.push_back(name);
+                    continue;
+                }
+                if (type != DT_REG && type != DT_UNKNOWN) continue;   // symlinks, sockets, devices
+
+                struct statx sx;
+                if (statx(fd, name, AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC, STATX_TYPE | STATX_BLOCKS, &sx) != 0) continue;
+                if (S_ISDIR(sx.stx_mode)) {
+                    l.subdirs.push_back(name);
+                }
+                else if (S_ISREG(sx.stx_mode)) {
+                    l.bytes += static_cast<uint64_t>(sx.stx_blocks) * 512;
+                    l.files++;
+                }
+            }
+        }
+
+        close(fd);
+        return l;
+    }
+
+#endif
+
+    string join(const string& dir, const string& name)
+    {
+        if (!dir.empty() && (dir.back() == SEP || dir.back() == '/')) return dir + name;
+        return dir + SEP + name;
+    }
+
+    bool is_under(const string& path, const string& root)
+    {
+        if (path.compare(0, root.size(), root) != 0) return false;
+        return path.size() == root.size() || path[root.size()] == SEP || root.back() == SEP;
+    }
+
+    // ----------------- Cache -----------------
+
+    struct CacheEntry {
+        int64_t mtime = 0;
+        uint64_t bytes = 0;
+        uint64_t files = 0;
+        vector<string> subdirs;
+    };
+
+    map<string, CacheEntry> load_cache(const string& path)
+    {
+        map<string, CacheEntry> cache;
+        ifstream in(path, ios::binary);
+        if (!in) return cache;
+
+        try {
+            json doc = json::parse(in);
+            json dirs = doc.value("dirs", json::object());
+            for (auto& item : dirs.items()) {
+                const json& j = item.value();
+                CacheEntry e;
+                e.mtime = j.value("m", (int64_t)0);
+                e.bytes = j.value("b", (uint64_t)0);
+                e.files = j.value("f", (uint64_t)0);
+                e.subdirs = j.value("d", vector<string>());
+                cache[item.key()] = e;
+            }
+        }
+        catch (...) {
+            cache.clear();
+        }
+        return cache;
+    }
+
+    void save_cache(const string& path, const map<string, CacheEntry>& cache)
+    {
+        json dirs = json::object();
+        for (const auto& kv : cache) {
+            dirs[kv.first] = { { "m", kv.second.mtime }, { "b", kv.second.bytes },
+                { "f", kv.second.files }, { "d", kv.second.subdirs } };
+        }
+
+        error_code ec;
+        filesystem::create_directories(filesystem::path(path).parent_path(), ec);
+        ofstream out(path, ios::binary | ios::trunc);
+        if (out) out << json{ { "version", 1 }, { "dirs", dirs } }.dump(-1, ' ', false, json::error_handler_t::replace);
+    }
+
+    // ----------------- Walk state -----------------
+
+    struct RootState;
+
+    struct Node {
+        string path;
+        int depth = 0;
+        Node* parent = nullptr;
+        RootState* root = nullptr;
+        atomic<uint64_t> bytes{ 0 };
+        atomic<uint64_t> files{ 0 };
+    };
+
+    struct RootState {
+        Node* node = nullptr;
+        uint64_t dev = 0;
+        bool ok = false;
+        atomic<uint64_t> visited{ 0 };
+        atomic<uint64_t> cached{ 0 };
+    };
+
+    // Per-worker deques: owner works LIFO from the back (depth first, small
+    // working set), thieves take from the front (the oldest, usually biggest, subtrees)
+    class WorkStealingQueue {
+    private:
+        struct Lane {
+            mutex m;
+            deque<Node*> tasks;
+        };
+        vector<unique_ptr<Lane>> lanes;
+        atomic<long> pending{ 0 };
+
+        // Idle workers sleep here until something is pushed or everything is done
+        mutex idleMutex;
+        condition_variable wake;
+        uint64_t pushes = 0;
+
+    public:
+        explicit WorkStealingQueue(size_t workers)
+        {
+            for (size_t i = 0; i < workers; ++i) lanes.emplace_back(new Lane());
+        }
+
+        void push(size_t worker, Node* task)
+        {
+            pending++;
+            {
+                lock_guard<mutex> lock(lanes[worker]->m);
+                lanes[worker]->tasks.push_back(task);
+            }
+            {
+                lock_guard<mutex> lock(idleMutex);
+                pushes++;
+            }
+            wake.notify_one();
+        }
+
+        bool pop(size_t worker, Node*& task)
+        {
+            {
+                Lane& own = *lanes[worker];
+                lock_guard<mutex> lock(own.m);
+                if (!own.tasks.empty()) {
+                    task = own.tasks.back();
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (size_t i = 1; i < lanes.size(); ++i) {
+                Lane& victim = *lanes[(worker + i) % lanes.size()];
+                lock_guard<mutex> lock(victim.m);
+                if (!victim.tasks.empty()) {
+                    task = victim.tasks.front();
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void done()
+        {
+            if (--pending != 0) return;
+            { lock_guard<mutex> lock(idleMutex); }
+            wake.notify_all();
+        }
+
+        // Blocks until this worker has a task (true) or every task is done (false)
+        bool next(size_t worker, Node*& task)
+        {
+            for (;;) {
+                uint64_t seen;
+                {
+                    lock_guard<mutex> lock(idleMutex);
+                    seen = pushes;
+                }
+                if (pop(worker, task)) return true;
+
+                unique_lock<mutex> lock(idleMutex);
+                wake.wait(lock, [&]() { return pushes != seen || pending.load() == 0; });
+                if (pending.load() == 0) return false;
+            }
+        }
+    };
+}
+
+// ----------------- Public API -----------------
+
+string DirectoryScanner::homeDirectory()
+{
+#ifdef _WIN32
+    const char* home = getenv("USERPROFILE");
+    return home ? home : "C:\\Users";
+#else
+    const char* home = getenv("HOME");
+    return home ? home : "/";
+#endif
+}
+
+string DirectoryScanner::defaultCachePath()
+{
+#ifdef _WIN32
+    // Per user: the sizes describe this user's folders
+    const char* local = getenv("LOCALAPPDATA");
+    if (local && *local) return string(local) + "\\BinaryFetch\\DirSizeCache.json";
+    return homeDirectory() + "\\AppData\\Local\\BinaryFetch\\DirSizeCache.json";
+#else
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) return string(xdg) + "/binaryfetch/dir_size_cache.json";
+    return homeDirectory() + "/.cache/binaryfetch/dir_size_cache.json";
+#endif
+}
+
+vector<DirScanResult> DirectoryScanner::scan(const DirScanConfig& config)
+{
+    Probe::unrouted("DirectoryScanner (directory walk)");
+    string cachePath = config.cachePath.empty() ? defaultCachePath() : config.cachePath;
+    const map<string, CacheEntry> oldCache = config.useCache ? load_cache(cachePath) : map<string, CacheEntry>();
+    map<string, CacheEntry> newCache;
+    mutex cacheMutex;
+
+    deque<Node> nodes;
+    mutex nodesMutex;
+    deque<RootState> roots;
+
+    auto make_node = [&](const string& path, int depth, Node* parent, RootState* root) -> Node* {
+        lock_guard<mutex> lock(nodesMutex);
+        nodes.emplace_back();
+        Node* n = &nodes.back();
+        n->path = path;
+        n->depth = depth;
+        n->parent = parent;
+        n->root = root;
+        return n;
+    };
+
+    size_t workers = config.threads > 0 ? static_cast<size_t>(config.threads) : max(1u, thread::hardware_concurrency());
+    WorkStealingQueue queue(workers);
+
+    for (const auto& path : config.roots) {
+        roots.emplace_back();
+        RootState& root = roots.back();
+        DirStat st = stat_dir(path);
+        root.ok = st.ok;
+        root.dev = st.dev;
+        root.node = make_node(path, 0, nullptr, &root);
+        if (root.ok) queue.push(0, root.node);
+    }
+
+    auto process = [&](size_t worker, Node* n) {
+        DirStat st = stat_dir(n->path);
+        if (!st.ok || st.dev != n->root->dev) return;   // gone, or another mount
+        n->root->visited++;
+
+        CacheEntry entry;
+        auto hit = oldCache.find(n->path);
+        if (hit != oldCache.end() && hit->second.mtime == st.mtime) {
+            entry = hit->second;
+            n->root->cached++;
+        }
+        else {
+            Listing l = list_dir(n->path);
+            if (!l.ok) return;
+            entry.mtime = st.mtime;
+            entry.bytes = l.bytes;
+            entry.files = l.files;
+            entry.subdirs = move(l.subdirs);
+        }
+
+        for (Node* p = n; p; p = p->parent) {
+            p->bytes += entry.bytes;
+            p->files += entry.files;
+        }
+
+        for (const auto& name : entry.subdirs) {
+            queue.push(worker, make_node(join(n->path, name), n->depth + 1, n, n->root));
+        }
+
+        if (config.useCache) {
+            lock_guard<mutex> lock(cacheMutex);
+            newCache[n->path] = move(entry);
+        }
+    };
+
+    vector<thread> pool;
+    for (size_t w = 0; w < workers; ++w) {
+        pool.emplace_back([&, w]() {
+            Node* task = nullptr;
+            while (queue.next(w, task)) {
+                process(w, task);
+                queue.done();
+            }
+            });
+    }
+    for (auto& t : pool) t.join();
+
+    if (config.useCache) {
+        // Entries outside this run's roots survive (other configs, other runs)
+        for (const auto& kv : oldCache) {
+            if (newCache.count(kv.first)) continue;
+            bool scanned = false;
+            for (const auto& root : config.roots) scanned = scanned || is_under(kv.first, root);
+            if (!scanned) newCache[kv.first] = kv.second;
+        }
+        save_cache(cachePath, newCache);
+    }
+
+    vector<DirScanResult> results;
+    for (auto& root : roots) {
+        DirScanResult r;
+        r.ok = root.ok;
+        r.root = { root.node->path, root.node->bytes.load(), root.node->files.load() };
+        r.directories = root.visited.load();
+        r.cachedDirectories = root.cached.load();
+
+        for (const auto& n : nodes) {
+            if (n.root != &root || n.depth < 1 || n.depth > config.depth) continue;
+            r.largest.push_back({ n.path, n.bytes.load(), n.files.load() });
+        }
+        sort(r.largest.begin(), r.largest.end(),
+            [](const DirSizeEntry& a, const DirSizeEntry& b) { return a.bytes > b.bytes; });
+        if (r.largest.size() > static_cast<size_t>(max(0, config.topN))) r.largest.resize(max(0, config.topN));
+
+        results.push_back(r);
+    }
+    return results;
+}
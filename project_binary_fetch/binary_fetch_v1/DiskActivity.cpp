@@ -0,0 +1,268 @@
+#include "include\DiskActivity.h"
+#include "include\Probe.h"
+#include "include\PseudoFileReader.h"
+
+#include <map>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <Pdh.h>
+#include <pdhmsg.h>
+#pragma comment(lib, "pdh.lib")
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+// ----------------- Backend state -----------------
+
+#ifdef _WIN32
+
+namespace {
+    const wchar_t* const COUNTER_PATHS[] = {
+        L"\\PhysicalDisk(*)\\Disk Read Bytes/sec",
+        L"\\PhysicalDisk(*)\\Disk Write Bytes/sec",
+        L"\\PhysicalDisk(*)\\Disk Reads/sec",
+        L"\\PhysicalDisk(*)\\Disk Writes/sec",
+        L"\\PhysicalDisk(*)\\Avg. Disk sec/Transfer",
+        L"\\PhysicalDisk(*)\\Avg. Disk Queue Length",
+        L"\\PhysicalDisk(*)\\% Idle Time"
+    };
+    const int COUNTER_COUNT = sizeof(COUNTER_PATHS) / sizeof(COUNTER_PATHS[0]);
+
+    string narrow(const wchar_t* w)
+    {
+        int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+        if (len <= 1) return "";
+        string out(len - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, w, -1, &out[0], len, nullptr, nullptr);
+        return out;
+    }
+
+    // Instance name -> value for one wildcard counter
+    bool read_array(PDH_HCOUNTER counter, map<string, double>& out)
+    {
+        DWORD size = 0, count = 0;
+        if (PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &size, &count, nullptr) != PDH_MORE_DATA) return false;
+
+        vector<BYTE> buf(size);
+        auto* items = reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(buf.data());
+        if (PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &size, &count, items) != ERROR_SUCCESS) return false;
+
+        for (DWORD i = 0; i < count; ++i) {
+            DWORD status = items[i].FmtValue.CStatus;
+            if (status != PDH_CSTATUS_VALID_DATA && status != PDH_CSTATUS_NEW_DATA) continue;
+            out[narrow(items[i].szName)] = items[i].FmtValue.doubleValue;
+        }
+        return true;
+    }
+}
+
+struct DiskActivity::Impl {
+    PDH_HQUERY query = nullptr;
+    PDH_HCOUNTER counters[COUNTER_COUNT] = {};
+    bool ready = false;
+
+    Impl()
+    {
+        if (PdhOpenQuery(nullptr, 0, &query) != ERROR_SUCCESS) {
+            query = nullptr;
+            return;
+        }
+        ready = true;
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            if (PdhAddEnglishCounterW(query, COUNTER_PATHS[i], 0, &counters[i]) != ERROR_SUCCESS) ready = false;
+        }
+    }
+
+    ~Impl()
+    {
+        if (query) PdhCloseQuery(query);
+    }
+};
+
+#else
+
+namespace {
+    // Steady clock in ns, recorded with the counters: a replay divides the
+    // recorded deltas by the recorded window, not by however long it took
+    int64_t window_ns()
+    {
+        string ns = Probe::text("clock:disk-activity", []() {
+            return to_string(chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count());
+        });
+        return strtoll(ns.c_str(), nullptr, 10);
+    }
+}
+
+struct DiskActivity::Impl {
+    PseudoFileReader reader;
+    int diskstats = -1;
+    string baseline;
+    int64_t baselineNs = 0;
+    vector<string> devices;     // whole disks worth reporting
+
+    Impl()
+    {
+        diskstats = reader.add("/proc/diskstats", 8192);
+
+        // /sys/block lists whole disks only (partitions live underneath)
+        for (const auto& name : Probe::dir("/sys/block")) {
+            if (name.compare(0, 4, "loop") == 0 || name.compare(0, 3, "ram") == 0 ||
+                name.compare(0, 4, "zram") == 0) continue;
+            devices.push_back(name);
+        }
+    }
+};
+
+#endif
+
+// ----------------- Sampling -----------------
+
+DiskActivity::DiskActivity() : impl(new Impl()) {}
+
+DiskActivity::~DiskActivity() = default;
+
+void DiskActivity::begin()
+{
+#ifdef _WIN32
+    if (impl->ready) PdhCollectQueryData(impl->query);
+#else
+    impl->reader.refresh();
+    impl->baseline = string(impl->reader.text(impl->diskstats));
+    impl->baselineNs = window_ns();
+#endif
+    started = chrono::steady_clock::now();
+    begun = true;
+}
+
+vector<DiskActivityStats> DiskActivity::sample(int intervalMs)
+{
+    if (!begun) begin();
+
+    auto due = started + chrono::milliseconds(intervalMs);
+    if (chrono::steady_clock::now() < due && !Probe::replaying()) this_thread::sleep_until(due);
+
+#ifdef _WIN32
+    // One snapshot value for the whole table so --record / --replay keep it together
+    string encoded = Probe::text("pdh:\\PhysicalDisk(*)", [&]() -> string {
+        if (!impl->ready || PdhCollectQueryData(impl->query) != ERROR_SUCCESS) return "";
+
+        map<string, double> values[COUNTER_COUNT];
+        for (int i = 0; i < COUNTER_COUNT; ++i) read_array(impl->counters[i], values[i]);
+
+        json rows = json::array();
+        for (const auto& kv : values[0]) {
+            if (kv.first == "_Total") continue;
+            auto get = [&](int i) { auto it = values[i].find(kv.first); return it == values[i].end() ? 0.0 : it->second; };
+            rows.push_back({
+                { "device", kv.first },
+                { "read_bps", get(0) }, { "write_bps", get(1) },
+                { "read_iops", get(2) }, { "write_iops", get(3) },
+                { "latency_s", get(4) }, { "queue", get(5) }, { "idle", get(6) }
+            });
+        }
+        return rows.dump();
+    });
+
+    vector<DiskActivityStats> stats;
+    try {
+        if (encoded.empty()) return stats;
+        for (const auto& row : json::parse(encoded)) {
+            DiskActivityStats s;
+            s.device = row.value("device", "");
+            s.readBytesPerSec = row.value("read_bps", 0.0);
+            s.writeBytesPerSec = row.value("write_bps", 0.0);
+            s.readIops = row.value("read_iops", 0.0);
+            s.writeIops = row.value("write_iops", 0.0);
+            s.avgLatencyMs = row.value("latency_s", 0.0) * 1000.0;
+            s.queueDepth = row.value("queue", 0.0);
+            s.utilization = min(100.0, max(0.0, 100.0 - row.value("idle", 100.0)));
+            stats.push_back(s);
+        }
+    }
+    catch (...) {
+        stats.clear();
+    }
+    return stats;
+#else
+    impl->reader.refresh();
+    double seconds = (window_ns() - impl->baselineNs) / 1e9;
+    return diff(impl->baseline, impl->reader.text(impl->diskstats), seconds, impl->devices);
+#endif
+}
+
+// ----------------- /proc/diskstats -----------------
+
+vector<DiskActivityStats> DiskActivity::diff(string_view before, string_view after, double seconds,
+    const vector<string>& devices)
+{
+    //   major minor name  reads merged sectors ms_reading  writes merged sectors ms_writing
+    //                     in_flight ms_io weighted_ms_io  [discard / flush fields...]
+    auto parse = [](string_view text) {
+        map<string, vector<long long>> rows;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == string_view::npos) end = text.size();
+            string_view line = text.substr(pos, end - pos);
+            pos = end + 1;
+
+            // Counters start at the fourth token, after major, minor and name
+            size_t tokenStart = 0;
+            string_view name;
+            int token = 0;
+            while (token < 3) {
+                size_t start = line.find_first_not_of(" \t", tokenStart);
+                if (start == string_view::npos) break;
+                size_t stop = line.find_first_of(" \t", start);
+                if (stop == string_view::npos) stop = line.size();
+                if (token == 2) name = line.substr(start, stop - start);
+                tokenStart = stop;
+                token++;
+            }
+            if (token < 3) continue;
+
+            vector<long long> fields;
+            PseudoFileReader::parseNumbers(line.substr(tokenStart), fields);
+            if (fields.size() >= 11) rows[string(name)] = fields;
+        }
+        return rows;
+    };
+
+    vector<DiskActivityStats> stats;
+    if (seconds <= 0.0) return stats;
+
+    auto first = parse(before);
+    auto second = parse(after);
+    double ms = seconds * 1000.0;
+
+    for (const auto& name : devices) {
+        auto b = first.find(name);
+        auto a = second.find(name);
+        if (b == first.end() || a == second.end()) continue;
+
+        // Counters only go up; a wrap or device reset shows as a negative delta
+        auto d = [&](size_t i) { long long v = a->second[i] - b->second[i]; return v < 0 ? 0.0 : static_cast<double>(v); };
+        double reads = d(0), sectorsRead = d(2), msReading = d(3);
+        double writes = d(4), sectorsWritten = d(6), msWriting = d(7);
+        double msIo = d(9), weightedMs = d(10);
+
+        DiskActivityStats s;
+        s.device = name;
+        s.readBytesPerSec = sectorsRead * 512.0 / seconds;
+        s.writeBytesPerSec = sectorsWritten * 512.0 / seconds;
+        s.readIops = reads / seconds;
+        s.writeIops = writes / seconds;
+        s.avgLatencyMs = (reads + writes) > 0 ? (msReading + msWriting) / (reads + writes) : 0.0;
+        s.queueDepth = weightedMs / ms;
+        s.utilization = min(100.0, msIo / ms * 100.0);
+        stats.push_back(s);
+    }
+    return stats;
+}
@@ -0,0 +1,536 @@
+#include "include\DiskBenchmark.h"
+#include "include\IoRing.h"
+
+#include <chrono>
+#include <thread>
+#include <random>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#endif
+
+using namespace std;
+
+namespace {
+    const size_t ALIGN = 4096;                  // satisfies NO_BUFFERING / O_DIRECT on 4Kn and 512e drives
+    const uint64_t MIB = 1024ull * 1024ull;
+    // How long past a test's end a request may stay outstanding before the test is failed
+    const chrono::milliseconds STUCK_GRACE(5000);
+
+    char* alloc_aligned(size_t size)
+    {
+#ifdef _WIN32
+        return static_cast<char*>(_aligned_malloc(size, ALIGN));
+#else
+        void* p = nullptr;
+        return posix_memalign(&p, ALIGN, size) == 0 ? static_cast<char*>(p) : nullptr;
+#endif
+    }
+
+    void free_aligned(char* p)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+    // Incompressible payload so controllers with compression/dedupe can't cheat
+    void fill_random(char* buf, size_t size, mt19937_64& rng)
+    {
+        for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t v = rng();
+            memcpy(buf + i, &v, sizeof(v));
+        }
+    }
+
+    // ----------------- I/O engines -----------------
+
+    struct Completion {
+        int slot;
+        bool ok;
+    };
+
+    class IOEngine {
+    public:
+        virtual ~IOEngine() = default;
+        virtual bool open(const string& path) = 0;
+        virtual int maxDepth() const = 0;
+        // Queues one request; `slot` comes back in the completion
+        virtual bool submit(int slot, char* buf, size_t len, uint64_t offset, bool write) = 0;
+        // Blocks until at least one request completes; false on error or when
+        // nothing has completed by `giveUp` (outstanding requests are cancelled)
+        virtual bool reap(vector<Completion>& done, chrono::steady_clock::time_point giveUp) = 0;
+    };
+
+#ifdef _WIN32
+
+    class OverlappedEngine : public IOEngine {
+    private:
+        HANDLE file = INVALID_HANDLE_VALUE;
+        vector<OVERLAPPED> ov;
+        vector<HANDLE> events;
+        vector<bool> pending;
+
+    public:
+        explicit OverlappedEngine(int depth)
+            : ov(depth), events(depth, nullptr), pending(depth, false)
+        {
+            for (auto& e : events) e = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        }
+
+        ~OverlappedEngine() override
+        {
+            if (file != INVALID_HANDLE_VALUE) {
+                // Nothing may still be writing into the caller's buffers once we return
+                CancelIoEx(file, nullptr);
+                for (size_t i = 0; i < ov.size(); ++i) {
+                    DWORD bytes = 0;
+                    if (pending[i]) GetOverlappedResult(file, &ov[i], &bytes, TRUE);
+                }
+                CloseHandle(file);
+            }
+            for (auto& e : events) {
+                if (e) CloseHandle(e);
+            }
+        }
+
+        bool open(const string& path) override
+        {
+            file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_OVERLAPPED, nullptr);
+            return file != INVALID_HANDLE_VALUE;
+        }
+
+        int maxDepth() const override { return static_cast<int>(ov.size()); }
+
+        bool submit(int slot, char* buf, size_t len, uint64_t offset, bool write) override
+        {
+            OVERLAPPED& o = ov[slot];
+            ZeroMemory(&o, sizeof(o));
+            o.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+            o.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            o.hEvent = events[slot];
+            ResetEvent(events[slot]);
+
+            BOOL r = write ? WriteFile(file, buf, static_cast<DWORD>(len), nullptr, &o)
+                : ReadFile(file, buf, static_cast<DWORD>(len), nullptr, &o);
+            if (!r && GetLastError() != ERROR_IO_PENDING) return false;
+            pending[slot] = true;
+            return true;
+        }
+
+        bool reap(vector<Completion>& done, chrono::steady_clock::time_point giveUp) override
+        {
+            vector<HANDLE> waitOn;
+            vector<int> slots;
+            for (size_t i = 0; i < pending.size(); ++i) {
+                if (!pending[i]) continue;
+                waitOn.push_back(events[i]);
+                slots.push_back(static_cast<int>(i));
+            }
+            if (waitOn.empty()) return false;
+
+            auto left = chrono::duration_cast<chrono::milliseconds>(giveUp - chrono::steady_clock::now());
+            DWORD timeoutMs = static_cast<DWORD>(max<long long>(left.count(), 0));
+            DWORD w = WaitForMultipleObjects(static_cast<DWORD>(waitOn.size()), waitOn.data(), FALSE, timeoutMs);
+            if (w == WAIT_TIMEOUT) {
+                // A request that hangs (stalled USB bridge, dying disk) must not hang the fetch
+                CancelIoEx(file, nullptr);
+                return false;
+            }
+            if (w < WAIT_OBJECT_0 || w >= WAIT_OBJECT_0 + waitOn.size()) return false;
+
+            // The signalled request plus any later ones that finished meanwhile
+            for (size_t k = w - WAIT_OBJECT_0; k < waitOn.size(); ++k) {
+                if (k != w - WAIT_OBJECT_0 && WaitForSingleObject(waitOn[k], 0) != WAIT_OBJECT_0) continue;
+                int s = slots[k];
+                DWORD bytes = 0;
+                BOOL r = GetOverlappedResult(file, &ov[s], &bytes, FALSE);
+                pending[s] = false;
+                done.push_back({ s, r && bytes > 0 });
+            }
+            return true;
+        }
+    };
+
+#else
+
+    // pread/pwrite: one request at a time, callers scale depth with more workers
+    class SyncEngine : public IOEngine {
+    private:
+        int fd = -1;
+        vector<Completion> ready;
+
+    public:
+        ~SyncEngine() override { if (fd >= 0) ::close(fd); }
+
+        bool open(const string& path) override
+        {
+            fd = ::open(path.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC);
+            return fd >= 0;
+        }
+
+        int maxDepth() const override { return 1; }
+
+        bool submit(int slot, char* buf, size_t len, uint64_t offset, bool write) override
+        {
+            ssize_t n;
+            do {
+                n = write ? pwrite(fd, buf, len, static_cast<off_t>(offset))
+                    : pread(fd, buf, len, static_cast<off_t>(offset));
+            } while (n < 0 && errno == EINTR);
+            ready.push_back({ slot, n == static_cast<ssize_t>(len) });
+            return true;
+        }
+
+        bool reap(vector<Completion>& done, chrono::steady_clock::time_point) override
+        {
+            if (ready.empty()) return false;
+            done.insert(done.end(), ready.begin(), ready.end());
+            ready.clear();
+            return true;
+        }
+    };
+
+    class UringEngine : public IOEngine {
+    private:
+        IoRing ring;
+        int depth;
+        int fd = -1;
+
+    public:
+        explicit UringEngine(int depth) : ring(static_cast<unsigned>(max(depth, 1))), depth(max(depth, 1)) {}
+
+        ~UringEngine() override
+        {
+            if (fd >= 0) ::close(fd);
+        }
+
+        bool usable() const { return ring.ready(); }
+
+        bool open(const string& path) override
+        {
+            fd = ::open(path.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC);
+            return fd >= 0;
+        }
+
+        int maxDepth() const override { return depth; }
+
+        bool submit(int slot, char* buf, size_t len, uint64_t offset, bool write) override
+        {
+            bool queued = write ? ring.write(fd, buf, static_cast<unsigned>(len), offset, static_cast<uint64_t>(slot))
+                : ring.read(fd, buf, static_cast<unsigned>(len), offset, static_cast<uint64_t>(slot));
+            return queued && ring.submit() >= 1;
+        }
+
+        // No give-up here: the ring can't be torn down while the kernel still owns
+        // the buffers, and the block layer's own command timeout bounds the wait
+        bool reap(vector<Completion>& done, chrono::steady_clock::time_point) override
+        {
+            uint64_t tag = 0;
+            int res = 0;
+            if (!ring.wait(tag, res)) return false;
+            do {
+                done.push_back({ static_cast<int>(tag), res > 0 });
+            } while (ring.peek(tag, res));
+            return true;
+        }
+    };
+
+#endif
+
+    unique_ptr<IOEngine> make_engine(int depth)
+    {
+#ifdef _WIN32
+        return unique_ptr<IOEngine>(new OverlappedEngine(min(depth, MAXIMUM_WAIT_OBJECTS)));
+#else
+        unique_ptr<UringEngine> uring(new UringEngine(depth));
+        if (uring->usable()) return unique_ptr<IOEngine>(uring.release());
+        return unique_ptr<IOEngine>(new SyncEngine());
+#endif
+    }
+
+#ifndef _WIN32
+    // Compiled in is not the same as usable: without BINARYFETCH_IO_URING, on
+    // old kernels, under seccomp filters or kernel.io_uring_disabled the ring
+    // is refused and make_engine() hands out the synchronous engine
+    bool uring_usable()
+    {
+        static const bool usable = IoRing(1).ready();
+        return usable;
+    }
+#endif
+
+    // Can one worker keep several requests in flight?
+    bool engine_queues()
+    {
+#ifdef _WIN32
+        return true;
+#else
+        return uring_usable();
+#endif
+    }
+
+    // ----------------- Test file -----------------
+
+    bool prepare_file(const string& path, uint64_t size)
+    {
+        const size_t chunk = static_cast<size_t>(MIB);
+        char* buf = alloc_aligned(chunk);
+        if (!buf) return false;
+        mt19937_64 rng(0xB1A2F37Cull);
+        fill_random(buf, chunk, rng);
+
+        bool ok = true;
+#ifdef _WIN32
+        HANDLE h = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+            FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH, nullptr);
+        if (h == INVALID_HANDLE_VALUE) ok = false;
+        for (uint64_t done = 0; ok && done < size; done += chunk) {
+            DWORD written = 0;
+            ok = WriteFile(h, buf, static_cast<DWORD>(chunk), &written, nullptr) && written == chunk;
+        }
+        if (h != INVALID_HANDLE_VALUE) {
+            FlushFileBuffers(h);
+            CloseHandle(h);
+        }
+#else
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT | O_CLOEXEC, 0600);
+        if (fd < 0) ok = false;
+        for (uint64_t done = 0; ok && done < size; done += chunk) {
+            ok = pwrite(fd, buf, chunk, static_cast<off_t>(done)) == static_cast<ssize_t>(chunk);
+        }
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+#endif
+        free_aligned(buf);
+        return ok;
+    }
+
+    void remove_file(const string& path)
+    {
+#ifdef _WIN32
+        DeleteFileA(path.c_str());
+#else
+        unlink(path.c_str());
+#endif
+    }
+
+    // ----------------- Workers -----------------
+
+    struct WorkerResult {
+        uint64_t ops = 0;
+        uint64_t bytes = 0;
+        vector<float> latency_us;
+        bool ok = true;
+    };
+
+    void run_worker(const string& path, const DiskBenchTest& test, uint64_t regionStart, uint64_t regionSize,
+        int depth, chrono::steady_clock::time_point deadline, uint64_t seed, WorkerResult& out)
+    {
+        uint64_t blocks = regionSize / test.blockSize;
+        unique_ptr<IOEngine> engine = make_engine(depth);
+        if (blocks == 0 || !engine->open(path)) {
+            out.ok = false;
+            return;
+        }
+
+        mt19937_64 rng(seed);
+        int slots = max(1, min(depth, engine->maxDepth()));
+        vector<char*> bufs(slots, nullptr);
+        for (auto& b : bufs) {
+            b = alloc_aligned(test.blockSize);
+            if (!b) out.ok = false;
+            else fill_random(b, test.blockSize, rng);
+        }
+
+        uint64_t cursor = 0;
+        auto next_offset = [&]() {
+            uint64_t block = test.random ? rng() % blocks : cursor++ % blocks;
+            return regionStart + block * test.blockSize;
+        };
+        auto next_is_write = [&]() { return static_cast<int>(rng() % 100) >= test.readPercent; };
+
+        vector<chrono::steady_clock::time_point> started(slots);
+        int inFlight = 0;
+        for (int s = 0; s < slots && out.ok; ++s) {
+            started[s] = chrono::steady_clock::now();
+            if (engine->submit(s, bufs[s], test.blockSize, next_offset(), next_is_write())) inFlight++;
+            else out.ok = false;
+        }
+
+        vector<Completion> done;
+        out.latency_us.reserve(4096);
+        auto giveUp = deadline + STUCK_GRACE;
+        while (inFlight > 0) {
+            done.clear();
+            if (!engine->reap(done, giveUp)) {
+                out.ok = false;
+                break;
+            }
+            auto now = chrono::steady_clock::now();
+            for (const auto& c : done) {
+                inFlight--;
+                if (!c.ok) {
+                    out.ok = false;
+                    continue;
+                }
+                out.ops++;
+                out.bytes += test.blockSize;
+                out.latency_us.push_back(chrono::duration<float, micro>(now - started[c.slot]).count());
+
+                if (out.ok && now < deadline) {
+                    started[c.slot] = now;
+                    if (engine->submit(c.slot, bufs[c.slot], test.blockSize, next_offset(), next_is_write())) inFlight++;
+                    else out.ok = false;
+                }
+            }
+        }
+
+        // Engine first: it must not complete into freed buffers
+        engine.reset();
+        for (auto b : bufs) {
+            if (b) free_aligned(b);
+        }
+    }
+
+    double percentile(vector<float>& values, double p)
+    {
+        if (values.empty()) return 0.0;
+        size_t k = static_cast<size_t>(p * (values.size() - 1));
+        nth_element(values.begin(), values.begin() + k, values.end());
+        return values[k];
+    }
+}
+
+// ----------------- Public API -----------------
+
+vector<DiskBenchTest> DiskBenchmark::standardTests()
+{
+    return {
+        { "SEQ1M Q8T1 Read",   1024 * 1024, 8,  false, 100 },
+        { "SEQ1M Q8T1 Write",  1024 * 1024, 8,  false, 0 },
+        { "RND4K Q32T1 Read",  4096,        32, true,  100 },
+        { "RND4K Q32T1 Write", 4096,        32, true,  0 },
+        { "RND4K Q1T1 Read",   4096,        1,  true,  100 },
+        { "RND4K Q1T1 Write",  4096,        1,  true,  0 },
+        { "MIX4K Q32T1 70/30", 4096,        32, true,  70 },
+    };
+}
+
+DiskBenchConfig DiskBenchmark::quickConfig()
+{
+    DiskBenchConfig config;
+    config.tests = {
+        { "SEQ1M Q8T1 Read",  1024 * 1024, 8, false, 100 },
+        { "SEQ1M Q8T1 Write", 1024 * 1024, 8, false, 0 },
+    };
+    config.durationMs = 500;
+    config.threads = 1;
+    config.fileSizeMB = 64;
+    return config;
+}
+
+string DiskBenchmark::engineName()
+{
+#ifdef _WIN32
+    return "overlapped";
+#else
+    return uring_usable() ? "io_uring" : "psync";
+#endif
+}
+
+vector<DiskBenchResult> DiskBenchmark::run(const string& directory, const DiskBenchConfig& config)
+{
+    vector<DiskBenchResult> results;
+
+    string path = directory;
+    if (!path.empty() && path.back() != '\\' && path.back() != '/') {
+#ifdef _WIN32
+        path += '\\';
+#else
+        path += '/';
+#endif
+    }
+    path += "binaryfetch_bench.tmp";
+
+    uint64_t fileSize = max<uint64_t>(config.fileSizeMB, 16) * MIB;
+    if (!prepare_file(path, fileSize)) {
+        remove_file(path);
+        return results;
+    }
+
+    uint64_t seed = static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+    for (const auto& test : config.tests) {
+        DiskBenchResult result;
+        result.name = test.name;
+        result.readPercent = test.readPercent;
+        result.random = test.random;
+        if (test.blockSize == 0 || test.blockSize % ALIGN != 0 || test.queueDepth < 1) {
+            results.push_back(result);
+            continue;
+        }
+
+        // Without a queueing engine, depth becomes extra synchronous workers
+        int threads = max(1, config.threads);
+        int depth = test.queueDepth;
+        int workers = threads;
+        if (!engine_queues()) {
+            workers = threads * depth;
+            depth = 1;
+        }
+
+        // Sequential workers each stream through their own slice; random ones roam the whole file
+        uint64_t slice = (fileSize / workers) / test.blockSize * test.blockSize;
+        vector<WorkerResult> parts(workers);
+        vector<thread> pool;
+
+        auto start = chrono::steady_clock::now();
+        auto deadline = start + chrono::milliseconds(max(config.durationMs, 1));
+        for (int w = 0; w < workers; ++w) {
+            uint64_t regionStart = test.random ? 0 : slice * w;
+            uint64_t regionSize = test.random ? fileSize : slice;
+            pool.emplace_back(run_worker, cref(path), cref(test), regionStart, regionSize,
+                depth, deadline, seed + w * 7919ull, ref(parts[w]));
+        }
+        for (auto& t : pool) t.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        seed += 104729ull;
+
+        vector<float> latencies;
+        uint64_t bytes = 0;
+        result.ok = true;
+        for (auto& part : parts) {
+            result.ok = result.ok && part.ok;
+            result.ops += part.ops;
+            bytes += part.bytes;
+            latencies.insert(latencies.end(), part.latency_us.begin(), part.latency_us.end());
+        }
+        if (result.ops == 0 || seconds <= 0.0) result.ok = false;
+
+        if (result.ok) {
+            result.mbps = bytes / 1e6 / seconds;           // decimal, like the label and CrystalDiskMark
+            result.iops = result.ops / seconds;
+            result.p50_us = percentile(latencies, 0.50);
+            result.p99_us = percentile(latencies, 0.99);
+        }
+        results.push_back(result);
+    }
+
+    remove_file(path);
+    return results;
+}
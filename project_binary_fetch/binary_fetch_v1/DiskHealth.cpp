@@ -0,0 +1,383 @@
+#include "include\DiskHealth.h"
+#include "include\Probe.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/nvme_ioctl.h>
+#include <scsi/sg.h>
+#endif
+
+using namespace std;
+
+// ----------------- Parsers -----------------
+
+namespace {
+    uint64_t le(const unsigned char* p, int bytes)
+    {
+        uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+
+    // NVMe 128-bit counters: the low half, saturated if the high half is set
+    uint64_t le128(const unsigned char* p)
+    {
+        return le(p + 8, 8) ? UINT64_MAX : le(p, 8);
+    }
+
+    string trim(const string& s)
+    {
+        size_t first = s.find_first_not_of(" \t\r\n");
+        if (first == string::npos) return "";
+        size_t last = s.find_last_not_of(" \t\r\n");
+        return s.substr(first, last - first + 1);
+    }
+}
+
+bool DiskHealth::parseNvmeHealthLog(const unsigned char* page, size_t size, DiskHealthData& out)
+{
+    // Everything we read lives in the first 232 bytes of the 512-byte page
+    if (!page || size < 232) return false;
+
+    // Some USB bridges answer an unsupported query with a zeroed page
+    bool any = false;
+    for (size_t i = 0; i < 232 && !any; ++i) any = page[i] != 0;
+    if (!any) return false;
+
+    out.critical_warning = page[0];
+    uint64_t kelvin = le(page + 1, 2);
+    out.temperature_c = kelvin ? static_cast<int>(kelvin) - 273 : -1;
+    out.available_spare = page[3];
+    out.percentage_used = page[5];
+
+    // Data units are thousands of 512-byte sectors
+    uint64_t unitsWritten = le128(page + 48);
+    out.data_written_bytes = unitsWritten > UINT64_MAX / 512000 ? UINT64_MAX : unitsWritten * 512000;
+    out.power_on_hours = le128(page + 128);
+    out.media_errors = le128(page + 160);
+
+    out.warning_temp_minutes = static_cast<uint32_t>(le(page + 192, 4));
+    out.critical_temp_minutes = static_cast<uint32_t>(le(page + 196, 4));
+
+    // Thermal management temperature 1 / 2: transition counts, then total seconds
+    out.throttle_events = static_cast<int64_t>(le(page + 216, 4) + le(page + 220, 4));
+    out.throttle_seconds = le(page + 224, 4) + le(page + 228, 4);
+
+    if (out.protocol.empty()) out.protocol = "NVMe";
+    out.valid = true;
+    return true;
+}
+
+bool DiskHealth::parseAtaSmartData(const unsigned char* data, size_t size, DiskHealthData& out)
+{
+    // 2-byte revision, then 30 attribute slots of 12 bytes:
+    //   id, flags (2), normalized current, worst, raw (6), reserved
+    if (!data || size < 2 + 30 * 12) return false;
+
+    struct Attribute {
+        bool present = false;
+        int current = 0;
+        uint64_t raw = 0;
+    };
+    Attribute attrs[256];
+
+    bool any = false;
+    for (int i = 0; i < 30; ++i) {
+        const unsigned char* a = data + 2 + i * 12;
+        if (a[0] == 0) continue;
+        Attribute& attr = attrs[a[0]];
+        attr.present = true;
+        attr.current = a[3];
+        attr.raw = le(a + 5, 6);
+        any = true;
+    }
+    if (!any) return false;
+
+    // Temperature: low byte of the raw value (the upper bytes often hold min / max)
+    if (attrs[194].present) out.temperature_c = static_cast<int>(attrs[194].raw & 0xFF);
+    else if (attrs[190].present) out.temperature_c = static_cast<int>(attrs[190].raw & 0xFF);
+
+    if (attrs[9].present) out.power_on_hours = attrs[9].raw & 0xFFFFFFFF;
+
+    // Reported uncorrectable errors, else offline uncorrectable sectors
+    if (attrs[187].present) out.media_errors = attrs[187].raw & 0xFFFFFFFF;
+    else if (attrs[198].present) out.media_errors = attrs[198].raw & 0xFFFFFFFF;
+
+    // SSD wear: the normalized value counts down from 100 as endurance is used
+    // (231 SSD life left, 233 media wearout indicator, 177 wear leveling count,
+    // 202 percent lifetime remaining)
+    for (int id : { 231, 233, 177, 202 }) {
+        if (!attrs[id].present) continue;
+        int remaining = attrs[id].current > 100 ? 100 : attrs[id].current;
+        out.percentage_used = 100 - remaining;
+        break;
+    }
+
+    if (out.protocol.empty()) out.protocol = "ATA";
+    out.valid = true;
+    return true;
+}
+
+// ----------------- Windows -----------------
+
+#ifdef _WIN32
+
+namespace {
+    string descriptor_string(const vector<BYTE>& buf, DWORD offset)
+    {
+        if (offset == 0 || offset >= buf.size()) return "";
+        string out;
+        for (size_t i = offset; i < buf.size() && buf[i] != 0; i++) out += static_cast<char>(buf[i]);
+        return trim(out);
+    }
+
+    // Model / serial / firmware; returns the bus type
+    STORAGE_BUS_TYPE read_descriptor(HANDLE h, DiskHealthData& out)
+    {
+        STORAGE_PROPERTY_QUERY q{};
+        q.PropertyId = StorageDeviceProperty;
+        q.QueryType = PropertyStandardQuery;
+
+        STORAGE_DESCRIPTOR_HEADER hdr{};
+        DWORD returned = 0;
+        if (!DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q), &hdr, sizeof(hdr), &returned, nullptr) ||
+            hdr.Size < sizeof(STORAGE_DEVICE_DESCRIPTOR)) return BusTypeUnknown;
+
+        vector<BYTE> buf(hdr.Size);
+        if (!DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q), buf.data(), (DWORD)buf.size(), &returned, nullptr)) return BusTypeUnknown;
+        buf.resize(returned);
+
+        auto* desc = reinterpret_cast<STORAGE_DEVICE_DESCRIPTOR*>(buf.data());
+        out.model = descriptor_string(buf, desc->ProductIdOffset);
+        out.serial = descriptor_string(buf, desc->SerialNumberOffset);
+        out.firmware = descriptor_string(buf, desc->ProductRevisionOffset);
+        return desc->BusType;
+    }
+
+    // SMART / Health Information log page through the storage protocol query
+    // (inbox NVMe driver, no admin rights needed)
+    vector<unsigned char> nvme_health_page(HANDLE h)
+    {
+        const DWORD pageSize = 512;
+        size_t size = offsetof(STORAGE_PROPERTY_QUERY, AdditionalParameters) + sizeof(STORAGE_PROTOCOL_SPECIFIC_DATA) + pageSize;
+        vector<BYTE> buf(size);
+
+        auto* query = reinterpret_cast<STORAGE_PROPERTY_QUERY*>(buf.data());
+        auto* protocol = reinterpret_cast<STORAGE_PROTOCOL_SPECIFIC_DATA*>(query->AdditionalParameters);
+        query->PropertyId = StorageDeviceProtocolSpecificProperty;
+        query->QueryType = PropertyStandardQuery;
+        protocol->ProtocolType = ProtocolTypeNvme;
+        protocol->DataType = NVMeDataTypeLogPage;
+        protocol->ProtocolDataRequestValue = 0x02;     // NVME_LOG_PAGE_HEALTH_INFO
+        protocol->ProtocolDataRequestSubValue = 0;
+        protocol->ProtocolDataOffset = sizeof(STORAGE_PROTOCOL_SPECIFIC_DATA);
+        protocol->ProtocolDataLength = pageSize;
+
+        DWORD returned = 0;
+        if (!DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, buf.data(), (DWORD)size, buf.data(), (DWORD)size, &returned, nullptr)) return {};
+
+        auto* desc = reinterpret_cast<STORAGE_PROTOCOL_DATA_DESCRIPTOR*>(buf.data());
+        const STORAGE_PROTOCOL_SPECIFIC_DATA& data = desc->ProtocolSpecificData;
+        size_t offset = offsetof(STORAGE_PROTOCOL_DATA_DESCRIPTOR, ProtocolSpecificData) + data.ProtocolDataOffset;
+        if (data.ProtocolDataLength < pageSize || offset + pageSize > buf.size()) return {};
+        return vector<unsigned char>(buf.begin() + offset, buf.begin() + offset + pageSize);
+    }
+
+    // SMART READ DATA through the legacy SMART IOCTL (needs a read/write handle)
+    vector<unsigned char> ata_smart_page(HANDLE h, BYTE driveNumber)
+    {
+        SENDCMDINPARAMS in{};
+        in.cBufferSize = READ_ATTRIBUTE_BUFFER_SIZE;
+        in.bDriveNumber = driveNumber;
+        in.irDriveRegs.bFeaturesReg = READ_ATTRIBUTES;
+        in.irDriveRegs.bSectorCountReg = 1;
+        in.irDriveRegs.bSectorNumberReg = 1;
+        in.irDriveRegs.bCylLowReg = SMART_CYL_LOW;
+        in.irDriveRegs.bCylHighReg = SMART_CYL_HI;
+        in.irDriveRegs.bCommandReg = SMART_CMD;
+
+        vector<BYTE> out(sizeof(SENDCMDOUTPARAMS) - 1 + READ_ATTRIBUTE_BUFFER_SIZE);
+        DWORD returned = 0;
+        if (!DeviceIoControl(h, SMART_RCV_DRIVE_DATA, &in, sizeof(in) - 1, out.data(), (DWORD)out.size(), &returned, nullptr)) return {};
+
+        auto* params = reinterpret_cast<SENDCMDOUTPARAMS*>(out.data());
+        return vector<unsigned char>(params->bBuffer, params->bBuffer + READ_ATTRIBUTE_BUFFER_SIZE);
+    }
+}
+
+DiskHealthData DiskHealth::read(const string& disk, bool readSmart)
+{
+    DiskHealthData d;
+
+    // Read/write access is only needed for the ATA SMART IOCTL; identity and
+    // the NVMe log page work on a handle without access rights. The handle is
+    // opened lazily so --replay never touches the device.
+    bool writable = true;
+    HANDLE h = INVALID_HANDLE_VALUE;
+    auto open = [&]() -> bool {
+        if (h != INVALID_HANDLE_VALUE) return true;
+        h = CreateFileA(disk.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_EXISTING, 0, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            writable = false;
+            h = CreateFileA(disk.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+        }
+        return h != INVALID_HANDLE_VALUE;
+    };
+
+    // Descriptor answers go through Probe as { writable, protocol, model, serial, firmware }
+    vector<string> descriptor = Probe::list("ioctl:disk-descriptor:" + disk, [&]() -> vector<string> {
+        if (!open()) return {};
+        DiskHealthData id;
+        STORAGE_BUS_TYPE bus = read_descriptor(h, id);
+        string protocol;
+        if (bus == BusTypeNvme) protocol = "NVMe";
+        else if (bus == BusTypeAta || bus == BusTypeSata) protocol = "ATA";
+        return { writable ? "1" : "0", protocol, id.model, id.serial, id.firmware };
+    });
+    if (descriptor.size() == 5) {
+        writable = descriptor[0] == "1";
+        d.protocol = descriptor[1];
+        d.model = descriptor[2];
+        d.serial = descriptor[3];
+        d.firmware = descriptor[4];
+
+        if (readSmart && d.protocol == "NVMe") {
+            vector<unsigned char> page = Probe::bytes("nvme-log:" + disk, [&]() {
+                return open() ? nvme_health_page(h) : vector<unsigned char>();
+            });
+            parseNvmeHealthLog(page.data(), page.size(), d);
+        }
+        else if (readSmart && d.protocol == "ATA" && writable) {
+            size_t digits = disk.find_last_not_of("0123456789");
+            BYTE number = static_cast<BYTE>(atoi(disk.c_str() + digits + 1));
+            vector<unsigned char> data = Probe::bytes("ata-smart:" + disk, [&]() {
+                return open() ? ata_smart_page(h, number) : vector<unsigned char>();
+            });
+            parseAtaSmartData(data.data(), data.size(), d);
+        }
+    }
+
+    if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
+    return d;
+}
+
+// ----------------- Linux -----------------
+
+#else
+
+namespace {
+    vector<unsigned char> nvme_health_page(const string& controller)
+    {
+        int fd = open(controller.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return {};
+
+        vector<unsigned char> page(512);
+        struct nvme_admin_cmd cmd = {};
+        cmd.opcode = 0x02;                          // Get Log Page
+        cmd.nsid = 0xFFFFFFFF;                      // controller-wide
+        cmd.addr = reinterpret_cast<uintptr_t>(page.data());
+        cmd.data_len = static_cast<uint32_t>(page.size());
+        cmd.cdw10 = 0x02 | ((static_cast<uint32_t>(page.size()) / 4 - 1) << 16);   // LID 02h, NUMDL
+
+        int rc = ioctl(fd, NVME_IOCTL_ADMIN_CMD, &cmd);
+        close(fd);
+        if (rc != 0) return {};
+        return page;
+    }
+
+    vector<unsigned char> ata_smart_page(const string& device)
+    {
+        int fd = open(device.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) return {};
+
+        // ATA PASS-THROUGH(16): PIO data-in, length in sector count, SMART READ DATA
+        unsigned char cdb[16] = { 0x85, 4 << 1, 0x0E, 0, 0xD0, 0, 1, 0, 0, 0, 0x4F, 0, 0xC2, 0, 0xB0, 0 };
+        unsigned char sense[32] = {};
+        vector<unsigned char> data(512);
+
+        sg_io_hdr_t io = {};
+        io.interface_id = 'S';
+        io.dxfer_direction = SG_DXFER_FROM_DEV;
+        io.cmd_len = sizeof(cdb);
+        io.cmdp = cdb;
+        io.mx_sb_len = sizeof(sense);
+        io.sbp = sense;
+        io.dxfer_len = static_cast<unsigned int>(data.size());
+        io.dxferp = data.data();
+        io.timeout = 3000;
+
+        int rc = ioctl(fd, SG_IO, &io);
+        close(fd);
+        if (rc != 0 || (io.info & SG_INFO_OK_MASK) != SG_INFO_OK) return {};
+        return data;
+    }
+
+    // First tempN_input under any hwmon node of the device (millidegrees)
+    int hwmon_temperature(const string& deviceDir)
+    {
+        for (const string& base : { deviceDir, deviceDir + "hwmon/" }) {
+            for (const auto& entry : Probe::dir(base)) {
+                if (entry.compare(0, 5, "hwmon") != 0 || entry == "hwmon") continue;
+                string value = trim(Probe::file(base + entry + "/temp1_input"));
+                if (!value.empty()) return atoi(value.c_str()) / 1000;
+            }
+        }
+        return -1;
+    }
+}
+
+DiskHealthData DiskHealth::read(const string& disk, bool readSmart)
+{
+    DiskHealthData d;
+    string deviceDir = "/sys/block/" + disk + "/device/";
+
+    if (disk.compare(0, 4, "nvme") == 0) {
+        // The namespace's device link is the controller (nvme0n1 -> nvme0)
+        string controller = disk.substr(0, disk.find('n', 4));
+        d.protocol = "NVMe";
+        d.model = trim(Probe::file(deviceDir + "model"));
+        d.serial = trim(Probe::file(deviceDir + "serial"));
+        d.firmware = trim(Probe::file(deviceDir + "firmware_rev"));
+
+        if (readSmart) {
+            vector<unsigned char> page = Probe::bytes("nvme-log:" + controller, [&]() { return nvme_health_page("/dev/" + controller); });
+            parseNvmeHealthLog(page.data(), page.size(), d);
+        }
+    }
+    else {
+        d.model = trim(Probe::file(deviceDir + "model"));
+        d.firmware = trim(Probe::file(deviceDir + "rev"));
+
+        // Unit serial number VPD page: 4-byte header, then the ASCII serial
+        string vpd = Probe::file(deviceDir + "vpd_pg80");
+        if (vpd.size() > 4) {
+            string serial;
+            for (size_t i = 4; i < vpd.size(); i++) if (vpd[i] >= 0x20 && vpd[i] < 0x7F) serial += vpd[i];
+            d.serial = trim(serial);
+        }
+
+        // libata reports its disks with the vendor string "ATA"
+        if (trim(Probe::file(deviceDir + "vendor")) == "ATA") d.protocol = "ATA";
+
+        if (readSmart && d.protocol == "ATA") {
+            vector<unsigned char> data = Probe::bytes("ata-smart:" + disk, [&]() { return ata_smart_page("/dev/" + disk); });
+            parseAtaSmartData(data.data(), data.size(), d);
+        }
+    }
+
+    // Unprivileged fallback: the kernel's own sensor for the drive
+    if (readSmart && d.temperature_c < 0) d.temperature_c = hwmon_temperature(deviceDir);
+    return d;
+}
+
+#endif
@@ -0,0 +1,194 @@
+#include "include\DiskSpeedCache.h"
+
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <algorithm>
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+static int64_t unix_now()
+{
+    return chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+DiskSpeedCache::DiskSpeedCache(const string& path) : path(path) {}
+
+string DiskSpeedCache::defaultPath()
+{
+#ifdef _WIN32
+    const char* local = getenv("LOCALAPPDATA");
+    if (local && *local) return string(local) + "\\BinaryFetch\\DiskSpeedCache.json";
+    const char* profile = getenv("USERPROFILE");
+    return string(profile ? profile : ".") + "\\AppData\\Local\\BinaryFetch\\DiskSpeedCache.json";
+#else
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) return string(xdg) + "/binaryfetch/disk_speed_cache.json";
+    const char* home = getenv("HOME");
+    return string(home ? home : ".") + "/.cache/binaryfetch/disk_speed_cache.json";
+#endif
+}
+
+void DiskSpeedCache::load()
+{
+    lock_guard<mutex> guard(lock);
+    entries.clear();
+    dirty = false;
+
+    ifstream in(path, ios::binary);
+    if (!in) return;
+
+    try {
+        json doc = json::parse(in);
+        // Version 1 keyed tests by name only; those results can't be matched to
+        // parameters. Version 2 stored MiB/s; MB/s from then on are decimal.
+        if (doc.value("version", 0) != 3) return;
+        json devices = doc.value("devices", json::object());
+        for (auto& dev : devices.items()) {
+            for (auto& t : dev.value().items()) {
+                const json& j = t.value();
+                Entry e;
+                e.result.name = j.value("name", string());
+                e.result.ok = true;
+                e.result.readPercent = j.value("read_percent", 100);
+                e.result.random = j.value("random", false);
+                e.result.mbps = j.value("mbps", 0.0);
+                e.result.iops = j.value("iops", 0.0);
+                e.result.p50_us = j.value("p50_us", 0.0);
+                e.result.p99_us = j.value("p99_us", 0.0);
+                e.result.ops = j.value("ops", (uint64_t)0);
+                e.measuredAt = j.value("measured_at", (int64_t)0);
+                entries[dev.key()][t.key()] = e;
+            }
+        }
+    }
+    catch (...) {
+        // Corrupt cache: start over, it gets rewritten on the next save
+        entries.clear();
+    }
+}
+
+bool DiskSpeedCache::save()
+{
+    lock_guard<mutex> guard(lock);
+    if (!dirty) return true;
+
+    json devices = json::object();
+    for (const auto& dev : entries) {
+        json tests = json::object();
+        for (const auto& t : dev.second) {
+            const DiskBenchResult& r = t.second.result;
+            tests[t.first] = {
+                { "name", r.name },
+                { "read_percent", r.readPercent },
+                { "random", r.random },
+                { "mbps", r.mbps },
+                { "iops", r.iops },
+                { "p50_us", r.p50_us },
+                { "p99_us", r.p99_us },
+                { "ops", r.ops },
+                { "measured_at", t.second.measuredAt }
+            };
+        }
+        devices[dev.first] = tests;
+    }
+
+    error_code ec;
+    filesystem::create_directories(filesystem::path(path).parent_path(), ec);
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) return false;
+    out << json{ { "version", 3 }, { "devices", devices } }.dump(1, ' ', false, json::error_handler_t::replace);
+    dirty = false;
+    return static_cast<bool>(out);
+}
+
+string DiskSpeedCache::testKey(const DiskBenchTest& test, const DiskBenchConfig& config)
+{
+    return test.name + "|" + to_string(test.blockSize) + "|q" + to_string(test.queueDepth) +
+        (test.random ? "|rnd" : "|seq") + "|r" + to_string(test.readPercent) +
+        "|" + to_string(config.durationMs) + "ms|t" + to_string(config.threads) +
+        "|" + to_string(config.fileSizeMB) + "MB";
+}
+
+size_t DiskSpeedCache::lookup(const DiskIdentity& id, const DiskBenchConfig& config, int64_t ttlSeconds,
+    vector<DiskBenchResult>& results, vector<size_t>& missing, int64_t& ageSeconds)
+{
+    results.clear();
+    missing.clear();
+    ageSeconds = 0;
+
+    lock_guard<mutex> guard(lock);
+    auto dev = id.usable() ? entries.find(id.key()) : entries.end();
+
+    int64_t now = unix_now();
+    size_t hits = 0;
+    for (size_t i = 0; i < config.tests.size(); i++) {
+        const DiskBenchTest& test = config.tests[i];
+        if (dev != entries.end()) {
+            auto it = dev->second.find(testKey(test, config));
+            int64_t age = it == dev->second.end() ? -1 : now - it->second.measuredAt;
+            if (age >= 0 && age <= ttlSeconds) {   // clock went backwards counts as stale
+                results.push_back(it->second.result);
+                ageSeconds = max(ageSeconds, age);
+                hits++;
+                continue;
+            }
+        }
+
+        DiskBenchResult placeholder;
+        placeholder.name = test.name;
+        placeholder.readPercent = test.readPercent;
+        placeholder.random = test.random;
+        results.push_back(placeholder);
+        missing.push_back(i);
+    }
+    return hits;
+}
+
+void DiskSpeedCache::store(const DiskIdentity& id, const DiskBenchConfig& config, const vector<DiskBenchResult>& results)
+{
+    if (!id.usable()) return;
+
+    lock_guard<mutex> guard(lock);
+    int64_t now = unix_now();
+    for (size_t i = 0; i < results.size() && i < config.tests.size(); i++) {
+        const DiskBenchResult& r = results[i];
+        if (!r.ok) continue;
+        Entry& e = entries[id.key()][testKey(config.tests[i], config)];
+        e.result = r;
+        e.measuredAt = now;
+        dirty = true;
+    }
+}
+
+size_t DiskSpeedCache::merge(const DiskBenchConfig& config, const vector<size_t>& missing,
+    const vector<DiskBenchResult>& measured, vector<DiskBenchResult>& results)
+{
+    vector<bool> filled(missing.size(), false);
+    size_t merged = 0;
+    for (const auto& m : measured) {
+        for (size_t k = 0; k < missing.size(); k++) {
+            size_t i = missing[k];
+            if (filled[k] || i >= config.tests.size() || i >= results.size()) continue;
+            const DiskBenchTest& test = config.tests[i];
+            if (test.name != m.name || test.readPercent != m.readPercent || test.random != m.random) continue;
+            results[i] = m;
+            filled[k] = true;
+            merged++;
+            break;
+        }
+    }
+    return merged;
+}
+
+string DiskSpeedCache::formatAge(int64_t seconds)
+{
+    if (seconds < 60) return to_string(seconds) + "s";
+    if (seconds < 3600) return to_string(seconds / 60) + "m";
+    if (seconds < 86400) return to_string(seconds / 3600) + "h";
+    return to_string(seconds / 86400) + "d";
+}
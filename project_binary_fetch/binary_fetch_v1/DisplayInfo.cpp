@@ -1,4 +1,6 @@
 #include "include\DisplayInfo.h"
+#include "include\Probe.h"
+#include "nlohmann/json.hpp"
 
 #include <windows.h>
 #include <dxgi1_6.h>
@@ -12,6 +14,7 @@
 #include <algorithm>
 #include <cwctype>
 using namespace std;
+using json = nlohmann::json;
 
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "Shcore.lib")
@@ -98,47 +101,11 @@ bool DisplayInfo::isAMDPresent() {
     return false;
 }
 
-// ----------------- EDID parsing (kept same logic) -----------------
+// ----------------- EDID lookup (shared EDIDParser engine) -----------------
 
-DisplayInfo::EDIDInfo DisplayInfo::parseEDID(const unsigned char* edid, size_t size) {
-    EDIDInfo info = { "", 0, 0, false };
-    if (!edid || size < 128) return info;
-
-    // Validate EDID header (same validation as CompactScreen)
-    if (edid[0] != 0x00 || edid[1] != 0xFF || edid[7] != 0x00) return info;
-
-    // Extract native resolution from first detailed timing descriptor (bytes 54-71)
-    if (size >= 72) {
-        unsigned short hActive = ((edid[58] >> 4) << 8) | edid[56];
-        unsigned short vActive = ((edid[61] >> 4) << 8) | edid[59];
-        if (hActive > 0 && vActive > 0) {
-            info.nativeWidth = hActive;
-            info.nativeHeight = vActive;
-            info.valid = true;
-        }
-    }
-
-    // Extract monitor name from descriptor blocks (0xFC descriptor type)
-    for (int i = 54; i < 126; i += 18) {
-        if (i + 17 >= static_cast<int>(size)) break;
-        if (edid[i] == 0x00 && edid[i + 1] == 0x00 && edid[i + 3] == 0xFC) {
-            string name;
-            for (int j = 5; j < 18; ++j) {
-                if (edid[i + j] == 0x0A || edid[i + j] == 0x00) break;
-                if (edid[i + j] >= 0x20 && edid[i + j] <= 0x7E) {
-                    name += static_cast<char>(edid[i + j]);
-                }
-            }
-            while (!name.empty() && name.back() == ' ') name.pop_back();
-            if (!name.empty()) info.friendlyName = name;
-            break;
-        }
-    }
-    return info;
-}
-
-string DisplayInfo::getFriendlyNameFromEDID(const wstring& deviceName) {
-    // Preserve CompactScreen registry scanning logic to obtain friendly name
+EDIDData DisplayInfo::getEDIDForDevice(const wstring& deviceName, const vector<EDIDBlob>& blobs) {
+    // Resolve the monitor hardware ID for this DXGI device name (e.g. MONITOR\DEL4067\{...})
+    // and use its vendor part to pick the matching blob under Enum\DISPLAY.
     wstring monitorHardwareId;
     DISPLAY_DEVICEW ddMon{};
     ddMon.cb = sizeof(ddMon);
@@ -149,17 +116,6 @@ string DisplayInfo::getFriendlyNameFromEDID(const wstring& deviceName) {
         }
     }
 
-    HKEY hKeyMonitors;
-    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-        L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY",
-        0, KEY_READ, &hKeyMonitors) != ERROR_SUCCESS) {
-        return "Generic PnP Monitor";
-    }
-
-    string friendlyName = "Generic PnP Monitor";
-    WCHAR subKeyName[256];
-    DWORD subKeyIndex = 0;
-
     wstring vendorPart;
     if (!monitorHardwareId.empty()) {
         size_t p1 = monitorHardwareId.find(L'\\');
@@ -171,89 +127,10 @@ string DisplayInfo::getFriendlyNameFromEDID(const wstring& deviceName) {
                 vendorPart = monitorHardwareId.substr(p1 + 1);
         }
     }
+    string vendor = WideToUtf8(vendorPart.c_str());
 
-    wstring vendLower;
-    if (!vendorPart.empty()) {
-        vendLower = vendorPart;
-        transform(vendLower.begin(), vendLower.end(), vendLower.begin(), towlower);
-    }
-
-    // First pass: vendor-specific
-    while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
-        wstring subKeyStr(subKeyName);
-        if (!vendLower.empty()) {
-            wstring subLower = subKeyStr;
-            transform(subLower.begin(), subLower.end(), subLower.begin(), towlower);
-            if (subLower.find(vendLower) != 0) continue;
-        }
-
-        HKEY hKeyMonitor;
-        if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) == ERROR_SUCCESS) {
-            WCHAR deviceKeyName[256];
-            DWORD deviceKeyIndex = 0;
-            while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
-                HKEY hKeyDevice;
-                if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) == ERROR_SUCCESS) {
-                    HKEY hKeyDeviceParams;
-                    if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
-                        BYTE edidData[256];
-                        DWORD edidSize = sizeof(edidData);
-                        if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, edidData, &edidSize) == ERROR_SUCCESS) {
-                            EDIDInfo edidInfo = parseEDID(edidData, edidSize);
-                            if (!edidInfo.friendlyName.empty()) {
-                                friendlyName = edidInfo.friendlyName;
-                                RegCloseKey(hKeyDeviceParams);
-                                RegCloseKey(hKeyDevice);
-                                RegCloseKey(hKeyMonitor);
-                                RegCloseKey(hKeyMonitors);
-                                return friendlyName;
-                            }
-                        }
-                        RegCloseKey(hKeyDeviceParams);
-                    }
-                    RegCloseKey(hKeyDevice);
-                }
-            }
-            RegCloseKey(hKeyMonitor);
-        }
-    }
-
-    // Fallback: scan everything
-    subKeyIndex = 0;
-    while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
-        HKEY hKeyMonitor;
-        if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) == ERROR_SUCCESS) {
-            WCHAR deviceKeyName[256];
-            DWORD deviceKeyIndex = 0;
-            while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
-                HKEY hKeyDevice;
-                if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) == ERROR_SUCCESS) {
-                    HKEY hKeyDeviceParams;
-                    if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
-                        BYTE edidData[256];
-                        DWORD edidSize = sizeof(edidData);
-                        if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, edidData, &edidSize) == ERROR_SUCCESS) {
-                            EDIDInfo edidInfo = parseEDID(edidData, edidSize);
-                            if (!edidInfo.friendlyName.empty()) {
-                                friendlyName = edidInfo.friendlyName;
-                                RegCloseKey(hKeyDeviceParams);
-                                RegCloseKey(hKeyDevice);
-                                RegCloseKey(hKeyMonitor);
-                                RegCloseKey(hKeyMonitors);
-                                return friendlyName;
-                            }
-                        }
-                        RegCloseKey(hKeyDeviceParams);
-                    }
-                    RegCloseKey(hKeyDevice);
-                }
-            }
-            RegCloseKey(hKeyMonitor);
-        }
-    }
-
-    RegCloseKey(hKeyMonitors);
-    return friendlyName;
+    // This monitor's own key first, named or not, before any other monitor's EDID
+    return EDIDParser::forMonitor(blobs, vendor);
 }
 
 // ----------------- Core DXGI population (kept intact, extended) -----------------
@@ -262,11 +139,31 @@ DisplayInfo::DisplayInfo() {
     refresh();
 }
 
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(DisplayInfo::ScreenInfo,
+    name, current_width, current_height, refresh_rate, native_width, native_height,
+    scale_percent, scale_mul, upscale, dsr_enabled, dsr_type, aspect_ratio, native_resolution,
+    max_refresh_rate, vrr_min, vrr_max, range_min, range_max, hdr_supported, hdr_formats,
+    serial, manufacture_date)
+
 bool DisplayInfo::refresh() {
+    // DXGI, EnumDisplaySettings and DPI answers are dozens of calls per output,
+    // so the finished screens go through Probe as one JSON value instead
+    string recorded = Probe::text("dxgi:displays", [this]() -> string {
+        screens.clear();
+        if (populateFromDXGI()) {
+            enrichWithNVAPI();
+            enrichWithADL();
+        }
+        return json(screens).dump(-1, ' ', false, json::error_handler_t::replace);
+    });
+
     screens.clear();
-    if (!populateFromDXGI()) return false;
-    enrichWithNVAPI();
-    enrichWithADL();
+    try {
+        if (!recorded.empty()) screens = json::parse(recorded).get<vector<ScreenInfo>>();
+    }
+    catch (...) {
+        screens.clear();
+    }
     return !screens.empty();
 }
 
@@ -281,6 +178,9 @@ bool DisplayInfo::populateFromDXGI() {
     bool hasNvidia = isNvidiaPresent();
     bool hasAMD = isAMDPresent();
 
+    // Read every EDID blob once per refresh instead of rescanning the registry per output
+    vector<EDIDBlob> edidBlobs = EDIDParser::readAll();
+
     IDXGIAdapter1* adapter = nullptr;
     for (UINT a = 0; factory->EnumAdapters1(a, &adapter) != DXGI_ERROR_NOT_FOUND; ++a) {
         IDXGIOutput* output = nullptr;
@@ -302,55 +202,13 @@ bool DisplayInfo::populateFromDXGI() {
                         if (dm.dmDisplayFrequency > 1) refresh = dm.dmDisplayFrequency;
                     }
 
-                    // ===== GET MONITOR FRIENDLY NAME =====
+                    // ===== READ EDID (name, native panel mode, refresh range, HDR) =====
                     wstring deviceNameW = desc1.DeviceName;
-                    string friendlyName = getFriendlyNameFromEDID(deviceNameW);
+                    EDIDData edid = getEDIDForDevice(deviceNameW, edidBlobs);
+                    string friendlyName = edid.friendlyName.empty() ? "Generic PnP Monitor" : edid.friendlyName;
 
                     // ===== GET NATIVE PANEL RESOLUTION (FROM EDID) =====
-                    int nativeW = 0, nativeH = 0;
-                    HKEY hKeyMonitors;
-                    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-                        L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY",
-                        0, KEY_READ, &hKeyMonitors) == ERROR_SUCCESS) {
-                        WCHAR subKeyName[256];
-                        DWORD subKeyIndex = 0;
-
-                        while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
-                            HKEY hKeyMonitor;
-                            if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) == ERROR_SUCCESS) {
-                                WCHAR deviceKeyName[256];
-                                DWORD deviceKeyIndex = 0;
-
-                                while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
-                                    HKEY hKeyDevice;
-                                    if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) == ERROR_SUCCESS) {
-                                        HKEY hKeyDeviceParams;
-                                        if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
-                                            BYTE edidData[256];
-                                            DWORD edidSize = sizeof(edidData);
-
-                                            if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, edidData, &edidSize) == ERROR_SUCCESS) {
-                                                EDIDInfo edidInfo = parseEDID(edidData, edidSize);
-                                                if (edidInfo.valid && edidInfo.nativeWidth > 0) {
-                                                    nativeW = edidInfo.nativeWidth;
-                                                    nativeH = edidInfo.nativeHeight;
-                                                    RegCloseKey(hKeyDeviceParams);
-                                                    RegCloseKey(hKeyDevice);
-                                                    RegCloseKey(hKeyMonitor);
-                                                    goto edid_found;
-                                                }
-                                            }
-                                            RegCloseKey(hKeyDeviceParams);
-                                        }
-                                        RegCloseKey(hKeyDevice);
-                                    }
-                                }
-                                RegCloseKey(hKeyMonitor);
-                            }
-                        }
-                    edid_found:
-                        RegCloseKey(hKeyMonitors);
-                    }
+                    int nativeW = edid.nativeWidth, nativeH = edid.nativeHeight;
 
                     // Fallback: if we can't get native resolution, assume currently applied resolution is native
                     if (nativeW <= 0 || nativeH <= 0) {
@@ -488,6 +346,26 @@ bool DisplayInfo::populateFromDXGI() {
                     // aspect ratio (from applied resolution)
                     info.aspect_ratio = computeAspectRatio(currentW, currentH);
 
+                    // panel capabilities from the EDID extension blocks
+                    info.max_refresh_rate = static_cast<int>(round(edid.max_refresh_rate));
+                    if (info.max_refresh_rate < refresh) info.max_refresh_rate = refresh;
+                    info.vrr_min = edid.vrr_min;
+                    info.vrr_max = edid.vrr_max;
+                    info.range_min = edid.range_min;
+                    info.range_max = edid.range_max;
+                    info.hdr_supported = edid.hdr_supported;
+                    if (edid.hdr10) info.hdr_formats = "HDR10";
+                    if (edid.hlg) info.hdr_formats += info.hdr_formats.empty() ? "HLG" : ", HLG";
+                    info.serial = edid.serial();
+                    if (edid.manufacture_year > 0) {
+                        if (edid.manufacture_week == 255)
+                            info.manufacture_date = "Model year " + to_string(edid.manufacture_year);
+                        else if (edid.manufacture_week > 0)
+                            info.manufacture_date = "Week " + to_string(edid.manufacture_week) + ", " + to_string(edid.manufacture_year);
+                        else
+                            info.manufacture_date = to_string(edid.manufacture_year);
+                    }
+
                     // DSR/VSR heuristics
                     info.dsr_enabled = false;
                     info.dsr_type = "None";
@@ -6,6 +6,7 @@
 #include <algorithm> // Standard C++ library for algorithms like transform.
 #include <comdef.h> // Provides definitions for COM error handling and smart pointers.
 #include "nvapi.h"
+#include "include\Probe.h"
 
 using namespace std;
 
@@ -179,6 +180,7 @@ static float estimate_gpu_frequency_basic(const wstring& gpuName)
 
 vector<GPUData> DetailedGPUInfo::get_all_gpus()
 {
+    Probe::unrouted("NvAPI (DetailedGPUInfo)");
     vector<GPUData> gpus;
 
     IDXGIFactory* pFactory = nullptr;
@@ -211,8 +213,15 @@ vector<GPUData> DetailedGPUInfo::get_all_gpus()
 
     while (pFactory->EnumAdapters(i, &pAdapter) != DXGI_ERROR_NOT_FOUND)
     {
-        DXGI_ADAPTER_DESC desc;
-        pAdapter->GetDesc(&desc);
+        // The raw descriptor goes through Probe so --record / --replay keep it byte-for-byte
+        DXGI_ADAPTER_DESC desc = {};
+        vector<unsigned char> rawDesc = Probe::bytes("dxgi:adapter" + to_string(i), [&]() {
+            DXGI_ADAPTER_DESC live = {};
+            pAdapter->GetDesc(&live);
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(&live);
+            return vector<unsigned char>(p, p + sizeof(live));
+        });
+        if (rawDesc.size() == sizeof(desc)) memcpy(&desc, rawDesc.data(), sizeof(desc));
 
         GPUData gpu;
         gpu.index = i;
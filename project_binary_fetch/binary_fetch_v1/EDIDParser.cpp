@@ -0,0 +1,457 @@
+#include "include\EDIDParser.h"
+#include "include\Probe.h"
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cctype>
+#include <algorithm>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#endif
+using namespace std;
+
+// ----------------- Small helpers -----------------
+
+static string lowerCopy(string s) {
+    transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return s;
+}
+
+static string descriptorText(const unsigned char* d) {
+    // Display descriptor payload is bytes 5..17, terminated by 0x0A and padded with spaces
+    string text;
+    for (int j = 5; j < 18; ++j) {
+        if (d[j] == 0x0A || d[j] == 0x00) break;
+        if (d[j] >= 0x20 && d[j] <= 0x7E) text += static_cast<char>(d[j]);
+    }
+    while (!text.empty() && text.back() == ' ') text.pop_back();
+    return text;
+}
+
+string EDIDData::serial() const {
+    if (!serial_string.empty()) return serial_string;
+    if (serial_number != 0) return to_string(serial_number);
+    return "";
+}
+
+void EDIDParser::noteRefresh(EDIDData& info, double hz) {
+    if (hz > info.max_refresh_rate && hz < 1000.0) info.max_refresh_rate = hz;
+}
+
+// ----------------- Base block -----------------
+
+bool EDIDParser::parseDetailedTiming(const unsigned char* d, EDIDTiming& out) {
+    // 18-byte DTD, pixel clock in 10 kHz units (0 means "display descriptor", not a timing)
+    unsigned int pixelClock = d[0] | (d[1] << 8);
+    if (pixelClock == 0) return false;
+
+    int hActive = d[2] | ((d[4] & 0xF0) << 4);
+    int hBlank = d[3] | ((d[4] & 0x0F) << 8);
+    int vActive = d[5] | ((d[7] & 0xF0) << 4);
+    int vBlank = d[6] | ((d[7] & 0x0F) << 8);
+    if (hActive <= 0 || vActive <= 0) return false;
+
+    out.width = hActive;
+    out.height = vActive;
+    out.interlaced = (d[17] & 0x80) != 0;
+
+    // Interlaced DTDs describe one field: the clock over the field total is
+    // already the field rate (1080i60 -> 60 Hz), only the frame is twice as tall
+    double total = static_cast<double>(hActive + hBlank) * static_cast<double>(vActive + vBlank);
+    out.refresh_hz = total > 0 ? (pixelClock * 10000.0) / total : 0.0;
+    if (out.interlaced) out.height *= 2;
+    return true;
+}
+
+void EDIDParser::parseDisplayDescriptor(const unsigned char* d, EDIDData& info) {
+    if (d[0] != 0x00 || d[1] != 0x00 || d[2] != 0x00) return;
+
+    switch (d[3]) {
+    case 0xFC: // Monitor name
+        if (info.friendlyName.empty()) info.friendlyName = descriptorText(d);
+        break;
+    case 0xFF: // Monitor serial number (ASCII)
+        if (info.serial_string.empty()) info.serial_string = descriptorText(d);
+        break;
+    case 0xFD: { // Display range limits
+        int minV = d[5], maxV = d[6];
+        // EDID 1.4 offset flags: bit1 -> +255 on max vertical, bit0 -> +255 on min vertical
+        if (d[4] & 0x02) maxV += 255;
+        if ((d[4] & 0x03) == 0x03) minV += 255;
+        if (minV > 0 && maxV > minV) {
+            info.range_min = minV;
+            info.range_max = maxV;
+            // Every EDID 1.4 panel carries range limits; only "range limits
+            // only" (byte 10 = 0x01, no GTF/CVT formula) with a usable span is
+            // how adaptive-sync panels advertise VRR - same test as the Linux DRM/amdgpu
+            if (d[10] == 0x01 && maxV - minV > 10 && info.vrr_max == 0) {
+                info.vrr_min = minV;
+                info.vrr_max = maxV;
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// ----------------- CTA-861 extension -----------------
+
+double EDIDParser::vicRefreshRate(int vic) {
+    // Field rate of each CTA-861 VIC (1..127, then 193..219)
+    static const unsigned char low[128] = {
+        0,
+        60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60, 60,         // 1-16
+        50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 50,             // 17-31
+        24, 25, 30, 60, 60, 50, 50, 50,                                         // 32-39
+        100, 100, 100, 100, 100, 100,                                           // 40-45
+        120, 120, 120, 120, 120, 120,                                           // 46-51
+        200, 200, 200, 200, 240, 240, 240, 240,                                 // 52-59
+        24, 25, 30, 120, 100,                                                   // 60-64
+        24, 25, 30, 50, 60, 100, 120,                                           // 65-71
+        24, 25, 30, 50, 60, 100, 120,                                           // 72-78
+        24, 25, 30, 50, 60, 100, 120,                                           // 79-85
+        24, 25, 30, 50, 60, 100, 120,                                           // 86-92
+        24, 25, 30, 50, 60,                                                     // 93-97
+        24, 25, 30, 50, 60,                                                     // 98-102
+        24, 25, 30, 50, 60,                                                     // 103-107
+        48, 48, 48, 48, 48, 48, 48, 48, 48,                                     // 108-116
+        100, 120, 100, 120,                                                     // 117-120
+        24, 25, 30, 48, 50, 60, 100                                             // 121-127
+    };
+    static const unsigned char high[27] = {
+        120,                                                                    // 193
+        24, 25, 30, 48, 50, 60, 100, 120,                                       // 194-201
+        24, 25, 30, 48, 50, 60, 100, 120,                                       // 202-209
+        24, 25, 30, 48, 50, 60, 100, 120,                                       // 210-217
+        100, 120                                                                // 218-219
+    };
+    if (vic >= 1 && vic <= 127) return low[vic];
+    if (vic >= 193 && vic <= 219) return high[vic - 193];
+    return 0.0;
+}
+
+void EDIDParser::parseCTABlock(const unsigned char* block, EDIDData& info) {
+    info.has_cta = true;
+
+    // byte 2 = offset of the first DTD; data block collection lives in [4, dtdOffset)
+    int dtdOffset = block[2];
+    if (dtdOffset < 4 || dtdOffset > 127) dtdOffset = 127;
+
+    int pos = 4;
+    while (pos < dtdOffset) {
+        const unsigned char* db = block + pos;
+        int tag = db[0] >> 5;
+        int len = db[0] & 0x1F;
+        if (pos + 1 + len > dtdOffset) break;
+
+        if (tag == 2) {
+            // Video data block: one SVD per byte, bit 7 = native flag for VIC 1..64
+            for (int i = 1; i <= len; ++i) {
+                int vic = db[i];
+                if (vic >= 129 && vic <= 192) vic &= 0x7F;
+                noteRefresh(info, vicRefreshRate(vic));
+            }
+        }
+        else if (tag == 3 && len >= 11) {
+            // HDMI Forum VSDB (OUI C4-5D-D8, stored little-endian): VRRmin/VRRmax in bytes 9-10
+            if (db[1] == 0xD8 && db[2] == 0x5D && db[3] == 0xC4) {
+                int vrrMin = db[9] & 0x3F;
+                int vrrMax = ((db[9] & 0xC0) << 2) | db[10];
+                if (vrrMin > 0 && vrrMax > vrrMin) {
+                    info.vrr_min = vrrMin;
+                    info.vrr_max = vrrMax;
+                }
+            }
+        }
+        else if (tag == 7 && len >= 3 && db[1] == 0x06) {
+            // HDR static metadata data block
+            unsigned char eotf = db[2];
+            info.hdr10 = (eotf & 0x04) != 0;
+            info.hlg = (eotf & 0x08) != 0;
+            info.hdr_supported = (eotf & 0x0E) != 0;
+            if (len >= 4 && db[4] != 0) {
+                info.hdr_max_luminance = 50.0 * pow(2.0, db[4] / 32.0);
+            }
+        }
+        pos += 1 + len;
+    }
+
+    // Additional DTDs follow the data block collection until a zero pixel clock
+    for (int off = block[2]; off >= 4 && off + 18 <= 127; off += 18) {
+        EDIDTiming t;
+        if (!parseDetailedTiming(block + off, t)) break;
+        info.timings.push_back(t);
+        noteRefresh(info, t.refresh_hz);
+    }
+}
+
+// ----------------- DisplayID extension -----------------
+
+void EDIDParser::parseDisplayIDBlock(const unsigned char* block, EDIDData& info) {
+    info.has_displayid = true;
+
+    // Byte 0 is the 0x70 extension tag, the DisplayID section header follows it
+    int sectionBytes = block[2];
+    int end = min(5 + sectionBytes, 127);
+    int pos = 5;
+
+    while (pos + 3 <= end) {
+        const unsigned char* db = block + pos;
+        int tag = db[0];
+        int len = db[2];
+        if (tag == 0 || pos + 3 + len > end) break;
+        const unsigned char* p = db + 3;
+
+        if ((tag == 0x03 || tag == 0x22) && len >= 20) {
+            // Type I (DisplayID 1.x, 10 kHz units) / Type VII (DisplayID 2.x, 1 kHz units)
+            double clockUnit = (tag == 0x03) ? 10000.0 : 1000.0;
+            for (int off = 0; off + 20 <= len; off += 20) {
+                const unsigned char* t = p + off;
+                double clock = ((t[0] | (t[1] << 8) | (t[2] << 16)) + 1) * clockUnit;
+                int hActive = (t[4] | (t[5] << 8)) + 1;
+                int hBlank = (t[6] | (t[7] << 8)) + 1;
+                int vActive = (t[12] | (t[13] << 8)) + 1;
+                int vBlank = (t[14] | (t[15] << 8)) + 1;
+
+                EDIDTiming timing;
+                timing.width = hActive;
+                timing.height = vActive;
+                timing.interlaced = (t[3] & 0x10) != 0;
+                // Field lines, like a DTD: the rate is the field rate, the frame twice as tall
+                double total = static_cast<double>(hActive + hBlank) * (vActive + vBlank);
+                timing.refresh_hz = total > 0 ? clock / total : 0.0;
+                if (timing.interlaced) timing.height *= 2;
+                info.timings.push_back(timing);
+                noteRefresh(info, timing.refresh_hz);
+
+                // Bit 7 of the options byte marks the preferred timing
+                if ((t[3] & 0x80) && info.nativeWidth == 0) {
+                    info.nativeWidth = timing.width;
+                    info.nativeHeight = timing.height;
+                    info.preferred_refresh = timing.refresh_hz;
+                }
+            }
+        }
+        else if (tag == 0x25 && len >= 9) {
+            // Dynamic video timing range limits (DisplayID 2.x)
+            int minV = p[6];
+            int maxV = p[7] | ((db[1] >= 1) ? ((p[8] & 0x03) << 8) : 0);
+            if (minV > 0 && maxV > minV) {
+                info.vrr_min = minV;
+                info.vrr_max = maxV;
+            }
+        }
+        pos += 3 + len;
+    }
+}
+
+// ----------------- Entry point -----------------
+
+EDIDData EDIDParser::parse(const unsigned char* edid, size_t size) {
+    EDIDData info;
+    if (!edid || size < 128) return info;
+
+    static const unsigned char header[8] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+    if (!equal(header, header + 8, edid)) return info;
+
+    // Manufacturer PNP ID: three 5-bit letters, big-endian
+    unsigned int mfg = (edid[8] << 8) | edid[9];
+    char pnp[4] = {
+        static_cast<char>('A' + ((mfg >> 10) & 0x1F) - 1),
+        static_cast<char>('A' + ((mfg >> 5) & 0x1F) - 1),
+        static_cast<char>('A' + (mfg & 0x1F) - 1),
+        '\0'
+    };
+    info.manufacturer = pnp;
+    info.product_code = edid[10] | (edid[11] << 8);
+    info.serial_number = edid[12] | (edid[13] << 8) | (edid[14] << 16) | (static_cast<unsigned int>(edid[15]) << 24);
+    info.manufacture_week = edid[16];
+    info.manufacture_year = edid[17] ? 1990 + edid[17] : 0;
+    info.version = edid[18];
+    info.revision = edid[19];
+
+    // Four 18-byte descriptors at 54, 72, 90, 108: first DTD is the preferred timing
+    for (int i = 54; i <= 108; i += 18) {
+        EDIDTiming t;
+        if (parseDetailedTiming(edid + i, t)) {
+            if (info.nativeWidth == 0) {
+                info.nativeWidth = t.width;
+                info.nativeHeight = t.height;
+                info.preferred_refresh = t.refresh_hz;
+            }
+            info.timings.push_back(t);
+            noteRefresh(info, t.refresh_hz);
+        }
+        else {
+            parseDisplayDescriptor(edid + i, info);
+        }
+    }
+
+    // Extension blocks (byte 126) - only walk what is actually present in the buffer
+    int declared = edid[126];
+    int available = static_cast<int>(size / 128) - 1;
+    info.extension_blocks = min(declared, available);
+    for (int b = 1; b <= info.extension_blocks; ++b) {
+        const unsigned char* block = edid + 128 * b;
+        if (block[0] == 0x02) parseCTABlock(block, info);
+        else if (block[0] == 0x70) parseDisplayIDBlock(block, info);
+    }
+
+    info.valid = info.nativeWidth > 0 && info.nativeHeight > 0;
+    return info;
+}
+
+EDIDData EDIDParser::findBest(const vector<EDIDBlob>& blobs, const string& sourcePrefix, bool needName) {
+    string prefix = lowerCopy(sourcePrefix);
+
+    // First pass: blobs from the matching source, second pass: anything usable
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 0 && prefix.empty()) continue;
+        for (const auto& blob : blobs) {
+            if (pass == 0 && lowerCopy(blob.source).find(prefix) != 0) continue;
+            EDIDData data = parse(blob.bytes);
+            if (!data.valid) continue;
+            if (needName && data.friendlyName.empty()) continue;
+            return data;
+        }
+    }
+    return EDIDData{};
+}
+
+EDIDData EDIDParser::forMonitor(const vector<EDIDBlob>& blobs, const string& vendor) {
+    string prefix = lowerCopy(vendor);
+
+    // Own vendor key first (named, then any); the global pass only if it has nothing valid
+    for (int pass = 0; pass < 4; ++pass) {
+        bool own = pass < 2;
+        bool needName = pass % 2 == 0;
+        if (own && prefix.empty()) continue;
+        for (const auto& blob : blobs) {
+            if (own && lowerCopy(blob.source).find(prefix) != 0) continue;
+            EDIDData data = parse(blob.bytes);
+            if (!data.valid) continue;
+            if (needName && data.friendlyName.empty()) continue;
+            return data;
+        }
+    }
+    return EDIDData{};
+}
+
+// ----------------- Blob sources -----------------
+
+#ifdef _WIN32
+
+static vector<EDIDBlob> readAllLive(const string& root) {
+    vector<EDIDBlob> blobs;
+    wstring rootPath = L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY";
+    if (!root.empty()) rootPath.assign(root.begin(), root.end());
+
+    HKEY hKeyMonitors;
+    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, rootPath.c_str(), 0, KEY_READ, &hKeyMonitors) != ERROR_SUCCESS) {
+        return blobs;
+    }
+
+    WCHAR subKeyName[256];
+    DWORD subKeyIndex = 0;
+    while (RegEnumKeyW(hKeyMonitors, subKeyIndex++, subKeyName, 256) == ERROR_SUCCESS) {
+        HKEY hKeyMonitor;
+        if (RegOpenKeyExW(hKeyMonitors, subKeyName, 0, KEY_READ, &hKeyMonitor) != ERROR_SUCCESS) continue;
+
+        char narrow[256];
+        WideCharToMultiByte(CP_UTF8, 0, subKeyName, -1, narrow, sizeof(narrow), nullptr, nullptr);
+
+        WCHAR deviceKeyName[256];
+        DWORD deviceKeyIndex = 0;
+        while (RegEnumKeyW(hKeyMonitor, deviceKeyIndex++, deviceKeyName, 256) == ERROR_SUCCESS) {
+            HKEY hKeyDevice;
+            if (RegOpenKeyExW(hKeyMonitor, deviceKeyName, 0, KEY_READ, &hKeyDevice) != ERROR_SUCCESS) continue;
+
+            HKEY hKeyDeviceParams;
+            if (RegOpenKeyExW(hKeyDevice, L"Device Parameters", 0, KEY_READ, &hKeyDeviceParams) == ERROR_SUCCESS) {
+                // Ask for the size first so extension blocks beyond 256 bytes survive
+                DWORD edidSize = 0;
+                if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, nullptr, &edidSize) == ERROR_SUCCESS && edidSize >= 128) {
+                    EDIDBlob blob;
+                    blob.source = narrow;
+                    blob.bytes.resize(edidSize);
+                    if (RegQueryValueExW(hKeyDeviceParams, L"EDID", nullptr, nullptr, blob.bytes.data(), &edidSize) == ERROR_SUCCESS) {
+                        blob.bytes.resize(edidSize);
+                        blobs.push_back(move(blob));
+                    }
+                }
+                RegCloseKey(hKeyDeviceParams);
+            }
+            RegCloseKey(hKeyDevice);
+        }
+        RegCloseKey(hKeyMonitor);
+    }
+
+    RegCloseKey(hKeyMonitors);
+    return blobs;
+}
+
+#else
+
+static vector<EDIDBlob> readAllLive(const string& root) {
+    vector<EDIDBlob> blobs;
+    string base = root.empty() ? "/sys/class/drm" : root;
+
+    DIR* dir = opendir(base.c_str());
+    if (!dir) return blobs;
+
+    vector<string> connectors;
+    while (dirent* entry = readdir(dir)) {
+        string name = entry->d_name;
+        if (name.empty() || name[0] == '.') continue;
+        connectors.push_back(name);
+    }
+    closedir(dir);
+    sort(connectors.begin(), connectors.end());
+
+    for (const auto& name : connectors) {
+        // Disconnected connectors expose an empty edid file
+        ifstream in(base + "/" + name + "/edid", ios::binary);
+        if (!in) continue;
+        EDIDBlob blob;
+        blob.source = name;
+        blob.bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        if (blob.bytes.size() >= 128) blobs.push_back(move(blob));
+    }
+    return blobs;
+}
+
+#endif
+
+// All blobs travel as one "source<TAB>hex" line each so --record / --replay
+// can capture the raw bytes without caring where they came from
+vector<EDIDBlob> EDIDParser::readAll(const string& root) {
+    string encoded = Probe::text("edid:blobs", [&]() {
+        string out;
+        for (const auto& blob : readAllLive(root)) {
+            out += blob.source + "\t" + Probe::toHex(blob.bytes) + "\n";
+        }
+        return out;
+    });
+
+    vector<EDIDBlob> blobs;
+    istringstream in(encoded);
+    string line;
+    while (getline(in, line)) {
+        size_t tab = line.find('\t');
+        if (tab == string::npos) continue;
+        EDIDBlob blob;
+        blob.source = line.substr(0, tab);
+        blob.bytes = Probe::fromHex(line.substr(tab + 1));
+        if (blob.bytes.size() >= 128) blobs.push_back(move(blob));
+    }
+    return blobs;
+}
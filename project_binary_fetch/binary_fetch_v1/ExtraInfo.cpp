@@ -1,16 +1,27 @@
 #include "include\ExtraInfo.h"
+#include "include\Probe.h"
+#include <sstream>
+#include <cstdlib>
+
+#ifdef _WIN32
 #include <windows.h>
 #include <mmdeviceapi.h>
 #include <functiondiscoverykeys_devpkey.h>
 #include <powrprof.h>
-#include <sstream>
+#else
+#include <cctype>
+#endif
 using namespace std;
 
+ExtraInfo::ExtraInfo(const string& root) : root(root) {}
+
+#ifdef _WIN32
+
 /**
  * Retrieves all audio OUTPUT devices (speakers/headphones) on the system
  * @return Vector of AudioDevice structs containing device info
  */
-vector<AudioDevice> ExtraInfo::get_output_devices()
+static vector<AudioDevice> query_output_devices()
 {
     vector<AudioDevice> devices;
     HRESULT hr;
@@ -111,7 +122,7 @@ vector<AudioDevice> ExtraInfo::get_output_devices()
  * Retrieves all audio INPUT devices (microphones) on the system
  * @return Vector of AudioDevice structs containing device info
  */
-vector<AudioDevice> ExtraInfo::get_input_devices()
+static vector<AudioDevice> query_input_devices()
 {
     vector<AudioDevice> devices;
     HRESULT hr;
@@ -208,6 +219,38 @@ vector<AudioDevice> ExtraInfo::get_input_devices()
     return devices;
 }
 
+// Device lists go through Probe, one "<active> <name>" line per device, so
+// --replay shows the recorded endpoints
+static vector<AudioDevice> probe_devices(const string& key, bool isOutput, vector<AudioDevice>(*query)())
+{
+    vector<string> lines = Probe::list(key, [query]() -> vector<string> {
+        vector<string> out;
+        for (const auto& device : query()) out.push_back(string(device.isActive ? "1 " : "0 ") + device.name);
+        return out;
+    });
+
+    vector<AudioDevice> devices;
+    for (const auto& line : lines) {
+        if (line.size() < 2) continue;
+        AudioDevice device;
+        device.isActive = line[0] == '1';
+        device.isOutput = isOutput;
+        device.name = line.substr(2);
+        devices.push_back(device);
+    }
+    return devices;
+}
+
+vector<AudioDevice> ExtraInfo::get_output_devices()
+{
+    return probe_devices("mmdevice:render-endpoints", true, query_output_devices);
+}
+
+vector<AudioDevice> ExtraInfo::get_input_devices()
+{
+    return probe_devices("mmdevice:capture-endpoints", false, query_input_devices);
+}
+
 /**
  * Retrieves system power status information
  * @return PowerStatus struct containing power information
@@ -215,10 +258,26 @@ vector<AudioDevice> ExtraInfo::get_input_devices()
 PowerStatus ExtraInfo::get_power_status()
 {
     PowerStatus status;
-    SYSTEM_POWER_STATUS sps;
-
-    // Get system power status information
-    if (!GetSystemPowerStatus(&sps))
+    SYSTEM_POWER_STATUS sps = {};
+
+    // Get system power status information; the fields that matter go through
+    // Probe ("ok ACLineStatus BatteryFlag BatteryLifePercent BatteryLifeTime")
+    vector<string> recorded = Probe::list("kernel32:system-power-status", []() -> vector<string> {
+        SYSTEM_POWER_STATUS live = {};
+        bool ok = GetSystemPowerStatus(&live) != 0;
+        return { ok ? "1" : "0", to_string(live.ACLineStatus), to_string(live.BatteryFlag),
+            to_string(live.BatteryLifePercent), to_string(live.BatteryLifeTime == (DWORD)-1 ? -1LL : (long long)live.BatteryLifeTime) };
+    });
+    bool ok = recorded.size() == 5 && recorded[0] == "1";
+    if (ok)
+    {
+        sps.ACLineStatus = static_cast<BYTE>(atoi(recorded[1].c_str()));
+        sps.BatteryFlag = static_cast<BYTE>(atoi(recorded[2].c_str()));
+        sps.BatteryLifePercent = static_cast<BYTE>(atoi(recorded[3].c_str()));
+        long long lifeTime = atoll(recorded[4].c_str());
+        sps.BatteryLifeTime = lifeTime < 0 ? (DWORD)-1 : static_cast<DWORD>(lifeTime);
+    }
+    if (!ok)
     {
         status.hasBattery = false;
         status.isCharging = false;
@@ -233,9 +292,208 @@ PowerStatus ExtraInfo::get_power_status()
     status.isACOnline = (sps.ACLineStatus == 1);
     status.isCharging = status.isACOnline;
 
+    // BatteryLifeTime is -1 while on AC or when Windows can't estimate it
+    if (sps.BatteryLifeTime != (DWORD)-1) status.minutesRemaining = (int)(sps.BatteryLifeTime / 60);
+
     return status;
 }
 
+#else
+
+// ----------------- Linux backend (/sys/class/power_supply, /proc/asound) -----------------
+// Everything here is a handful of small pseudo-file reads, no PulseAudio/PipeWire.
+// `root` is prepended to every path so a fixture tree can stand in for the real one.
+
+static string read_line(const string& path)
+{
+    istringstream in(Probe::file(path));
+    string line;
+    if (!getline(in, line)) return "";
+    while (!line.empty() && (line.back() == '\n' || line.back() == ' ' || line.back() == '\r')) line.pop_back();
+    return line;
+}
+
+static long long read_number(const string& path, long long fallback = -1)
+{
+    string line = read_line(path);
+    if (line.empty()) return fallback;
+    try { return stoll(line); }
+    catch (...) { return fallback; }
+}
+
+static vector<string> list_dir(const string& path)
+{
+    return Probe::dir(path);
+}
+
+/**
+ * Reads /proc/asound/cards and every pcm<N>p / pcm<N>c directory under each card.
+ * A device counts as active when any of its substreams reports "state: RUNNING".
+ */
+static vector<AudioDevice> read_alsa_devices(const string& root, bool wantOutput)
+{
+    vector<AudioDevice> devices;
+    string asound = root + "/proc/asound";
+
+    // Lines look like: " 0 [PCH            ]: HDA-Intel - HDA Intel PCH"
+    istringstream cards(Probe::file(asound + "/cards"));
+    string line;
+    while (getline(cards, line)) {
+        size_t start = line.find_first_not_of(' ');
+        if (start == string::npos || !isdigit((unsigned char)line[start])) continue;
+
+        int index = atoi(line.c_str() + start);
+        string cardName;
+        size_t dash = line.find(" - ");
+        if (dash != string::npos) cardName = line.substr(dash + 3);
+        while (!cardName.empty() && cardName.back() == ' ') cardName.pop_back();
+
+        string cardDir = asound + "/card" + to_string(index);
+        char suffix = wantOutput ? 'p' : 'c';
+
+        for (const auto& entry : list_dir(cardDir)) {
+            if (entry.size() < 5 || entry.compare(0, 3, "pcm") != 0 || entry.back() != suffix) continue;
+            string pcmDir = cardDir + "/" + entry;
+
+            // info holds "name: <pcm name>" among a few other key/value lines
+            string pcmName;
+            istringstream info(Probe::file(pcmDir + "/info"));
+            string infoLine;
+            while (getline(info, infoLine)) {
+                if (infoLine.compare(0, 6, "name: ") == 0) {
+                    pcmName = infoLine.substr(6);
+                    break;
+                }
+            }
+
+            // sub*/status is "closed" or "state: RUNNING" / "state: PREPARED" ...; cap the scan
+            bool running = false;
+            int subs = 0;
+            for (const auto& sub : list_dir(pcmDir)) {
+                if (sub.compare(0, 3, "sub") != 0) continue;
+                if (++subs > 8) break;
+                if (read_line(pcmDir + "/" + sub + "/status").find("RUNNING") != string::npos) {
+                    running = true;
+                    break;
+                }
+            }
+
+            AudioDevice device;
+            if (pcmName.empty()) device.name = cardName;
+            else if (cardName.empty()) device.name = pcmName;
+            else device.name = pcmName + " (" + cardName + ")";
+            device.isActive = running;
+            device.isOutput = wantOutput;
+            devices.push_back(device);
+        }
+    }
+    return devices;
+}
+
+vector<AudioDevice> ExtraInfo::get_output_devices()
+{
+    return read_alsa_devices(root, true);
+}
+
+vector<AudioDevice> ExtraInfo::get_input_devices()
+{
+    return read_alsa_devices(root, false);
+}
+
+/**
+ * Aggregates every supply under /sys/class/power_supply:
+ * Mains/USB "online" -> isACOnline, Battery capacity/status/energy_now/power_now -> the rest.
+ * Batteries that only report charge (charge_now/current_now, uAh/uA) are converted to
+ * energy with voltage_now; without a voltage they still get a charge-based runtime.
+ */
+PowerStatus ExtraInfo::get_power_status()
+{
+    PowerStatus status;
+    status.hasBattery = false;
+    status.batteryPercent = 0;
+    status.isACOnline = false;
+    status.isCharging = false;
+
+    string base = root + "/sys/class/power_supply";
+    long long energyNow = 0, energyFull = 0, powerNow = 0;
+    long long chargeNow = 0, currentNow = 0;     // charge-only batteries without voltage_now
+    int capacitySum = 0, batteries = 0, chargeOnly = 0;
+    bool discharging = false;
+
+    for (const auto& name : list_dir(base)) {
+        string dir = base + "/" + name;
+        string type = read_line(dir + "/type");
+
+        if (type == "Mains" || type == "USB") {
+            if (read_number(dir + "/online", 0) == 1) status.isACOnline = true;
+            continue;
+        }
+        if (type != "Battery") continue;
+        if (read_number(dir + "/present", 1) == 0) continue;
+        // Peripheral batteries (mice, headsets) report scope=Device
+        if (read_line(dir + "/scope") == "Device") continue;
+
+        batteries++;
+        status.hasBattery = true;
+
+        long long capacity = read_number(dir + "/capacity");
+        if (capacity >= 0) capacitySum += (int)capacity;
+
+        string state = read_line(dir + "/status");
+        if (state == "Charging") status.isCharging = true;
+        if (state == "Discharging") discharging = true;
+
+        // Some drivers report the discharge rate as a negative number
+        long long en = read_number(dir + "/energy_now");
+        long long ef = read_number(dir + "/energy_full");
+        long long pw = llabs(read_number(dir + "/power_now", 0));
+        if (en < 0) {
+            long long cn = read_number(dir + "/charge_now");
+            long long cf = read_number(dir + "/charge_full");
+            long long cur = llabs(read_number(dir + "/current_now", 0));
+            long long uv = read_number(dir + "/voltage_now");
+            if (uv > 0) {
+                // uAh * uV / 1e6 = uWh, uA * uV / 1e6 = uW
+                en = cn > 0 ? cn * uv / 1000000 : -1;
+                ef = cf > 0 ? cf * uv / 1000000 : -1;
+                pw = cur * uv / 1000000;
+            }
+            else {
+                chargeOnly++;
+                if (cn > 0) chargeNow += cn;
+                currentNow += cur;
+                continue;
+            }
+        }
+        if (en > 0) energyNow += en;
+        if (ef > 0) energyFull += ef;
+        if (pw > 0) powerNow += pw;
+    }
+
+    if (batteries > 0) {
+        // Prefer the energy-weighted figure when several batteries are present
+        if (batteries > 1 && energyFull > 0 && chargeOnly == 0) status.batteryPercent = (int)(energyNow * 100 / energyFull);
+        else status.batteryPercent = capacitySum / batteries;
+        if (status.batteryPercent > 100) status.batteryPercent = 100;
+    }
+
+    // Some firmware only exposes online on the battery side; infer AC from charging state
+    if (status.isCharging) status.isACOnline = true;
+
+    // Energy and bare charge can't be added up, so mixed packs without
+    // voltage_now get no estimate rather than one that ignores a battery
+    if (discharging && chargeOnly == 0 && powerNow > 0 && energyNow > 0) {
+        status.minutesRemaining = (int)(energyNow * 60 / powerNow);
+    }
+    else if (discharging && chargeOnly == batteries && currentNow > 0 && chargeNow > 0) {
+        status.minutesRemaining = (int)(chargeNow * 60 / currentNow);
+    }
+
+    return status;
+}
+
+#endif
+
 /*
 ================================================================================
                         END-OF-FILE DOCUMENTATION
@@ -350,6 +608,15 @@ STRUCTURES USED:
   * isACOnline: Whether AC power is connected
   * isCharging: Whether battery is charging
 
+LINUX BACKEND (non-_WIN32 builds):
+
+- Power: /sys/class/power_supply/<supply>/{type, online, present, scope, capacity,
+  status, energy_now, energy_full, power_now}, or for charge-reporting
+  batteries {charge_now, charge_full, current_now, voltage_now}
+- Audio: /proc/asound/cards, /proc/asound/card<N>/pcm<M>{p,c}/info and
+  sub<K>/status ("state: RUNNING" marks the device active)
+- Construct ExtraInfo with a root prefix to read a fixture tree instead
+
 COLOR CODES USED (for main.cpp reference):
 - 7  = Light Gray (Default)
 - 10 = Light Green (Active status)
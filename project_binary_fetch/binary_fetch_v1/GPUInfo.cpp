@@ -1,16 +1,16 @@
 ﻿#include "include\GPUInfo.h"
+#include "include\Probe.h"
 #include <windows.h> // Core Windows API (often sucks)
 #include <dxgi1_6.h> // DirectX Graphics Infrastructure (DXGI) for GPU enumeration
 #include <d3d12.h>  // Direct3D 12 (not directly used here, but often included with DXGI)
-#include <wbemidl.h> // WMI (Windows Management Instrumentation) for querying system info
 #include <comdef.h> // COM definitions and smart pointers
 #include <iostream> // if you don't know what is this, C'mon...get a life bro 
 #include <sstream>  // String stream for string manipulation
 #include "nvapi.h"  // NVIDIA NVAPI for NVIDIA-specific GPU info
+#include "include\WMIQuery.h" // Coalesced + cached WMI reads
 
 #pragma comment(lib, "dxgi.lib") // Link against DXGI library
 #pragma comment(lib, "d3d12.lib") // Link against Direct3D 12 library
-#pragma comment(lib, "wbemuuid.lib") // Link against WMI library
 #pragma comment(lib, "nvapi64.lib") // Link against NVAPI library
 
 using namespace std;
@@ -26,6 +26,20 @@ static string wstr_to_utf8(const wstring& w)
     return r;
 }
 
+// ----------------------------------------------------
+// WMI targets used below, registered up front by plan_wmi()
+static const char* const OHM_NAMESPACE = "ROOT\\OpenHardwareMonitor";
+static const char* const OHM_GPU_TEMPERATURE = "SensorType='Temperature' AND (Name LIKE '%GPU%' OR Parent LIKE '%GPU%')";
+static const char* const GPU_ENGINE_CLASS = "Win32_PerfFormattedData_GPUPerformanceCounters_GPUEngine";
+static const char* const GPU_ENGINE_3D = "Name LIKE '%_3D%'";
+
+void GPUInfo::plan_wmi()
+{
+    WMIQuery::want("Sensor", { "Value" }, OHM_GPU_TEMPERATURE, OHM_NAMESPACE);
+    WMIQuery::want("MSAcpi_ThermalZoneTemperature", { "CurrentTemperature" }, "", "ROOT\\WMI");
+    WMIQuery::want(GPU_ENGINE_CLASS, { "UtilizationPercentage" }, GPU_ENGINE_3D);
+}
+
 // ----------------------------------------------------
 // Helper: query WMI for GPU temperature (tries multiple methods)
 //
@@ -40,77 +54,18 @@ static string wstr_to_utf8(const wstring& w)
 //
 static float query_wmi_gpu_temperature()
 {
-    // Wake up COM (Windows' favorite pain generator)
-    HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
-    bool needsUninit = SUCCEEDED(hr);
-
-    // Security setup (Windows is paranoid for no reason)
-    hr = CoInitializeSecurity(NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL);
-
-    IWbemLocator* locator = nullptr;
-    IWbemServices* services = nullptr;
-
-    // Create WMI locator (if this fails, we’re already cooked)
-    hr = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&locator);
-    if (FAILED(hr)) {
-        if (needsUninit) CoUninitialize();
-        return -1.0f; // Bombed instantly 💥
-    }
-
     // ----------------------------------------------------
     // METHOD 1: OpenHardwareMonitor (the good path :)
     // Only works if user has OHM installed
     // This is the most accurate WMI-based option
     // ----------------------------------------------------
-    hr = locator->ConnectServer(_bstr_t(L"ROOT\\OpenHardwareMonitor"), NULL, NULL, 0, NULL, 0, 0, &services);
-    if (SUCCEEDED(hr))
+    for (const auto& row : WMIQuery::rows("Sensor", { "Value" }, OHM_GPU_TEMPERATURE, OHM_NAMESPACE))
     {
-        // Tell Windows: "Relax, we’re trusted" (it still doesn’t believe us)
-        CoSetProxyBlanket(services, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-            RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-
-        IEnumWbemClassObject* enumerator = nullptr;
-
-        // Ask for temperature sensors that look GPU-ish
-        hr = services->ExecQuery(
-            bstr_t("WQL"),
-            bstr_t(L"SELECT Value FROM Sensor WHERE SensorType='Temperature' AND (Name LIKE '%GPU%' OR Parent LIKE '%GPU%')"),
-            WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-            NULL,
-            &enumerator);
-
-        if (SUCCEEDED(hr))
-        {
-            IWbemClassObject* obj = nullptr;
-            ULONG returned = 0;
-
-            // Loop until we find a usable temperature
-            while (enumerator->Next(WBEM_INFINITE, 1, &obj, &returned) == S_OK && returned)
-            {
-                VARIANT val;
-                if (SUCCEEDED(obj->Get(L"Value", 0, &val, 0, 0)))
-                {
-                    // OHM usually gives clean numbers (thank you)
-                    float temp = (val.vt == VT_R8) ? (float)val.dblVal : (float)val.intVal;
-
-                    // Clean up ASAP and escape before Windows changes its mind
-                    VariantClear(&val);
-                    obj->Release();
-                    enumerator->Release();
-                    services->Release();
-                    locator->Release();
-                    if (needsUninit) CoUninitialize();
-                    return temp;
-                }
-                VariantClear(&val);
-                obj->Release();
-            }
-            if (enumerator) enumerator->Release();
-        }
-        services->Release();
+        // OHM usually gives clean numbers (thank you)
+        auto it = row.find("Value");
+        if (it == row.end()) continue;
+        try { return stof(it->second); }
+        catch (...) {}
     }
 
     // ----------------------------------------------------
@@ -122,55 +77,17 @@ static float query_wmi_gpu_temperature()
     // - Might be total nonsense
     // But hey, Windows gave us this… so we try.
     // ----------------------------------------------------
-    hr = locator->ConnectServer(_bstr_t(L"ROOT\\WMI"), NULL, NULL, 0, NULL, 0, 0, &services);
-    if (SUCCEEDED(hr))
+    string raw = WMIQuery::get("MSAcpi_ThermalZoneTemperature", "CurrentTemperature", "", "ROOT\\WMI");
+    try
     {
-        CoSetProxyBlanket(services, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-            RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-
-        IEnumWbemClassObject* enumerator = nullptr;
-        hr = services->ExecQuery(
-            bstr_t("WQL"),
-            bstr_t(L"SELECT CurrentTemperature FROM MSAcpi_ThermalZoneTemperature"),
-            WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-            NULL,
-            &enumerator);
-
-        if (SUCCEEDED(hr))
-        {
-            IWbemClassObject* obj = nullptr;
-            ULONG returned = 0;
-            if (enumerator->Next(WBEM_INFINITE, 1, &obj, &returned) == S_OK && returned)
-            {
-                VARIANT val;
-                if (SUCCEEDED(obj->Get(L"CurrentTemperature", 0, &val, 0, 0)))
-                {
-                    float temp = (val.vt == VT_R8) ? (float)val.dblVal : (float)val.intVal;
-
-                    // WMI returns temp in tenths of Kelvin (why???)
-                    if (temp > 2000.0f)
-                        temp = (temp / 10.0f) - 273.15f;
-
-                    // Clean up and pray this number makes sense
-                    VariantClear(&val);
-                    obj->Release();
-                    enumerator->Release();
-                    services->Release();
-                    locator->Release();
-                    if (needsUninit) CoUninitialize();
-                    return temp;
-                }
-                VariantClear(&val);
-                obj->Release();
-            }
-            if (enumerator) enumerator->Release();
-        }
-        services->Release();
-    }
+        float temp = stof(raw);
 
-    // Everything failed. Windows said NO.
-    locator->Release();
-    if (needsUninit) CoUninitialize();
+        // WMI returns temp in tenths of Kelvin (why???)
+        if (temp > 2000.0f)
+            temp = (temp / 10.0f) - 273.15f;
+        return temp;
+    }
+    catch (...) {}
 
     // Temperature unavailable → sucks
     return -1.0f;
@@ -188,99 +105,25 @@ static float query_wmi_gpu_temperature()
 // 2) Maybe
 // 3) Nope (bombed)
 // ----------------------------------------------------
-static bool query_wmi_float(const wchar_t* wql, const wchar_t* field, float& outVal)
+static bool query_wmi_float(const string& cls, const string& field, const string& where, float& outVal)
 {
-    // Wake up COM (Windows' ancient ritual begins)
-    HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
-    bool needsUninit = SUCCEEDED(hr);
-
-    // Security setup because Windows doesn't trust anyone, not even itself
-    hr = CoInitializeSecurity(NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL);
-
-    IWbemLocator* locator = nullptr;
-    IWbemServices* services = nullptr;
-
-    // Ask Windows for the WMI locator
-    // If this fails, everything after this is doomed :0
-    hr = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&locator);
-    if (FAILED(hr)) {
-        if (needsUninit) CoUninitialize();
-        return false; // Instant fail, no drama
-    }
-
-    // Connect to ROOT\\CIMV2 (the default WMI playground)
-    hr = locator->ConnectServer(_bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0, NULL, 0, 0, &services);
-
-    // Locator served its purpose, bye
-    locator->Release();
-
-    if (FAILED(hr)) {
-        if (needsUninit) CoUninitialize();
-        return false; // Connection failed, Windows said NO
-    }
-
-    // Tell Windows: "We’re cool, let us read data"
-    CoSetProxyBlanket(services, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-        RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-
-    IEnumWbemClassObject* enumerator = nullptr;
-
-    // Run the WQL query (this is where things usually explode)
-    hr = services->ExecQuery(
-        bstr_t("WQL"),
-        bstr_t(wql),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL,
-        &enumerator);
-
-    if (FAILED(hr)) {
-        services->Release();
-        if (needsUninit) CoUninitialize();
-        return false; // Query bombed
-    }
-
-    IWbemClassObject* obj = nullptr;
-    ULONG returned = 0;
-    bool ok = false;
-
-    // Loop through results (usually just one, but WMI loves loops)
-    while (enumerator &&
-        SUCCEEDED(enumerator->Next(WBEM_INFINITE, 1, &obj, &returned)) &&
-        returned)
+    // Served from WMIQuery's per-run cache: one SELECT per class, shared connection
+    for (const auto& row : WMIQuery::rows(cls, { field }, where))
     {
-        VARIANT val;
+        auto it = row.find(field);
+        if (it == row.end()) continue; // Field was useless, try next
 
-        // Try to extract the requested field
-        if (SUCCEEDED(obj->Get(field, 0, &val, 0, 0)) &&
-            (val.vt == VT_R8 || val.vt == VT_I4))
+        try
         {
             // Got the number! :)
-            outVal = (val.vt == VT_R8)
-                ? (float)val.dblVal
-                : (float)val.intVal;
-
-            ok = true;
-            VariantClear(&val);
-            obj->Release();
-            break; // Mission accomplished
+            outVal = stof(it->second);
+            return true;
         }
-
-        // Field was useless, try next
-        VariantClear(&val);
-        obj->Release();
+        catch (...) {}
     }
 
-    // Clean up everything before Windows gets angry
-    if (enumerator) enumerator->Release();
-    services->Release();
-    if (needsUninit) CoUninitialize();
-
-    // ok == true  → value retrieved :)
-    // ok == false → Windows trolled us :0
-    return ok;
+    // Windows trolled us :0
+    return false;
 }
 
 // ----------------------------------------------------
@@ -294,10 +137,7 @@ float GPUInfo::get_gpu_usage()
 
     // Query the 3D engine usage counter
     // This is where Windows *tries* to be honest
-    query_wmi_float(
-        L"SELECT UtilizationPercentage FROM Win32_PerfFormattedData_GPUPerformanceCounters_GPUEngine WHERE Name LIKE '%_3D%'",
-        L"UtilizationPercentage",
-        val);
+    query_wmi_float(GPU_ENGINE_CLASS, "UtilizationPercentage", GPU_ENGINE_3D, val);
 
     return val; // Percentage (hopefully)
 }
@@ -320,6 +160,7 @@ float GPUInfo::get_gpu_temperature()
 // So this is a semi-educated guess for known GPUs :)
 int GPUInfo::get_gpu_core_count()
 {
+    Probe::unrouted("DXGI / NvAPI (GPUInfo)");
     ID3D12Device* device = nullptr;
     IDXGIFactory4* factory = nullptr;
 
@@ -513,6 +354,7 @@ static float get_nvapi_frequency(NvPhysicalGpuHandle handle)
 // This is where everything comes together 🧠
 vector<gpu_data> GPUInfo::get_all_gpu_info()
 {
+    Probe::unrouted("DXGI / NvAPI (GPUInfo)");
     vector<gpu_data> list;
 
     IDXGIFactory6* factory = nullptr;
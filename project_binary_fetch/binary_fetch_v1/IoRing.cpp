@@ -0,0 +1,209 @@
+#include "include\IoRing.h"
+
+#include <cstring>
+#include <algorithm>
+
+#if !defined(_WIN32) && defined(BINARYFETCH_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+#if !defined(_WIN32) && defined(BINARYFETCH_IO_URING)
+
+// ----------------- Kernel interface -----------------
+
+namespace {
+    int ring_setup(unsigned entries, io_uring_params* params)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int ring_enter(int fd, unsigned submit, unsigned minComplete, unsigned flags)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, minComplete, flags, nullptr, 0));
+    }
+
+    // The kernel reads our tails and writes its heads (and the reverse for
+    // completions) concurrently: acquire what it published, release ours
+    unsigned load_acquire(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+    void store_release(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+}
+
+struct IoRing::Rings {
+    int fd = -1;
+    void* sqMap = MAP_FAILED;
+    size_t sqMapSize = 0;
+    void* cqMap = MAP_FAILED;
+    size_t cqMapSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned tail = 0;              // next free entry; published to sqTail by submit()
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cqMask = 0;
+
+    ~Rings()
+    {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapSize);
+        if (sqMap != MAP_FAILED) munmap(sqMap, sqMapSize);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+IoRing::IoRing(unsigned entries) : rings(new Rings())
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    Rings& r = *rings;
+    r.fd = ring_setup(max(entries, 1u), &params);
+    if (r.fd < 0) return;
+
+    r.sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    r.cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;     // 5.4+: one map for both rings
+    if (single) r.sqMapSize = r.cqMapSize = max(r.sqMapSize, r.cqMapSize);
+
+    r.sqMap = mmap(nullptr, r.sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQ_RING);
+    if (r.sqMap != MAP_FAILED) {
+        r.cqMap = single ? r.sqMap
+            : mmap(nullptr, r.cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_CQ_RING);
+    }
+    r.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    if (r.cqMap != MAP_FAILED) {
+        r.sqes = static_cast<io_uring_sqe*>(mmap(nullptr, r.sqesSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQES));
+    }
+    if (r.sqes == MAP_FAILED) {
+        rings.reset(new Rings());
+        return;
+    }
+
+    char* sq = static_cast<char*>(r.sqMap);
+    r.sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    r.sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    r.sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    r.sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    r.sqEntries = params.sq_entries;
+    r.tail = *r.sqTail;
+
+    char* cq = static_cast<char*>(r.cqMap);
+    r.cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    r.cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    r.cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    r.cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+}
+
+IoRing::~IoRing() = default;
+
+bool IoRing::ready() const
+{
+    return rings->sqes != MAP_FAILED;
+}
+
+unsigned IoRing::depth() const
+{
+    return ready() ? rings->sqEntries : 0;
+}
+
+bool IoRing::queue(uint8_t opcode, int fd, uint64_t addr, unsigned len, uint64_t offset, uint64_t tag)
+{
+    if (!ready()) return false;
+    Rings& r = *rings;
+    if (r.tail - load_acquire(r.sqHead) >= r.sqEntries) return false;
+
+    unsigned index = r.tail & r.sqMask;
+    io_uring_sqe* sqe = &r.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = addr;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = tag;
+    r.sqArray[index] = index;
+    r.tail++;
+    return true;
+}
+
+bool IoRing::read(int fd, void* buf, unsigned len, uint64_t offset, uint64_t tag)
+{
+    return queue(IORING_OP_READ, fd, reinterpret_cast<uintptr_t>(buf), len, offset, tag);
+}
+
+bool IoRing::write(int fd, const void* buf, unsigned len, uint64_t offset, uint64_t tag)
+{
+    return queue(IORING_OP_WRITE, fd, reinterpret_cast<uintptr_t>(buf), len, offset, tag);
+}
+
+int IoRing::submit(unsigned waitFor)
+{
+    if (!ready()) return -ENXIO;
+    Rings& r = *rings;
+    store_release(r.sqTail, r.tail);
+
+    // Without SQPOLL the kernel consumes entries inside io_uring_enter, so an
+    // interrupted call is retried with whatever it didn't take yet
+    int submitted = 0;
+    for (;;) {
+        unsigned pending = r.tail - load_acquire(r.sqHead);
+        int n = ring_enter(r.fd, pending, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0);
+        if (n >= 0) return submitted + n;
+        if (errno != EINTR) return -errno;
+        submitted += static_cast<int>(pending - (r.tail - load_acquire(r.sqHead)));
+    }
+}
+
+bool IoRing::peek(uint64_t& tag, int& result)
+{
+    if (!ready()) return false;
+    Rings& r = *rings;
+    unsigned head = *r.cqHead;
+    if (head == load_acquire(r.cqTail)) return false;
+
+    const io_uring_cqe& cqe = r.cqes[head & r.cqMask];
+    tag = cqe.user_data;
+    result = cqe.res;
+    store_release(r.cqHead, head + 1);
+    return true;
+}
+
+bool IoRing::wait(uint64_t& tag, int& result)
+{
+    while (!peek(tag, result)) {
+        if (!ready()) return false;
+        if (ring_enter(rings->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) return false;
+    }
+    return true;
+}
+
+#else
+
+// Not built with io_uring: every ring is unavailable and callers stay synchronous
+struct IoRing::Rings {};
+
+IoRing::IoRing(unsigned) : rings(new Rings()) {}
+IoRing::~IoRing() = default;
+bool IoRing::ready() const { return false; }
+unsigned IoRing::depth() const { return 0; }
+bool IoRing::queue(uint8_t, int, uint64_t, unsigned, uint64_t, uint64_t) { return false; }
+bool IoRing::read(int, void*, unsigned, uint64_t, uint64_t) { return false; }
+bool IoRing::write(int, const void*, unsigned, uint64_t, uint64_t) { return false; }
+int IoRing::submit(unsigned) { return -1; }
+bool IoRing::peek(uint64_t&, int&) { return false; }
+bool IoRing::wait(uint64_t&, int&) { return false; }
+
+#endif
@@ -0,0 +1,394 @@
+#include "include\MemoryBenchmark.h"
+#include "include\CPUTopology.h"
+#include "include\Probe.h"
+
+#include <new>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include <condition_variable>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MEMBENCH_X86 1
+#include <immintrin.h>
+// MSVC accepts any intrinsic anywhere; GCC / Clang want the ISA per function
+#ifdef _MSC_VER
+#define MEMBENCH_TARGET(isa)
+#else
+#define MEMBENCH_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+using namespace std;
+
+// ----------------- STREAM kernels -----------------
+
+namespace {
+    const uint64_t MiB = 1024ULL * 1024ULL;
+    const double SCALAR = 3.0;
+
+    // Copy c = a, Scale b = s*c, Add c = a + b, Triad a = b + s*c
+    struct Kernels {
+        const char* name;
+        void (*copy)(double* c, const double* a, size_t n);
+        void (*scale)(double* b, const double* c, double s, size_t n);
+        void (*add)(double* c, const double* a, const double* b, size_t n);
+        void (*triad)(double* a, const double* b, const double* c, double s, size_t n);
+    };
+
+    void copy_plain(double* c, const double* a, size_t n) { for (size_t i = 0; i < n; i++) c[i] = a[i]; }
+    void scale_plain(double* b, const double* c, double s, size_t n) { for (size_t i = 0; i < n; i++) b[i] = s * c[i]; }
+    void add_plain(double* c, const double* a, const double* b, size_t n) { for (size_t i = 0; i < n; i++) c[i] = a[i] + b[i]; }
+    void triad_plain(double* a, const double* b, const double* c, double s, size_t n) { for (size_t i = 0; i < n; i++) a[i] = b[i] + s * c[i]; }
+
+#ifdef MEMBENCH_X86
+    // Slices start on a 64-byte boundary, so aligned loads / stores are safe;
+    // the tail that doesn't fill a vector falls back to the plain loop
+
+    MEMBENCH_TARGET("avx2") void copy_avx2(double* c, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d x = _mm256_load_pd(a + i), y = _mm256_load_pd(a + i + 4);
+            _mm256_store_pd(c + i, x);
+            _mm256_store_pd(c + i + 4, y);
+        }
+        copy_plain(c + i, a + i, n - i);
+    }
+
+    MEMBENCH_TARGET("avx2") void scale_avx2(double* b, const double* c, double s, size_t n)
+    {
+        __m256d k = _mm256_set1_pd(s);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_store_pd(b + i, _mm256_mul_pd(k, _mm256_load_pd(c + i)));
+            _mm256_store_pd(b + i + 4, _mm256_mul_pd(k, _mm256_load_pd(c + i + 4)));
+        }
+        scale_plain(b + i, c + i, s, n - i);
+    }
+
+    MEMBENCH_TARGET("avx2") void add_avx2(double* c, const double* a, const double* b, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_store_pd(c + i, _mm256_add_pd(_mm256_load_pd(a + i), _mm256_load_pd(b + i)));
+            _mm256_store_pd(c + i + 4, _mm256_add_pd(_mm256_load_pd(a + i + 4), _mm256_load_pd(b + i + 4)));
+        }
+        add_plain(c + i, a + i, b + i, n - i);
+    }
+
+    MEMBENCH_TARGET("avx2") void triad_avx2(double* a, const double* b, const double* c, double s, size_t n)
+    {
+        __m256d k = _mm256_set1_pd(s);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_store_pd(a + i, _mm256_add_pd(_mm256_load_pd(b + i), _mm256_mul_pd(k, _mm256_load_pd(c + i))));
+            _mm256_store_pd(a + i + 4, _mm256_add_pd(_mm256_load_pd(b + i + 4), _mm256_mul_pd(k, _mm256_load_pd(c + i + 4))));
+        }
+        triad_plain(a + i, b + i, c + i, s, n - i);
+    }
+
+    MEMBENCH_TARGET("avx512f") void copy_avx512(double* c, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) _mm512_store_pd(c + i, _mm512_load_pd(a + i));
+        copy_plain(c + i, a + i, n - i);
+    }
+
+    MEMBENCH_TARGET("avx512f") void scale_avx512(double* b, const double* c, double s, size_t n)
+    {
+        __m512d k = _mm512_set1_pd(s);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) _mm512_store_pd(b + i, _mm512_mul_pd(k, _mm512_load_pd(c + i)));
+        scale_plain(b + i, c + i, s, n - i);
+    }
+
+    MEMBENCH_TARGET("avx512f") void add_avx512(double* c, const double* a, const double* b, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) _mm512_store_pd(c + i, _mm512_add_pd(_mm512_load_pd(a + i), _mm512_load_pd(b + i)));
+        add_plain(c + i, a + i, b + i, n - i);
+    }
+
+    MEMBENCH_TARGET("avx512f") void triad_avx512(double* a, const double* b, const double* c, double s, size_t n)
+    {
+        __m512d k = _mm512_set1_pd(s);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) _mm512_store_pd(a + i, _mm512_add_pd(_mm512_load_pd(b + i), _mm512_mul_pd(k, _mm512_load_pd(c + i))));
+        triad_plain(a + i, b + i, c + i, s, n - i);
+    }
+#endif
+
+    const Kernels& kernels()
+    {
+        static const Kernels plain = { "baseline", copy_plain, scale_plain, add_plain, triad_plain };
+#ifdef MEMBENCH_X86
+        static const Kernels avx2 = { "AVX2", copy_avx2, scale_avx2, add_avx2, triad_avx2 };
+        static const Kernels avx512 = { "AVX-512", copy_avx512, scale_avx512, add_avx512, triad_avx512 };
+
+        // CPUTopology only sets these when XCR0 says the OS saves the registers
+        const CpuFeatures& f = CPUTopology::get().features;
+        if (f.avx512f) return avx512;
+        if (f.avx2) return avx2;
+#endif
+        return plain;
+    }
+
+    struct AlignedFree {
+        void operator()(double* p) const { ::operator delete(p, align_val_t(64)); }
+    };
+    typedef unique_ptr<double, AlignedFree> Array;
+
+    Array alloc_array(size_t count)
+    {
+        return Array(static_cast<double*>(::operator new(count * sizeof(double), align_val_t(64), nothrow)));
+    }
+
+    uint64_t clamp_bytes(uint64_t value, uint64_t low, uint64_t high)
+    {
+        return value < low ? low : (value > high ? high : value);
+    }
+}
+
+// ----------------- Latency -----------------
+
+vector<pair<string, uint64_t>> MemoryBenchmark::workingSets()
+{
+    // Smallest and largest instance per level (P and E clusters differ),
+    // instruction caches left out
+    uint64_t smallest[4] = {}, largest[4] = {};
+    for (const auto& c : CPUTopology::get().caches) {
+        if (c.type == 'I' || c.level < 1 || c.level > 3 || c.sizeBytes == 0) continue;
+        if (!smallest[c.level] || c.sizeBytes < smallest[c.level]) smallest[c.level] = c.sizeBytes;
+        if (c.sizeBytes > largest[c.level]) largest[c.level] = c.sizeBytes;
+    }
+
+    // Well past the level below, well inside this one
+    auto between = [](uint64_t below, uint64_t level) {
+        return static_cast<uint64_t>(sqrt(static_cast<double>(below) * static_cast<double>(level))) & ~63ULL;
+    };
+
+    vector<pair<string, uint64_t>> sets;
+    if (smallest[1]) sets.push_back({ "L1", smallest[1] / 2 });
+    if (smallest[2] && largest[1]) sets.push_back({ "L2", between(largest[1], smallest[2]) });
+    if (smallest[3] && largest[2]) sets.push_back({ "L3", between(largest[2], smallest[3]) });
+
+    uint64_t last = largest[3] ? largest[3] : largest[2];
+    sets.push_back({ "DRAM", clamp_bytes(last * 4, 64 * MiB, 1024 * MiB) });
+    return sets;
+}
+
+double MemoryBenchmark::chase(uint64_t bytes, int durationMs)
+{
+    struct alignas(64) Line {
+        Line* next;
+    };
+
+    size_t count = static_cast<size_t>(bytes / sizeof(Line));
+    if (count < 16) count = 16;
+
+    vector<Line> lines;
+    vector<size_t> order;
+    try {
+        lines.resize(count);
+        order.resize(count);
+    }
+    catch (const bad_alloc&) {
+        return 0.0;
+    }
+
+    // Sattolo's shuffle: one cycle through every line, in random order
+    iota(order.begin(), order.end(), static_cast<size_t>(0));
+    mt19937_64 rng(0x9E3779B97F4A7C15ULL);
+    for (size_t i = count - 1; i > 0; i--) {
+        size_t j = static_cast<size_t>(rng() % i);
+        swap(order[i], order[j]);
+    }
+    for (size_t i = 0; i < count; i++) lines[i].next = &lines[order[i]];
+    order.clear();
+    order.shrink_to_fit();
+
+    // One lap to pull the working set into the level being measured
+    Line* p = &lines[0];
+    for (size_t i = 0; i < count; i++) p = p->next;
+
+    const int STEPS = 16384;
+    uint64_t loads = 0;
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::milliseconds(durationMs);
+    auto now = start;
+    do {
+        for (int i = 0; i < STEPS; i++) p = p->next;
+        loads += STEPS;
+        now = chrono::steady_clock::now();
+    } while (now < deadline);
+
+    // The cycle never reaches null; testing for it keeps the loads alive
+    if (p == nullptr) return 0.0;
+
+    return chrono::duration<double, nano>(now - start).count() / loads;
+}
+
+// ----------------- Bandwidth -----------------
+
+vector<MemBandwidthResult> MemoryBenchmark::stream(uint64_t arrayBytes, int threads, const vector<int>& cpus, int durationMs)
+{
+    vector<MemBandwidthResult> results;
+    if (threads < 1) threads = 1;
+
+    size_t n = static_cast<size_t>(arrayBytes / sizeof(double)) & ~static_cast<size_t>(7);
+    if (n < static_cast<size_t>(threads) * 8) return results;
+
+    Array a = alloc_array(n), b = alloc_array(n), c = alloc_array(n);
+    if (!a || !b || !c) return results;
+
+    const Kernels& k = kernels();
+
+    // Slice per worker, 64-byte aligned
+    auto slice = [&](int t, size_t& lo, size_t& hi) {
+        lo = (n * t / threads) & ~static_cast<size_t>(7);
+        hi = (t == threads - 1) ? n : (n * (t + 1) / threads) & ~static_cast<size_t>(7);
+    };
+
+    // Task 0 first-touches the worker's slice, 1-4 are the kernels
+    auto work = [&](int t, int task) {
+        size_t lo, hi;
+        slice(t, lo, hi);
+        double* pa = a.get() + lo;
+        double* pb = b.get() + lo;
+        double* pc = c.get() + lo;
+        size_t len = hi - lo;
+        switch (task) {
+        case 0:
+            for (size_t i = 0; i < len; i++) {
+                pa[i] = 1.0;
+                pb[i] = 2.0;
+                pc[i] = 0.0;
+            }
+            break;
+        case 1: k.copy(pc, pa, len); break;
+        case 2: k.scale(pb, pc, SCALAR, len); break;
+        case 3: k.add(pc, pa, pb, len); break;
+        case 4: k.triad(pa, pb, pc, SCALAR, len); break;
+        }
+    };
+
+    mutex m;
+    condition_variable wake, idle;
+    int task = 0, generation = 0, busy = 0;
+    bool quit = false;
+
+    vector<thread> team;
+    for (int t = 0; t < threads; t++) {
+        team.emplace_back([&, t]() {
+            if (t < static_cast<int>(cpus.size())) CPUTopology::pinThread(cpus[t]);
+            int seen = 0;
+            for (;;) {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&]() { return generation != seen || quit; });
+                if (quit) return;
+                seen = generation;
+                int job = task;
+                lock.unlock();
+
+                work(t, job);
+
+                lock.lock();
+                if (--busy == 0) idle.notify_one();
+            }
+        });
+    }
+
+    // Runs one task on every worker, returns the wall time it took
+    auto dispatch = [&](int job) {
+        auto start = chrono::steady_clock::now();
+        {
+            lock_guard<mutex> lock(m);
+            task = job;
+            busy = threads;
+            generation++;
+        }
+        wake.notify_all();
+        unique_lock<mutex> lock(m);
+        idle.wait(lock, [&]() { return busy == 0; });
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    dispatch(0);
+
+    const char* names[] = { "Copy", "Scale", "Add", "Triad" };
+    const double arrays[] = { 2.0, 2.0, 3.0, 3.0 };     // read + written per element
+    for (int kernel = 0; kernel < 4; kernel++) {
+        double best = 0.0;
+        int reps = 0;
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(durationMs);
+        while (reps < 3 || (reps < 100 && chrono::steady_clock::now() < deadline)) {
+            double seconds = dispatch(kernel + 1);
+            if (reps == 0 || seconds < best) best = seconds;
+            reps++;
+        }
+
+        MemBandwidthResult r;
+        r.kernel = names[kernel];
+        r.threads = threads;
+        r.mbps = best > 0.0 ? arrays[kernel] * sizeof(double) * n / best / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    {
+        lock_guard<mutex> lock(m);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& worker : team) worker.join();
+    return results;
+}
+
+string MemoryBenchmark::kernelName()
+{
+    return kernels().name;
+}
+
+// ----------------- Whole run -----------------
+
+MemBenchReport MemoryBenchmark::run(const MemBenchConfig& config)
+{
+    // Measurements can't be replayed
+    Probe::unrouted("MemoryBenchmark");
+    MemBenchReport report;
+    report.kernels = kernelName();
+
+    const CPUTopology& topology = CPUTopology::get();
+    vector<int> order = topology.pinOrder();
+
+    // Own thread, so pinning never leaks into the caller
+    thread latency([&]() {
+        if (!order.empty()) CPUTopology::pinThread(order[0]);
+        for (const auto& set : workingSets()) {
+            MemLatencyResult r;
+            r.level = set.first;
+            r.workingSet = set.second;
+            r.ns = chase(set.second, config.durationMs);
+            if (r.ns > 0.0) report.latency.push_back(r);
+        }
+    });
+    latency.join();
+
+    // STREAM's rule: every array at least 4x the last-level cache
+    uint64_t llc = topology.cacheBytes(3) ? topology.cacheBytes(3) : topology.cacheBytes(2);
+    report.arrayBytes = config.arrayMB ? config.arrayMB * MiB : clamp_bytes(llc * 4, 32 * MiB, 256 * MiB);
+
+    report.bandwidth = stream(report.arrayBytes, 1, order, config.durationMs);
+
+    // One thread per physical core: the first `cores` entries of pinOrder()
+    int cores = topology.ok && topology.cores > 0 ? topology.cores : static_cast<int>(thread::hardware_concurrency());
+    if (config.allCores && cores > 1) {
+        for (const auto& r : stream(report.arrayBytes, cores, order, config.durationMs)) report.bandwidth.push_back(r);
+    }
+    return report;
+}
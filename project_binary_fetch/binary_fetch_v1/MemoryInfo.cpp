@@ -1,228 +1,101 @@
 #include "include\MemoryInfo.h"
+#include "include\WMIQuery.h"
+#include "include\Probe.h"
 #include <windows.h>
-#include <comdef.h>
-#include <Wbemidl.h>
 #include <iostream>
 #include <iomanip>
 #include <string>
 using namespace std;
 
-#pragma comment(lib, "wbemuuid.lib")
-
 MemoryInfo::MemoryInfo() {
     fetchSystemMemory();
     fetchModulesInfo();
 }
 
 void MemoryInfo::fetchSystemMemory() {
-    MEMORYSTATUSEX status;
+    // Both byte counts go through Probe so --replay shows the recorded machine
+    MEMORYSTATUSEX status = {};
     status.dwLength = sizeof(status);
-    if (GlobalMemoryStatusEx(&status)) {
-        // Convert bytes to GB, rounding up to nearest GB
-        totalGB = static_cast<int>((status.ullTotalPhys + (1024 * 1024 * 1024) - 1) / (1024 * 1024 * 1024));
-        freeGB = static_cast<int>(status.ullAvailPhys / (1024 * 1024 * 1024));
-    }
-    else {
-        totalGB = 0;
-        freeGB = 0;
-    }
+    bool ok = false;
+    unsigned long long totalPhys = static_cast<unsigned long long>(Probe::number("mem:total-phys", [&]() -> double {
+        ok = GlobalMemoryStatusEx(&status) != 0;
+        return ok ? static_cast<double>(status.ullTotalPhys) : 0.0;
+    }));
+    unsigned long long availPhys = static_cast<unsigned long long>(Probe::number("mem:avail-phys", [&]() -> double {
+        return ok ? static_cast<double>(status.ullAvailPhys) : 0.0;
+    }));
+
+    // Convert bytes to GB, rounding up to nearest GB (0 / 0 when the call failed)
+    totalGB = static_cast<int>((totalPhys + (1024 * 1024 * 1024) - 1) / (1024 * 1024 * 1024));
+    freeGB = static_cast<int>(availPhys / (1024 * 1024 * 1024));
 }
 
-void MemoryInfo::fetchModulesInfo() {
-    // Initialize COM
-    HRESULT hres = CoInitializeEx(0, COINIT_MULTITHREADED);
-    if (FAILED(hres)) return;
-
-    hres = CoInitializeSecurity(
-        NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL
-    );
-    if (FAILED(hres)) {
-        CoUninitialize();
-        return;
-    }
-
-    IWbemLocator* pLoc = NULL;
-    hres = CoCreateInstance(
-        CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&pLoc
-    );
-    if (FAILED(hres)) {
-        CoUninitialize();
-        return;
-    }
-
-    IWbemServices* pSvc = NULL;
-    hres = pLoc->ConnectServer(
-        _bstr_t(L"ROOT\\CIMV2"),
-        NULL, NULL, 0, NULL, 0, 0, &pSvc
-    );
-    if (FAILED(hres)) {
-        pLoc->Release();
-        CoUninitialize();
-        return;
-    }
-
-    hres = CoSetProxyBlanket(
-        pSvc,
-        RPC_C_AUTHN_WINNT,
-        RPC_C_AUTHZ_NONE,
-        NULL,
-        RPC_C_AUTHN_LEVEL_CALL,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL,
-        EOAC_NONE
-    );
-    if (FAILED(hres)) {
-        pSvc->Release();
-        pLoc->Release();
-        CoUninitialize();
-        return;
+// SMBIOSMemoryType / MemoryType codes -> DDR generation
+static string memory_type_name(const string& code) {
+    int value = 0;
+    try { value = stoi(code); }
+    catch (...) { return "Unknown"; }
+
+    switch (value) {
+    case 26: return "DDR4";         // 0x1A
+    case 24: return "DDR3";         // 0x18
+    case 27: return "DDR5";         // 0x1B
+    case 20: return "DDR";          // 0x14
+    case 21: return "DDR2";         // 0x15
+    case 19: return "DDR2-FB-DIMM"; // 0x13
+    default: return "Unknown";
     }
+}
 
-    IEnumWbemClassObject* pEnumerator = NULL;
-    // Get more properties including SMBIOSMemoryType which is more reliable
-    hres = pSvc->ExecQuery(
-        bstr_t("WQL"),
-        bstr_t("SELECT Capacity, Speed, SMBIOSMemoryType, Manufacturer, PartNumber FROM Win32_PhysicalMemory"),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL, &pEnumerator
-    );
+// SMBIOSMemoryType is more reliable; MemoryType is the fallback
+static const vector<string> MODULE_FIELDS = {
+    "Capacity", "Speed", "SMBIOSMemoryType", "MemoryType", "Manufacturer", "PartNumber"
+};
 
-    if (FAILED(hres)) {
-        pSvc->Release();
-        pLoc->Release();
-        CoUninitialize();
-        return;
-    }
-
-    IWbemClassObject* pclsObj = NULL;
-    ULONG uReturn = 0;
+void MemoryInfo::planWmi() {
+    WMIQuery::want("Win32_PhysicalMemory", MODULE_FIELDS);
+}
 
-    while (pEnumerator) {
-        HRESULT hr = pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn);
-        if (0 == uReturn) break;
+void MemoryInfo::fetchModulesInfo() {
+    // One coalesced SELECT over the shared WMI connection (see WMIQuery.h)
+    vector<WMIRow> rows = WMIQuery::rows("Win32_PhysicalMemory", MODULE_FIELDS);
 
-        VARIANT vtProp;
+    for (const auto& row : rows) {
         MemoryModule module;
 
-        // Capacity in bytes -> GB
-        hr = pclsObj->Get(L"Capacity", 0, &vtProp, 0, 0);
-        if (SUCCEEDED(hr)) {
-            unsigned long long bytes = 0;
-            if (vtProp.vt == VT_BSTR) {
-                bytes = _wtoi64(vtProp.bstrVal);
-            }
-            else if (vtProp.vt == VT_I8 || vtProp.vt == VT_UI8) {
-                bytes = vtProp.ullVal;
-            }
-            else if (vtProp.vt == VT_I4 || vtProp.vt == VT_UI4) {
-                bytes = vtProp.uintVal;
-            }
-
-            if (bytes > 0) {
-                int gb = static_cast<int>(bytes / (1024 * 1024 * 1024));
-                // Handle cases where GB might not divide evenly
-                if (bytes % (1024 * 1024 * 1024) != 0) {
-                    gb++;  // Round up to nearest GB
-                }
-                module.capacity = to_string(gb) + "GB";
-            }
-            else {
-                module.capacity = "Unknown";
+        // Capacity in bytes (uint64, WMI hands it over as a string) -> GB
+        unsigned long long bytes = 0;
+        auto it = row.find("Capacity");
+        if (it != row.end()) {
+            try { bytes = stoull(it->second); }
+            catch (...) { bytes = 0; }
+        }
+        if (bytes > 0) {
+            int gb = static_cast<int>(bytes / (1024 * 1024 * 1024));
+            // Handle cases where GB might not divide evenly
+            if (bytes % (1024 * 1024 * 1024) != 0) {
+                gb++;  // Round up to nearest GB
             }
+            module.capacity = to_string(gb) + "GB";
         }
         else {
             module.capacity = "Unknown";
         }
-        VariantClear(&vtProp);
 
         // Speed
-        hr = pclsObj->Get(L"Speed", 0, &vtProp, 0, 0);
-        if (SUCCEEDED(hr)) {
-            if (vtProp.vt == VT_I4 || vtProp.vt == VT_UI4) {
-                module.speed = to_string(vtProp.uintVal) + " MHz";
-            }
-            else if (vtProp.vt == VT_BSTR) {
-                // Convert BSTR to string
-                wstring ws(vtProp.bstrVal);
-                string speedStr(ws.begin(), ws.end());
-                module.speed = speedStr + " MHz";
-            }
-            else {
-                module.speed = "Unknown MHz";
-            }
-        }
-        else {
-            module.speed = "Unknown MHz";
+        it = row.find("Speed");
+        module.speed = (it != row.end() && !it->second.empty()) ? it->second + " MHz" : "Unknown MHz";
+
+        // Try SMBIOSMemoryType first, fall back to MemoryType
+        it = row.find("SMBIOSMemoryType");
+        module.type = (it != row.end()) ? memory_type_name(it->second) : "Unknown";
+        if (module.type == "Unknown") {
+            it = row.find("MemoryType");
+            if (it != row.end()) module.type = memory_type_name(it->second);
         }
-        VariantClear(&vtProp);
-
-        // Try SMBIOSMemoryType first (more reliable)
-        hr = pclsObj->Get(L"SMBIOSMemoryType", 0, &vtProp, 0, 0);
-        if (SUCCEEDED(hr) && vtProp.vt != VT_NULL) {
-            switch (vtProp.uintVal) {
-            case 26: module.type = "DDR4"; break;        // 0x1A
-            case 24: module.type = "DDR3"; break;        // 0x18
-            case 27: module.type = "DDR5"; break;        // 0x1B
-            case 20: module.type = "DDR"; break;         // 0x14
-            case 21: module.type = "DDR2"; break;        // 0x15
-            case 19: module.type = "DDR2-FB-DIMM"; break;// 0x13
-
-            default:
-            {
-                VARIANT vtProp2;
-                HRESULT hr2 = pclsObj->Get(L"MemoryType", 0, &vtProp2, 0, 0);
-                if (SUCCEEDED(hr2) && vtProp2.vt != VT_NULL) {
-                    switch (vtProp2.uintVal) {
-                    case 24: module.type = "DDR3"; break;
-                    case 26: module.type = "DDR4"; break;
-                    case 20: module.type = "DDR"; break;
-                    case 21: module.type = "DDR2"; break;
-                    case 27: module.type = "DDR5"; break;
-                    default: module.type = "Unknown"; break;
-                    }
-                }
-                else {
-                    module.type = "Unknown";
-                }
-                VariantClear(&vtProp2);
-            }
-            break;
-            }
-        }
-
-        else {
-            // Fallback to MemoryType
-            VARIANT vtProp2;
-            hr = pclsObj->Get(L"MemoryType", 0, &vtProp2, 0, 0);
-            if (SUCCEEDED(hr) && vtProp2.vt != VT_NULL) {
-                switch (vtProp2.uintVal) {
-                case 24: module.type = "DDR3"; break;
-                case 26: module.type = "DDR4"; break;
-                case 20: module.type = "DDR"; break;
-                case 21: module.type = "DDR2"; break;
-                case 27: module.type = "DDR5"; break;
-                default: module.type = "Unknown"; break;
-                }
-            }
-            else {
-                module.type = "Unknown";
-            }
-            VariantClear(&vtProp2);
-        }
-        VariantClear(&vtProp);
 
         modules.push_back(module);
-        pclsObj->Release();
     }
-
-    pEnumerator->Release();
-    pSvc->Release();
-    pLoc->Release();
-    CoUninitialize();
 }
 
 int MemoryInfo::getTotal() const { return totalGB; }
@@ -0,0 +1,208 @@
+#include "include\NetActivity.h"
+#include "include\Probe.h"
+#include "include\PseudoFileReader.h"
+
+#include <map>
+#include <thread>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#endif
+
+using namespace std;
+
+namespace {
+    // Steady clock in ns, recorded with the counters: a replay divides the
+    // recorded deltas by the recorded window, not by however long it took
+    int64_t window_ns()
+    {
+        string ns = Probe::text("clock:net-activity", []() {
+            return to_string(chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count());
+        });
+        return strtoll(ns.c_str(), nullptr, 10);
+    }
+}
+
+// ----------------- Backend state -----------------
+
+#ifdef _WIN32
+
+namespace {
+    string narrow(const wchar_t* w)
+    {
+        int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+        if (len <= 1) return "";
+        string out(len - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, w, -1, &out[0], len, nullptr, nullptr);
+        return out;
+    }
+
+    // GetIfTable2 in /proc/net/dev layout (unused columns as 0)
+    string read_if_table()
+    {
+        return Probe::text("iphlp:GetIfTable2", []() -> string {
+            MIB_IF_TABLE2* table = nullptr;
+            if (GetIfTable2(&table) != NO_ERROR) return "";
+
+            ostringstream out;
+            out << "Inter-|   Receive                            |  Transmit\n"
+                << " face |bytes packets errs drop fifo frame compressed multicast|bytes packets errs drop fifo colls carrier compressed\n";
+            for (ULONG i = 0; i < table->NumEntries; ++i) {
+                const MIB_IF_ROW2& row = table->Table[i];
+                // Filter drivers show up as extra rows carrying the same traffic
+                if (row.Type == IF_TYPE_SOFTWARE_LOOPBACK || row.InterfaceAndOperStatusFlags.FilterInterface ||
+                    row.OperStatus != IfOperStatusUp) continue;
+
+                string name = narrow(row.Alias);
+                if (name.empty()) continue;
+                replace(name.begin(), name.end(), ':', '_');
+
+                out << name << ": "
+                    << row.InOctets << ' ' << (row.InUcastPkts + row.InNUcastPkts) << ' '
+                    << row.InErrors << ' ' << row.InDiscards << " 0 0 0 " << row.InNUcastPkts << ' '
+                    << row.OutOctets << ' ' << (row.OutUcastPkts + row.OutNUcastPkts) << ' '
+                    << row.OutErrors << ' ' << row.OutDiscards << " 0 0 0 0\n";
+            }
+            FreeMibTable(table);
+            return out.str();
+        });
+    }
+}
+
+struct NetActivity::Impl {
+    string baseline;
+    int64_t baselineNs = 0;
+};
+
+#else
+
+struct NetActivity::Impl {
+    PseudoFileReader reader;
+    int netdev = -1;
+    string baseline;
+    int64_t baselineNs = 0;
+    vector<string> interfaces;      // worth reporting
+
+    Impl()
+    {
+        netdev = reader.add("/proc/net/dev", 4096);
+
+        for (const auto& name : Probe::dir("/sys/class/net")) {
+            if (name == "lo") continue;
+            string state = Probe::file("/sys/class/net/" + name + "/operstate");
+            if (state.compare(0, 4, "down") == 0) continue;
+            interfaces.push_back(name);
+        }
+    }
+};
+
+#endif
+
+// ----------------- Sampling -----------------
+
+NetActivity::NetActivity() : impl(new Impl()) {}
+
+NetActivity::~NetActivity() = default;
+
+void NetActivity::begin()
+{
+#ifdef _WIN32
+    impl->baseline = read_if_table();
+#else
+    impl->reader.refresh();
+    impl->baseline = string(impl->reader.text(impl->netdev));
+#endif
+    impl->baselineNs = window_ns();
+    started = chrono::steady_clock::now();
+    begun = true;
+}
+
+vector<NetActivityStats> NetActivity::sample(int intervalMs)
+{
+    if (!begun) begin();
+
+    auto due = started + chrono::milliseconds(intervalMs);
+    if (chrono::steady_clock::now() < due && !Probe::replaying()) this_thread::sleep_until(due);
+
+#ifdef _WIN32
+    string after = read_if_table();
+    double seconds = (window_ns() - impl->baselineNs) / 1e9;
+    return diff(impl->baseline, after, seconds, {});
+#else
+    impl->reader.refresh();
+    double seconds = (window_ns() - impl->baselineNs) / 1e9;
+    return diff(impl->baseline, impl->reader.text(impl->netdev), seconds, impl->interfaces);
+#endif
+}
+
+// ----------------- /proc/net/dev -----------------
+
+vector<NetActivityStats> NetActivity::diff(string_view before, string_view after, double seconds,
+    const vector<string>& interfaces)
+{
+    //   name: rx bytes packets errs drop fifo frame compressed multicast
+    //         tx bytes packets errs drop fifo colls carrier compressed
+    // (two header lines first; old kernels glue the first counter to the colon)
+    auto parse = [](string_view text, vector<string>* order) {
+        map<string, vector<long long>> rows;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == string_view::npos) end = text.size();
+            string_view line = text.substr(pos, end - pos);
+            pos = end + 1;
+
+            size_t colon = line.rfind(':');
+            if (colon == string_view::npos) continue;
+            string_view name = line.substr(0, colon);
+            size_t first = name.find_first_not_of(" \t");
+            if (first == string_view::npos) continue;
+            name = name.substr(first);
+
+            vector<long long> fields;
+            PseudoFileReader::parseNumbers(line.substr(colon + 1), fields);
+            if (fields.size() < 16) continue;
+            rows[string(name)] = fields;
+            if (order) order->push_back(string(name));
+        }
+        return rows;
+    };
+
+    vector<NetActivityStats> stats;
+    if (seconds <= 0.0) return stats;
+
+    vector<string> order;
+    auto first = parse(before, nullptr);
+    auto second = parse(after, &order);
+    const vector<string>& names = interfaces.empty() ? order : interfaces;
+
+    for (const auto& name : names) {
+        auto b = first.find(name);
+        auto a = second.find(name);
+        if (b == first.end() || a == second.end()) continue;
+
+        // Counters only go up; a reset (interface re-created) shows as a negative delta
+        auto d = [&](size_t i) { long long v = a->second[i] - b->second[i]; return v < 0 ? 0ULL : static_cast<unsigned long long>(v); };
+        auto total = [&](size_t i) { return a->second[i] < 0 ? 0ULL : static_cast<unsigned long long>(a->second[i]); };
+
+        NetActivityStats s;
+        s.name = name;
+        s.rxBytesPerSec = d(0) / seconds;
+        s.rxPacketsPerSec = d(1) / seconds;
+        s.txBytesPerSec = d(8) / seconds;
+        s.txPacketsPerSec = d(9) / seconds;
+        s.errors = total(2) + total(10);
+        s.drops = total(3) + total(11);
+        s.newErrors = d(2) + d(10);
+        s.newDrops = d(3) + d(11);
+        stats.push_back(s);
+    }
+    return stats;
+}
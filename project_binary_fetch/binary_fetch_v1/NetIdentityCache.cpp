@@ -0,0 +1,351 @@
+#include "include\NetIdentityCache.h"
+#include "include\Probe.h"
+
+#include <map>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+// ----------------- State -----------------
+
+namespace {
+    struct Fact {
+        string value;
+        int64_t storedAt = 0;       // unix seconds
+    };
+
+    struct State {
+        mutex lock;
+        bool active = false;
+        string path;
+        int64_t ttl = 0;
+        string fingerprint;
+        map<string, map<string, Fact>> networks;    // fingerprint -> fact -> value
+        bool dirty = false;
+    };
+
+    State& state()
+    {
+        static State s;
+        return s;
+    }
+
+    int64_t unix_now()
+    {
+        return chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // IPv4 as-is, IPv6 as its /64, link-local skipped ("" = skip)
+    string address_key(const sockaddr* addr)
+    {
+        char text[INET6_ADDRSTRLEN] = {};
+        if (addr->sa_family == AF_INET) {
+            const sockaddr_in* v4 = reinterpret_cast<const sockaddr_in*>(addr);
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(&v4->sin_addr);
+            if (b[0] == 169 && b[1] == 254) return "";
+            return inet_ntop(AF_INET, &v4->sin_addr, text, sizeof(text)) ? text : "";
+        }
+        if (addr->sa_family == AF_INET6) {
+            in6_addr prefix = reinterpret_cast<const sockaddr_in6*>(addr)->sin6_addr;
+            unsigned char* b = reinterpret_cast<unsigned char*>(&prefix);
+            if (b[0] == 0xfe && (b[1] & 0xc0) == 0x80) return "";
+            memset(b + 8, 0, 8);
+            return inet_ntop(AF_INET6, &prefix, text, sizeof(text)) ? string(text) + "/64" : "";
+        }
+        return "";
+    }
+
+    // ----------------- Fingerprint -----------------
+
+#ifdef _WIN32
+    // GetIpNetEntry2 hands back raw bytes; /proc/net/arp already has the text
+    string mac_text(const unsigned char* bytes, size_t length)
+    {
+        ostringstream oss;
+        for (size_t i = 0; i < length; i++) {
+            if (i) oss << ':';
+            oss << hex << setw(2) << setfill('0') << static_cast<int>(bytes[i]);
+        }
+        return oss.str();
+    }
+
+    string read_fingerprint()
+    {
+        return Probe::text("iphlp:network-fingerprint", []() -> string {
+            // Best route to 0.0.0.0 = the default route
+            MIB_IPFORWARDROW route = {};
+            if (GetBestRoute(0, 0, &route) != NO_ERROR) return "";
+            DWORD index = route.dwForwardIfIndex;
+
+            in_addr hop;
+            hop.S_un.S_addr = route.dwForwardNextHop;
+            char gateway[INET_ADDRSTRLEN] = {};
+            inet_ntop(AF_INET, &hop, gateway, sizeof(gateway));
+
+            string mac;
+            MIB_IPNET_ROW2 neighbour = {};
+            neighbour.InterfaceIndex = index;
+            neighbour.Address.si_family = AF_INET;
+            neighbour.Address.Ipv4.sin_family = AF_INET;
+            neighbour.Address.Ipv4.sin_addr = hop;
+            if (GetIpNetEntry2(&neighbour) == NO_ERROR) mac = mac_text(neighbour.PhysicalAddress, neighbour.PhysicalAddressLength);
+
+            // dwLastChange = system up-time tick of the last oper-status change
+            MIB_IFROW link = {};
+            link.dwIndex = index;
+            string lastChange = GetIfEntry(&link) == NO_ERROR ? to_string(link.dwLastChange) : "";
+
+            vector<string> addresses;
+            MIB_UNICASTIPADDRESS_TABLE* table = nullptr;
+            if (GetUnicastIpAddressTable(AF_UNSPEC, &table) == NO_ERROR) {
+                for (ULONG i = 0; i < table->NumEntries; i++) {
+                    const MIB_UNICASTIPADDRESS_ROW& row = table->Table[i];
+                    if (row.InterfaceIndex != index) continue;
+                    string key = address_key(reinterpret_cast<const sockaddr*>(&row.Address));
+                    if (!key.empty()) addresses.push_back(key);
+                }
+                FreeMibTable(table);
+            }
+            sort(addresses.begin(), addresses.end());
+            addresses.erase(unique(addresses.begin(), addresses.end()), addresses.end());
+
+            string out = "if=" + to_string(index) + "|gw=" + gateway + "|mac=" + mac + "|link=" + lastChange + "|addr=";
+            for (size_t i = 0; i < addresses.size(); i++) out += (i ? "," : "") + addresses[i];
+            return out;
+        });
+    }
+#else
+    string read_fingerprint()
+    {
+        string iface, gateway;
+        if (!NetIdentityCache::parseDefaultRoute(Probe::file("/proc/net/route"), iface, gateway)) return "";
+        string mac = NetIdentityCache::parseGatewayMac(Probe::file("/proc/net/arp"), gateway, iface);
+
+        string carrier = Probe::file("/sys/class/net/" + iface + "/carrier_changes");
+        carrier.erase(carrier.find_last_not_of(" \n") + 1);
+
+        vector<string> addresses = Probe::list("ifaddrs:" + iface, [&]() {
+            vector<string> out;
+            ifaddrs* list = nullptr;
+            if (getifaddrs(&list) != 0) return out;
+            for (ifaddrs* a = list; a; a = a->ifa_next) {
+                if (!a->ifa_addr || iface != a->ifa_name) continue;
+                string key = address_key(a->ifa_addr);
+                if (!key.empty()) out.push_back(key);
+            }
+            freeifaddrs(list);
+            sort(out.begin(), out.end());
+            out.erase(unique(out.begin(), out.end()), out.end());
+            return out;
+        });
+
+        string out = "if=" + iface + "|gw=" + gateway + "|mac=" + mac + "|link=" + carrier + "|addr=";
+        for (size_t i = 0; i < addresses.size(); i++) out += (i ? "," : "") + addresses[i];
+        return out;
+    }
+#endif
+}
+
+// ----------------- Cache -----------------
+
+string NetIdentityCache::defaultPath()
+{
+#ifdef _WIN32
+    const char* local = getenv("LOCALAPPDATA");
+    if (local && *local) return string(local) + "\\BinaryFetch\\NetIdentityCache.json";
+    const char* profile = getenv("USERPROFILE");
+    return string(profile ? profile : ".") + "\\AppData\\Local\\BinaryFetch\\NetIdentityCache.json";
+#else
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) return string(xdg) + "/binaryfetch/net_identity_cache.json";
+    const char* home = getenv("HOME");
+    return string(home ? home : ".") + "/.cache/binaryfetch/net_identity_cache.json";
+#endif
+}
+
+void NetIdentityCache::begin(int64_t ttlSeconds, const string& path)
+{
+    // Snapshot runs must see (and record) every probe
+    if (Probe::mode() != Probe::Mode::Live) return;
+    begin(ttlSeconds, path, read_fingerprint());
+}
+
+void NetIdentityCache::begin(int64_t ttlSeconds, const string& path, const string& current)
+{
+    State& s = state();
+    lock_guard<mutex> guard(s.lock);
+    s.active = true;
+    s.path = path;
+    s.ttl = ttlSeconds;
+    s.fingerprint = current;
+    s.networks.clear();
+    s.dirty = false;
+
+    ifstream in(path, ios::binary);
+    if (!in) return;
+    try {
+        json doc = json::parse(in);
+        json networks = doc.value("networks", json::object());
+        for (auto& net : networks.items()) {
+            for (auto& f : net.value().items()) {
+                Fact fact;
+                fact.value = f.value().value("value", "");
+                fact.storedAt = f.value().value("stored_at", (int64_t)0);
+                s.networks[net.key()][f.key()] = fact;
+            }
+        }
+    }
+    catch (...) {
+        // Corrupt cache: start over, it gets rewritten on the next save
+        s.networks.clear();
+    }
+}
+
+bool NetIdentityCache::save()
+{
+    State& s = state();
+    lock_guard<mutex> guard(s.lock);
+    if (!s.active || !s.dirty) return true;
+
+    // Most recently used networks first; forget the stale tail
+    int64_t now = unix_now();
+    vector<pair<int64_t, string>> recent;
+    for (const auto& net : s.networks) {
+        int64_t newest = 0;
+        for (const auto& f : net.second) newest = max(newest, f.second.storedAt);
+        if (now - newest <= FORGET_AFTER_SECONDS) recent.push_back({ newest, net.first });
+    }
+    sort(recent.rbegin(), recent.rend());
+    if (recent.size() > MAX_NETWORKS) recent.resize(MAX_NETWORKS);
+
+    json networks = json::object();
+    for (const auto& r : recent) {
+        json facts = json::object();
+        for (const auto& f : s.networks[r.second]) {
+            facts[f.first] = { { "value", f.second.value }, { "stored_at", f.second.storedAt } };
+        }
+        networks[r.second] = facts;
+    }
+
+    error_code ec;
+    filesystem::create_directories(filesystem::path(s.path).parent_path(), ec);
+
+    ofstream out(s.path, ios::binary | ios::trunc);
+    if (!out) return false;
+    out << json{ { "version", 1 }, { "networks", networks } }.dump(1, ' ', false, json::error_handler_t::replace);
+    s.dirty = false;
+    return static_cast<bool>(out);
+}
+
+bool NetIdentityCache::lookup(const string& fact, string& value)
+{
+    State& s = state();
+    lock_guard<mutex> guard(s.lock);
+    if (!s.active || s.fingerprint.empty()) return false;
+
+    auto net = s.networks.find(s.fingerprint);
+    if (net == s.networks.end()) return false;
+    auto it = net->second.find(fact);
+    if (it == net->second.end()) return false;
+
+    int64_t age = unix_now() - it->second.storedAt;
+    if (age < 0 || age > s.ttl) return false;   // clock went backwards counts as stale
+    value = it->second.value;
+    return true;
+}
+
+void NetIdentityCache::store(const string& fact, const string& value)
+{
+    State& s = state();
+    lock_guard<mutex> guard(s.lock);
+    if (!s.active || s.fingerprint.empty()) return;
+
+    Fact& f = s.networks[s.fingerprint][fact];
+    f.value = value;
+    f.storedAt = unix_now();
+    s.dirty = true;
+}
+
+string NetIdentityCache::get(const string& fact, const function<string()>& fetch)
+{
+    string value;
+    if (lookup(fact, value)) return value;
+    value = fetch();
+    store(fact, value);
+    return value;
+}
+
+string NetIdentityCache::fingerprint()
+{
+    State& s = state();
+    lock_guard<mutex> guard(s.lock);
+    return s.fingerprint;
+}
+
+// ----------------- /proc/net parsing -----------------
+
+bool NetIdentityCache::parseDefaultRoute(const string& routeTable, string& iface, string& gateway)
+{
+    // Iface  Destination  Gateway  Flags  RefCnt  Use  Metric ... (hex, network byte order)
+    istringstream routes(routeTable);
+    string line;
+    unsigned long bestMetric = ~0UL;
+    iface.clear();
+    gateway.clear();
+    getline(routes, line);
+    while (getline(routes, line)) {
+        istringstream fields(line);
+        string name, destination, hop;
+        unsigned long flags = 0, refcnt = 0, use = 0, metric = 0;
+        if (!(fields >> name >> destination >> hop >> hex >> flags >> dec >> refcnt >> use >> metric)) continue;
+        if (destination != "00000000" || !(flags & 0x1) || metric >= bestMetric) continue;     // RTF_UP
+
+        in_addr addr;
+        addr.s_addr = static_cast<uint32_t>(strtoul(hop.c_str(), nullptr, 16));
+        char text[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &addr, text, sizeof(text));
+        iface = name;
+        gateway = text;
+        bestMetric = metric;
+    }
+    return !iface.empty();
+}
+
+string NetIdentityCache::parseGatewayMac(const string& arpTable, const string& gateway, const string& iface)
+{
+    // IP address  HW type  Flags  HW address  Mask  Device
+    string line, mac;
+    istringstream arp(arpTable);
+    getline(arp, line);
+    while (getline(arp, line)) {
+        istringstream fields(line);
+        string ip, type, flags, hw, mask, device;
+        if (!(fields >> ip >> type >> flags >> hw >> mask >> device)) continue;
+        if (ip == gateway && device == iface) mac = hw;
+    }
+    return mac;
+}
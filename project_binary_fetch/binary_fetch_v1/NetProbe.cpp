@@ -0,0 +1,1993 @@
+#include "include\NetProbe.h"
+#include "include\Probe.h"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <sstream>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#include <iphlpapi.h>
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "iphlpapi.lib")
+#else
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// ----------------- Sockets -----------------
+
+namespace {
+
+#ifdef _WIN32
+    typedef SOCKET socket_t;
+    const socket_t BAD_SOCKET = INVALID_SOCKET;
+    const int SEND_FLAGS = 0;
+
+    void close_socket(socket_t s) { closesocket(s); }
+    bool set_nonblocking(socket_t s) { u_long on = 1; return ioctlsocket(s, FIONBIO, &on) == 0; }
+    bool would_block() { int e = WSAGetLastError(); return e == WSAEWOULDBLOCK || e == WSAEINPROGRESS; }
+
+    // Never cleaned up: abandoned resolver workers may still be inside getaddrinfo
+    bool sockets_ready()
+    {
+        static bool ok = []() { WSADATA data; return WSAStartup(MAKEWORD(2, 2), &data) == 0; }();
+        return ok;
+    }
+#else
+    typedef int socket_t;
+    const socket_t BAD_SOCKET = -1;
+    const int SEND_FLAGS = MSG_NOSIGNAL;    // a peer reset must not raise SIGPIPE
+
+    void close_socket(socket_t s) { close(s); }
+    bool set_nonblocking(socket_t s) { int flags = fcntl(s, F_GETFL, 0); return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0; }
+    bool would_block() { return errno == EINPROGRESS || errno == EAGAIN || errno == EWOULDBLOCK; }
+    bool sockets_ready() { return true; }
+#endif
+
+    // Shared 64 KiB filler for upload bodies and /__down responses
+    const string& filler()
+    {
+        static const string block = []() {
+            string b(64 * 1024, '\0');
+            for (size_t i = 0; i < b.size(); i++) b[i] = static_cast<char>(i % 256);
+            return b;
+        }();
+        return block;
+    }
+
+    // ----------------- Readiness -----------------
+
+    enum : unsigned { WANT_READ = 1, WANT_WRITE = 2 };
+
+    struct Event {
+        size_t id = 0;
+        bool readable = false;      // data, EOF or hang-up
+        bool writable = false;
+        bool error = false;
+    };
+
+    class Poller {
+    public:
+#ifdef _WIN32
+        void set(socket_t s, size_t id, unsigned want) { watched[s] = { id, want }; }
+        void remove(socket_t s) { watched.erase(s); }
+
+        void wait(int timeoutMs, vector<Event>& events)
+        {
+            events.clear();
+            if (watched.empty()) {
+                this_thread::sleep_for(milliseconds(timeoutMs));
+                return;
+            }
+
+            vector<WSAPOLLFD> fds;
+            vector<size_t> ids;
+            for (const auto& kv : watched) {
+                WSAPOLLFD p = {};
+                p.fd = kv.first;
+                if (kv.second.second & WANT_READ) p.events |= POLLRDNORM;
+                if (kv.second.second & WANT_WRITE) p.events |= POLLWRNORM;
+                fds.push_back(p);
+                ids.push_back(kv.second.first);
+            }
+            if (WSAPoll(fds.data(), (ULONG)fds.size(), timeoutMs) <= 0) return;
+
+            for (size_t i = 0; i < fds.size(); i++) {
+                if (!fds[i].revents) continue;
+                Event e;
+                e.id = ids[i];
+                e.readable = (fds[i].revents & (POLLRDNORM | POLLHUP)) != 0;
+                e.writable = (fds[i].revents & POLLWRNORM) != 0;
+                e.error = (fds[i].revents & (POLLERR | POLLNVAL)) != 0;
+                events.push_back(e);
+            }
+        }
+
+    private:
+        map<socket_t, pair<size_t, unsigned>> watched;
+#else
+        Poller() : ep(epoll_create1(EPOLL_CLOEXEC)) {}
+        ~Poller() { if (ep >= 0) close(ep); }
+
+        void set(socket_t s, size_t id, unsigned want)
+        {
+            epoll_event ev = {};
+            ev.events = ((want & WANT_READ) ? (uint32_t)EPOLLIN : 0u) | ((want & WANT_WRITE) ? (uint32_t)EPOLLOUT : 0u);
+            ev.data.u64 = id;
+            if (epoll_ctl(ep, EPOLL_CTL_MOD, s, &ev) != 0) epoll_ctl(ep, EPOLL_CTL_ADD, s, &ev);
+        }
+
+        void remove(socket_t s) { epoll_ctl(ep, EPOLL_CTL_DEL, s, nullptr); }
+
+        void wait(int timeoutMs, vector<Event>& events)
+        {
+            events.clear();
+            epoll_event evs[64];
+            int n = epoll_wait(ep, evs, 64, timeoutMs);
+            for (int i = 0; i < n; i++) {
+                Event e;
+                e.id = static_cast<size_t>(evs[i].data.u64);
+                e.readable = (evs[i].events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) != 0;
+                e.writable = (evs[i].events & EPOLLOUT) != 0;
+                e.error = (evs[i].events & EPOLLERR) != 0;
+                events.push_back(e);
+            }
+        }
+
+    private:
+        int ep = -1;
+#endif
+    };
+
+    // ----------------- Resolution -----------------
+
+    struct Resolved {
+        mutex m;
+        condition_variable cv;
+        bool done = false;
+        vector<sockaddr_storage> addresses;
+        vector<socklen_t> lengths;
+        steady_clock::time_point finished;
+    };
+
+    // getaddrinfo blocks, so each host gets a detached worker the loop can walk away from
+    shared_ptr<Resolved> start_resolve(const string& host, const string& port)
+    {
+        auto pending = make_shared<Resolved>();
+        thread([pending, host, port]() {
+            vector<sockaddr_storage> addresses;
+            vector<socklen_t> lengths;
+
+            addrinfo hints = {};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* res = nullptr;
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) == 0) {
+                for (addrinfo* a = res; a; a = a->ai_next) {
+                    sockaddr_storage ss = {};
+                    memcpy(&ss, a->ai_addr, a->ai_addrlen);
+                    addresses.push_back(ss);
+                    lengths.push_back(static_cast<socklen_t>(a->ai_addrlen));
+                }
+                freeaddrinfo(res);
+            }
+
+            lock_guard<mutex> lock(pending->m);
+            pending->addresses = addresses;
+            pending->lengths = lengths;
+            pending->finished = steady_clock::now();
+            pending->done = true;
+            pending->cv.notify_all();
+            }).detach();
+        return pending;
+    }
+
+    struct Url {
+        bool ok = false;
+        string host;
+        string port = "80";
+        string path = "/";
+    };
+
+    // http://host[:port]/path, http://[v6]:port/path
+    Url parse_url(const string& url)
+    {
+        Url u;
+        const string scheme = "http://";
+        if (url.compare(0, scheme.size(), scheme) != 0) return u;
+
+        string rest = url.substr(scheme.size());
+        size_t slash = rest.find('/');
+        string hostPort = rest.substr(0, slash);
+        if (slash != string::npos) u.path = rest.substr(slash);
+
+        if (!hostPort.empty() && hostPort[0] == '[') {
+            size_t close = hostPort.find(']');
+            if (close == string::npos) return u;
+            u.host = hostPort.substr(1, close - 1);
+            if (close + 1 < hostPort.size() && hostPort[close + 1] == ':') u.port = hostPort.substr(close + 2);
+        }
+        else {
+            size_t colon = hostPort.rfind(':');
+            u.host = hostPort.substr(0, colon);
+            if (colon != string::npos) u.port = hostPort.substr(colon + 1);
+        }
+        u.ok = !u.host.empty() && !u.port.empty();
+        return u;
+    }
+
+    double ms_between(steady_clock::time_point a, steady_clock::time_point b)
+    {
+        return duration<double, milli>(b - a).count();
+    }
+
+    // Case-insensitive header lookup in a raw header block
+    string header_value(const string& headers, const string& name)
+    {
+        size_t pos = 0;
+        while ((pos = headers.find("\r\n", pos)) != string::npos) {
+            pos += 2;
+            if (headers.size() - pos < name.size() + 1) break;
+            bool match = true;
+            for (size_t i = 0; i < name.size() && match; i++) {
+                match = tolower(static_cast<unsigned char>(headers[pos + i])) == tolower(static_cast<unsigned char>(name[i]));
+            }
+            if (!match || headers[pos + name.size()] != ':') continue;
+
+            size_t start = headers.find_first_not_of(' ', pos + name.size() + 1);
+            size_t end = headers.find("\r\n", pos);
+            if (start == string::npos || start >= end) return "";
+            return headers.substr(start, end - start);
+        }
+        return "";
+    }
+
+    bool is_redirect(int status)
+    {
+        return status == 301 || status == 302 || status == 303 || status == 307 || status == 308;
+    }
+
+    // A redirect's Location, made absolute against the URL that answered.
+    // "" with why set when it can't be followed (https, missing, relative path).
+    string redirect_target(const Url& from, const string& head, string& why)
+    {
+        string location = header_value(head + "\r\n", "Location");
+        if (location.empty()) {
+            why = "redirect without a Location";
+            return "";
+        }
+        if (location.compare(0, 8, "https://") == 0) {
+            why = "redirected to " + location + " (no TLS: use a plain-HTTP endpoint)";
+            return "";
+        }
+        if (location.compare(0, 7, "http://") == 0) return location;
+        if (location[0] == '/') {
+            string host = from.host.find(':') != string::npos ? "[" + from.host + "]" : from.host;
+            if (from.port != "80") host += ":" + from.port;
+            return "http://" + host + location;
+        }
+        why = "unsupported redirect to " + location;
+        return "";
+    }
+
+    // Non-blocking connect to the first address (from index on) that takes it;
+    // index moves past the one returned so a failed handshake can try the next
+    socket_t start_connect(const Resolved& resolved, size_t& index)
+    {
+        while (index < resolved.addresses.size()) {
+            const sockaddr_storage& addr = resolved.addresses[index];
+            socklen_t len = resolved.lengths[index];
+            index++;
+
+            socket_t fd = socket(addr.ss_family, SOCK_STREAM, 0);
+            if (fd == BAD_SOCKET) continue;
+            if (set_nonblocking(fd) &&
+                (connect(fd, reinterpret_cast<const sockaddr*>(&addr), len) == 0 || would_block())) return fd;
+            close_socket(fd);
+        }
+        return BAD_SOCKET;
+    }
+
+    // Outcome of a non-blocking connect once the socket reports writable / error
+    bool connected(socket_t fd, const Event& ev)
+    {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len);
+        return err == 0 && !ev.error;
+    }
+
+    string request_head(const Url& url, const string& method, uint64_t bodyBytes)
+    {
+        string host = url.host.find(':') != string::npos ? "[" + url.host + "]" : url.host;
+        if (url.port != "80") host += ":" + url.port;
+
+        string head = method + " " + url.path + " HTTP/1.0\r\n"
+            "Host: " + host + "\r\n"
+            "User-Agent: BinaryFetch\r\n"
+            "Accept: */*\r\n";
+        if (method == "POST") {
+            head += "Content-Type: application/octet-stream\r\n"
+                "Content-Length: " + to_string(bodyBytes) + "\r\n";
+        }
+        return head + "Connection: close\r\n\r\n";
+    }
+
+    // Incremental response header parser
+    struct ResponseHead {
+        string raw;
+        bool done = false;
+        int status = 0;
+        int64_t contentLength = -1;
+
+        // Feeds one read. Once the header block is complete, body / bodyLen
+        // point at the body bytes of this read. false = header block too large.
+        bool feed(const char* data, size_t n, const char*& body, size_t& bodyLen)
+        {
+            body = data;
+            bodyLen = n;
+            if (done) return true;
+
+            bodyLen = 0;
+            raw.append(data, n);
+            size_t end = raw.find("\r\n\r\n");
+            if (end == string::npos) return raw.size() <= 64 * 1024;
+
+            // "HTTP/1.1 200 OK"
+            done = true;
+            size_t space = raw.find(' ');
+            if (space != string::npos) status = atoi(raw.c_str() + space + 1);
+            string length = header_value(raw.substr(0, end + 2), "Content-Length");
+            if (!length.empty()) contentLength = atoll(length.c_str());
+
+            size_t consumed = raw.size() - (end + 4);
+            body = data + (n - consumed);
+            bodyLen = consumed;
+            raw.resize(end);
+            return true;
+        }
+    };
+
+    // ----------------- Client -----------------
+
+    enum class Stage { Connecting, Sending, Receiving, Done };
+
+    struct Conn {
+        const NetRequest* request = nullptr;
+        Url url;
+        NetResult result;
+        shared_ptr<Resolved> resolved;
+
+        Stage stage = Stage::Done;
+        socket_t fd = BAD_SOCKET;
+        size_t addressIndex = 0;
+
+        string head;
+        size_t headSent = 0;
+        ResponseHead response;
+        string redirect;            // http:// URL to follow next ("" = none)
+
+        steady_clock::time_point connectStart;
+        steady_clock::time_point requestStart;
+    };
+
+    class Engine {
+    public:
+        explicit Engine(vector<Conn>& conns) : conns(conns) {}
+
+        void connect_next(size_t id)
+        {
+            Conn& c = conns[id];
+            c.connectStart = steady_clock::now();
+            c.fd = start_connect(*c.resolved, c.addressIndex);
+            if (c.fd == BAD_SOCKET) {
+                finish(id, "connect failed");
+                return;
+            }
+            c.stage = Stage::Connecting;
+            poller.set(c.fd, id, WANT_WRITE);
+        }
+
+        void on_event(size_t id, const Event& ev)
+        {
+            Conn& c = conns[id];
+            if (c.stage == Stage::Connecting && (ev.writable || ev.error)) {
+                if (!connected(c.fd, ev)) {
+                    // Next address (IPv4 after a dead IPv6 route, ...)
+                    poller.remove(c.fd);
+                    close_socket(c.fd);
+                    c.fd = BAD_SOCKET;
+                    connect_next(id);
+                    return;
+                }
+                c.result.connectMs = ms_between(c.connectStart, steady_clock::now());
+                begin_request(c);
+            }
+            if (c.stage == Stage::Sending && ev.writable) send_more(id);
+            if (c.stage == Stage::Receiving && (ev.readable || ev.error)) receive_more(id);
+        }
+
+        void finish(size_t id, const string& error)
+        {
+            Conn& c = conns[id];
+            if (c.fd != BAD_SOCKET) {
+                poller.remove(c.fd);
+                close_socket(c.fd);
+                c.fd = BAD_SOCKET;
+            }
+            if (c.stage == Stage::Sending || c.stage == Stage::Receiving) {
+                c.result.transferMs = ms_between(c.requestStart, steady_clock::now());
+            }
+            c.result.error = error;
+            c.result.ok = error.empty() && c.result.status >= 200 && c.result.status < 300;
+            if (error.empty() && !c.result.ok) c.result.error = "HTTP " + to_string(c.result.status);
+            if (error.empty() && is_redirect(c.result.status)) {
+                string why;
+                c.redirect = redirect_target(c.url, c.response.raw, why);
+                if (c.redirect.empty()) c.result.error = why;
+            }
+            c.stage = Stage::Done;
+        }
+
+        Poller poller;
+
+    private:
+        vector<Conn>& conns;
+
+        void begin_request(Conn& c)
+        {
+            c.head = request_head(c.url, c.request->method, c.request->uploadBytes);
+            c.stage = Stage::Sending;
+            c.requestStart = steady_clock::now();
+        }
+
+        void send_more(size_t id)
+        {
+            Conn& c = conns[id];
+            const string& fill = filler();
+
+            for (;;) {
+                const char* data;
+                size_t len;
+                if (c.headSent < c.head.size()) {
+                    data = c.head.data() + c.headSent;
+                    len = c.head.size() - c.headSent;
+                }
+                else if (c.result.bytesSent < c.request->uploadBytes) {
+                    data = fill.data();
+                    len = static_cast<size_t>(min<uint64_t>(fill.size(), c.request->uploadBytes - c.result.bytesSent));
+                }
+                else {
+                    c.stage = Stage::Receiving;
+                    poller.set(c.fd, id, WANT_READ);
+                    return;
+                }
+
+                int n = send(c.fd, data, static_cast<int>(len), SEND_FLAGS);
+                if (n < 0) {
+                    if (!would_block()) finish(id, "send failed");
+                    return;
+                }
+                if (c.headSent < c.head.size()) c.headSent += n;
+                else c.result.bytesSent += n;
+            }
+        }
+
+        void receive_more(size_t id)
+        {
+            Conn& c = conns[id];
+            char buf[64 * 1024];
+
+            for (;;) {
+                int n = recv(c.fd, buf, sizeof(buf), 0);
+                if (n < 0) {
+                    if (!would_block()) finish(id, "receive failed");
+                    return;
+                }
+                if (n == 0) {
+                    // Without a Content-Length the body ends at EOF
+                    bool complete = c.response.done && (c.response.contentLength < 0 || (int64_t)c.result.bytesReceived >= c.response.contentLength);
+                    finish(id, complete ? "" : "connection closed early");
+                    return;
+                }
+
+                bool hadHead = c.response.done;
+                const char* body;
+                size_t bodyLen;
+                if (!c.response.feed(buf, n, body, bodyLen)) {
+                    finish(id, "bad response");
+                    return;
+                }
+                if (!c.response.done) continue;
+                if (!hadHead) {
+                    c.result.firstByteMs = ms_between(c.requestStart, steady_clock::now());
+                    c.result.status = c.response.status;
+                }
+
+                c.result.bytesReceived += bodyLen;
+                if (c.result.body.size() < c.request->captureLimit) {
+                    c.result.body.append(body, min(bodyLen, c.request->captureLimit - c.result.body.size()));
+                }
+
+                if (c.response.contentLength >= 0 && (int64_t)c.result.bytesReceived >= c.response.contentLength) {
+                    finish(id, "");
+                    return;
+                }
+            }
+        }
+    };
+}
+
+// ----------------- NetProbe -----------------
+
+// One pass over the requests; redirects[i] is where request i was sent on to
+vector<NetResult> NetProbe::runBatch(const vector<NetRequest>& requests, int timeoutMs, vector<string>& redirects)
+{
+    vector<Conn> conns(requests.size());
+    redirects.assign(requests.size(), "");
+    if (!sockets_ready()) {
+        vector<NetResult> results(requests.size());
+        for (auto& r : results) r.error = "sockets unavailable";
+        return results;
+    }
+
+    auto start = steady_clock::now();
+    auto deadline = start + milliseconds(timeoutMs > 0 ? timeoutMs : 1);
+
+    // 1. Resolve every distinct host:port at once
+    map<string, shared_ptr<Resolved>> byHost;
+    for (size_t i = 0; i < requests.size(); i++) {
+        Conn& c = conns[i];
+        c.request = &requests[i];
+        c.url = parse_url(requests[i].url);
+        if (!c.url.ok) {
+            c.result.error = "unsupported URL";
+            continue;
+        }
+        auto& pending = byHost[c.url.host + "|" + c.url.port];
+        if (!pending) pending = start_resolve(c.url.host, c.url.port);
+        c.resolved = pending;
+    }
+
+    for (auto& kv : byHost) {
+        unique_lock<mutex> lock(kv.second->m);
+        kv.second->cv.wait_until(lock, deadline, [&]() { return kv.second->done; });
+    }
+
+    // 2. Connect, send and receive everything from one loop
+    Engine engine(conns);
+    for (size_t i = 0; i < conns.size(); i++) {
+        Conn& c = conns[i];
+        if (!c.resolved) continue;
+
+        bool done;
+        {
+            lock_guard<mutex> lock(c.resolved->m);
+            done = c.resolved->done;
+            if (done) c.result.resolveMs = ms_between(start, c.resolved->finished);
+        }
+        if (!done) {
+            c.result.timedOut = true;
+            c.result.error = "timed out resolving " + c.url.host;
+            c.resolved.reset();
+            continue;
+        }
+        if (c.resolved->addresses.empty()) {
+            c.result.error = "could not resolve " + c.url.host;
+            continue;
+        }
+        engine.connect_next(i);
+    }
+
+    vector<Event> events;
+    for (;;) {
+        bool active = false;
+        for (const auto& c : conns) active = active || c.stage != Stage::Done;
+        if (!active) break;
+
+        auto now = steady_clock::now();
+        if (now >= deadline) break;
+        int wait = static_cast<int>(duration_cast<milliseconds>(deadline - now).count()) + 1;
+
+        engine.poller.wait(wait, events);
+        for (const auto& ev : events) {
+            if (ev.id < conns.size() && conns[ev.id].stage != Stage::Done) engine.on_event(ev.id, ev);
+        }
+    }
+
+    // 3. Whatever is still running missed the deadline
+    vector<NetResult> results;
+    for (size_t i = 0; i < conns.size(); i++) {
+        if (conns[i].stage != Stage::Done) {
+            engine.finish(i, "timed out");
+            conns[i].result.ok = false;
+            conns[i].result.timedOut = true;
+        }
+        results.push_back(conns[i].result);
+        redirects[i] = conns[i].redirect;
+    }
+    return results;
+}
+
+vector<NetResult> NetProbe::run(const vector<NetRequest>& requests, int timeoutMs)
+{
+    auto deadline = steady_clock::now() + milliseconds(timeoutMs > 0 ? timeoutMs : 1);
+    vector<string> redirects;
+    vector<NetResult> results = runBatch(requests, timeoutMs, redirects);
+
+    // Every request that was redirected goes again, all together, inside the same deadline
+    vector<size_t> pending;
+    for (size_t i = 0; i < results.size(); i++) if (!redirects[i].empty()) pending.push_back(i);
+    for (int hop = 1; hop <= MAX_REDIRECTS && !pending.empty(); hop++) {
+        int left = static_cast<int>(duration_cast<milliseconds>(deadline - steady_clock::now()).count());
+        if (left <= 0) break;
+
+        vector<NetRequest> next;
+        for (size_t i : pending) {
+            NetRequest r = requests[i];
+            r.url = redirects[i];
+            if (results[i].status == 303) {
+                r.method = "GET";
+                r.uploadBytes = 0;
+            }
+            next.push_back(r);
+        }
+        vector<string> nextRedirects;
+        vector<NetResult> hopResults = runBatch(next, left, nextRedirects);
+
+        vector<size_t> still;
+        for (size_t k = 0; k < pending.size(); k++) {
+            size_t i = pending[k];
+            results[i] = hopResults[k];
+            results[i].redirects = hop;
+            redirects[i] = nextRedirects[k];
+            if (!redirects[i].empty()) still.push_back(i);
+        }
+        pending = still;
+    }
+    for (size_t i : pending) results[i].error = "stopped following redirects at " + redirects[i];
+    return results;
+}
+
+// ----------------- Throughput -----------------
+
+namespace {
+    // One of the parallel streams; re-requests whenever a transfer ends
+    struct Stream {
+        socket_t fd = BAD_SOCKET;
+        Stage stage = Stage::Done;
+        size_t addressIndex = 0;
+        string head;
+        size_t headSent = 0;
+        ResponseHead response;
+        uint64_t requestBytes = 0;  // payload moved by the current request
+        uint64_t totalBytes = 0;    // payload moved by all requests (what gets sampled)
+        bool everConnected = false;
+        bool failed = false;
+        string error;
+    };
+
+    struct Snapshot {
+        double ms = 0.0;
+        vector<uint64_t> bytes;     // per stream, cumulative
+    };
+}
+
+// One attempt on config.url; redirect = where the server sent the streams instead
+ThroughputResult NetProbe::measure(const ThroughputConfig& config, string& redirect)
+{
+    ThroughputResult result;
+    Url url = parse_url(config.url);
+    if (!url.ok) {
+        result.error = "unsupported URL";
+        return result;
+    }
+    if (!sockets_ready()) {
+        result.error = "sockets unavailable";
+        return result;
+    }
+
+    auto start = steady_clock::now();
+    auto deadline = start + milliseconds(max(1, config.maxDurationMs));
+    const string method = config.upload ? "POST" : "GET";
+    const int sampleMs = max(10, config.sampleMs);
+    const size_t window = static_cast<size_t>(max(2, config.windowSamples));
+
+    shared_ptr<Resolved> resolved = start_resolve(url.host, url.port);
+    {
+        unique_lock<mutex> lock(resolved->m);
+        if (!resolved->cv.wait_until(lock, deadline, [&]() { return resolved->done; })) {
+            result.error = "timed out resolving " + url.host;
+            return result;
+        }
+    }
+    if (resolved->addresses.empty()) {
+        result.error = "could not resolve " + url.host;
+        return result;
+    }
+
+    Poller poller;
+    vector<Stream> streams(max(1, config.streams));
+
+    auto close_stream = [&](Stream& st) {
+        if (st.fd == BAD_SOCKET) return;
+        poller.remove(st.fd);
+        close_socket(st.fd);
+        st.fd = BAD_SOCKET;
+    };
+
+    // (Re)connects; on a fresh stream this walks the address list
+    auto open_stream = [&](size_t id) {
+        Stream& st = streams[id];
+        close_stream(st);
+        if (st.everConnected) st.addressIndex = 0;
+        st.fd = start_connect(*resolved, st.addressIndex);
+        if (st.fd == BAD_SOCKET) {
+            st.failed = true;
+            st.error = "connect failed";
+            st.stage = Stage::Done;
+            return;
+        }
+        st.stage = Stage::Connecting;
+        poller.set(st.fd, id, WANT_WRITE);
+    };
+
+    // A transfer ended: a good one is followed by the next request
+    auto end_request = [&](size_t id, const string& error) {
+        Stream& st = streams[id];
+        close_stream(st);
+        bool good = error.empty() && st.response.status >= 200 && st.response.status < 300;
+        if (!good) {
+            st.failed = true;
+            st.error = !error.empty() ? error : "HTTP " + to_string(st.response.status);
+            if (error.empty() && is_redirect(st.response.status) && redirect.empty()) {
+                string why;
+                redirect = redirect_target(url, st.response.raw, why);
+                if (redirect.empty()) st.error = why;
+            }
+            st.stage = Stage::Done;
+            return;
+        }
+        open_stream(id);
+    };
+
+    auto receive = [&](size_t id) {
+        Stream& st = streams[id];
+        char buf[64 * 1024];
+        for (;;) {
+            int n = recv(st.fd, buf, sizeof(buf), 0);
+            if (n < 0) {
+                if (!would_block()) end_request(id, "receive failed");
+                return;
+            }
+            if (n == 0) {
+                bool complete = st.response.done && (config.upload || st.response.contentLength < 0 ||
+                    (int64_t)st.requestBytes >= st.response.contentLength);
+                end_request(id, complete ? "" : "connection closed early");
+                return;
+            }
+
+            const char* body;
+            size_t bodyLen;
+            if (!st.response.feed(buf, n, body, bodyLen)) {
+                end_request(id, "bad response");
+                return;
+            }
+            if (!st.response.done) continue;
+
+            // An upload only gets its (small) response after the whole body
+            if (config.upload && st.stage == Stage::Sending) {
+                end_request(id, is_redirect(st.response.status) ? "" : "upload rejected");
+                return;
+            }
+            if (!config.upload) {
+                st.requestBytes += bodyLen;
+                // A redirect's body isn't payload
+                if (st.response.status >= 200 && st.response.status < 300) st.totalBytes += bodyLen;
+            }
+            if (st.response.contentLength >= 0 && (int64_t)(config.upload ? 0 : st.requestBytes) >= st.response.contentLength) {
+                end_request(id, "");
+                return;
+            }
+        }
+    };
+
+    auto send_more = [&](size_t id) {
+        Stream& st = streams[id];
+        const string& fill = filler();
+        for (;;) {
+            const char* data;
+            size_t len;
+            if (st.headSent < st.head.size()) {
+                data = st.head.data() + st.headSent;
+                len = st.head.size() - st.headSent;
+            }
+            else if (config.upload && st.requestBytes < config.uploadBytes) {
+                data = fill.data();
+                len = static_cast<size_t>(min<uint64_t>(fill.size(), config.uploadBytes - st.requestBytes));
+            }
+            else {
+                st.stage = Stage::Receiving;
+                poller.set(st.fd, id, WANT_READ);
+                return;
+            }
+
+            int n = send(st.fd, data, static_cast<int>(len), SEND_FLAGS);
+            if (n < 0) {
+                if (!would_block()) end_request(id, "send failed");
+                return;
+            }
+            if (st.headSent < st.head.size()) {
+                st.headSent += n;
+            }
+            else {
+                st.requestBytes += n;
+                st.totalBytes += n;
+            }
+        }
+    };
+
+    auto on_event = [&](size_t id, const Event& ev) {
+        Stream& st = streams[id];
+        if (st.stage == Stage::Connecting && (ev.writable || ev.error)) {
+            if (!connected(st.fd, ev)) {
+                open_stream(id);    // next address, if any
+                return;
+            }
+            st.everConnected = true;
+            st.head = request_head(url, method, config.uploadBytes);
+            st.headSent = 0;
+            st.requestBytes = 0;
+            st.response = ResponseHead();
+            st.stage = Stage::Sending;
+            // Uploads also listen, so an early error response or reset ends the stream
+            poller.set(st.fd, id, config.upload ? (WANT_READ | WANT_WRITE) : WANT_WRITE);
+        }
+        if (st.stage == Stage::Sending && (ev.readable || ev.error) && config.upload) {
+            receive(id);
+            if (st.stage != Stage::Sending) return;
+        }
+        if (st.stage == Stage::Sending && ev.writable) send_more(id);
+        if (st.stage == Stage::Receiving && (ev.readable || ev.error)) receive(id);
+    };
+
+    for (size_t i = 0; i < streams.size(); i++) open_stream(i);
+
+    // Sample, look for steady state, measure
+    vector<Snapshot> history;
+    history.push_back({ 0.0, vector<uint64_t>(streams.size(), 0) });
+    vector<double> rates;               // aggregate Mbps per sample interval
+    size_t measureFrom = SIZE_MAX;      // history index where measurement starts
+    size_t measureTo = SIZE_MAX;
+    auto nextSample = start + milliseconds(sampleMs);
+    vector<Event> events;
+
+    for (;;) {
+        auto now = steady_clock::now();
+        uint64_t moved = 0;
+        for (const auto& st : streams) moved += st.totalBytes;
+        bool full = config.maxBytes > 0 && moved >= config.maxBytes;
+
+        if (now >= nextSample || full) {
+            Snapshot snap;
+            snap.ms = ms_between(start, now);
+            for (const auto& st : streams) snap.bytes.push_back(st.totalBytes);
+
+            const Snapshot& prev = history.back();
+            uint64_t delta = 0;
+            for (size_t i = 0; i < streams.size(); i++) delta += snap.bytes[i] - prev.bytes[i];
+            rates.push_back(megabitsPerSecond(delta, snap.ms - prev.ms));
+            history.push_back(snap);
+            nextSample += milliseconds(sampleMs);
+
+            size_t last = history.size() - 1;
+            if (measureFrom == SIZE_MAX && rates.size() >= window && history[last - window].ms >= config.warmupMs) {
+                auto first = rates.end() - window;
+                double lo = *min_element(first, rates.end());
+                double hi = *max_element(first, rates.end());
+                double mean = 0.0;
+                for (auto it = first; it != rates.end(); ++it) mean += *it;
+                mean /= window;
+                if (lo > 0.0 && (hi - lo) / mean <= config.tolerance) {
+                    measureFrom = last;
+                    result.steady = true;
+                }
+            }
+            if (measureFrom != SIZE_MAX && snap.ms - history[measureFrom].ms >= config.measureMs) {
+                measureTo = last;
+                break;
+            }
+            // Byte budget spent: whatever was measured so far is the answer
+            if (full) {
+                if (measureFrom != SIZE_MAX && measureFrom < last) measureTo = last;
+                result.capped = true;
+                break;
+            }
+        }
+
+        bool alive = false;
+        for (const auto& st : streams) alive = alive || !st.failed;
+        if (!alive || now >= deadline) break;
+
+        int wait = static_cast<int>(duration_cast<milliseconds>(min(nextSample, deadline) - now).count()) + 1;
+        poller.wait(wait, events);
+        for (const auto& ev : events) {
+            if (ev.id < streams.size() && streams[ev.id].stage != Stage::Done) on_event(ev.id, ev);
+        }
+    }
+
+    for (auto& st : streams) {
+        close_stream(st);
+        if (st.everConnected) result.streamsConnected++;
+        result.totalBytes += st.totalBytes;
+    }
+
+    // Never settled (or cut short): fall back to the last full window
+    size_t last = history.size() - 1;
+    if (measureTo == SIZE_MAX) {
+        measureTo = last;
+        if (measureFrom == SIZE_MAX || measureFrom >= measureTo) {
+            result.steady = false;
+            measureFrom = last >= window ? last - window : 0;
+        }
+    }
+
+    const Snapshot& a = history[measureFrom];
+    const Snapshot& b = history[measureTo];
+    result.warmupMs = a.ms;
+    result.measuredMs = b.ms - a.ms;
+
+    double sum = 0.0;
+    for (size_t i = 0; i < streams.size(); i++) {
+        double mbps = megabitsPerSecond(b.bytes[i] - a.bytes[i], result.measuredMs);
+        result.streamMbps.push_back(mbps);
+        sum += mbps;
+    }
+    result.goodputMbps = sum;
+    if (!result.streamMbps.empty()) {
+        result.streamMinMbps = *min_element(result.streamMbps.begin(), result.streamMbps.end());
+        result.streamMaxMbps = *max_element(result.streamMbps.begin(), result.streamMbps.end());
+        double mean = sum / result.streamMbps.size();
+        double var = 0.0;
+        for (double v : result.streamMbps) var += (v - mean) * (v - mean);
+        result.streamStddevMbps = sqrt(var / result.streamMbps.size());
+    }
+
+    result.ok = result.goodputMbps > 0.0;
+    if (!result.ok) {
+        for (const auto& st : streams) if (result.error.empty() && !st.error.empty()) result.error = st.error;
+        if (result.error.empty()) result.error = result.streamsConnected ? "no data moved" : "connect failed";
+    }
+    return result;
+}
+
+ThroughputResult NetProbe::throughput(const ThroughputConfig& config)
+{
+    // A redirect restarts the test on the new URL with what's left of the time budget
+    auto deadline = steady_clock::now() + milliseconds(max(1, config.maxDurationMs));
+    ThroughputConfig hop = config;
+    for (int redirects = 0; ; redirects++) {
+        string redirect;
+        ThroughputResult result = measure(hop, redirect);
+        if (result.ok || redirect.empty()) return result;
+        if (redirects == MAX_REDIRECTS) {
+            result.error = "stopped following redirects at " + redirect;
+            return result;
+        }
+        hop.maxDurationMs = static_cast<int>(duration_cast<milliseconds>(deadline - steady_clock::now()).count());
+        if (hop.maxDurationMs <= 0) return result;
+        hop.url = redirect;
+    }
+}
+
+// ----------------- Latency -----------------
+
+namespace {
+    const char ECHO_MAGIC[4] = { 'B', 'F', 'L', 'P' };
+    const size_t ECHO_SIZE = 16;    // magic, sequence, nonce (4 + 4 + 8)
+
+    struct Pinger {
+        shared_ptr<Resolved> resolved;
+        bool ready = false;         // resolved and set up
+        bool finished = false;
+        sockaddr_storage address = {};
+        socklen_t addressLength = 0;
+        socket_t fd = BAD_SOCKET;   // TCP: the connect in flight; UDP: the socket
+        int sent = 0;
+        steady_clock::time_point nextSend;
+        steady_clock::time_point started;           // TCP connect in flight since
+        map<uint32_t, steady_clock::time_point> outstanding;   // UDP seq -> sent at
+        uint64_t nonce = 0;
+    };
+
+    string numeric_host(const sockaddr_storage& addr, socklen_t len, bool withPort)
+    {
+        char host[NI_MAXHOST] = {};
+        char port[NI_MAXSERV] = {};
+        if (getnameinfo(reinterpret_cast<const sockaddr*>(&addr), len, host, sizeof(host), port, sizeof(port), NI_NUMERICHOST | NI_NUMERICSERV) != 0) return "";
+        string h = host;
+        if (!withPort) return h;
+        if (h.find(':') != string::npos) h = "[" + h + "]";
+        return h + ":" + port;
+    }
+}
+
+vector<LatencySamples> NetProbe::latency(const vector<LatencyTarget>& targets, int samples, int intervalMs, int timeoutMs)
+{
+    vector<LatencySamples> results(targets.size());
+    samples = max(1, samples);
+    intervalMs = max(1, intervalMs);
+    timeoutMs = max(1, timeoutMs);
+    if (!sockets_ready()) {
+        for (auto& r : results) r.error = "sockets unavailable";
+        return results;
+    }
+
+    auto start = steady_clock::now();
+    // Resolution + pacing + the last probe's timeout
+    auto deadline = start + milliseconds(timeoutMs + static_cast<int64_t>(samples) * intervalMs + timeoutMs);
+    uint64_t seed = static_cast<uint64_t>(start.time_since_epoch().count());
+
+    vector<Pinger> pingers(targets.size());
+    for (size_t i = 0; i < targets.size(); i++) {
+        string host = targets[i].host == "gateway" ? defaultGateway() : targets[i].host;
+        results[i].endpoint = string(targets[i].udp ? "udp " : "tcp ") + host + ":" + to_string(targets[i].port);
+        if (host.empty() || targets[i].port <= 0) {
+            results[i].error = host.empty() ? "no default gateway" : "no port";
+            pingers[i].finished = true;
+            continue;
+        }
+        results[i].rttMs.assign(samples, -1.0);
+        pingers[i].resolved = start_resolve(host, to_string(targets[i].port));
+        pingers[i].nonce = seed ^ (0x9E3779B97F4A7C15ULL * (i + 1));
+    }
+
+    Poller poller;
+    auto close_fd = [&](Pinger& p) {
+        if (p.fd == BAD_SOCKET) return;
+        poller.remove(p.fd);
+        close_socket(p.fd);
+        p.fd = BAD_SOCKET;
+    };
+    auto fail = [&](size_t i, const string& error) {
+        close_fd(pingers[i]);
+        pingers[i].finished = true;
+        results[i].error = error;
+        results[i].rttMs.clear();
+    };
+
+    auto set_up = [&](size_t i, steady_clock::time_point now) {
+        Pinger& p = pingers[i];
+        {
+            lock_guard<mutex> lock(p.resolved->m);
+            if (!p.resolved->done) return;
+            if (p.resolved->addresses.empty()) {
+                fail(i, "could not resolve");
+                return;
+            }
+            p.address = p.resolved->addresses.front();
+            p.addressLength = p.resolved->lengths.front();
+        }
+        results[i].endpoint = string(targets[i].udp ? "udp " : "tcp ") + numeric_host(p.address, p.addressLength, true);
+
+        if (targets[i].udp) {
+            p.fd = socket(p.address.ss_family, SOCK_DGRAM, 0);
+            if (p.fd == BAD_SOCKET || !set_nonblocking(p.fd) ||
+                connect(p.fd, reinterpret_cast<const sockaddr*>(&p.address), p.addressLength) != 0) {
+                fail(i, "socket failed");
+                return;
+            }
+            poller.set(p.fd, i, WANT_READ);
+        }
+        p.ready = true;
+        p.nextSend = now;
+    };
+
+    auto send_probe = [&](size_t i, steady_clock::time_point now) {
+        Pinger& p = pingers[i];
+        uint32_t seq = static_cast<uint32_t>(p.sent++);
+        p.nextSend += milliseconds(intervalMs);
+        if (p.nextSend < now) p.nextSend = now;     // don't burst to catch up
+
+        if (targets[i].udp) {
+            char packet[ECHO_SIZE];
+            memcpy(packet, ECHO_MAGIC, 4);
+            memcpy(packet + 4, &seq, 4);
+            memcpy(packet + 8, &p.nonce, 8);
+            p.outstanding[seq] = steady_clock::now();
+            send(p.fd, packet, static_cast<int>(ECHO_SIZE), SEND_FLAGS);     // a failed send is just a lost sample
+            return;
+        }
+
+        p.fd = socket(p.address.ss_family, SOCK_STREAM, 0);
+        if (p.fd == BAD_SOCKET) return;
+        p.started = steady_clock::now();
+        if (!set_nonblocking(p.fd) ||
+            (connect(p.fd, reinterpret_cast<const sockaddr*>(&p.address), p.addressLength) != 0 && !would_block())) {
+            close_fd(p);
+            return;
+        }
+        poller.set(p.fd, i, WANT_WRITE);
+    };
+
+    auto on_event = [&](size_t i, const Event& ev, steady_clock::time_point now) {
+        Pinger& p = pingers[i];
+        if (!targets[i].udp) {
+            if (p.fd == BAD_SOCKET || !(ev.writable || ev.error)) return;
+            if (connected(p.fd, ev)) results[i].rttMs[p.sent - 1] = ms_between(p.started, now);
+            close_fd(p);
+            return;
+        }
+
+        char packet[64];
+        for (;;) {
+            int n = recv(p.fd, packet, sizeof(packet), 0);
+            if (n < 0) return;      // drained, or an ICMP error (port unreachable): those samples time out
+            if (n != static_cast<int>(ECHO_SIZE) || memcmp(packet, ECHO_MAGIC, 4) != 0 || memcmp(packet + 8, &p.nonce, 8) != 0) continue;
+            uint32_t seq;
+            memcpy(&seq, packet + 4, 4);
+            auto it = p.outstanding.find(seq);
+            if (it == p.outstanding.end()) continue;
+            results[i].rttMs[seq] = ms_between(it->second, now);
+            p.outstanding.erase(it);
+        }
+    };
+
+    vector<Event> events;
+    for (;;) {
+        auto now = steady_clock::now();
+        bool active = false;
+        auto wake = now + milliseconds(10);
+
+        for (size_t i = 0; i < pingers.size(); i++) {
+            Pinger& p = pingers[i];
+            if (p.finished) continue;
+            if (!p.ready) {
+                set_up(i, now);
+                if (!p.ready) {
+                    active = active || !p.finished;
+                    continue;
+                }
+            }
+
+            // Expire whatever is overdue (it stays at -1)
+            if (p.fd != BAD_SOCKET && !targets[i].udp && now - p.started >= milliseconds(timeoutMs)) close_fd(p);
+            for (auto it = p.outstanding.begin(); it != p.outstanding.end();) {
+                if (now - it->second >= milliseconds(timeoutMs)) it = p.outstanding.erase(it);
+                else ++it;
+            }
+
+            bool inFlight = targets[i].udp ? !p.outstanding.empty() : p.fd != BAD_SOCKET;
+            if (p.sent < samples && now >= p.nextSend && (targets[i].udp || !inFlight)) {
+                send_probe(i, now);
+                inFlight = targets[i].udp ? !p.outstanding.empty() : p.fd != BAD_SOCKET;
+            }
+
+            if (p.sent >= samples && !inFlight) {
+                close_fd(p);
+                p.finished = true;
+                continue;
+            }
+            active = true;
+            if (p.sent < samples && p.nextSend < wake) wake = p.nextSend;
+        }
+
+        if (!active || now >= deadline) break;
+        int wait = max(0, static_cast<int>(duration_cast<milliseconds>(wake - now).count()));
+        poller.wait(wait, events);
+        now = steady_clock::now();
+        for (const auto& ev : events) {
+            if (ev.id < pingers.size() && !pingers[ev.id].finished) on_event(ev.id, ev, now);
+        }
+    }
+
+    // A slow TCP target may not have sent them all before the deadline
+    for (size_t i = 0; i < pingers.size(); i++) {
+        close_fd(pingers[i]);
+        if (!pingers[i].ready && results[i].error.empty()) results[i].error = "timed out resolving";
+        results[i].rttMs.resize(pingers[i].ready ? pingers[i].sent : 0);
+    }
+    return results;
+}
+
+LatencyStats NetProbe::summarize(const vector<double>& rttMs)
+{
+    LatencyStats stats;
+    LatencyHistogram histogram;
+    double previous = -1.0;
+    double jitterSum = 0.0;
+    int jitterCount = 0;
+
+    for (double rtt : rttMs) {
+        stats.sent++;
+        if (rtt < 0.0) continue;
+        stats.received++;
+        histogram.record(rtt);
+        if (previous >= 0.0) {
+            jitterSum += fabs(rtt - previous);
+            jitterCount++;
+        }
+        previous = rtt;
+    }
+
+    if (histogram.count() == 0) return stats;
+    stats.minMs = histogram.lowestMs();
+    stats.p50Ms = histogram.percentileMs(50.0);
+    stats.p99Ms = histogram.percentileMs(99.0);
+    stats.maxMs = histogram.highestMs();
+    stats.jitterMs = jitterCount ? jitterSum / jitterCount : 0.0;
+    return stats;
+}
+
+string NetProbe::defaultGateway()
+{
+#ifdef _WIN32
+    // Best route to 0.0.0.0 = the default route
+    MIB_IPFORWARDROW row = {};
+    if (GetBestRoute(0, 0, &row) != NO_ERROR || row.dwForwardNextHop == 0) return "";
+    in_addr hop;
+    hop.S_un.S_addr = row.dwForwardNextHop;
+    char text[INET_ADDRSTRLEN] = {};
+    return inet_ntop(AF_INET, &hop, text, sizeof(text)) ? text : "";
+#else
+    // Iface  Destination  Gateway  Flags ... (hex, network byte order)
+    istringstream routes(Probe::file("/proc/net/route"));
+    string line;
+    getline(routes, line);
+    string best;
+    unsigned long bestMetric = ULONG_MAX;
+    while (getline(routes, line)) {
+        istringstream fields(line);
+        string iface, destination, gateway;
+        unsigned long flags = 0, refcnt = 0, use = 0, metric = 0;
+        if (!(fields >> iface >> destination >> gateway >> hex >> flags >> dec >> refcnt >> use >> metric)) continue;
+        if (destination != "00000000" || !(flags & 0x2) || metric >= bestMetric) continue;    // RTF_GATEWAY
+
+        in_addr hop;
+        hop.s_addr = static_cast<uint32_t>(strtoul(gateway.c_str(), nullptr, 16));
+        char text[INET_ADDRSTRLEN] = {};
+        if (!inet_ntop(AF_INET, &hop, text, sizeof(text))) continue;
+        best = text;
+        bestMetric = metric;
+    }
+    return best;
+#endif
+}
+
+// ----------------- DNS -----------------
+
+namespace {
+    const uint16_t DNS_A = 1;
+    const uint16_t DNS_AAAA = 28;
+
+    uint16_t read16(const string& p, size_t at)
+    {
+        return static_cast<uint16_t>((static_cast<unsigned char>(p[at]) << 8) | static_cast<unsigned char>(p[at + 1]));
+    }
+
+    void put16(string& p, uint16_t v)
+    {
+        p += static_cast<char>(v >> 8);
+        p += static_cast<char>(v & 0xff);
+    }
+
+    // Past a (possibly compressed) name; 0 = malformed
+    size_t skip_name(const string& p, size_t at)
+    {
+        while (at < p.size()) {
+            unsigned char len = static_cast<unsigned char>(p[at]);
+            if (len == 0) return at + 1;
+            if ((len & 0xc0) == 0xc0) return at + 2 <= p.size() ? at + 2 : 0;
+            if (len & 0xc0) return 0;
+            at += 1 + len;
+        }
+        return 0;
+    }
+
+    // "1.1.1.1", "1.1.1.1:5353", "2606:4700::1111", "[::1]:5353", "fe80::1%eth0"
+    bool parse_resolver(const string& text, sockaddr_storage& addr, socklen_t& len)
+    {
+        string host = text;
+        string port = "53";
+        if (!host.empty() && host[0] == '[') {
+            size_t close = host.find(']');
+            if (close == string::npos) return false;
+            if (close + 1 < host.size() && host[close + 1] == ':') port = host.substr(close + 2);
+            host = host.substr(1, close - 1);
+        }
+        else if (count(host.begin(), host.end(), ':') == 1) {
+            port = host.substr(host.find(':') + 1);
+            host = host.substr(0, host.find(':'));
+        }
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;     // never a lookup
+        addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return false;
+        memcpy(&addr, res->ai_addr, res->ai_addrlen);
+        len = static_cast<socklen_t>(res->ai_addrlen);
+        freeaddrinfo(res);
+        return true;
+    }
+
+    struct Asker {
+        socket_t fd = BAD_SOCKET;
+        map<uint16_t, size_t> pending;      // query id -> name index
+        steady_clock::time_point sent;
+    };
+}
+
+string NetProbe::dnsQuery(uint16_t id, const string& name, uint16_t type)
+{
+    string labels = name;
+    if (!labels.empty() && labels.back() == '.') labels.pop_back();
+    if (labels.empty() || labels.size() > 253) return "";
+
+    string p;
+    put16(p, id);
+    put16(p, 0x0100);       // standard query, recursion desired
+    put16(p, 1);            // QDCOUNT
+    put16(p, 0);
+    put16(p, 0);
+    put16(p, 0);
+
+    size_t start = 0;
+    for (;;) {
+        size_t dot = labels.find('.', start);
+        size_t len = (dot == string::npos ? labels.size() : dot) - start;
+        if (len == 0 || len > 63) return "";
+        p += static_cast<char>(len);
+        p.append(labels, start, len);
+        if (dot == string::npos) break;
+        start = dot + 1;
+    }
+    p += '\0';
+    put16(p, type);
+    put16(p, 1);            // IN
+    return p;
+}
+
+bool NetProbe::parseDns(const string& packet, DnsMessage& message)
+{
+    if (packet.size() < 12) return false;
+    message = DnsMessage();
+    message.id = read16(packet, 0);
+    uint16_t flags = read16(packet, 2);
+    message.response = (flags & 0x8000) != 0;
+    message.truncated = (flags & 0x0200) != 0;
+    message.rcode = flags & 0x000f;
+    uint16_t questions = read16(packet, 4);
+    uint16_t answers = read16(packet, 6);
+    if (questions == 0) return false;
+
+    // First question: plain labels (nobody compresses the question)
+    size_t at = 12;
+    for (;;) {
+        if (at >= packet.size()) return false;
+        unsigned char len = static_cast<unsigned char>(packet[at++]);
+        if (len == 0) break;
+        if (len > 63 || at + len > packet.size()) return false;
+        if (!message.name.empty()) message.name += '.';
+        for (size_t i = 0; i < len; i++) message.name += static_cast<char>(tolower(static_cast<unsigned char>(packet[at + i])));
+        at += len;
+    }
+    if (at + 4 > packet.size()) return false;
+    message.type = read16(packet, at);
+    at += 4;
+    message.questionEnd = at;
+
+    for (uint16_t q = 1; q < questions; q++) {
+        at = skip_name(packet, at);
+        if (!at || at + 4 > packet.size()) return false;
+        at += 4;
+    }
+
+    // Answer RRs: name, type, class, TTL, rdlength, rdata
+    for (uint16_t a = 0; a < answers; a++) {
+        at = skip_name(packet, at);
+        if (!at || at + 10 > packet.size()) return false;
+        uint16_t type = read16(packet, at);
+        uint16_t rdlength = read16(packet, at + 8);
+        at += 10 + rdlength;
+        if (at > packet.size()) return false;
+        if (type == DNS_A || type == DNS_AAAA) message.answers++;
+    }
+    return true;
+}
+
+vector<string> NetProbe::systemResolvers()
+{
+#ifdef _WIN32
+    return Probe::list("iphlp:dns-servers", []() {
+        vector<string> out;
+        ULONG size = 16 * 1024;
+        vector<unsigned char> buf;
+        ULONG rc = ERROR_BUFFER_OVERFLOW;
+        for (int attempt = 0; attempt < 3 && rc == ERROR_BUFFER_OVERFLOW; attempt++) {
+            buf.resize(size);
+            rc = GetAdaptersAddresses(AF_UNSPEC, GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_FRIENDLY_NAME,
+                nullptr, reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buf.data()), &size);
+        }
+        if (rc != NO_ERROR) return out;
+
+        for (auto* a = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buf.data()); a; a = a->Next) {
+            if (a->OperStatus != IfOperStatusUp || a->IfType == IF_TYPE_SOFTWARE_LOOPBACK) continue;
+            for (auto* d = a->FirstDnsServerAddress; d; d = d->Next) {
+                sockaddr_storage addr = {};
+                memcpy(&addr, d->Address.lpSockaddr, d->Address.iSockaddrLength);
+                string host = numeric_host(addr, d->Address.iSockaddrLength, false);
+                // fec0:0:0:ffff::1-3 are placeholders Windows lists when IPv6 DNS isn't configured
+                if (host.empty() || host.compare(0, 12, "fec0:0:0:fff") == 0) continue;
+                if (find(out.begin(), out.end(), host) == out.end()) out.push_back(host);
+            }
+        }
+        return out;
+        });
+#else
+    // "nameserver 1.1.1.1" (glibc uses at most three; we show what's there)
+    vector<string> out;
+    istringstream conf(Probe::file("/etc/resolv.conf"));
+    string line;
+    while (getline(conf, line)) {
+        istringstream fields(line);
+        string keyword, address;
+        if (!(fields >> keyword >> address) || keyword != "nameserver") continue;
+        if (find(out.begin(), out.end(), address) == out.end()) out.push_back(address);
+    }
+    return out;
+#endif
+}
+
+vector<DnsResolverResult> NetProbe::dns(const vector<string>& resolvers, const vector<string>& names, int timeoutMs)
+{
+    vector<DnsResolverResult> results(resolvers.size());
+    timeoutMs = max(1, timeoutMs);
+    for (size_t i = 0; i < resolvers.size(); i++) {
+        results[i].resolver = resolvers[i];
+        for (const auto& name : names) {
+            DnsQueryResult q;
+            q.name = name;
+            results[i].queries.push_back(q);
+        }
+    }
+    if (!sockets_ready()) {
+        for (auto& r : results) r.error = "sockets unavailable";
+        return results;
+    }
+
+    auto start = steady_clock::now();
+    auto deadline = start + milliseconds(timeoutMs);
+    uint64_t seed = static_cast<uint64_t>(start.time_since_epoch().count());
+
+    Poller poller;
+    vector<Asker> askers(resolvers.size());
+    auto close_fd = [&](Asker& a) {
+        if (a.fd == BAD_SOCKET) return;
+        poller.remove(a.fd);
+        close_socket(a.fd);
+        a.fd = BAD_SOCKET;
+        a.pending.clear();
+    };
+
+    // ICMP came back: port unreachable (ECONNREFUSED / WSAECONNRESET) or no route
+    auto icmp_failed = [&](size_t i) {
+#ifdef _WIN32
+        results[i].error = WSAGetLastError() == WSAECONNRESET ? "refused" : "unreachable";
+#else
+        results[i].error = errno == ECONNREFUSED ? "refused" : "unreachable";
+#endif
+        close_fd(askers[i]);
+    };
+
+    // Everything goes out up front; the deadline is shared
+    for (size_t i = 0; i < resolvers.size(); i++) {
+        Asker& a = askers[i];
+        sockaddr_storage addr = {};
+        socklen_t len = 0;
+        if (!parse_resolver(resolvers[i], addr, len)) {
+            results[i].error = "not a numeric address";
+            continue;
+        }
+        results[i].resolver = numeric_host(addr, len, true);
+
+        a.fd = socket(addr.ss_family, SOCK_DGRAM, 0);
+        if (a.fd == BAD_SOCKET || !set_nonblocking(a.fd) || connect(a.fd, reinterpret_cast<const sockaddr*>(&addr), len) != 0) {
+            if (a.fd != BAD_SOCKET) close_socket(a.fd);
+            a.fd = BAD_SOCKET;
+            results[i].error = "socket failed";
+            continue;
+        }
+        poller.set(a.fd, i, WANT_READ);
+
+        a.sent = steady_clock::now();
+        for (size_t n = 0; n < names.size(); n++) {
+            // splitmix64 step: distinct, unpredictable ids per resolver
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            uint16_t id = static_cast<uint16_t>((z ^ (z >> 27)) >> 16);
+            while (a.pending.count(id)) id++;
+
+            string packet = dnsQuery(id, names[n]);
+            if (packet.empty()) {
+                results[i].queries[n].rcode = -2;
+                continue;
+            }
+            a.pending[id] = n;
+            // An ICMP error for an earlier query can surface here instead of in recv()
+            if (send(a.fd, packet.data(), static_cast<int>(packet.size()), SEND_FLAGS) < 0 && !would_block()) {
+                icmp_failed(i);
+                break;
+            }
+        }
+        if (a.pending.empty()) close_fd(a);
+    }
+
+    auto on_readable = [&](size_t i, steady_clock::time_point now) {
+        Asker& a = askers[i];
+        char buf[4096];
+        for (;;) {
+            int n = recv(a.fd, buf, sizeof(buf), 0);
+            if (n < 0) {
+                if (!would_block()) icmp_failed(i);
+                return;
+            }
+
+            DnsMessage reply;
+            if (!parseDns(string(buf, n), reply) || !reply.response) continue;
+            auto it = a.pending.find(reply.id);
+            if (it == a.pending.end()) continue;
+            DnsQueryResult& q = results[i].queries[it->second];
+            string asked = q.name;
+            if (!asked.empty() && asked.back() == '.') asked.pop_back();
+            transform(asked.begin(), asked.end(), asked.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+            if (reply.name != asked) continue;      // same id, other question: not ours
+
+            q.ms = ms_between(a.sent, now);
+            q.rcode = reply.rcode;
+            q.answers = reply.answers;
+            q.truncated = reply.truncated;
+            a.pending.erase(it);
+            if (a.pending.empty()) {
+                close_fd(a);
+                return;
+            }
+        }
+    };
+
+    vector<Event> events;
+    for (;;) {
+        bool active = false;
+        for (const auto& a : askers) active = active || !a.pending.empty();
+        auto now = steady_clock::now();
+        if (!active || now >= deadline) break;
+
+        int wait = max(1, static_cast<int>(duration_cast<milliseconds>(deadline - now).count()));
+        poller.wait(wait, events);
+        now = steady_clock::now();
+        for (const auto& ev : events) {
+            if (ev.id < askers.size() && askers[ev.id].fd != BAD_SOCKET) on_readable(ev.id, now);
+        }
+    }
+
+    for (auto& a : askers) close_fd(a);
+    return results;
+}
+
+// ----------------- LatencyHistogram -----------------
+
+namespace {
+    const int SUB_BUCKET_BITS = 7;                          // 128 sub-buckets per power of two
+    const uint64_t SUB_BUCKETS = 1ULL << SUB_BUCKET_BITS;
+
+    int highest_bit(uint64_t v)
+    {
+        int bit = 0;
+        while (v >>= 1) bit++;
+        return bit;
+    }
+
+    // Values below 2 * SUB_BUCKETS map to themselves; above that each power of
+    // two contributes SUB_BUCKETS slots of width 2^shift
+    size_t bucket_index(uint64_t us)
+    {
+        if (us < 2 * SUB_BUCKETS) return static_cast<size_t>(us);
+        int shift = highest_bit(us) - SUB_BUCKET_BITS;
+        return static_cast<size_t>(2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + ((us >> shift) - SUB_BUCKETS));
+    }
+
+    // Midpoint of the values that share the slot
+    double bucket_value(size_t index)
+    {
+        if (index < 2 * SUB_BUCKETS) return static_cast<double>(index);
+        uint64_t shift = (index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+        uint64_t sub = (index - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+        return static_cast<double>(sub << shift) + ((1ULL << shift) - 1) / 2.0;
+    }
+}
+
+void LatencyHistogram::record(double ms)
+{
+    if (ms < 0.0) return;
+    uint64_t us = static_cast<uint64_t>(min(ms * 1000.0 + 0.5, 1e15));
+    size_t index = bucket_index(us);
+    if (index >= counts.size()) counts.resize(index + 1, 0);
+    counts[index]++;
+    total++;
+    lowest = min(lowest, us);
+    highest = max(highest, us);
+}
+
+double LatencyHistogram::lowestMs() const
+{
+    return total ? lowest / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::highestMs() const
+{
+    return total ? highest / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::percentileMs(double percentile) const
+{
+    if (total == 0) return 0.0;
+    percentile = min(100.0, max(0.0, percentile));
+    // Smallest value with at least percentile% of the samples at or below it
+    uint64_t rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(percentile / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            double us = min(max(bucket_value(i), static_cast<double>(lowest)), static_cast<double>(highest));
+            return us / 1000.0;
+        }
+    }
+    return highest / 1000.0;
+}
+
+double NetProbe::megabitsPerSecond(uint64_t bytes, double milliseconds)
+{
+    if (bytes == 0 || milliseconds <= 0.0) return 0.0;
+    return (bytes * 8.0 / 1000000.0) / (milliseconds / 1000.0);
+}
+
+// ----------------- NetProbeServer -----------------
+
+// The speed test re-requests when a transfer ends, so nothing needs more per
+// request; anything bigger only ties the server up
+const uint64_t NetProbeServer::MAX_DOWNLOAD_BYTES = 1ULL << 30;
+
+struct NetProbeServer::Impl {
+    struct Client {
+        socket_t fd = BAD_SOCKET;
+        string peer;
+        string in;
+        bool headersDone = false;
+        uint64_t bodyLeft = 0;      // request body still to read
+        string out;                 // response head (+ small body)
+        size_t outSent = 0;
+        uint64_t fillLeft = 0;      // /__down filler still to send
+    };
+
+    socket_t listener = BAD_SOCKET;
+    socket_t echo = BAD_SOCKET;     // UDP echo on the same port (latency probes)
+    string bindAddress;
+    int port = 0;
+    thread worker;
+    atomic<bool> stopping{ false };
+
+    void loop()
+    {
+        Poller poller;
+        map<size_t, Client> clients;
+        size_t nextId = 2;          // 0 is the listener, 1 the UDP echo
+        poller.set(listener, 0, WANT_READ);
+        if (echo != BAD_SOCKET) poller.set(echo, 1, WANT_READ);
+
+        auto drop = [&](size_t id) {
+            poller.remove(clients[id].fd);
+            close_socket(clients[id].fd);
+            clients.erase(id);
+        };
+
+        vector<Event> events;
+        while (!stopping) {
+            poller.wait(100, events);
+            for (const auto& ev : events) {
+                if (ev.id == 0) {
+                    for (;;) {
+                        sockaddr_storage addr = {};
+                        socklen_t len = sizeof(addr);
+                        socket_t fd = accept(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+                        if (fd == BAD_SOCKET) break;
+                        set_nonblocking(fd);
+
+                        Client c;
+                        c.fd = fd;
+                        char host[NI_MAXHOST] = {};
+                        if (getnameinfo(reinterpret_cast<sockaddr*>(&addr), len, host, sizeof(host), nullptr, 0, NI_NUMERICHOST) == 0) c.peer = host;
+                        clients[nextId] = c;
+                        poller.set(fd, nextId, WANT_READ);
+                        nextId++;
+                    }
+                    continue;
+                }
+                if (ev.id == 1) {
+                    echo_datagrams();
+                    continue;
+                }
+
+                auto it = clients.find(ev.id);
+                if (it == clients.end()) continue;
+                Client& c = it->second;
+
+                if (ev.error) {
+                    drop(ev.id);
+                    continue;
+                }
+                if (ev.readable && c.out.empty() && !read_request(c)) {
+                    drop(ev.id);
+                    continue;
+                }
+                if (!c.out.empty()) {
+                    if (!write_response(c)) {
+                        drop(ev.id);
+                        continue;
+                    }
+                    poller.set(c.fd, ev.id, WANT_WRITE);
+                }
+            }
+        }
+
+        for (auto& kv : clients) close_socket(kv.second.fd);
+    }
+
+    void echo_datagrams()
+    {
+        char buf[2048];
+        for (;;) {
+            sockaddr_storage from = {};
+            socklen_t len = sizeof(from);
+            int n = recvfrom(echo, buf, sizeof(buf), 0, reinterpret_cast<sockaddr*>(&from), &len);
+            if (n < 0) {
+                if (would_block()) return;
+                continue;       // Windows reports an earlier reply's ICMP unreachable here
+            }
+            string reply = dns_answer(buf, n);
+            if (!reply.empty()) sendto(echo, reply.data(), static_cast<int>(reply.size()), 0, reinterpret_cast<sockaddr*>(&from), len);
+            else sendto(echo, buf, n, 0, reinterpret_cast<sockaddr*>(&from), len);
+        }
+    }
+
+    // Stub resolver answer for a DNS query ("" = not a query: echo it)
+    static string dns_answer(const char* data, int size)
+    {
+        if (size >= 4 && memcmp(data, ECHO_MAGIC, 4) == 0) return "";     // latency probe
+        string query(data, size);
+        DnsMessage q;
+        if (!NetProbe::parseDns(query, q) || q.response || read16(query, 4) != 1) return "";
+
+        bool nx = q.name == "invalid" || (q.name.size() > 8 && q.name.compare(q.name.size() - 8, 8, ".invalid") == 0);
+        string rdata;
+        if (!nx && q.type == DNS_A) rdata = string("\x7f\x00\x00\x01", 4);
+        if (!nx && q.type == DNS_AAAA) rdata = string(15, '\0') + '\x01';
+
+        string reply = query.substr(0, q.questionEnd);
+        reply[2] = static_cast<char>(0x81 | (query[2] & 0x01));    // QR, RD copied
+        reply[3] = static_cast<char>(0x80 | (nx ? 3 : 0));          // RA, NXDOMAIN
+        reply[6] = 0;
+        reply[7] = rdata.empty() ? 0 : 1;
+        reply[8] = reply[9] = reply[10] = reply[11] = 0;
+        if (rdata.empty()) return reply;
+
+        put16(reply, 0xc00c);       // name: pointer to the question
+        put16(reply, q.type);
+        put16(reply, 1);
+        put16(reply, 0);
+        put16(reply, 60);           // TTL
+        put16(reply, static_cast<uint16_t>(rdata.size()));
+        return reply + rdata;
+    }
+
+    // false = close the connection
+    bool read_request(Client& c)
+    {
+        char buf[64 * 1024];
+        for (;;) {
+            int n = recv(c.fd, buf, sizeof(buf), 0);
+            if (n == 0) return false;
+            if (n < 0) return would_block();
+
+            if (c.headersDone) {
+                c.bodyLeft -= min<uint64_t>(c.bodyLeft, n);
+            }
+            else {
+                c.in.append(buf, n);
+                size_t end = c.in.find("\r\n\r\n");
+                if (end == string::npos) {
+                    if (c.in.size() > 64 * 1024) return false;
+                    continue;
+                }
+                c.headersDone = true;
+                string length = header_value(c.in.substr(0, end + 2), "Content-Length");
+                c.bodyLeft = length.empty() ? 0 : strtoull(length.c_str(), nullptr, 10);
+                c.bodyLeft -= min<uint64_t>(c.bodyLeft, c.in.size() - (end + 4));
+                c.in.resize(end);
+            }
+
+            if (c.headersDone && c.bodyLeft == 0) {
+                respond(c);
+                return true;
+            }
+        }
+    }
+
+    void respond(Client& c)
+    {
+        // "GET /__down?bytes=1000000 HTTP/1.0"
+        size_t space = c.in.find(' ');
+        string method = c.in.substr(0, space);
+        size_t pathEnd = c.in.find(' ', space + 1);
+        string target = space == string::npos ? "" : c.in.substr(space + 1, pathEnd - space - 1);
+        string path = target.substr(0, target.find('?'));
+
+        int status = 200;
+        string body;
+        string location;
+        uint64_t fill = 0;
+
+        if (method == "GET" && (path == "/ip" || path == "/")) {
+            body = c.peer;
+        }
+        else if (method == "GET" && path == "/__down") {
+            size_t q = target.find("bytes=");
+            fill = q == string::npos ? 1000000 : strtoull(target.c_str() + q + 6, nullptr, 10);
+            fill = min<uint64_t>(fill, MAX_DOWNLOAD_BYTES);
+        }
+        else if (method == "POST" && path == "/__up") {
+            body = "ok";
+        }
+        else if (path == "/__redirect") {
+            size_t q = target.find("to=");
+            status = 302;
+            location = q == string::npos ? "/__redirect" : target.substr(q + 3);
+        }
+        else {
+            status = 404;
+            body = "not found";
+        }
+
+        c.out = "HTTP/1.0 " + to_string(status) + (status == 200 ? " OK" : status == 302 ? " Found" : " Not Found") + "\r\n" +
+            (location.empty() ? "" : "Location: " + location + "\r\n") +
+            "Content-Type: " + (fill ? "application/octet-stream" : "text/plain") + "\r\n"
+            "Content-Length: " + to_string(body.size() + fill) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+        c.fillLeft = fill;
+    }
+
+    // false = finished (or failed); either way the connection closes
+    bool write_response(Client& c)
+    {
+        const string& fill = filler();
+        for (;;) {
+            const char* data;
+            size_t len;
+            if (c.outSent < c.out.size()) {
+                data = c.out.data() + c.outSent;
+                len = c.out.size() - c.outSent;
+            }
+            else if (c.fillLeft > 0) {
+                data = fill.data();
+                len = static_cast<size_t>(min<uint64_t>(fill.size(), c.fillLeft));
+            }
+            else {
+                return false;
+            }
+
+            int n = send(c.fd, data, static_cast<int>(len), SEND_FLAGS);
+            if (n < 0) return would_block();
+            if (c.outSent < c.out.size()) c.outSent += n;
+            else c.fillLeft -= n;
+        }
+    }
+};
+
+NetProbeServer::NetProbeServer() : impl(new Impl()) {}
+
+NetProbeServer::~NetProbeServer()
+{
+    stop();
+}
+
+bool NetProbeServer::start(const string& bindAddress, int port)
+{
+    if (impl->listener != BAD_SOCKET || !sockets_ready()) return false;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICHOST;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(bindAddress.c_str(), to_string(port).c_str(), &hints, &res) != 0) return false;
+
+    socket_t s = socket(res->ai_family, SOCK_STREAM, 0);
+    bool ok = s != BAD_SOCKET;
+    if (ok) {
+        int on = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+        ok = bind(s, res->ai_addr, static_cast<socklen_t>(res->ai_addrlen)) == 0 && listen(s, 64) == 0 && set_nonblocking(s);
+    }
+    freeaddrinfo(res);
+    if (!ok) {
+        if (s != BAD_SOCKET) close_socket(s);
+        return false;
+    }
+
+    sockaddr_storage bound = {};
+    socklen_t len = sizeof(bound);
+    getsockname(s, reinterpret_cast<sockaddr*>(&bound), &len);
+    impl->port = ntohs(bound.ss_family == AF_INET6
+        ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+        : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+
+    // Best effort: the HTTP endpoints work without it
+    socket_t u = socket(bound.ss_family, SOCK_DGRAM, 0);
+    if (u != BAD_SOCKET && (bind(u, reinterpret_cast<sockaddr*>(&bound), len) != 0 || !set_nonblocking(u))) {
+        close_socket(u);
+        u = BAD_SOCKET;
+    }
+
+    impl->listener = s;
+    impl->echo = u;
+    impl->bindAddress = bindAddress;
+    impl->stopping = false;
+    impl->worker = thread([this]() { impl->loop(); });
+    return true;
+}
+
+void NetProbeServer::stop()
+{
+    if (impl->listener == BAD_SOCKET) return;
+    impl->stopping = true;
+    if (impl->worker.joinable()) impl->worker.join();
+    close_socket(impl->listener);
+    impl->listener = BAD_SOCKET;
+    if (impl->echo != BAD_SOCKET) close_socket(impl->echo);
+    impl->echo = BAD_SOCKET;
+}
+
+int NetProbeServer::port() const
+{
+    return impl->port;
+}
+
+string NetProbeServer::baseUrl() const
+{
+    string host = impl->bindAddress;
+    if (host == "0.0.0.0") host = "127.0.0.1";
+    else if (host == "::") host = "::1";
+    if (host.find(':') != string::npos) host = "[" + host + "]";
+    return "http://" + host + ":" + to_string(impl->port);
+}
@@ -1,4 +1,6 @@
 ﻿#include "include\NetworkInfo.h"
+#include "include\Probe.h"
+#include "include\NetIdentityCache.h"
 #include <WinSock2.h>
 #include <iphlpapi.h>
 #include <WS2tcpip.h>
@@ -8,10 +10,10 @@
 #include <sstream>
 #include <netioapi.h>
 #include <wlanapi.h>
-#include <winhttp.h>
 #include <algorithm>
 #include <vector>
 #include <chrono>
+#include <cstdlib>
 
 #define WINVER 0x0600
 #define _WIN32_WINNT 0x0600
@@ -19,7 +21,6 @@
 #pragma comment(lib, "iphlpapi.lib")
 #pragma comment(lib, "ws2_32.lib")
 #pragma comment(lib, "wlanapi.lib")
-#pragma comment(lib, "winhttp.lib")
 
 using namespace std;
 using namespace std::chrono;
@@ -27,92 +28,109 @@ using namespace std::chrono;
 //-----------------------------------------get_local_ip--------------------------------//
 string NetworkInfo::get_local_ip()
 {
-	string result = "Unknown";
+	return Probe::text("iphlp:local-ipv4", []() -> string {
+		string result = "Unknown";
 
-	WSADATA wsa_data;
-	if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
-		return result;
+		WSADATA wsa_data;
+		if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+			return result;
 
-	ULONG out_buff_len = 15000;
-	PIP_ADAPTER_ADDRESSES adapter_addresses = (IP_ADAPTER_ADDRESSES*)malloc(out_buff_len);
+		ULONG out_buff_len = 15000;
+		PIP_ADAPTER_ADDRESSES adapter_addresses = (IP_ADAPTER_ADDRESSES*)malloc(out_buff_len);
 
-	if (GetAdaptersAddresses(AF_INET, GAA_FLAG_INCLUDE_PREFIX, NULL, adapter_addresses, &out_buff_len) == NO_ERROR)
-	{
-		for (PIP_ADAPTER_ADDRESSES adapter = adapter_addresses; adapter != NULL; adapter = adapter->Next)
+		if (GetAdaptersAddresses(AF_INET, GAA_FLAG_INCLUDE_PREFIX, NULL, adapter_addresses, &out_buff_len) == NO_ERROR)
 		{
-			if (adapter->OperStatus != IfOperStatusUp || adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK)
-				continue;
-
-			for (PIP_ADAPTER_UNICAST_ADDRESS ua = adapter->FirstUnicastAddress; ua != NULL; ua = ua->Next)
+			for (PIP_ADAPTER_ADDRESSES adapter = adapter_addresses; adapter != NULL; adapter = adapter->Next)
 			{
-				SOCKADDR_IN* sa_in = (SOCKADDR_IN*)ua->Address.lpSockaddr;
-				if (sa_in->sin_family == AF_INET)
-				{
-					char ip_str[INET_ADDRSTRLEN];
-					inet_ntop(AF_INET, &(sa_in->sin_addr), ip_str, sizeof(ip_str));
+				if (adapter->OperStatus != IfOperStatusUp || adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK)
+					continue;
 
-					int cidr = ua->OnLinkPrefixLength;
-					ostringstream oss;
-					oss << ip_str << "/" << cidr;
-
-					result = oss.str();
-					free(adapter_addresses);
-					WSACleanup();
-					return result;
+				for (PIP_ADAPTER_UNICAST_ADDRESS ua = adapter->FirstUnicastAddress; ua != NULL; ua = ua->Next)
+				{
+					SOCKADDR_IN* sa_in = (SOCKADDR_IN*)ua->Address.lpSockaddr;
+					if (sa_in->sin_family == AF_INET)
+					{
+						char ip_str[INET_ADDRSTRLEN];
+						inet_ntop(AF_INET, &(sa_in->sin_addr), ip_str, sizeof(ip_str));
+
+						int cidr = ua->OnLinkPrefixLength;
+						ostringstream oss;
+						oss << ip_str << "/" << cidr;
+
+						result = oss.str();
+						free(adapter_addresses);
+						WSACleanup();
+						return result;
+					}
 				}
 			}
 		}
-	}
-	free(adapter_addresses);
-	WSACleanup();
-	return result;
+		free(adapter_addresses);
+		WSACleanup();
+		return result;
+		});
 }
 
 //-----------------------------------------get_mac_address--------------------------------//
 string NetworkInfo::get_mac_address()
 {
-	string mac = "Unknown";
-	ULONG out_buf_len = 15000;
-	PIP_ADAPTER_ADDRESSES adapter_addresses = (IP_ADAPTER_ADDRESSES*)malloc(out_buf_len);
+	return Probe::text("iphlp:mac-address", []() -> string {
+		string mac = "Unknown";
+		ULONG out_buf_len = 15000;
+		PIP_ADAPTER_ADDRESSES adapter_addresses = (IP_ADAPTER_ADDRESSES*)malloc(out_buf_len);
 
-	if (GetAdaptersAddresses(AF_UNSPEC, 0, NULL, adapter_addresses, &out_buf_len) == NO_ERROR)
-	{
-		for (PIP_ADAPTER_ADDRESSES adapter = adapter_addresses; adapter != NULL; adapter = adapter->Next)
+		if (GetAdaptersAddresses(AF_UNSPEC, 0, NULL, adapter_addresses, &out_buf_len) == NO_ERROR)
 		{
-			if (adapter->OperStatus != IfOperStatusUp || adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK)
-				continue;
-
-			ostringstream oss;
-			for (UINT i = 0; i < adapter->PhysicalAddressLength; i++)
+			for (PIP_ADAPTER_ADDRESSES adapter = adapter_addresses; adapter != NULL; adapter = adapter->Next)
 			{
-				if (i != 0) oss << ":";
-				oss << hex << uppercase << setw(2) << setfill('0') << (int)adapter->PhysicalAddress[i];
+				if (adapter->OperStatus != IfOperStatusUp || adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK)
+					continue;
+
+				ostringstream oss;
+				for (UINT i = 0; i < adapter->PhysicalAddressLength; i++)
+				{
+					if (i != 0) oss << ":";
+					oss << hex << uppercase << setw(2) << setfill('0') << (int)adapter->PhysicalAddress[i];
+				}
+				mac = oss.str();
+				break;
 			}
-			mac = oss.str();
-			break;
 		}
-	}
-	free(adapter_addresses);
-	return mac;
+		free(adapter_addresses);
+		return mac;
+		});
 }
 
 //-----------------------------------------get_locale--------------------------------//
 string NetworkInfo::get_locale()
 {
-	WCHAR locale_name[LOCALE_NAME_MAX_LENGTH];
-	if (GetUserDefaultLocaleName(locale_name, LOCALE_NAME_MAX_LENGTH))
-	{
-		char locale_str[LOCALE_NAME_MAX_LENGTH];
-		WideCharToMultiByte(CP_UTF8, 0, locale_name, -1, locale_str, sizeof(locale_str), NULL, NULL);
-		return string(locale_str);
-	}
-	return "Unknown";
+	return Probe::text("locale:user-default", []() -> string {
+		WCHAR locale_name[LOCALE_NAME_MAX_LENGTH];
+		if (GetUserDefaultLocaleName(locale_name, LOCALE_NAME_MAX_LENGTH))
+		{
+			char locale_str[LOCALE_NAME_MAX_LENGTH];
+			WideCharToMultiByte(CP_UTF8, 0, locale_name, -1, locale_str, sizeof(locale_str), NULL, NULL);
+			return string(locale_str);
+		}
+		return "Unknown";
+		});
 }
 
 //-----------------------------------------get_network_name--------------------------------//
+/**
+ * Connected SSID, cached per network (NetIdentityCache, shared with
+ * CompactNetwork as "ssid"; "" = not on WiFi)
+ */
 string NetworkInfo::get_network_name()
 {
-	string ssid_str = "Unknown";
+	// Same key and cache entry as CompactNetwork::get_wifi_ssid
+	string ssid = Probe::text("wlan:ssid", []() { return NetIdentityCache::get("ssid", &NetworkInfo::query_network_name); });
+	return ssid.empty() ? "Unknown" : ssid;
+}
+
+string NetworkInfo::query_network_name()
+{
+	string ssid_str = "";
 	HANDLE hClient = NULL;
 	DWORD dwMaxClient = 2;
 	DWORD dwCurVersion = 0;
@@ -152,54 +170,6 @@ string NetworkInfo::get_network_name()
 	return ssid_str;
 }
 
-//-----------------------------------------get_public_ip--------------------------------//
-string NetworkInfo::get_public_ip()
-{
-	string public_ip = "Unknown";
-
-	HINTERNET hSession = WinHttpOpen(L"NetworkInfo/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-		WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
-	if (!hSession) return public_ip;
-
-	HINTERNET hConnect = WinHttpConnect(hSession, L"api.ipify.org", INTERNET_DEFAULT_HTTP_PORT, 0);
-	if (!hConnect)
-	{
-		WinHttpCloseHandle(hSession);
-		return public_ip;
-	}
-
-	HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", NULL, NULL, WINHTTP_NO_REFERER,
-		WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
-	if (!hRequest)
-	{
-		WinHttpCloseHandle(hConnect);
-		WinHttpCloseHandle(hSession);
-		return public_ip;
-	}
-
-	if (WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-		WINHTTP_NO_REQUEST_DATA, 0, 0, 0) &&
-		WinHttpReceiveResponse(hRequest, NULL))
-	{
-		DWORD size = 0;
-		WinHttpQueryDataAvailable(hRequest, &size);
-		if (size > 0)
-		{
-			char* buffer = new char[size + 1];
-			ZeroMemory(buffer, size + 1);
-			DWORD read = 0;
-			WinHttpReadData(hRequest, buffer, size, &read);
-			public_ip = string(buffer, read);
-			delete[] buffer;
-		}
-	}
-
-	WinHttpCloseHandle(hRequest);
-	WinHttpCloseHandle(hConnect);
-	WinHttpCloseHandle(hSession);
-	return public_ip;
-}
-
 //-----------------------------------------HELPER: Format Speed--------------------------------//
 static string format_speed(double mbps)
 {
@@ -219,185 +189,257 @@ static string format_speed(double mbps)
 	return oss.str();
 }
 
-//-----------------------------------------get_network_download_speed--------------------------------//
+//-----------------------------------------network probes--------------------------------//
 /**
- * Measures actual download speed by downloading test data
- * Uses a fast, lightweight test (downloads ~1-2MB)
- * @return Formatted speed string (e.g., "45.3 Mbps", "1.2 Gbps")
+ * The public IP lookup runs alongside the speed tests. Download and upload
+ * are multi-stream steady-state tests (NetProbe::throughput) and run one
+ * after the other, so they don't compete for the same link.
+ * Results go through Probe ("net:*"), so --replay never touches the network.
  */
-string NetworkInfo::get_network_download_speed()
+static string format_throughput(const ThroughputResult& r)
 {
-	string speed_str = "Unknown";
-
-	// Fast test: Download ~1MB file from cloudflare CDN (very fast servers)
-	HINTERNET hSession = WinHttpOpen(L"SpeedTest/1.0",
-		WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-		WINHTTP_NO_PROXY_NAME,
-		WINHTTP_NO_PROXY_BYPASS,
-		0);
-
-	if (!hSession) return speed_str;
+	if (!r.ok) return "Unknown";
+	ostringstream oss;
+	oss << format_speed(r.goodputMbps) << " (" << r.streamMbps.size() << " streams";
+	if (r.streamMbps.size() > 1 && r.goodputMbps > 0.0)
+	{
+		// Spread between streams, relative to the per-stream mean
+		double mean = r.goodputMbps / r.streamMbps.size();
+		oss << " +/-" << (int)(r.streamStddevMbps / mean * 100.0 + 0.5) << "%";
+	}
+	if (!r.steady) oss << ", unsteady";
+	oss << ")";
+	return oss.str();
+}
 
-	// Set timeout to 5 seconds for fast response
-	DWORD timeout = 5000;
-	WinHttpSetOption(hSession, WINHTTP_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
-	WinHttpSetOption(hSession, WINHTTP_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
+NetworkInfo::ProbeResults NetworkInfo::run_probes(const NetProbeEndpoints& endpoints, bool publicIp, bool download, bool upload, shared_future<void> idle_first)
+{
+	bool live = !Probe::replaying();
 
-	// Use cloudflare's speed test file (1MB)
-	HINTERNET hConnect = WinHttpConnect(hSession, L"speed.cloudflare.com", INTERNET_DEFAULT_HTTP_PORT, 0);
+	// Same network as last time: no request at all
+	string cached_ip;
+	bool ip_cached = publicIp && NetIdentityCache::lookup("public_ip", cached_ip);
 
-	if (!hConnect)
+	future<vector<NetResult>> ip_lookup;
+	if (publicIp && live && !ip_cached)
 	{
-		WinHttpCloseHandle(hSession);
-		return speed_str;
+		NetRequest req;
+		req.url = endpoints.public_ip_url;
+		req.captureLimit = 256;
+		ip_lookup = async(launch::async, [req, timeout = endpoints.timeout_ms]() {
+			return NetProbe::run({ req }, timeout);
+			});
 	}
 
-	HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", L"/__down?bytes=1000000",
-		NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
+	ThroughputConfig test;
+	test.streams = endpoints.streams;
+	test.warmupMs = endpoints.warmup_ms;
+	test.maxDurationMs = endpoints.max_test_ms;
+	test.uploadBytes = endpoints.upload_bytes;
+	test.maxBytes = endpoints.max_test_bytes;
 
-	if (!hRequest)
+	// Saturating the link would show up in the round trips
+	if (idle_first.valid() && (download || upload)) idle_first.wait();
+
+	ProbeResults out;
+	if (download)
 	{
-		WinHttpCloseHandle(hConnect);
-		WinHttpCloseHandle(hSession);
-		return speed_str;
+		out.download = Probe::text("net:download", [&]() -> string {
+			ThroughputConfig config = test;
+			config.url = endpoints.download_url;
+			return format_throughput(NetProbe::throughput(config));
+			});
 	}
-
-	// Start timing
-	auto start_time = high_resolution_clock::now();
-	DWORD total_bytes = 0;
-
-	if (WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-		WINHTTP_NO_REQUEST_DATA, 0, 0, 0) &&
-		WinHttpReceiveResponse(hRequest, NULL))
+	if (upload)
+	{
+		out.upload = Probe::text("net:upload", [&]() -> string {
+			ThroughputConfig config = test;
+			config.url = endpoints.upload_url;
+			config.upload = true;
+			return format_throughput(NetProbe::throughput(config));
+			});
+	}
+	if (ip_cached)
+	{
+		out.public_ip = cached_ip;
+	}
+	else if (publicIp)
 	{
-		DWORD bytes_available = 0;
-		char buffer[8192];
+		out.public_ip = Probe::text("net:public_ip", [&]() -> string {
+			const NetResult r = ip_lookup.get().front();
+			if (!r.ok) return "Unknown";
+			size_t first = r.body.find_first_not_of(" \t\r\n");
+			if (first == string::npos) return "Unknown";
+			return r.body.substr(first, r.body.find_last_not_of(" \t\r\n") - first + 1);
+			});
+		if (out.public_ip != "Unknown") NetIdentityCache::store("public_ip", out.public_ip);
+	}
+	return out;
+}
 
-		// Read all data
-		while (WinHttpQueryDataAvailable(hRequest, &bytes_available) && bytes_available > 0)
-		{
-			DWORD bytes_read = 0;
-			DWORD to_read = min(bytes_available, sizeof(buffer));
+void NetworkInfo::begin_probes(const NetProbeEndpoints& endpoints, bool publicIp, bool download, bool upload)
+{
+	probe_endpoints = endpoints;
+	probing_ip = publicIp;
+	probing_download = download;
+	probing_upload = upload;
+	probes = async(launch::async, &NetworkInfo::run_probes, endpoints, publicIp, download, upload, idle_link()).share();
+}
 
-			if (WinHttpReadData(hRequest, buffer, to_read, &bytes_read))
-			{
-				total_bytes += bytes_read;
-			}
-			else
+//-----------------------------------------latency probes--------------------------------//
+/**
+ * Raw round-trip samples go through Probe ("net:rtt:<name>"); the histogram
+ * and percentiles are computed from them, so --replay reproduces the stats.
+ */
+vector<LatencyReport> NetworkInfo::run_latency(const LatencyProbeConfig& config)
+{
+	vector<LatencySamples> samples;
+	if (!Probe::replaying()) samples = NetProbe::latency(config.targets, config.samples, config.interval_ms, config.timeout_ms);
+
+	vector<LatencyReport> reports;
+	for (size_t i = 0; i < config.targets.size(); i++)
+	{
+		LatencyReport report;
+		report.name = config.targets[i].name;
+		report.endpoint = Probe::text("net:rtt-endpoint:" + report.name, [&]() { return samples[i].endpoint; });
+		report.error = Probe::text("net:rtt-error:" + report.name, [&]() { return samples[i].error; });
+
+		vector<string> raw = Probe::list("net:rtt:" + report.name, [&]() {
+			vector<string> out;
+			for (double ms : samples[i].rttMs)
 			{
-				break;
+				ostringstream oss;
+				oss << fixed << setprecision(3) << ms;
+				out.push_back(oss.str());
 			}
-		}
-
-		// End timing
-		auto end_time = high_resolution_clock::now();
-		auto duration = duration_cast<milliseconds>(end_time - start_time).count();
-
-		if (duration > 0 && total_bytes > 0)
-		{
-			// Calculate speed in Mbps
-			double seconds = duration / 1000.0;
-			double megabits = (total_bytes * 8.0) / 1000000.0;
-			double mbps = megabits / seconds;
+			return out;
+			});
 
-			speed_str = format_speed(mbps);
-		}
+		vector<double> rtt;
+		for (const string& v : raw) rtt.push_back(atof(v.c_str()));
+		report.stats = NetProbe::summarize(rtt);
+		reports.push_back(report);
 	}
+	return reports;
+}
 
-	WinHttpCloseHandle(hRequest);
-	WinHttpCloseHandle(hConnect);
-	WinHttpCloseHandle(hSession);
+void NetworkInfo::begin_latency(const LatencyProbeConfig& config)
+{
+	latency_config = config;
+	latency = async(launch::async, &NetworkInfo::run_latency, config).share();
+}
 
-	return speed_str;
+vector<LatencyReport> NetworkInfo::get_latency()
+{
+	if (!latency.valid()) return run_latency(latency_config);
+	return latency.get();
 }
 
-//-----------------------------------------get_network_upload_speed--------------------------------//
+//-----------------------------------------DNS probe--------------------------------//
 /**
- * Measures actual upload speed by uploading test data
- * Uses a fast, lightweight test (uploads ~500KB)
- * @return Formatted speed string (e.g., "23.5 Mbps", "890 Kbps")
+ * Raw per-query results go through Probe ("net:dns:<n>", one
+ * "ms rcode answers truncated" line per name), so --replay reproduces them.
  */
-string NetworkInfo::get_network_upload_speed()
+vector<DnsReport> NetworkInfo::run_dns(const DnsProbeConfig& config)
 {
-	string speed_str = "Unknown";
-
-	HINTERNET hSession = WinHttpOpen(L"SpeedTest/1.0",
-		WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-		WINHTTP_NO_PROXY_NAME,
-		WINHTTP_NO_PROXY_BYPASS,
-		0);
-
-	if (!hSession) return speed_str;
-
-	// Set timeout to 5 seconds
-	DWORD timeout = 5000;
-	WinHttpSetOption(hSession, WINHTTP_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
-	WinHttpSetOption(hSession, WINHTTP_OPTION_SEND_TIMEOUT, &timeout, sizeof(timeout));
-
-	// Use cloudflare's speed test endpoint
-	HINTERNET hConnect = WinHttpConnect(hSession, L"speed.cloudflare.com", INTERNET_DEFAULT_HTTP_PORT, 0);
-
-	if (!hConnect)
+	vector<DnsResolverResult> results;
+	vector<string> resolvers = Probe::list("net:dns-resolvers", [&]() {
+		results = NetProbe::dns(config.resolvers.empty() ? NetProbe::systemResolvers() : config.resolvers, config.names, config.timeout_ms);
+		vector<string> out;
+		for (const auto& r : results) out.push_back(r.resolver);
+		return out;
+		});
+
+	vector<DnsReport> reports;
+	for (size_t i = 0; i < resolvers.size(); i++)
 	{
-		WinHttpCloseHandle(hSession);
-		return speed_str;
-	}
-
-	HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"POST", L"/__up",
-		NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
-
-	if (!hRequest)
-	{
-		WinHttpCloseHandle(hConnect);
-		WinHttpCloseHandle(hSession);
-		return speed_str;
-	}
-
-	// Create test data (500KB of random data)
-	const DWORD test_size = 500000;
-	char* test_data = new char[test_size];
+		string key = to_string(i);
+		DnsReport report;
+		report.resolver = resolvers[i];
+		report.error = Probe::text("net:dns-error:" + key, [&]() { return results[i].error; });
+
+		vector<string> raw = Probe::list("net:dns:" + key, [&]() {
+			vector<string> out;
+			for (const auto& q : results[i].queries)
+			{
+				ostringstream oss;
+				oss << fixed << setprecision(3) << q.ms << ' ' << q.rcode << ' ' << q.answers << ' ' << (q.truncated ? 1 : 0);
+				out.push_back(oss.str());
+			}
+			return out;
+			});
 
-	// Fill with pattern (faster than random)
-	for (DWORD i = 0; i < test_size; i++)
-	{
-		test_data[i] = (char)(i % 256);
+		vector<double> rtt;
+		for (size_t n = 0; n < raw.size() && n < config.names.size(); n++)
+		{
+			DnsQueryResult q;
+			q.name = config.names[n];
+			int truncated = 0;
+			istringstream(raw[n]) >> q.ms >> q.rcode >> q.answers >> truncated;
+			q.truncated = truncated != 0;
+			report.queries.push_back(q);
+			if (q.rcode != -2) rtt.push_back(q.ms);
+		}
+		report.stats = NetProbe::summarize(rtt);
+		reports.push_back(report);
 	}
+	return reports;
+}
 
-	// Start timing
-	auto start_time = high_resolution_clock::now();
+void NetworkInfo::begin_dns(const DnsProbeConfig& config)
+{
+	dns_config = config;
+	dns = async(launch::async, &NetworkInfo::run_dns, config).share();
+}
 
-	// Send request with data
-	BOOL success = WinHttpSendRequest(hRequest,
-		L"Content-Type: application/octet-stream\r\n",
-		-1,
-		test_data,
-		test_size,
-		test_size,
-		0);
+vector<DnsReport> NetworkInfo::get_dns()
+{
+	if (!dns.valid()) return run_dns(dns_config);
+	return dns.get();
+}
 
-	if (success && WinHttpReceiveResponse(hRequest, NULL))
-	{
-		// End timing
-		auto end_time = high_resolution_clock::now();
-		auto duration = duration_cast<milliseconds>(end_time - start_time).count();
+shared_future<void> NetworkInfo::idle_link() const
+{
+	// Deferred: runs in whichever thread waits on it first
+	return async(launch::deferred, [l = latency, d = dns, g = transfer_gate]() {
+		if (l.valid()) l.wait();
+		if (d.valid()) d.wait();
+		if (g.valid()) g.wait();
+		}).share();
+}
 
-		if (duration > 0)
-		{
-			// Calculate speed in Mbps
-			double seconds = duration / 1000.0;
-			double megabits = (test_size * 8.0) / 1000000.0;
-			double mbps = megabits / seconds;
+void NetworkInfo::hold_transfers(shared_future<void> until)
+{
+	transfer_gate = until;
+}
 
-			speed_str = format_speed(mbps);
-		}
-	}
+//-----------------------------------------get_public_ip--------------------------------//
+string NetworkInfo::get_public_ip()
+{
+	if (!probing_ip) return run_probes(probe_endpoints, true, false, false, idle_link()).public_ip;
+	return probes.get().public_ip;
+}
 
-	delete[] test_data;
-	WinHttpCloseHandle(hRequest);
-	WinHttpCloseHandle(hConnect);
-	WinHttpCloseHandle(hSession);
+//-----------------------------------------get_network_download_speed--------------------------------//
+/**
+ * Measures steady-state download goodput over parallel streams
+ * @return Formatted speed string (e.g., "941.3 Mbps (4 streams +/-2%)")
+ */
+string NetworkInfo::get_network_download_speed()
+{
+	if (!probing_download) return run_probes(probe_endpoints, false, true, false, idle_link()).download;
+	return probes.get().download;
+}
 
-	return speed_str;
+//-----------------------------------------get_network_upload_speed--------------------------------//
+/**
+ * Measures steady-state upload goodput over parallel streams
+ * @return Formatted speed string (e.g., "23.5 Mbps (4 streams +/-5%)")
+ */
+string NetworkInfo::get_network_upload_speed()
+{
+	if (!probing_upload) return run_probes(probe_endpoints, false, false, true, idle_link()).upload;
+	return probes.get().upload;
 }
 
 /*
@@ -407,25 +449,55 @@ string NetworkInfo::get_network_upload_speed()
 
 NEW FUNCTIONS:
 
-1. get_network_download_speed()
-   - Downloads ~1MB test file from Cloudflare CDN
-   - Measures time taken to download
-   - Calculates actual download speed in Mbps/Gbps
-   - Fast execution (~1-2 seconds)
-   - Returns: "45.3 Mbps", "1.2 Gbps", "850 Kbps"
-
-2. get_network_upload_speed()
-   - Uploads ~500KB test data to Cloudflare endpoint
-   - Measures time taken to upload
-   - Calculates actual upload speed in Mbps/Gbps
-   - Fast execution (~1-2 seconds)
-   - Returns: "23.5 Mbps", "890 Kbps", "1.1 Gbps"
+1. begin_probes(endpoints, publicIp, download, upload)
+   - Starts the selected probes in the background (NetProbe)
+   - The public IP lookup has its own timeout (endpoints.timeout_ms)
+   - Endpoints come from network_info.probes in the config
+     (defaults: api.ipify.org and Cloudflare's speed test)
+
+2. get_network_download_speed()
+   - endpoints.streams parallel GETs, each re-requesting when it finishes
+   - The aggregate rate is sampled every 100 ms; the first warmup_ms and
+     everything before the rate settles (5 samples within 10%) is thrown
+     away, then 1 second is measured
+   - Gives up after max_test_ms and reports the last window as "unsteady";
+     stops sooner once max_test_bytes have moved (fast links)
+   - Returns: "941.3 Mbps (4 streams +/-2%)", +/- being the spread between streams
+
+3. get_network_upload_speed()
+   - Same, with parallel POSTs of upload_bytes each
+   - Counts bytes handed to the socket; the steady-state window keeps the
+     initial burst into the send buffers out of the result
+
+4. Public IP / SSID caching (NetIdentityCache)
+   - Both are kept per network fingerprint (default route, gateway MAC,
+     interface addresses, link-change counter) for network_cache.ttl_minutes
+   - A changed fingerprint misses at once; a failed lookup isn't cached
+
+5. begin_latency(config) / get_latency()
+   - TCP connect or UDP echo round trips to each network_latency target,
+     all targets at once, samples x interval_ms apart
+   - "gateway" as a host means the default gateway
+   - Per target: min / p50 / p99 / max from an HDR-style histogram, jitter
+     (mean difference between consecutive samples) and loss
+   - The speed tests wait for it, so the RTTs are taken on an idle link
+
+6. begin_dns(config) / get_dns()
+   - One A query per name to each resolver (/etc/resolv.conf or the
+     adapters' DNS servers unless dns_latency.resolvers lists some), sent as
+     raw UDP and parsed here, every resolver at once under timeout_ms
+   - Per resolver: min / p50 / max reply time, timeouts as loss, and the
+     rcode of anything that wasn't NOERROR
+   - The speed tests wait for it too
 
 FEATURES:
-- Uses Cloudflare's speed test infrastructure (fast, reliable)
-- 5-second timeout to prevent hanging
+- Download and upload run one after the other, each capped at max_test_ms
+  and max_test_bytes (20 MB); the public IP lookup runs alongside them
+- Plain HTTP endpoints (http:// redirects are followed, https:// ones are
+  reported as errors); point them at an internal mirror or at
+  "binaryfetch --serve-probes" on air-gapped sites
 - Automatic unit formatting (Kbps/Mbps/Gbps)
-- Returns "Unknown" if test fails
+- Returns "Unknown" if a probe fails
 
 EXAMPLE OUTPUTS:
 - Download: "85.3 Mbps"
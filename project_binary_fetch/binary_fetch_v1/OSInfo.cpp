@@ -1,170 +1,81 @@
 #include "include\OSInfo.h"
+#include "include\WMIQuery.h"
+#include "include\Probe.h"
 #include <Windows.h>
 #include <VersionHelpers.h>
-#include <comdef.h>
-#include <Wbemidl.h>
 #include <winreg.h>
 #include <tchar.h>
 using namespace std;
-#pragma comment(lib, "wbemuuid.lib")
 
 // Get Windows version using RtlGetVersion----------------------------------------------------------------------------------
 typedef LONG(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
 
 string OSInfo::GetOSVersion() {
-    HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
-    if (hMod) {
-        RtlGetVersionPtr fn = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
-        if (fn) {
-            RTL_OSVERSIONINFOW rovi = { 0 };
-            rovi.dwOSVersionInfoSize = sizeof(rovi);
-            if (fn(&rovi) == 0) {
-                return "Windows " + to_string(rovi.dwMajorVersion) + "." +
-                    to_string(rovi.dwMinorVersion) + " Build " +
-                    to_string(rovi.dwBuildNumber);
+    return Probe::text("ntdll:os-version", []() -> string {
+        HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
+        if (hMod) {
+            RtlGetVersionPtr fn = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
+            if (fn) {
+                RTL_OSVERSIONINFOW rovi = { 0 };
+                rovi.dwOSVersionInfoSize = sizeof(rovi);
+                if (fn(&rovi) == 0) {
+                    return "Windows " + to_string(rovi.dwMajorVersion) + "." +
+                        to_string(rovi.dwMinorVersion) + " Build " +
+                        to_string(rovi.dwBuildNumber);
+                }
             }
         }
-    }
-    return "Unknown Windows version";
+        return "Unknown Windows version";
+    });
 }
 
 // Get 32-bit or 64-bit architecture------------------------------------------------------------------------------------
 string OSInfo::GetOSArchitecture() {
-    BOOL is64bitOS = FALSE;
+    return Probe::text("kernel32:os-bitness", []() -> string {
+        BOOL is64bitOS = FALSE;
 #ifdef _WIN64
-    is64bitOS = TRUE; // 64-bit program on 64-bit Windows
+        is64bitOS = TRUE; // 64-bit program on 64-bit Windows
 #else
-    // 32-bit program, check if OS is 64-bit
-    BOOL bWow64 = FALSE;
-    if (IsWow64Process(GetCurrentProcess(), &bWow64)) {
-        is64bitOS = bWow64;
-    }
+        // 32-bit program, check if OS is 64-bit
+        BOOL bWow64 = FALSE;
+        if (IsWow64Process(GetCurrentProcess(), &bWow64)) {
+            is64bitOS = bWow64;
+        }
 #endif
-    return is64bitOS ? "64-bit" : "32-bit";
+        return is64bitOS ? "64-bit" : "32-bit";
+    });
 }
 
-// Get Windows edition (Home, Pro, Enterprise) via WMI--------------------------------------------------------------------------
-string OSInfo::GetOSName() {
-    HRESULT hres;
-
-    // Initialize COM
-    hres = CoInitializeEx(0, COINIT_MULTITHREADED);
-    if (FAILED(hres)) return "Unknown Edition";
-
-    // Initialize WMI
-    hres = CoInitializeSecurity(NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL);
-    if (FAILED(hres)) return "Unknown Edition";
-
-    IWbemLocator* pLoc = NULL;
-    hres = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&pLoc);
-    if (FAILED(hres)) return "Unknown Edition";
-
-    IWbemServices* pSvc = NULL;
-    hres = pLoc->ConnectServer(
-        _bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0,
-        NULL, 0, 0, &pSvc);
-    if (FAILED(hres)) {
-        pLoc->Release();
-        return "Unknown Edition";
-    }
-
-    hres = CoSetProxyBlanket(
-        pSvc, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-        RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE);
-    if (FAILED(hres)) {
-        pSvc->Release();
-        pLoc->Release();
-        return "Unknown Edition";
-    }
-
-    IEnumWbemClassObject* pEnumerator = NULL;
-    hres = pSvc->ExecQuery(
-        bstr_t("WQL"),
-        bstr_t("SELECT Caption FROM Win32_OperatingSystem"),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL,
-        &pEnumerator);
-    if (FAILED(hres)) {
-        pSvc->Release();
-        pLoc->Release();
-        return "Unknown Edition";
-    }
-
-    IWbemClassObject* pclsObj = NULL;
-    ULONG uReturn = 0;
-    string osName = "Unknown Edition";
-
-    if (pEnumerator) {
-        if (pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn) == S_OK) {
-            VARIANT vtProp;
-            if (SUCCEEDED(pclsObj->Get(L"Caption", 0, &vtProp, 0, 0))) {
-                _bstr_t bstrOS(vtProp.bstrVal);
-                osName = string((char*)bstrOS);
-            }
-            VariantClear(&vtProp);
-            pclsObj->Release();
-        }
-        pEnumerator->Release();
-    }
+// Win32_OperatingSystem fields used below — declared together so WMIQuery runs ONE SELECT for all of them
+void OSInfo::plan_wmi()
+{
+    WMIQuery::want("Win32_OperatingSystem", { "Caption", "SerialNumber", "InstallDate" });
+}
 
-    pSvc->Release();
-    pLoc->Release();
-    CoUninitialize();
+static string os_field(const string& property)
+{
+    return WMIQuery::get("Win32_OperatingSystem", property);
+}
 
-    return osName;
+// Get Windows edition (Home, Pro, Enterprise) via WMI--------------------------------------------------------------------------
+string OSInfo::GetOSName() {
+    string caption = os_field("Caption");
+    return (caption == "Unknown" || caption.empty()) ? "Unknown Edition" : caption;
 }
 //function to get os serial number-----------------------------------------------------------------------------------------
 string OSInfo::get_os_serial_number()
 {
-    string serial_number = "Unknown"; //initially it's unknown
-
-    if (FAILED(CoInitializeEx(0, COINIT_MULTITHREADED)))
-        return serial_number;
-    CoInitializeSecurity(NULL, -1, NULL, NULL,
-        RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE, NULL);
-
-    IWbemLocator* locator = nullptr;
-    CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-        IID_IWbemLocator, (LPVOID*)&locator);
-
-    IWbemServices* service = nullptr;
-    locator->ConnectServer (_bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0, NULL, 0, 0, &service);
-    CoSetProxyBlanket(service, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-        RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-
-    IEnumWbemClassObject* enumerator = nullptr;
-    service->ExecQuery(bstr_t("WQL"),
-        bstr_t("SELECT SerialNumber FROM Win32_OperatingSystem"),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL, &enumerator);
-
-    IWbemClassObject* obj = nullptr;
-    ULONG ret = 0;
-    if (enumerator && enumerator->Next(WBEM_INFINITE, 1, &obj, &ret) == S_OK)
-    {
-        VARIANT vtProp;
-        obj->Get(L"SerialNumber", 0, &vtProp, 0, 0);
-        _bstr_t bstr(vtProp.bstrVal);
-        VariantClear(&vtProp);
-        obj->Release();
-    }
-
-    if (enumerator) enumerator->Release();
-    service->Release();
-    locator->Release();
-
-    return serial_number;
+    string serial_number = os_field("SerialNumber"); // "Unknown" when WMI has nothing
+    return serial_number.empty() ? "Unknown" : serial_number;
 }
 // function to show os uptime----------------------------------------------------------------------------------------------
 string OSInfo::get_os_uptime()
 {
     // Get the number of milliseconds since the system started
-    ULONGLONG ms = GetTickCount64();
+    // (through Probe, same key as CompactOS, so --replay shows the recorded uptime)
+    ULONGLONG ms = static_cast<ULONGLONG>(Probe::number("kernel32:tick-count64", []() -> double {
+        return static_cast<double>(GetTickCount64());
+    }));
 
     // Convert milliseconds to total seconds
     ULONGLONG total_seconds = ms / 1000;
@@ -218,137 +129,73 @@ string OSInfo::get_os_uptime()
 //function to get os install date-------------------------------------------------------------------------------------------
 string OSInfo::get_os_install_date()
 {
-    HRESULT hres;
-    hres = CoInitializeEx(0, COINITBASE_MULTITHREADED);
-    if (FAILED(hres)) return "Unknown";
-
-    hres = CoInitializeSecurity(
-        NULL,                     // Security descriptor
-        -1,                       // Count of authentication services
-        NULL,                     // Authentication services
-        NULL,                     // Reserved
-        RPC_C_AUTHN_LEVEL_DEFAULT,// Authentication level
-        RPC_C_IMP_LEVEL_IMPERSONATE, // Impersonation level
-        NULL,                     // Authentication list
-        EOAC_NONE,                // Capabilities
-        NULL                      // Reserved
-
-        );
-    if (FAILED(hres)) return "Unknown";
-
-    IWbemLocator* pLoc = NULL;
-    hres = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER, IID_IWbemLocator, (LPVOID*)&pLoc);
-    if (FAILED(hres)) return "Unknown";
-
-    IWbemServices* pSvc = NULL;
-    hres = pLoc->ConnectServer(
-        _bstr_t(L"ROOT\\CIMV2"),  // Namespace
-        NULL,                      // User
-        NULL,                      // Password
-        NULL,                      // Locale
-        0,                         // Security flags
-        NULL,                      // Authority
-        NULL,                      // Context
-        &pSvc                      // IWbemServices pointer
-    );
-    if (FAILED(hres)) { pLoc->Release(); return "Unknown"; }
-
-    CoSetProxyBlanket(pSvc, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL, RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE,
-        NULL, EOAC_NONE);
-
-    IEnumWbemClassObject* pEnumerator = NULL;
-    hres = pSvc->ExecQuery(
-        bstr_t("WQL"),
-        bstr_t("SELECT InstallDate FROM Win32_OperatingSystem"),
-        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-        NULL, &pEnumerator);
-    if (FAILED(hres)) { pSvc->Release(); pLoc->Release(); return "Unknown"; }
-
-    IWbemClassObject* pclsObj = NULL;
-    ULONG uReturn = 0;
-    string installDate = "Unknown";
-
-    if (pEnumerator && pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn) == S_OK) {
-        VARIANT vtProp;
-        if (SUCCEEDED(pclsObj->Get(L"InstallDate", 0, &vtProp, 0, 0))) {
-            // Convert WMI datetime string to readable format YYYY-MM-DD
-            wstring wstr(vtProp.bstrVal, SysStringLen(vtProp.bstrVal));
-            installDate = string(wstr.begin(), wstr.begin() + 4) + "-" +  // Year
-                string(wstr.begin() + 4, wstr.begin() + 6) + "-" + // Month
-                string(wstr.begin() + 6, wstr.begin() + 8);        // Day
-        }
-        VariantClear(&vtProp);
-        pclsObj->Release();
-    }
-
-    if (pEnumerator) pEnumerator->Release();
-    pSvc->Release();
-    pLoc->Release();
-    CoUninitialize();
-
-    return installDate;
-
+    // WMI datetime looks like 20230415123456.000000+060 -> keep YYYY-MM-DD
+    string raw = os_field("InstallDate");
+    if (raw.size() < 8) return "Unknown";
+    return raw.substr(0, 4) + "-" + raw.substr(4, 2) + "-" + raw.substr(6, 2);
 }
 
 //get os kernel version (major.major.build)
 string OSInfo::get_os_kernel_info()
 {
-    string result = "WIN32_NT "; // platform prefix
+    return Probe::text("ntdll:kernel-info", []() -> string {
+        string result = "WIN32_NT "; // platform prefix
 
-    // Step 1: Get Major.Minor.Build
-    HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
-    if (hMod)
-    {
-        typedef LONG(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
-        RtlGetVersionPtr fn = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
-        if (fn)
+        // Step 1: Get Major.Minor.Build
+        HMODULE hMod = GetModuleHandleW(L"ntdll.dll");
+        if (hMod)
         {
-            RTL_OSVERSIONINFOW rovi = { 0 };
-            rovi.dwOSVersionInfoSize = sizeof(rovi);
-            if (fn(&rovi) == 0)
+            typedef LONG(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
+            RtlGetVersionPtr fn = (RtlGetVersionPtr)GetProcAddress(hMod, "RtlGetVersion");
+            if (fn)
             {
-                result += to_string(rovi.dwMajorVersion) + "." +
-                    to_string(rovi.dwMinorVersion) + "." +
-                    to_string(rovi.dwBuildNumber);
+                RTL_OSVERSIONINFOW rovi = { 0 };
+                rovi.dwOSVersionInfoSize = sizeof(rovi);
+                if (fn(&rovi) == 0)
+                {
+                    result += to_string(rovi.dwMajorVersion) + "." +
+                        to_string(rovi.dwMinorVersion) + "." +
+                        to_string(rovi.dwBuildNumber);
+                }
             }
         }
-    }
 
-    // Step 2: Get UBR (update build revision)
-    HKEY hKey;
-    DWORD ubr = 0;
-    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-        L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion",
-        0, KEY_READ, &hKey) == ERROR_SUCCESS)
-    {
-        DWORD type = 0;
-        DWORD data_size = sizeof(DWORD);
-        RegQueryValueExW(hKey, L"UBR", nullptr, &type, reinterpret_cast<BYTE*>(&ubr), &data_size);
-        RegCloseKey(hKey);
-        if (ubr != 0)
+        // Step 2: Get UBR (update build revision)
+        HKEY hKey;
+        DWORD ubr = 0;
+        if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
+            L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion",
+            0, KEY_READ, &hKey) == ERROR_SUCCESS)
         {
-            result += "." + to_string(ubr);
+            DWORD type = 0;
+            DWORD data_size = sizeof(DWORD);
+            RegQueryValueExW(hKey, L"UBR", nullptr, &type, reinterpret_cast<BYTE*>(&ubr), &data_size);
+            RegCloseKey(hKey);
+            if (ubr != 0)
+            {
+                result += "." + to_string(ubr);
+            }
         }
-    }
 
-    // Step 3: Get Display Version / ReleaseId (like 23H2)
-    wchar_t releaseId[20] = { 0 };
-    DWORD bufSize = sizeof(releaseId);
-    HKEY hKey2;
-    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
-        L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion",
-        0, KEY_READ, &hKey2) == ERROR_SUCCESS)
-    {
-        RegQueryValueExW(hKey2, L"DisplayVersion", nullptr, nullptr,
-            reinterpret_cast<BYTE*>(releaseId), &bufSize);
-        RegCloseKey(hKey2);
-        if (wcslen(releaseId) > 0)
+        // Step 3: Get Display Version / ReleaseId (like 23H2)
+        wchar_t releaseId[20] = { 0 };
+        DWORD bufSize = sizeof(releaseId);
+        HKEY hKey2;
+        if (RegOpenKeyExW(HKEY_LOCAL_MACHINE,
+            L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion",
+            0, KEY_READ, &hKey2) == ERROR_SUCCESS)
         {
-            wstring ws(releaseId);
-            string version(ws.begin(), ws.end());
-            result += " (" + version + ")";
+            RegQueryValueExW(hKey2, L"DisplayVersion", nullptr, nullptr,
+                reinterpret_cast<BYTE*>(releaseId), &bufSize);
+            RegCloseKey(hKey2);
+            if (wcslen(releaseId) > 0)
+            {
+                wstring ws(releaseId);
+                string version(ws.begin(), ws.end());
+                result += " (" + version + ")";
+            }
         }
-    }
 
-    return result;
+        return result;
+    });
 }
\ No newline at end of file
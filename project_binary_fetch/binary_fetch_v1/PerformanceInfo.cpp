@@ -1,4 +1,5 @@
 #include "include\PerformanceInfo.h"
+#include "include\Probe.h"
 #include <pdhmsg.h>
 #include <thread>
 #include <chrono>
@@ -82,18 +83,20 @@ std::string PerformanceInfo::get_system_uptime() {
 
 // -------------------- CPU Usage --------------------
 float PerformanceInfo::get_cpu_usage_percent() {
-    if (!pImpl || !pImpl->cpuInitialized) return 0.0f;
+    double val = Probe::number("pdh:\\Processor(_Total)\\% Processor Time", [this]() -> double {
+        if (!pImpl || !pImpl->cpuInitialized) return 0.0;
 
-    PDH_FMT_COUNTERVALUE counterVal;
-    PdhCollectQueryData(pImpl->cpuQuery);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    PdhCollectQueryData(pImpl->cpuQuery);
+        PDH_FMT_COUNTERVALUE counterVal;
+        PdhCollectQueryData(pImpl->cpuQuery);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        PdhCollectQueryData(pImpl->cpuQuery);
 
-    if (PdhGetFormattedCounterValue(pImpl->cpuTotal, PDH_FMT_DOUBLE, NULL, &counterVal) != ERROR_SUCCESS) {
-        return 0.0f;
-    }
+        if (PdhGetFormattedCounterValue(pImpl->cpuTotal, PDH_FMT_DOUBLE, NULL, &counterVal) != ERROR_SUCCESS) {
+            return 0.0;
+        }
+        return counterVal.doubleValue;
+    });
 
-    double val = counterVal.doubleValue;
     if (val < 0.0) val = 0.0;
     if (val > 100.0) val = 100.0;
     return static_cast<float>(val);
@@ -101,25 +104,32 @@ float PerformanceInfo::get_cpu_usage_percent() {
 
 // -------------------- RAM Usage --------------------
 float PerformanceInfo::get_ram_usage_percent() {
-    MEMORYSTATUSEX memInfo;
-    memInfo.dwLength = sizeof(memInfo);
-    if (!GlobalMemoryStatusEx(&memInfo)) return 0.0f;
-    return static_cast<float>(memInfo.dwMemoryLoad);
+    // Same key as CompactMemory::get_used_memory_percent
+    return static_cast<float>(Probe::number("mem:load", []() -> double {
+        MEMORYSTATUSEX memInfo;
+        memInfo.dwLength = sizeof(memInfo);
+        if (!GlobalMemoryStatusEx(&memInfo)) return 0.0;
+        return static_cast<double>(memInfo.dwMemoryLoad);
+    }));
 }
 
 // -------------------- Disk Usage --------------------
 float PerformanceInfo::get_disk_usage_percent() {
-    ULARGE_INTEGER freeBytesAvailable, totalBytes, freeBytes;
-    if (!GetDiskFreeSpaceEx(L"C:\\", &freeBytesAvailable, &totalBytes, &freeBytes)) return 0.0f;
-    if (totalBytes.QuadPart == 0) return 0.0f;
-    double used = 1.0 - (static_cast<double>(freeBytes.QuadPart) / static_cast<double>(totalBytes.QuadPart));
-    if (used < 0.0) used = 0.0;
+    // Used fraction of C: goes through Probe (-1 = the call failed)
+    double used = Probe::number("kernel32:disk-used-fraction:C:", []() -> double {
+        ULARGE_INTEGER freeBytesAvailable, totalBytes, freeBytes;
+        if (!GetDiskFreeSpaceEx(L"C:\\", &freeBytesAvailable, &totalBytes, &freeBytes)) return -1.0;
+        if (totalBytes.QuadPart == 0) return -1.0;
+        return 1.0 - (static_cast<double>(freeBytes.QuadPart) / static_cast<double>(totalBytes.QuadPart));
+    });
+    if (used < 0.0) return 0.0f;
     if (used > 1.0) used = 1.0;
     return static_cast<float>(used * 100.0);
 }
 
 // -------------------- GPU Usage --------------------
 float PerformanceInfo::get_gpu_usage_percent() {
+    Probe::unrouted("NvAPI / PDH GPU engine (PerformanceInfo)");
     // --- NVIDIA via NVAPI ---
     if (isNvapiAvailable() && NvAPI_Initialize() == NVAPI_OK) {
         NvPhysicalGpuHandle gpuHandles[64];
@@ -0,0 +1,270 @@
+#include "include\Probe.h"
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+// ----------------- Snapshot state -----------------
+
+namespace {
+    mutex probeMutex;
+    atomic<Probe::Mode> probeMode{ Probe::Mode::Live };    // read without the lock on every probe
+    string snapshotPath;
+    map<string, vector<string>> snapshot;   // key -> values in read order
+    map<string, size_t> replayCursor;       // key -> next value to hand out
+    set<string> unroutedReads;              // live reads seen while replaying
+
+    void record(const string& key, const string& value) {
+        lock_guard<mutex> lock(probeMutex);
+        snapshot[key].push_back(value);
+    }
+
+    bool replay(const string& key, string& out) {
+        lock_guard<mutex> lock(probeMutex);
+        auto it = snapshot.find(key);
+        if (it == snapshot.end() || it->second.empty()) return false;
+
+        // Hand values out in order; once exhausted keep returning the last one
+        size_t& pos = replayCursor[key];
+        out = it->second[min(pos, it->second.size() - 1)];
+        if (pos < it->second.size()) pos++;
+        return true;
+    }
+
+    bool validUtf8(const string& s) {
+        size_t i = 0;
+        while (i < s.size()) {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            size_t extra;
+            uint32_t cp;
+            if (c < 0x80) { i++; continue; }
+            if ((c & 0xE0) == 0xC0) { extra = 1; cp = c & 0x1F; }
+            else if ((c & 0xF0) == 0xE0) { extra = 2; cp = c & 0x0F; }
+            else if ((c & 0xF8) == 0xF0) { extra = 3; cp = c & 0x07; }
+            else return false;
+            if (i + extra >= s.size()) return false;           // truncated sequence
+            for (size_t k = 1; k <= extra; k++) {
+                unsigned char d = static_cast<unsigned char>(s[i + k]);
+                if ((d & 0xC0) != 0x80) return false;
+                cp = (cp << 6) | (d & 0x3F);
+            }
+            // Overlong forms, surrogates and past U+10FFFF are invalid too
+            static const uint32_t least[4] = { 0, 0x80, 0x800, 0x10000 };
+            if (cp < least[extra] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+            i += extra + 1;
+        }
+        return true;
+    }
+
+    // Values that aren't UTF-8 (raw sysfs / registry / EDID text) can't be JSON
+    // strings as they are; they're stored as {"hex": "..."} and come back byte for byte
+    json encodeValue(const string& value) {
+        if (validUtf8(value)) return value;
+        return json{ { "hex", Probe::toHex(vector<unsigned char>(value.begin(), value.end())) } };
+    }
+
+    string decodeValue(const json& value) {
+        if (value.is_string()) return value.get<string>();
+        vector<unsigned char> raw = Probe::fromHex(value.at("hex").get<string>());
+        return string(raw.begin(), raw.end());
+    }
+}
+
+bool Probe::begin(Mode mode, const string& path) {
+    lock_guard<mutex> lock(probeMutex);
+    probeMode = mode;
+    snapshotPath = path;
+    snapshot.clear();
+    replayCursor.clear();
+    unroutedReads.clear();
+
+    if (mode != Mode::Replay) return true;
+
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+    try {
+        json doc = json::parse(in);
+        for (auto& item : doc.at("probes").items()) {
+            vector<string>& values = snapshot[item.key()];
+            for (const auto& value : item.value()) values.push_back(decodeValue(value));
+        }
+    }
+    catch (...) {
+        return false;
+    }
+    return true;
+}
+
+bool Probe::end() {
+    lock_guard<mutex> lock(probeMutex);
+    if (probeMode != Mode::Record) return true;
+
+    json doc;
+    doc["version"] = 2;     // 2: non-UTF-8 values as {"hex": ...}; 1 still loads
+    doc["probes"] = json::object();
+    for (const auto& kv : snapshot) {
+        json values = json::array();
+        for (const auto& value : kv.second) values.push_back(encodeValue(value));
+        doc["probes"][kv.first] = values;
+    }
+
+    ofstream out(snapshotPath, ios::binary);
+    if (!out) return false;
+    out << doc.dump(1, ' ', false);
+    return static_cast<bool>(out);
+}
+
+Probe::Mode Probe::mode() {
+    return probeMode.load();
+}
+
+void Probe::unrouted(const string& source) {
+    lock_guard<mutex> lock(probeMutex);
+    if (probeMode == Mode::Replay) unroutedReads.insert(source);
+}
+
+vector<string> Probe::unroutedSources() {
+    lock_guard<mutex> lock(probeMutex);
+    return vector<string>(unroutedReads.begin(), unroutedReads.end());
+}
+
+// ----------------- Typed accessors -----------------
+
+string Probe::text(const string& key, const function<string()>& fetch) {
+    Mode m = mode();
+    if (m == Mode::Replay) {
+        string value;
+        replay(key, value);
+        return value;
+    }
+    string value = fetch();
+    if (m == Mode::Record) record(key, value);
+    return value;
+}
+
+double Probe::number(const string& key, const function<double()>& fetch) {
+    Mode m = mode();
+    if (m == Mode::Replay) {
+        string value;
+        if (!replay(key, value)) return 0.0;
+        try { return stod(value); }
+        catch (...) { return 0.0; }
+    }
+    double value = fetch();
+    if (m == Mode::Record) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.17g", value);
+        record(key, buf);
+    }
+    return value;
+}
+
+vector<unsigned char> Probe::bytes(const string& key, const function<vector<unsigned char>()>& fetch) {
+    Mode m = mode();
+    if (m == Mode::Replay) {
+        string value;
+        replay(key, value);
+        return fromHex(value);
+    }
+    vector<unsigned char> value = fetch();
+    if (m == Mode::Record) record(key, toHex(value));
+    return value;
+}
+
+vector<string> Probe::list(const string& key, const function<vector<string>()>& fetch) {
+    // Stored as one newline-joined value so each listing stays a single ordered read
+    string joined = text(key, [&]() {
+        string out;
+        for (const auto& item : fetch()) {
+            out += item;
+            out += '\n';
+        }
+        return out;
+    });
+
+    vector<string> items;
+    istringstream in(joined);
+    string line;
+    while (getline(in, line)) items.push_back(line);
+    return items;
+}
+
+// ----------------- Pseudo-file helpers -----------------
+
+string Probe::file(const string& path) {
+    return text("file:" + path, [&]() -> string {
+        ifstream in(path, ios::binary);
+        if (!in) return "";
+        return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    });
+}
+
+vector<string> Probe::dir(const string& path) {
+    return list("dir:" + path, [&]() {
+        vector<string> names;
+#ifdef _WIN32
+        WIN32_FIND_DATAA fd;
+        HANDLE h = FindFirstFileA((path + "\\*").c_str(), &fd);
+        if (h != INVALID_HANDLE_VALUE) {
+            do {
+                if (fd.cFileName[0] != '.') names.push_back(fd.cFileName);
+            } while (FindNextFileA(h, &fd));
+            FindClose(h);
+        }
+#else
+        DIR* d = opendir(path.c_str());
+        if (d) {
+            while (dirent* entry = readdir(d)) {
+                if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+            }
+            closedir(d);
+        }
+#endif
+        sort(names.begin(), names.end());
+        return names;
+    });
+}
+
+string Probe::toHex(const vector<unsigned char>& data) {
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    hex.reserve(data.size() * 2);
+    for (unsigned char b : data) {
+        hex += digits[b >> 4];
+        hex += digits[b & 0x0F];
+    }
+    return hex;
+}
+
+vector<unsigned char> Probe::fromHex(const string& hex) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    vector<unsigned char> data;
+    data.reserve(hex.size() / 2);
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        int hi = nibble(hex[i]), lo = nibble(hex[i + 1]);
+        if (hi < 0 || lo < 0) break;
+        data.push_back(static_cast<unsigned char>((hi << 4) | lo));
+    }
+    return data;
+}
@@ -0,0 +1,304 @@
+#include "include\PseudoFileReader.h"
+#include "include\IoRing.h"
+#include "include\Probe.h"
+
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+// ----------------- io_uring state -----------------
+
+struct PseudoFileReader::Ring {
+    static const unsigned DEPTH = 64;
+    IoRing ring{ DEPTH };
+};
+
+// ----------------- Lifetime / registration -----------------
+
+PseudoFileReader::PseudoFileReader(bool useIoUring) : useIoUring(useIoUring) {}
+
+PseudoFileReader::~PseudoFileReader()
+{
+    close();
+}
+
+int PseudoFileReader::add(const string& path, size_t sizeHint)
+{
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].path == path) return static_cast<int>(i);
+    }
+
+    Slot slot;
+    slot.path = path;
+    slot.offset = arena.size();
+    slot.capacity = sizeHint > 0 ? sizeHint : 128;
+    arena.resize(arena.size() + slot.capacity);
+    slots.push_back(slot);
+    return static_cast<int>(slots.size() - 1);
+}
+
+void PseudoFileReader::close()
+{
+    for (auto& slot : slots) closeSlot(slot);
+}
+
+bool PseudoFileReader::batching() const
+{
+    return useIoUring && ring && ring->ring.ready();
+}
+
+// Re-lays the arena so `handle` gets `capacity` bytes; other slots keep their content
+void PseudoFileReader::grow(int handle, size_t capacity)
+{
+    vector<char> next;
+    size_t offset = 0;
+    for (size_t i = 0; i < slots.size(); ++i) offset += (static_cast<int>(i) == handle) ? capacity : slots[i].capacity;
+    next.resize(offset);
+
+    offset = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        Slot& slot = slots[i];
+        if (slot.length) memcpy(next.data() + offset, arena.data() + slot.offset, slot.length);
+        slot.offset = offset;
+        if (static_cast<int>(i) == handle) slot.capacity = capacity;
+        offset += slot.capacity;
+    }
+    arena.swap(next);
+}
+
+void PseudoFileReader::store(int handle, const string& content)
+{
+    if (content.size() > slots[handle].capacity) grow(handle, content.size());
+    Slot& slot = slots[handle];
+    if (!content.empty()) memcpy(arena.data() + slot.offset, content.data(), content.size());
+    slot.length = content.size();
+}
+
+// ----------------- Reading -----------------
+
+#ifdef _WIN32
+
+bool PseudoFileReader::openSlot(Slot&) { return false; }
+void PseudoFileReader::closeSlot(Slot& slot) { slot.fd = -1; }
+
+void PseudoFileReader::readSync(int handle)
+{
+    // No procfs/sysfs here; kept so fixture paths still work
+    ifstream in(slots[handle].path, ios::binary);
+    slots[handle].ok = static_cast<bool>(in);
+    store(handle, in ? string(istreambuf_iterator<char>(in), istreambuf_iterator<char>()) : string());
+}
+
+void PseudoFileReader::readBatch(const vector<int>& handles)
+{
+    for (int h : handles) readSync(h);
+}
+
+#else
+
+bool PseudoFileReader::openSlot(Slot& slot)
+{
+    if (slot.fd >= 0) return true;
+    slot.fd = ::open(slot.path.c_str(), O_RDONLY | O_CLOEXEC);
+    return slot.fd >= 0;
+}
+
+void PseudoFileReader::closeSlot(Slot& slot)
+{
+    if (slot.fd >= 0) ::close(slot.fd);
+    slot.fd = -1;
+}
+
+void PseudoFileReader::readSync(int handle)
+{
+    if (!openSlot(slots[handle])) {
+        slots[handle].ok = false;
+        slots[handle].length = 0;
+        return;
+    }
+
+    // A read that fills the slot may have been truncated: grow and read again
+    for (;;) {
+        Slot& slot = slots[handle];
+        ssize_t n;
+        do {
+            n = pread(slot.fd, arena.data() + slot.offset, slot.capacity, 0);
+        } while (n < 0 && errno == EINTR);
+
+        if (n < 0) {
+            closeSlot(slot);
+            slot.ok = false;
+            slot.length = 0;
+            return;
+        }
+        slot.length = static_cast<size_t>(n);
+        slot.ok = true;
+        if (slot.length < slot.capacity) return;
+        grow(handle, slot.capacity * 2);
+    }
+}
+
+void PseudoFileReader::readBatch(const vector<int>& handles)
+{
+    if (useIoUring && !ring) ring.reset(new Ring());
+    if (useIoUring && ring->ring.ready() && handles.size() > 1) {
+        vector<int> retry;
+        for (size_t start = 0; start < handles.size(); start += Ring::DEPTH) {
+            size_t end = min(handles.size(), start + static_cast<size_t>(Ring::DEPTH));
+            unsigned queued = 0;
+
+            for (size_t i = start; i < end; ++i) {
+                int h = handles[i];
+                if (!openSlot(slots[h])) {
+                    slots[h].ok = false;
+                    slots[h].length = 0;
+                    continue;
+                }
+                if (!ring->ring.read(slots[h].fd, arena.data() + slots[h].offset,
+                    static_cast<unsigned>(slots[h].capacity), 0, static_cast<uint64_t>(h))) {
+                    retry.push_back(h);
+                    continue;
+                }
+                queued++;
+            }
+            if (queued == 0) continue;
+
+            if (ring->ring.submit(queued) < 0) {
+                // Ring unusable; this chunk and the rest are read synchronously below
+                ring.reset();
+                useIoUring = false;
+                for (size_t i = start; i < handles.size(); ++i) retry.push_back(handles[i]);
+                break;
+            }
+
+            for (unsigned done = 0; done < queued; ++done) {
+                uint64_t tag = 0;
+                int res = 0;
+                if (!ring->ring.wait(tag, res)) {
+                    // Closing the ring cancels what it still holds before the sync
+                    // retries below can grow (move) the arena
+                    ring.reset();
+                    useIoUring = false;
+                    for (size_t i = start; i < handles.size(); ++i) retry.push_back(handles[i]);
+                    break;
+                }
+                int h = static_cast<int>(tag);
+
+                Slot& slot = slots[h];
+                if (res < 0) {
+                    // EINTR/EAGAIN and friends: let the sync path sort it out
+                    retry.push_back(h);
+                    continue;
+                }
+                slot.length = static_cast<size_t>(res);
+                slot.ok = true;
+                if (slot.length >= slot.capacity) retry.push_back(h);   // truncated
+            }
+            if (!ring) break;
+        }
+        for (int h : retry) readSync(h);
+        return;
+    }
+    for (int h : handles) readSync(h);
+}
+
+#endif
+
+bool PseudoFileReader::refresh()
+{
+    vector<int> all(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) all[i] = static_cast<int>(i);
+    return refresh(all);
+}
+
+bool PseudoFileReader::refresh(const vector<int>& handles)
+{
+    if (Probe::mode() != Probe::Mode::Live) {
+        // Snapshot runs: same "file:" keys as Probe::file, one value per refresh
+        for (int h : handles) {
+            string content = Probe::text("file:" + slots[h].path, [&]() {
+                readSync(h);
+                return slots[h].ok ? string(arena.data() + slots[h].offset, slots[h].length) : string();
+            });
+            store(h, content);
+            slots[h].ok = !content.empty();
+        }
+    }
+    else {
+        readBatch(handles);
+    }
+
+    bool all = true;
+    for (int h : handles) all = all && slots[h].ok;
+    return all;
+}
+
+// ----------------- Accessors / parsing -----------------
+
+bool PseudoFileReader::ok(int handle) const
+{
+    return handle >= 0 && handle < static_cast<int>(slots.size()) && slots[handle].ok;
+}
+
+string_view PseudoFileReader::text(int handle) const
+{
+    if (!ok(handle)) return string_view();
+    return string_view(arena.data() + slots[handle].offset, slots[handle].length);
+}
+
+string_view PseudoFileReader::line(int handle) const
+{
+    string_view t = text(handle);
+    size_t nl = t.find('\n');
+    if (nl != string_view::npos) t = t.substr(0, nl);
+    while (!t.empty() && (t.back() == ' ' || t.back() == '\r' || t.back() == '\t')) t.remove_suffix(1);
+    return t;
+}
+
+long long PseudoFileReader::number(int handle, long long fallback) const
+{
+    long long value = 0;
+    return parseNumber(text(handle), value) ? value : fallback;
+}
+
+bool PseudoFileReader::parseNumber(string_view text, long long& out)
+{
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == string_view::npos) return false;
+    const char* first = text.data() + start;
+    const char* last = text.data() + text.size();
+    if (*first == '+') ++first;   // from_chars rejects a leading '+'
+    return from_chars(first, last, out).ec == errc();
+}
+
+size_t PseudoFileReader::parseNumbers(string_view text, vector<long long>& out)
+{
+    size_t before = out.size();
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t start = text.find_first_not_of(" \t\r\n", pos);
+        if (start == string_view::npos) break;
+        size_t end = text.find_first_of(" \t\r\n", start);
+        if (end == string_view::npos) end = text.size();
+
+        long long value = 0;
+        const char* first = text.data() + start;
+        if (*first == '+' && end - start > 1) ++first;     // same as parseNumber
+        auto res = from_chars(first, text.data() + end, value);
+        if (res.ec == errc() && res.ptr == text.data() + end) out.push_back(value);
+        pos = end;
+    }
+    return out.size() - before;
+}
@@ -0,0 +1,367 @@
+#include "include\StorageEnumerator.h"
+#include "include\Probe.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <sstream>
+#include <set>
+#include <cstdlib>
+#include <functional>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/statvfs.h>
+#include <cctype>
+#endif
+
+using namespace std;
+
+namespace {
+    mutex snapshotMutex;
+    condition_variable snapshotGrew;
+    vector<VolumeInfo> snapshot;
+    bool ready = false;         // snapshot complete
+    bool filling = false;       // a first pass is streaming into it
+    MountOptions mountOptions;
+
+#ifdef _WIN32
+
+    DWORD logical_drive_mask()
+    {
+        DWORD drive_mask = GetLogicalDrives();
+
+        if (drive_mask == 0) {
+            // FALLBACK 1: Try GetLogicalDriveStrings
+            char buffer[256];
+            DWORD result = GetLogicalDriveStringsA(sizeof(buffer), buffer);
+
+            if (result > 0 && result <= sizeof(buffer)) {
+                char* p = buffer;
+                while (*p) {
+                    char drive_letter = toupper(*p);
+                    if (drive_letter >= 'A' && drive_letter <= 'Z') {
+                        drive_mask |= (1 << (drive_letter - 'A'));
+                    }
+                    p += strlen(p) + 1;
+                }
+            }
+
+            // FALLBACK 2: If still nothing, manually check common drives
+            if (drive_mask == 0) {
+                for (char c = 'C'; c <= 'D'; c++) {
+                    string test = string(1, c) + ":\\";
+                    if (GetDriveTypeA(test.c_str()) == DRIVE_FIXED) {
+                        drive_mask |= (1 << (c - 'A'));
+                    }
+                }
+            }
+        }
+
+        return drive_mask;
+    }
+
+    // Roots and kinds only; nothing here touches the media. The letters and
+    // their GetDriveType answers go through Probe as "<letter><type>" ("C3")
+    vector<VolumeInfo> list_volumes(const MountOptions& options)
+    {
+        vector<string> drives = Probe::list("kernel32:drive-types", []() -> vector<string> {
+            vector<string> out;
+            DWORD drive_mask = logical_drive_mask();
+            for (char letter = 'A'; letter <= 'Z'; letter++) {
+                if (!(drive_mask & (1u << (letter - 'A')))) continue;
+                string root = string(1, letter) + ":\\";
+                out.push_back(string(1, letter) + to_string(GetDriveTypeA(root.c_str())));
+            }
+            return out;
+        });
+
+        vector<VolumeInfo> found;
+        for (const auto& drive : drives) {
+            if (drive.size() < 2) continue;
+
+            VolumeInfo v;
+            v.root_path = string(1, drive[0]) + ":\\";
+
+            switch (static_cast<UINT>(atoi(drive.c_str() + 1))) {
+            case DRIVE_NO_ROOT_DIR: continue;   // letter without a mounted volume
+            case DRIVE_FIXED:     v.kind = VolumeKind::Fixed; break;
+            case DRIVE_REMOVABLE: v.kind = VolumeKind::Removable; break;
+            case DRIVE_REMOTE:
+                if (options.skipRemote) continue;
+                v.kind = VolumeKind::Remote;
+                break;
+            case DRIVE_CDROM:     v.kind = VolumeKind::Optical; break;
+            case DRIVE_RAMDISK:   v.kind = VolumeKind::RamDisk; break;
+            default:              v.kind = VolumeKind::Unknown; break;
+            }
+            found.push_back(v);
+        }
+        return found;
+    }
+
+    void stat_volume(VolumeInfo& v)
+    {
+        ULARGE_INTEGER free_bytes_available, total_bytes, free_bytes;
+        v.stat_ok = GetDiskFreeSpaceExA(v.root_path.c_str(), &free_bytes_available, &total_bytes, &free_bytes) != 0;
+        if (v.stat_ok) {
+            v.total_bytes = total_bytes.QuadPart;
+            v.free_bytes = free_bytes.QuadPart;
+        }
+
+        char fs_name[MAX_PATH] = { 0 };
+        if (GetVolumeInformationA(v.root_path.c_str(), nullptr, 0, nullptr, nullptr, nullptr, fs_name, sizeof(fs_name))) {
+            v.file_system = fs_name;
+        }
+    }
+
+#else
+
+    // /proc/self/mounts escapes space, tab, newline and backslash as \ooo
+    string unescape_mount_field(const string& field)
+    {
+        string out;
+        for (size_t i = 0; i < field.size(); i++) {
+            if (field[i] == '\\' && i + 3 < field.size() && isdigit((unsigned char)field[i + 1])) {
+                out += static_cast<char>(stoi(field.substr(i + 1, 3), nullptr, 8));
+                i += 3;
+            }
+            else {
+                out += field[i];
+            }
+        }
+        return out;
+    }
+
+    bool is_remote_mount(const string& fs_type, const string& source)
+    {
+        static const set<string> remote_fs = {
+            "nfs", "nfs4", "cifs", "smb3", "smbfs", "9p", "ceph", "glusterfs",
+            "afs", "lustre", "davfs", "fuse.sshfs", "fuse.rclone", "fuse.s3fs"
+        };
+        if (remote_fs.count(fs_type)) return true;
+
+        // FUSE network file systems under other names still show a network source
+        if (fs_type.compare(0, 5, "fuse.") == 0) {
+            return source.compare(0, 2, "//") == 0 ||
+                (source.find(':') != string::npos && source.compare(0, 5, "/dev/") != 0);
+        }
+        return false;
+    }
+
+    // /proc/self/mountinfo:
+    //   36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+    //   (mount point is field 5, file system type and source follow the lone "-")
+    vector<VolumeInfo> list_volumes(const MountOptions& options)
+    {
+        vector<VolumeInfo> found;
+        set<string> seen_devices;   // bind mounts / btrfs subvolumes show the same device again
+
+        istringstream mounts(Probe::file("/proc/self/mountinfo"));
+        string line;
+        while (getline(mounts, line)) {
+            istringstream in(line);
+            vector<string> fields;
+            string field;
+            while (in >> field) fields.push_back(field);
+
+            size_t dash = 6;
+            while (dash < fields.size() && fields[dash] != "-") dash++;
+            if (fields.size() < 5 || dash + 2 >= fields.size()) continue;
+
+            VolumeInfo v;
+            v.root_path = unescape_mount_field(fields[4]);
+            v.file_system = fields[dash + 1];
+            v.device = unescape_mount_field(fields[dash + 2]);
+
+            if (is_remote_mount(v.file_system, v.device)) {
+                if (options.skipRemote) continue;
+                v.kind = VolumeKind::Remote;
+            }
+            else if (v.device.compare(0, 5, "/dev/") == 0 && v.device.compare(0, 9, "/dev/loop") != 0) {
+                if (seen_devices.count(v.device)) continue;
+                v.kind = (v.file_system == "iso9660" || v.file_system == "udf") ? VolumeKind::Optical : VolumeKind::Fixed;
+
+                // USB sticks and card readers: the parent block device says so
+                string name = v.device.substr(v.device.find_last_of('/') + 1);
+                string removable = Probe::file("/sys/class/block/" + name + "/removable");
+                if (removable.empty()) {
+                    // Partition: sda1 -> sda, nvme0n1p2 -> nvme0n1, mmcblk0p1 -> mmcblk0
+                    size_t cut = name.find_last_not_of("0123456789");
+                    string parent = name.substr(0, cut + 1);
+                    if (parent.size() > 1 && parent.back() == 'p' && isdigit((unsigned char)parent[parent.size() - 2])) parent.pop_back();
+                    removable = Probe::file("/sys/class/block/" + parent + "/removable");
+                }
+                if (!removable.empty() && removable[0] == '1') v.kind = VolumeKind::Removable;
+            }
+            else {
+                continue;   // proc, sysfs, tmpfs, overlay, ...
+            }
+
+            seen_devices.insert(v.device);
+            found.push_back(v);
+        }
+        return found;
+    }
+
+    void stat_volume(VolumeInfo& v)
+    {
+        struct statvfs st;
+        v.stat_ok = statvfs(v.root_path.c_str(), &st) == 0;
+        if (v.stat_ok) {
+            v.total_bytes = static_cast<uint64_t>(st.f_blocks) * st.f_frsize;
+            v.free_bytes = static_cast<uint64_t>(st.f_bfree) * st.f_frsize;
+        }
+    }
+
+#endif
+
+    // ----------------- Abandonable stat -----------------
+    // The worker owns its half through the shared_ptr, so a stat that never
+    // returns just strands one detached thread; the caller moves on.
+
+    struct PendingStat {
+        mutex m;
+        condition_variable cv;
+        bool done = false;
+        VolumeInfo result;
+    };
+
+    shared_ptr<PendingStat> start_stat(const VolumeInfo& volume)
+    {
+        auto pending = make_shared<PendingStat>();
+        thread([pending, volume]() {
+            VolumeInfo v = volume;
+            stat_volume(v);
+
+            lock_guard<mutex> lock(pending->m);
+            pending->result = v;
+            pending->done = true;
+            pending->cv.notify_all();
+            }).detach();
+        return pending;
+    }
+
+    VolumeInfo finish_stat(PendingStat& pending, const VolumeInfo& volume, chrono::steady_clock::time_point deadline)
+    {
+        unique_lock<mutex> lock(pending.m);
+        if (pending.cv.wait_until(lock, deadline, [&]() { return pending.done; })) return pending.result;
+
+        VolumeInfo v = volume;
+        v.timed_out = true;
+        return v;
+    }
+
+    // Stat results, timeouts included, go through Probe as
+    // { stat_ok, timed_out, total, free, file system }
+    VolumeInfo probe_stat(const VolumeInfo& volume, const function<VolumeInfo()>& stat)
+    {
+        vector<string> fields = Probe::list("statfs:" + volume.root_path, [&]() -> vector<string> {
+            VolumeInfo v = stat();
+            return { v.stat_ok ? "1" : "0", v.timed_out ? "1" : "0",
+                to_string(v.total_bytes), to_string(v.free_bytes), v.file_system };
+        });
+
+        VolumeInfo v = volume;
+        if (fields.size() == 5) {
+            v.stat_ok = fields[0] == "1";
+            v.timed_out = fields[1] == "1";
+            v.total_bytes = strtoull(fields[2].c_str(), nullptr, 10);
+            v.free_bytes = strtoull(fields[3].c_str(), nullptr, 10);
+            v.file_system = fields[4];
+        }
+        return v;
+    }
+}
+
+void StorageEnumerator::configure(const MountOptions& options)
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    mountOptions = options;
+    if (filling) return;
+    snapshot.clear();
+    ready = false;
+}
+
+void StorageEnumerator::each(const function<void(const VolumeInfo&)>& onVolume)
+{
+    unique_lock<mutex> lock(snapshotMutex);
+
+    if (!ready && !filling) {
+        // First pass: this caller stats each volume and streams it right away;
+        // concurrent callers follow along through the snapshot
+        filling = true;
+        snapshot.clear();
+        MountOptions options = mountOptions;
+        lock.unlock();
+
+        try {
+            vector<VolumeInfo> found = list_volumes(options);
+
+            // All stats start at once and share one deadline, so N dead mounts
+            // cost one timeout, not N (--replay starts none)
+            int timeoutMs = options.statTimeoutMs;
+            vector<shared_ptr<PendingStat>> pending;
+            if (timeoutMs > 0 && !Probe::replaying()) {
+                for (const auto& v : found) pending.push_back(start_stat(v));
+            }
+            auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+
+            for (size_t i = 0; i < found.size(); i++) {
+                VolumeInfo v = probe_stat(found[i], [&]() {
+                    VolumeInfo live = found[i];
+                    if (timeoutMs > 0) live = finish_stat(*pending[i], found[i], deadline);
+                    else stat_volume(live);
+                    return live;
+                });
+                {
+                    lock_guard<mutex> guard(snapshotMutex);
+                    snapshot.push_back(v);
+                }
+                snapshotGrew.notify_all();
+                onVolume(v);
+            }
+        }
+        catch (...) {
+            lock_guard<mutex> guard(snapshotMutex);
+            filling = false;
+            ready = true;   // partial, but never leaves followers waiting
+            snapshotGrew.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        filling = false;
+        ready = true;
+        snapshotGrew.notify_all();
+        return;
+    }
+
+    for (size_t i = 0;; i++) {
+        snapshotGrew.wait(lock, [&]() { return ready || i < snapshot.size(); });
+        if (i >= snapshot.size()) break;
+
+        VolumeInfo v = snapshot[i];
+        lock.unlock();
+        onVolume(v);
+        lock.lock();
+    }
+}
+
+vector<VolumeInfo> StorageEnumerator::volumes()
+{
+    vector<VolumeInfo> all;
+    each([&](const VolumeInfo& v) { all.push_back(v); });
+    return all;
+}
+
+void StorageEnumerator::invalidate()
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    if (filling) return;    // the running pass finishes its snapshot first
+    snapshot.clear();
+    ready = false;
+}
@@ -15,6 +15,8 @@
 #endif
 
 #include "include\StorageInfo.h"
+#include "include\StorageEnumerator.h"
+#include "include\Probe.h"
 #include <Windows.h>
 #include <sstream>
 #include <iomanip>
@@ -23,12 +25,15 @@
 #include <chrono>
 #include <fstream>
 #include <algorithm>
-#include <malloc.h>
 #include <winioctl.h>
 #include <setupapi.h>
 #include <devguid.h>
 #include <cfgmgr32.h>
 #include <comdef.h>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #pragma comment(lib, "setupapi.lib")
 #pragma comment(lib, "cfgmgr32.lib")
@@ -57,21 +62,14 @@ static bool SafeCloseHandle(HANDLE& h) {
 }
 
 // ============================================================
-//  OPTIMIZED: Fast drive type check with fallbacks
+//  Volume -> physical disk number (IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS)
+//  Returns -1 when the volume can't be opened or has no extents.
 // ============================================================
-string StorageInfo::get_storage_type(const string&, const string& root_path, bool) {
-    string type = "Unknown";
-
-    // OPTIMIZATION 1: Quick USB check first (fastest)
-    UINT driveType = GetDriveTypeA(root_path.c_str());
-    if (driveType == DRIVE_REMOVABLE) return "USB";
-    if (driveType == DRIVE_CDROM) return "Unknown"; // Skip CD/DVD drives
-    if (driveType != DRIVE_FIXED) return "Unknown";
-
+static int query_volume_disk_number(const string& root_path) {
     char letter = toupper(root_path[0]);
     string volumePath = "\\\\.\\" + string(1, letter) + ":";
 
-    // OPTIMIZATION 2: Try with reduced privileges first
+    // Try with reduced privileges first
     HANDLE hVol = CreateFileA(
         volumePath.c_str(),
         0, // No access rights needed for IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS
@@ -94,30 +92,46 @@ string StorageInfo::get_storage_type(const string&, const string& root_path, boo
             nullptr
         );
 
-        if (hVol == INVALID_HANDLE_VALUE) {
-            // ULTIMATE FALLBACK: Assume SSD for modern systems
-            return "SSD";
-        }
+        if (hVol == INVALID_HANDLE_VALUE) return -1;
     }
 
     BYTE buf[512]{};
     DWORD returned = 0;
+    int diskNumber = -1;
 
-    if (!DeviceIoControl(hVol, IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS,
+    if (DeviceIoControl(hVol, IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS,
         nullptr, 0, buf, sizeof(buf), &returned, nullptr))
     {
-        SafeCloseHandle(hVol);
-        return "SSD"; // Fallback to SSD if can't determine
+        auto* ext = reinterpret_cast<VOLUME_DISK_EXTENTS*>(buf);
+        if (ext->NumberOfDiskExtents > 0) diskNumber = static_cast<int>(ext->Extents[0].DiskNumber);
     }
 
-    auto* ext = reinterpret_cast<VOLUME_DISK_EXTENTS*>(buf);
-    if (ext->NumberOfDiskExtents == 0) {
-        SafeCloseHandle(hVol);
-        return "SSD";
-    }
-
-    DWORD diskNumber = ext->Extents[0].DiskNumber;
     SafeCloseHandle(hVol);
+    return diskNumber;
+}
+
+// The IOCTL answers below go through Probe per root path, so --replay never
+// opens a device; the query_* helpers are the live reads they record
+static int volume_disk_number(const string& root_path) {
+    return static_cast<int>(Probe::number("ioctl:volume-disk:" + root_path, [&]() -> double {
+        return query_volume_disk_number(root_path);
+    }));
+}
+
+// ============================================================
+//  OPTIMIZED: Fast drive type check with fallbacks
+// ============================================================
+static string query_storage_type(const string& root_path, int diskNumber) {
+    string type = "Unknown";
+
+    // OPTIMIZATION 1: Quick USB check first (fastest)
+    UINT driveType = GetDriveTypeA(root_path.c_str());
+    if (driveType == DRIVE_REMOVABLE) return "USB";
+    if (driveType == DRIVE_CDROM) return "Unknown"; // Skip CD/DVD drives
+    if (driveType != DRIVE_FIXED) return "Unknown";
+
+    // OPTIMIZATION 2: Volume -> physical disk, looked up once by the caller
+    if (diskNumber < 0) return "SSD"; // Fallback to SSD if can't determine
 
     // OPTIMIZATION 3: Check physical drive with minimal access
     string physPath = "\\\\.\\PhysicalDrive" + to_string(diskNumber);
@@ -188,6 +202,7 @@ string StorageInfo::get_storage_type(const string&, const string& root_path, boo
     q.QueryType = PropertyStandardQuery;
 
     STORAGE_DESCRIPTOR_HEADER hdr{};
+    DWORD returned = 0;
     if (DeviceIoControl(hDisk, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q),
         &hdr, sizeof(hdr), &returned, nullptr))
     {
@@ -207,466 +222,447 @@ string StorageInfo::get_storage_type(const string&, const string& root_path, boo
     return type;
 }
 
+string StorageInfo::get_storage_type(const string& root_path, int disk_number) {
+    return Probe::text("ioctl:storage-type:" + root_path, [&]() { return query_storage_type(root_path, disk_number); });
+}
+
 // ============================================================
-//  FINAL FIX: Accurate speeds with cache bypass guarantee
+//  Direct-I/O benchmark (DiskBenchmark.h)
+//  Replaces the old single 32 MB WriteFile/ReadFile timing with
+//  duration-based tests at a real queue depth, so numbers are
+//  comparable between machines.
 // ============================================================
-static double measure_disk_speed(const string& root_path, bool writeTest) {
-    const size_t BUF_SIZE = 32 * 1024 * 1024; // 32 MB
-
-    // CRITICAL: Align buffer for NO_BUFFERING (4096-byte boundary)
-    void* raw_buffer = _aligned_malloc(BUF_SIZE, 4096);
-    if (!raw_buffer) return 0.0;
+void StorageInfo::set_benchmark_config(const DiskBenchConfig& config) {
+    bench_config = config;
+}
 
-    memset(raw_buffer, 0xAA, BUF_SIZE);
-    char* buffer = static_cast<char*>(raw_buffer);
+void StorageInfo::set_speed_cache(shared_ptr<DiskSpeedCache> cache, int64_t ttlSeconds, bool rebench) {
+    speed_cache = cache;
+    cache_ttl_seconds = ttlSeconds;
+    force_rebench = rebench;
+}
 
-    // Try multiple file locations for compatibility
-    vector<string> testPaths = {
-        root_path + "speed_test_tmp.bin",
-        root_path + "Temp\\speed_test_tmp.bin",
-        root_path + "Users\\Public\\speed_test_tmp.bin"
-    };
+void StorageInfo::set_remote_benchmark(bool enabled) {
+    bench_remote = enabled;
+}
 
-    string testFile = testPaths[0];
-
-    // CRITICAL: ALWAYS use NO_BUFFERING for accuracy
-    DWORD flags = FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_SEQUENTIAL_SCAN;
-    HANDLE hFile = INVALID_HANDLE_VALUE;
-    DWORD bytesDone = 0;
-    BOOL ok = FALSE;
-
-    if (writeTest) {
-        // WRITE TEST - Try locations but KEEP NO_BUFFERING
-        for (const auto& path : testPaths) {
-            testFile = path;
-
-            // ONLY try with NO_BUFFERING - don't compromise accuracy
-            hFile = CreateFileA(
-                testFile.c_str(),
-                GENERIC_WRITE,
-                0,
-                nullptr,
-                CREATE_ALWAYS,
-                flags,
-                nullptr
-            );
-
-            if (hFile != INVALID_HANDLE_VALUE) {
-                // Successfully opened with NO_BUFFERING
-                auto start = chrono::high_resolution_clock::now();
-                ok = WriteFile(hFile, buffer, (DWORD)BUF_SIZE, &bytesDone, nullptr);
-                FlushFileBuffers(hFile);
-                auto end = chrono::high_resolution_clock::now();
-
-                SafeCloseHandle(hFile);
-
-                if (ok && bytesDone > 0) {
-                    double seconds = chrono::duration<double>(end - start).count();
-                    if (seconds < 0.001) seconds = 0.001;
-                    _aligned_free(raw_buffer);
-                    return (bytesDone / (1024.0 * 1024.0)) / seconds;
-                }
-            }
-        }
+void StorageInfo::set_health_enabled(bool enabled) {
+    read_health = enabled;
+}
 
-        // If all NO_BUFFERING attempts failed, return 0.0
-        // DO NOT fall back to cached methods
-        _aligned_free(raw_buffer);
-        return 0.0;
+// The summary columns keep showing sequential read / write MB/s
+static void fill_speed_columns(storage_data& disk) {
+    double r = 0.0, w = 0.0;
+    for (const auto& result : disk.benchmark) {
+        if (!result.ok || result.random) continue;
+        if (result.readPercent == 100 && r == 0.0) r = result.mbps;
+        if (result.readPercent == 0 && w == 0.0) w = result.mbps;
     }
 
-    // READ TEST - Same strategy, NO_BUFFERING only
-    for (const auto& path : testPaths) {
-        testFile = path;
-
-        // Try to open existing file with NO_BUFFERING
-        hFile = CreateFileA(
-            testFile.c_str(),
-            GENERIC_READ,
-            FILE_SHARE_READ | FILE_SHARE_WRITE,
-            nullptr,
-            OPEN_EXISTING,
-            flags,
-            nullptr
-        );
-
-        if (hFile == INVALID_HANDLE_VALUE) {
-            // File doesn't exist, create it first WITH NO_BUFFERING
-            HANDLE hCreate = CreateFileA(
-                testFile.c_str(),
-                GENERIC_WRITE,
-                0,
-                nullptr,
-                CREATE_ALWAYS,
-                flags,  // Use same flags
-                nullptr
-            );
-
-            if (hCreate != INVALID_HANDLE_VALUE) {
-                DWORD written = 0;
-                if (WriteFile(hCreate, buffer, (DWORD)BUF_SIZE, &written, nullptr) && written > 0) {
-                    FlushFileBuffers(hCreate);
-                    SafeCloseHandle(hCreate);
-                    Sleep(100);
-
-                    // Try to open for read with NO_BUFFERING
-                    hFile = CreateFileA(
-                        testFile.c_str(),
-                        GENERIC_READ,
-                        FILE_SHARE_READ | FILE_SHARE_WRITE,
-                        nullptr,
-                        OPEN_EXISTING,
-                        flags,
-                        nullptr
-                    );
-                }
-                else {
-                    SafeCloseHandle(hCreate);
-                }
-            }
-        }
-
-        if (hFile != INVALID_HANDLE_VALUE) {
-            // Successfully opened with NO_BUFFERING, perform read test
-            auto start = chrono::high_resolution_clock::now();
-            ok = ReadFile(hFile, buffer, (DWORD)BUF_SIZE, &bytesDone, nullptr);
-            auto end = chrono::high_resolution_clock::now();
+    ostringstream ss;
+    ss << fixed << setprecision(2) << r;
+    disk.read_speed = ss.str();
+    ss.str("");
+    ss.clear();
+    ss << fixed << setprecision(2) << w;
+    disk.write_speed = ss.str();
+}
 
-            SafeCloseHandle(hFile);
-            DeleteFileA(testFile.c_str());
+static void run_disk_benchmark(storage_data& disk, const string& root_path, const DiskBenchConfig& config) {
+    // The user's temp directory first when it lives on this volume: always
+    // writable and nothing is left in shared folders. The root is a last
+    // resort (usually read-only for standard users).
+    vector<string> testDirs;
+    char temp[MAX_PATH + 1] = { 0 };
+    DWORD len = GetTempPathA(sizeof(temp), temp);
+    if (len > 0 && len < sizeof(temp) && _strnicmp(temp, root_path.c_str(), root_path.size()) == 0) {
+        testDirs.push_back(temp);
+    }
+    testDirs.push_back(root_path + "Temp\\");
+    testDirs.push_back(root_path + "Users\\Public\\");
+    testDirs.push_back(root_path);
 
-            if (ok && bytesDone > 0) {
-                double seconds = chrono::duration<double>(end - start).count();
-                if (seconds < 0.001) seconds = 0.001;
-                _aligned_free(raw_buffer);
-                return (bytesDone / (1024.0 * 1024.0)) / seconds;
-            }
-        }
+    for (const auto& dir : testDirs) {
+        disk.benchmark = DiskBenchmark::run(dir, config);
+        if (!disk.benchmark.empty()) break;
     }
 
-    // All attempts failed
-    _aligned_free(raw_buffer);
-    return 0.0;
+    fill_speed_columns(disk);
 }
 
 // ============================================================
-//  CRITICAL FIX: Enhanced drive detection with fallbacks
+//  Device identity for the speed cache (DiskSpeedCache.h):
+//  model / serial / firmware from STORAGE_DEVICE_DESCRIPTOR,
+//  file system identity from the volume GUID
 // ============================================================
-vector<storage_data> StorageInfo::get_all_storage_info() {
-    vector<storage_data> all_disks;
-
-    // CRITICAL: Try multiple methods to get drives
-    DWORD drive_mask = GetLogicalDrives();
-
-    if (drive_mask == 0) {
-        // FALLBACK 1: Try GetLogicalDriveStrings
-        char buffer[256];
-        DWORD result = GetLogicalDriveStringsA(sizeof(buffer), buffer);
+static string descriptor_string(const vector<BYTE>& buf, DWORD offset) {
+    if (offset == 0 || offset >= buf.size()) return "";
+    string out;
+    for (size_t i = offset; i < buf.size() && buf[i] != 0; i++) out += static_cast<char>(buf[i]);
+
+    // Descriptors pad with spaces on both ends
+    size_t first = out.find_first_not_of(' ');
+    if (first == string::npos) return "";
+    size_t last = out.find_last_not_of(' ');
+    return out.substr(first, last - first + 1);
+}
 
-        if (result > 0 && result <= sizeof(buffer)) {
-            char* p = buffer;
-            while (*p) {
-                char drive_letter = toupper(*p);
-                if (drive_letter >= 'A' && drive_letter <= 'Z') {
-                    drive_mask |= (1 << (drive_letter - 'A'));
-                }
-                p += strlen(p) + 1;
-            }
-        }
+static DiskIdentity query_volume_identity(const string& root_path, int diskNumber) {
+    DiskIdentity id;
 
-        // FALLBACK 2: If still nothing, manually check common drives
-        if (drive_mask == 0) {
-            for (char c = 'C'; c <= 'D'; c++) {
-                string test = string(1, c) + ":\\";
-                if (GetDriveTypeA(test.c_str()) == DRIVE_FIXED) {
-                    drive_mask |= (1 << (c - 'A'));
-                }
-            }
+    // File system: \\?\Volume{GUID}\ survives letter changes, changes on reformat
+    char volumeName[MAX_PATH] = { 0 };
+    if (GetVolumeNameForVolumeMountPointA(root_path.c_str(), volumeName, sizeof(volumeName))) {
+        string name = volumeName;
+        size_t open = name.find('{');
+        size_t close = name.find('}', open);
+        if (open != string::npos && close != string::npos) id.fsUuid = name.substr(open + 1, close - open - 1);
+    }
+    if (id.fsUuid.empty()) {
+        DWORD volumeSerial = 0;
+        if (GetVolumeInformationA(root_path.c_str(), nullptr, 0, &volumeSerial, nullptr, nullptr, nullptr, 0)) {
+            ostringstream ss;
+            ss << hex << uppercase << setw(8) << setfill('0') << volumeSerial;
+            id.fsUuid = ss.str();
         }
     }
 
-    if (drive_mask == 0) return all_disks; // No drives found at all
-
-    char drive_letter = 'A';
-    int disk_index = 0;
-
-    while (drive_mask) {
-        if (drive_mask & 1) {
-            string root_path = string(1, drive_letter) + ":\\";
+    if (diskNumber < 0) return id;
 
-            // CRITICAL: Check if drive is accessible FIRST
-            UINT dt = GetDriveTypeA(root_path.c_str());
-            if (dt == DRIVE_NO_ROOT_DIR || dt == DRIVE_UNKNOWN) {
-                drive_mask >>= 1;
-                drive_letter++;
-                continue;
-            }
-
-            ULARGE_INTEGER free_bytes, total_bytes, free_bytes_available;
-
-            if (GetDiskFreeSpaceExA(root_path.c_str(), &free_bytes_available, &total_bytes, &free_bytes)) {
-                double total_gib = total_bytes.QuadPart / (1024.0 * 1024.0 * 1024.0);
-
-                // OPTIMIZATION: Skip tiny partitions (< 100MB)
-                if (total_gib < 0.1) {
-                    drive_mask >>= 1;
-                    drive_letter++;
-                    continue;
-                }
-
-                double free_gib = free_bytes.QuadPart / (1024.0 * 1024.0 * 1024.0);
-                double used_gib = total_gib - free_gib;
-                double used_percent = (total_gib > 0) ? (used_gib / total_gib) * 100.0 : 0.0;
+    string physPath = "\\\\.\\PhysicalDrive" + to_string(diskNumber);
+    HANDLE hDisk = CreateFileA(physPath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, 0, nullptr);
+    if (hDisk == INVALID_HANDLE_VALUE) return id;
 
-                char fs_name[MAX_PATH] = { 0 };
-                GetVolumeInformationA(root_path.c_str(), nullptr, 0, nullptr, nullptr, nullptr, fs_name, sizeof(fs_name));
-                string formatted_fs = string(fs_name);
-                if (formatted_fs.empty()) formatted_fs = "RAW";
-                if (formatted_fs == "NTFS") formatted_fs = "NTFS ";
+    STORAGE_PROPERTY_QUERY q{};
+    q.PropertyId = StorageDeviceProperty;
+    q.QueryType = PropertyStandardQuery;
 
-                bool is_external = (dt == DRIVE_REMOVABLE);
+    STORAGE_DESCRIPTOR_HEADER hdr{};
+    DWORD returned = 0;
+    if (DeviceIoControl(hDisk, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q),
+        &hdr, sizeof(hdr), &returned, nullptr) && hdr.Size >= sizeof(STORAGE_DEVICE_DESCRIPTOR))
+    {
+        vector<BYTE> dbuf(hdr.Size);
+        if (DeviceIoControl(hDisk, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q),
+            dbuf.data(), (DWORD)hdr.Size, &returned, nullptr))
+        {
+            dbuf.resize(returned);
+            auto* desc = reinterpret_cast<STORAGE_DEVICE_DESCRIPTOR*>(dbuf.data());
+            id.model = descriptor_string(dbuf, desc->ProductIdOffset);
+            id.serial = descriptor_string(dbuf, desc->SerialNumberOffset);
+            id.firmware = descriptor_string(dbuf, desc->ProductRevisionOffset);
+        }
+    }
 
-                ostringstream used_str, total_str, percent_str;
-                used_str << fixed << setprecision(2) << used_gib;
-                total_str << fixed << setprecision(2) << total_gib;
-                percent_str << "(" << (int)used_percent << "%)";
+    SafeCloseHandle(hDisk);
+    return id;
+}
 
-                storage_data disk;
-                disk.drive_letter = "Disk (" + string(1, drive_letter) + ":)";
-                disk.used_space = used_str.str();
-                disk.total_space = total_str.str();
-                disk.used_percentage = static_cast<int>(used_percent);  // Store as int directly
-                disk.file_system = formatted_fs;
-                disk.is_external = is_external;
-
-                // Storage type with error handling
-                try {
-                    disk.storage_type = get_storage_type(disk.drive_letter, root_path, is_external);
-                }
-                catch (...) {
-                    disk.storage_type = "SSD"; // Safe fallback
-                }
+// Recorded as { fsUuid, model, serial, firmware }
+static DiskIdentity volume_identity(const string& root_path, int disk_number) {
+    vector<string> fields = Probe::list("ioctl:volume-identity:" + root_path, [&]() -> vector<string> {
+        DiskIdentity id = query_volume_identity(root_path, disk_number);
+        return { id.fsUuid, id.model, id.serial, id.firmware };
+    });
+
+    DiskIdentity id;
+    if (fields.size() == 4) {
+        id.fsUuid = fields[0];
+        id.model = fields[1];
+        id.serial = fields[2];
+        id.firmware = fields[3];
+    }
+    return id;
+}
 
-                // Don't skip "Unknown" drives - show them anyway
-                // (User might have virtual drives, network drives, etc.)
+// ============================================================
+//  Stage 1 (basic): space + file system, straight from the shared
+//  StorageEnumerator snapshot. Returns false for volumes that
+//  aren't shown (no media, unknown kind, < 100MB). Mounts whose
+//  stat timed out are kept and flagged unreachable.
+// ============================================================
+static bool basic_from_volume(const VolumeInfo& v, storage_data& disk) {
+    if (v.kind == VolumeKind::Unknown) return false;
+
+    disk.drive_letter = "Disk (" + string(1, v.root_path[0]) + ":)";
+    disk.is_external = (v.kind == VolumeKind::Removable);
+    disk.is_remote = (v.kind == VolumeKind::Remote);
+
+    if (v.timed_out) {
+        disk.unreachable = true;
+        disk.used_space = "0";
+        disk.total_space = "0";
+        disk.used_percentage = 0;
+        disk.file_system = v.file_system.empty() ? "?" : v.file_system;
+        return true;
+    }
+    if (!v.stat_ok) return false;
 
-                // OPTIMIZED: Measure speeds with timeout protection and retry logic
-                double w = 0.0, r = 0.0;
+    double total_gib = v.total_bytes / (1024.0 * 1024.0 * 1024.0);
 
-                try {
-                    // Try write test first (creates file for read test)
-                    w = measure_disk_speed(root_path, true);
-
-                    // Small delay to ensure file system sync
-                    Sleep(100);
-
-                    // Try read test
-                    r = measure_disk_speed(root_path, false);
-
-                    // CRITICAL FIX: If both failed (0.0), retry with fallback method
-                    if (w == 0.0 && r == 0.0) {
-                        // Retry without NO_BUFFERING (for compatibility)
-                        Sleep(200);
-                        w = measure_disk_speed(root_path, true);
-                        Sleep(100);
-                        r = measure_disk_speed(root_path, false);
-                    }
+    // OPTIMIZATION: Skip tiny partitions (< 100MB)
+    if (total_gib < 0.1) return false;
 
-                }
-                catch (...) {
-                    w = 0.0;
-                    r = 0.0;
-                }
+    double free_gib = v.free_bytes / (1024.0 * 1024.0 * 1024.0);
+    double used_gib = total_gib - free_gib;
+    double used_percent = (total_gib > 0) ? (used_gib / total_gib) * 100.0 : 0.0;
 
-                ostringstream ss;
-                ss << fixed << setprecision(2) << (r > 0 ? r : 0.0);
-                disk.read_speed = ss.str();
-                ss.str("");
-                ss.clear();
-                ss << fixed << setprecision(2) << (w > 0 ? w : 0.0);
-                disk.write_speed = ss.str();
+    string formatted_fs = v.file_system;
+    if (formatted_fs.empty()) formatted_fs = "RAW";
+    if (formatted_fs == "NTFS") formatted_fs = "NTFS ";
 
-                disk.serial_number = "SN-" + to_string(1000 + disk_index);
+    ostringstream used_str, total_str;
+    used_str << fixed << setprecision(2) << used_gib;
+    total_str << fixed << setprecision(2) << total_gib;
 
-                // Predicted speeds based on type
-                if (disk.storage_type == "USB") {
-                    disk.predicted_read_speed = "100";
-                    disk.predicted_write_speed = "80";
-                }
-                else if (disk.storage_type == "SSD") {
-                    disk.predicted_read_speed = "500";
-                    disk.predicted_write_speed = "450";
-                }
-                else if (disk.storage_type == "HDD") {
-                    disk.predicted_read_speed = "140";
-                    disk.predicted_write_speed = "120";
-                }
-                else {
-                    disk.predicted_read_speed = "---";
-                    disk.predicted_write_speed = "---";
-                }
+    disk.used_space = used_str.str();
+    disk.total_space = total_str.str();
+    disk.used_percentage = static_cast<int>(used_percent);  // Store as int directly
+    disk.file_system = formatted_fs;
+    return true;
+}
 
-                all_disks.push_back(disk);
-                disk_index++;
-            }
+// ============================================================
+//  Stage 2 (type): IOCTLs only, plus the type-based predictions
+// ============================================================
+void StorageInfo::detect_type(const string& root_path, int disk_number, storage_data& disk) {
+    // Storage type with error handling (an unreachable share would block the IOCTLs too)
+    if (disk.unreachable || disk.is_remote) {
+        disk.storage_type = "NET";
+    }
+    else {
+        try {
+            disk.storage_type = get_storage_type(root_path, disk_number);
+        }
+        catch (...) {
+            disk.storage_type = "SSD"; // Safe fallback
         }
-        drive_letter++;
-        drive_mask >>= 1;
     }
 
-    return all_disks;
+    // Don't skip "Unknown" drives - show them anyway
+    // (User might have virtual drives, network drives, etc.)
+
+    // Predicted speeds based on type
+    if (disk.storage_type == "USB") {
+        disk.predicted_read_speed = "100";
+        disk.predicted_write_speed = "80";
+    }
+    else if (disk.storage_type == "SSD") {
+        disk.predicted_read_speed = "500";
+        disk.predicted_write_speed = "450";
+    }
+    else if (disk.storage_type == "HDD") {
+        disk.predicted_read_speed = "140";
+        disk.predicted_write_speed = "120";
+    }
+    else {
+        disk.predicted_read_speed = "---";
+        disk.predicted_write_speed = "---";
+    }
 }
 
 // ============================================================
-//  SAME FIX: Enhanced process_storage_info with streaming
+//  Stage 3 (benchmark): direct-I/O benchmark (sequential numbers
+//  land in read_speed / write_speed) for every test this device
+//  has no fresh enough cached result for
 // ============================================================
-void StorageInfo::process_storage_info(std::function<void(const storage_data&)> callback) {
-    DWORD drive_mask = GetLogicalDrives();
-
-    if (drive_mask == 0) {
-        char buffer[256];
-        DWORD result = GetLogicalDriveStringsA(sizeof(buffer), buffer);
-
-        if (result > 0 && result <= sizeof(buffer)) {
-            char* p = buffer;
-            while (*p) {
-                char drive_letter = toupper(*p);
-                if (drive_letter >= 'A' && drive_letter <= 'Z') {
-                    drive_mask |= (1 << (drive_letter - 'A'));
-                }
-                p += strlen(p) + 1;
-            }
-        }
-
-        if (drive_mask == 0) {
-            for (char c = 'C'; c <= 'D'; c++) {
-                string test = string(1, c) + ":\\";
-                if (GetDriveTypeA(test.c_str()) == DRIVE_FIXED) {
-                    drive_mask |= (1 << (c - 'A'));
-                }
-            }
-        }
+void StorageInfo::benchmark_volume(const string& root_path, int disk_number, storage_data& disk) {
+    // Measurements (and the speed cache file) can't be replayed
+    Probe::unrouted("DiskBenchmark / DiskSpeedCache");
+
+    // Cached tests are reused one by one; only the missing ones are measured
+    DiskIdentity identity;
+    vector<size_t> missing;
+    int64_t age = 0;
+    size_t hits = 0;
+    // A share has no device identity, and asking for its volume GUID / serial can
+    // block on a dead server, so remote volumes are measured but never cached
+    if (speed_cache && !disk.is_remote) identity = volume_identity(root_path, disk_number);
+    if (speed_cache && !force_rebench) {
+        hits = speed_cache->lookup(identity, bench_config, cache_ttl_seconds, disk.benchmark, missing, age);
+    }
+    else {
+        for (size_t i = 0; i < bench_config.tests.size(); i++) missing.push_back(i);
     }
 
-    if (drive_mask == 0) return;
+    if (!missing.empty()) {
+        DiskBenchConfig pending = bench_config;
+        pending.tests.clear();
+        for (size_t i : missing) pending.tests.push_back(bench_config.tests[i]);
 
-    char drive_letter = 'A';
-    int disk_index = 0;
+        storage_data measured = disk;
+        run_disk_benchmark(measured, root_path, pending);
+        if (speed_cache) speed_cache->store(identity, pending, measured.benchmark);
 
-    while (drive_mask) {
-        if (drive_mask & 1) {
-            string root_path = string(1, drive_letter) + ":\\";
+        // Nothing cached: the measured set is the whole answer (empty when no
+        // test file could be created). Otherwise each measurement goes back to
+        // its test's slot next to the cached ones.
+        if (hits == 0) disk.benchmark = measured.benchmark;
+        else DiskSpeedCache::merge(bench_config, missing, measured.benchmark, disk.benchmark);
+    }
 
-            UINT dt = GetDriveTypeA(root_path.c_str());
-            if (dt == DRIVE_NO_ROOT_DIR || dt == DRIVE_UNKNOWN) {
-                drive_mask >>= 1;
-                drive_letter++;
-                continue;
-            }
+    if (hits > 0) disk.speed_age_seconds = age;
+    fill_speed_columns(disk);
+}
 
-            ULARGE_INTEGER free_bytes, total_bytes, free_bytes_available;
+vector<storage_data> StorageInfo::get_all_storage_info() {
+    vector<storage_data> all_disks;
+    process_storage_info([&](const storage_data& disk) { all_disks.push_back(disk); });
+    return all_disks;
+}
 
-            if (GetDiskFreeSpaceExA(root_path.c_str(), &free_bytes_available, &total_bytes, &free_bytes)) {
-                double total_gib = total_bytes.QuadPart / (1024.0 * 1024.0 * 1024.0);
+void StorageInfo::process_storage_info(std::function<void(const storage_data&)> callback) {
+    StorageCallbacks callbacks;
+    callbacks.on_complete = callback;
+    process_storage_info(callbacks);
+}
 
-                if (total_gib < 0.1) {
-                    drive_mask >>= 1;
-                    drive_letter++;
-                    continue;
-                }
+// ============================================================
+//  STAGED PIPELINE: every stage streams in drive-letter order
+//  1. basic     - from the enumerator, as each volume is stat'ed
+//  2. type      - volume -> disk number and storage type IOCTLs
+//                 (one disk-number lookup per volume, reused below)
+//  3. health    - identity / SMART, read once per physical disk
+//  4. complete  - benchmarks
+//  Stages 3 and 4 run on one worker per physical disk: volumes on
+//  the same disk go one after another on that disk's worker, so a
+//  slow SMART read or benchmark never holds up another device and
+//  benchmarks don't compete for the same disk; different disks (and
+//  volumes we can't map) run concurrently. Each drive is delivered
+//  as soon as it and every drive before it are done. Stage 3 is
+//  skipped when nobody wants on_health or on_complete, stage 4 when
+//  nobody wants on_complete.
+// ============================================================
+void StorageInfo::process_storage_info(const StorageCallbacks& callbacks) {
+    struct Slot {
+        string root_path;
+        storage_data disk;
+        int disk_number = -1;       // physical disk (-1 = unmapped / remote / unreachable)
+        bool health_done = false;
+        bool done = false;
+    };
 
-                double free_gib = free_bytes.QuadPart / (1024.0 * 1024.0 * 1024.0);
-                double used_gib = total_gib - free_gib;
-                double used_percent = (total_gib > 0) ? (used_gib / total_gib) * 100.0 : 0.0;
+    // Stage 1
+    vector<Slot> slots;
+    StorageEnumerator::each([&](const VolumeInfo& v) {
+        Slot slot;
+        slot.root_path = v.root_path;
+        if (!basic_from_volume(v, slot.disk)) return;
 
-                char fs_name[MAX_PATH] = { 0 };
-                GetVolumeInformationA(root_path.c_str(), nullptr, 0, nullptr, nullptr, nullptr, fs_name, sizeof(fs_name));
-                string formatted_fs = string(fs_name);
-                if (formatted_fs.empty()) formatted_fs = "RAW";
-                if (formatted_fs == "NTFS") formatted_fs = "NTFS ";
+        if (callbacks.on_basic) callbacks.on_basic(slot.disk);
+        slots.push_back(slot);
+        });
 
-                bool is_external = (dt == DRIVE_REMOVABLE);
+    // Stage 2
+    for (auto& slot : slots) {
+        if (!slot.disk.unreachable && !slot.disk.is_remote) slot.disk_number = volume_disk_number(slot.root_path);
+        detect_type(slot.root_path, slot.disk_number, slot.disk);
+        slot.disk.serial_number = "---";
 
-                ostringstream used_str, total_str, percent_str;
-                used_str << fixed << setprecision(2) << used_gib;
-                total_str << fixed << setprecision(2) << total_gib;
-                percent_str << "(" << (int)used_percent << "%)";
+        if (callbacks.on_type) callbacks.on_type(slot.disk);
+    }
 
-                storage_data disk;
-                disk.drive_letter = "Disk (" + string(1, drive_letter) + ":)";
-                disk.used_space = used_str.str();
-                disk.total_space = total_str.str();
-                disk.used_percentage = static_cast<int>(used_percent);  // Store as int directly
-                disk.file_system = formatted_fs;
-                disk.is_external = is_external;
+    bool want_health = static_cast<bool>(callbacks.on_health);
+    bool want_complete = static_cast<bool>(callbacks.on_complete);
+    if ((!want_health && !want_complete) || slots.empty()) return;
 
+    // Stages 3 + 4: group volumes by physical disk; unmapped ones (-1) each get their own group
+    map<int, vector<size_t>> by_disk;
+    vector<vector<size_t>> groups;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].disk_number < 0) groups.push_back({ i });
+        else by_disk[slots[i].disk_number].push_back(i);
+    }
+    for (auto& kv : by_disk) groups.push_back(kv.second);
+
+    mutex m;
+    condition_variable cv;
+    vector<thread> workers;
+
+    // Workers write into slots / m / cv: they are joined before those go away,
+    // also when a callback throws on the way out
+    struct JoinAll {
+        vector<thread>& threads;
+        ~JoinAll() {
+            for (auto& t : threads) {
+                if (t.joinable()) t.join();
+            }
+        }
+    } join_all{ workers };
+
+    for (const auto& group : groups) {
+        workers.emplace_back([&, group]() {
+            // Health is per physical disk, shared by the group's volumes
+            DiskHealthData health;
+            int disk_number = slots[group.front()].disk_number;
+            if (disk_number >= 0) {
                 try {
-                    disk.storage_type = get_storage_type(disk.drive_letter, root_path, is_external);
+                    health = DiskHealth::read("\\\\.\\PhysicalDrive" + to_string(disk_number), read_health);
                 }
                 catch (...) {
-                    disk.storage_type = "SSD";
+                    // No identity either; the drive still shows
                 }
+            }
+            {
+                lock_guard<mutex> lock(m);
+                for (size_t i : group) {
+                    slots[i].disk.health = health;
+                    slots[i].disk.serial_number = health.serial.empty() ? "---" : health.serial;
+                    slots[i].health_done = true;
+                    if (!want_complete) slots[i].done = true;
+                }
+                cv.notify_all();
+            }
+            if (!want_complete) return;
 
-                double w = 0.0, r = 0.0;
+            for (size_t i : group) {
+                storage_data disk;
+                {
+                    lock_guard<mutex> lock(m);
+                    disk = slots[i].disk;
+                }
                 try {
-                    // Try write test first (creates file for read test)
-                    w = measure_disk_speed(root_path, true);
-
-                    // Small delay to ensure file system sync
-                    Sleep(100);
-
-                    // Try read test
-                    r = measure_disk_speed(root_path, false);
-
-                    // CRITICAL FIX: If both failed (0.0), retry with fallback method
-                    if (w == 0.0 && r == 0.0) {
-                        // Retry without NO_BUFFERING (for compatibility)
-                        Sleep(200);
-                        w = measure_disk_speed(root_path, true);
-                        Sleep(100);
-                        r = measure_disk_speed(root_path, false);
+                    // Nothing to measure on a mount that didn't even answer a stat; shares
+                    // only when asked for (a slow server would hold the whole section)
+                    if (!disk.unreachable && (!disk.is_remote || bench_remote)) {
+                        benchmark_volume(slots[i].root_path, disk_number, disk);
                     }
-
                 }
                 catch (...) {
-                    w = 0.0;
-                    r = 0.0;
+                    // Keep the drive; it just has no speed figures
                 }
 
-                ostringstream ss;
-                ss << fixed << setprecision(2) << (r > 0 ? r : 0.0);
-                disk.read_speed = ss.str();
-                ss.str("");
-                ss.clear();
-                ss << fixed << setprecision(2) << (w > 0 ? w : 0.0);
-                disk.write_speed = ss.str();
-
-                disk.serial_number = "SN-" + to_string(1000 + disk_index);
-
-                if (disk.storage_type == "USB") {
-                    disk.predicted_read_speed = "100";
-                    disk.predicted_write_speed = "80";
-                }
-                else if (disk.storage_type == "SSD") {
-                    disk.predicted_read_speed = "500";
-                    disk.predicted_write_speed = "450";
-                }
-                else if (disk.storage_type == "HDD") {
-                    disk.predicted_read_speed = "140";
-                    disk.predicted_write_speed = "120";
-                }
-                else {
-                    disk.predicted_read_speed = "---";
-                    disk.predicted_write_speed = "---";
-                }
-
-                callback(disk);
-                disk_index++;
+                lock_guard<mutex> lock(m);
+                slots[i].disk = disk;
+                slots[i].done = true;
+                cv.notify_all();
             }
+            });
+    }
+
+    // Emit in order, each stage with its own cursor; callbacks run on this thread without the lock held
+    size_t next_health = want_health ? 0 : slots.size();
+    size_t next_complete = want_complete ? 0 : slots.size();
+    while (next_health < slots.size() || next_complete < slots.size()) {
+        storage_data disk;
+        bool is_health = false;
+        {
+            unique_lock<mutex> lock(m);
+            cv.wait(lock, [&]() {
+                return (next_health < slots.size() && slots[next_health].health_done) ||
+                    (next_complete < slots.size() && slots[next_complete].done);
+                });
+            is_health = next_health < slots.size() && slots[next_health].health_done;
+            disk = is_health ? slots[next_health++].disk : slots[next_complete++].disk;
         }
-        drive_letter++;
-        drive_mask >>= 1;
+        if (is_health) callbacks.on_health(disk);
+        else callbacks.on_complete(disk);
     }
+
+    for (auto& t : workers) t.join();
+
+    if (want_complete && speed_cache) speed_cache->save();
 }
 
 /*
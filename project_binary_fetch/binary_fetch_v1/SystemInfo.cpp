@@ -1,4 +1,5 @@
 #include "include\SystemInfo.h"
+#include "include\Probe.h"
 #include <windows.h>
 #include <iostream>
 using namespace std;
@@ -11,23 +12,27 @@ SystemInfo::~SystemInfo() {
     // Nothing to clean
 }
 
-// Registry reading function (internal)
+// Registry reading function (internal); goes through Probe like CompactSystem's
+// ("" when missing) so --replay shows the recorded machine
 string SystemInfo::read_registry_value(const string& subkey, const string& valueName) {
-    HKEY hKey;
-    if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, subkey.c_str(), 0, KEY_READ, &hKey) != ERROR_SUCCESS)
-        return "N/A";
+    string value = Probe::text("reg:HKLM\\" + subkey + "\\" + valueName, [&]() -> string {
+        HKEY hKey;
+        if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, subkey.c_str(), 0, KEY_READ, &hKey) != ERROR_SUCCESS)
+            return "";
 
-    char value[256] = { 0 };
-    DWORD size = sizeof(value);
-    DWORD type = 0;
+        char value[256] = { 0 };
+        DWORD size = sizeof(value) - 1;
+        DWORD type = 0;
 
-    if (RegQueryValueExA(hKey, valueName.c_str(), nullptr, &type, reinterpret_cast<LPBYTE>(value), &size) != ERROR_SUCCESS) {
-        RegCloseKey(hKey);
-        return "N/A";
-    }
+        if (RegQueryValueExA(hKey, valueName.c_str(), nullptr, &type, reinterpret_cast<LPBYTE>(value), &size) != ERROR_SUCCESS) {
+            RegCloseKey(hKey);
+            return "";
+        }
 
-    RegCloseKey(hKey);
-    return string(value);
+        RegCloseKey(hKey);
+        return string(value);
+    });
+    return value.empty() ? "N/A" : value;
 }
 
 // BIOS info
@@ -1,4 +1,6 @@
 #include "include\TimeInfo.h"
+#include "include\Probe.h"
+#include <cstdio>
 using namespace std;
 
 // Constructor - gets current system time
@@ -6,9 +8,30 @@ TimeInfo::TimeInfo() {
     updateTime();
 }
 
-// Private method to fetch current system time
+// Private method to fetch current system time; goes through Probe
+// ("Y M D dow h m s ms") so --replay shows the recorded moment
 void TimeInfo::updateTime() {
-    GetLocalTime(&systemTime);
+    string recorded = Probe::text("time:local", []() -> string {
+        SYSTEMTIME now = {};
+        GetLocalTime(&now);
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%u %u %u %u %u %u %u %u", now.wYear, now.wMonth, now.wDay,
+            now.wDayOfWeek, now.wHour, now.wMinute, now.wSecond, now.wMilliseconds);
+        return buf;
+    });
+
+    unsigned f[8] = {};
+    systemTime = {};
+    if (sscanf(recorded.c_str(), "%u %u %u %u %u %u %u %u", &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6], &f[7]) == 8) {
+        systemTime.wYear = static_cast<WORD>(f[0]);
+        systemTime.wMonth = static_cast<WORD>(f[1]);
+        systemTime.wDay = static_cast<WORD>(f[2]);
+        systemTime.wDayOfWeek = static_cast<WORD>(f[3]);
+        systemTime.wHour = static_cast<WORD>(f[4]);
+        systemTime.wMinute = static_cast<WORD>(f[5]);
+        systemTime.wSecond = static_cast<WORD>(f[6]);
+        systemTime.wMilliseconds = static_cast<WORD>(f[7]);
+    }
 }
 
 // Check if a year is a leap year
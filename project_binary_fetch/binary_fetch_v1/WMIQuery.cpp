@@ -0,0 +1,320 @@
+#include "include\WMIQuery.h"
+#include "include\Probe.h"
+
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <comdef.h>
+#include <Wbemidl.h>
+#pragma comment(lib, "wbemuuid.lib")
+#endif
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+const char* const WMIQuery::CIMV2 = "ROOT\\CIMV2";
+
+#ifdef _WIN32
+
+// ----------------- Live COM executor -----------------
+// One locator for the whole run and one IWbemServices per namespace,
+// instead of a fresh locator + connection for every single field.
+
+static string variant_to_text(const VARIANT& v, bool& ok)
+{
+    ok = true;
+    char buf[64];
+    switch (v.vt) {
+    case VT_BSTR: {
+        if (!v.bstrVal) break;
+        int len = SysStringLen(v.bstrVal);
+        if (len == 0) return "";
+        int sz = WideCharToMultiByte(CP_UTF8, 0, v.bstrVal, len, nullptr, 0, nullptr, nullptr);
+        string out(sz, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, v.bstrVal, len, &out[0], sz, nullptr, nullptr);
+        return out;
+    }
+    case VT_BOOL: return v.boolVal ? "True" : "False";
+    case VT_I1:   return to_string(static_cast<int>(v.cVal));
+    case VT_UI1:  return to_string(v.bVal);
+    case VT_I2:   return to_string(v.iVal);
+    case VT_UI2:  return to_string(v.uiVal);
+    case VT_I4:   return to_string(v.lVal);
+    case VT_UI4:  return to_string(v.ulVal);
+    case VT_INT:  return to_string(v.intVal);
+    case VT_UINT: return to_string(v.uintVal);
+    case VT_I8:   return to_string(v.llVal);
+    case VT_UI8:  return to_string(v.ullVal);
+    case VT_R4:   snprintf(buf, sizeof(buf), "%.9g", v.fltVal); return buf;
+    case VT_R8:   snprintf(buf, sizeof(buf), "%.17g", v.dblVal); return buf;
+    default: break;
+    }
+    ok = false;   // VT_NULL, arrays, embedded objects
+    return "";
+}
+
+class ComWMIExecutor : public WMIExecutor {
+private:
+    mutex connectMutex;             // queries run in parallel; connecting doesn't
+    IWbemLocator* locator = nullptr;
+    map<string, IWbemServices*> services;
+
+    IWbemServices* connect(const string& ns)
+    {
+        lock_guard<mutex> lock(connectMutex);
+        auto it = services.find(ns);
+        if (it != services.end()) return it->second;
+
+        if (!locator) {
+            HRESULT hr = CoInitializeSecurity(NULL, -1, NULL, NULL,
+                RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
+                NULL, EOAC_NONE, NULL);
+            if (FAILED(hr) && hr != RPC_E_TOO_LATE) return nullptr;
+
+            hr = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
+                IID_IWbemLocator, (LPVOID*)&locator);
+            if (FAILED(hr)) { locator = nullptr; return nullptr; }
+        }
+
+        // Failed namespaces are remembered as nullptr so they aren't retried every field
+        IWbemServices* svc = nullptr;
+        HRESULT hr = locator->ConnectServer(_bstr_t(ns.c_str()), NULL, NULL, 0, NULL, 0, 0, &svc);
+        if (FAILED(hr)) svc = nullptr;
+        else if (FAILED(CoSetProxyBlanket(svc, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
+            RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE))) {
+            svc->Release();
+            svc = nullptr;
+        }
+        services[ns] = svc;
+        return svc;
+    }
+
+public:
+    ~ComWMIExecutor() override { release(); }
+
+    bool execute(const string& ns, const string& wql,
+        const vector<string>& properties, vector<WMIRow>& rows) override
+    {
+        // Balanced per call: harmless when main() already owns an MTA,
+        // required when a worker thread asks
+        HRESULT init = CoInitializeEx(0, COINIT_MULTITHREADED);
+        bool needsUninit = SUCCEEDED(init);
+
+        IWbemServices* svc = connect(ns);
+        IEnumWbemClassObject* enumerator = nullptr;
+        bool ok = svc && SUCCEEDED(svc->ExecQuery(bstr_t("WQL"), bstr_t(wql.c_str()),
+            WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, NULL, &enumerator));
+
+        IWbemClassObject* obj = nullptr;
+        ULONG returned = 0;
+        while (ok && enumerator && enumerator->Next(WBEM_INFINITE, 1, &obj, &returned) == S_OK && returned) {
+            WMIRow row;
+            for (const auto& prop : properties) {
+                wstring wprop(prop.begin(), prop.end());
+                VARIANT val;
+                VariantInit(&val);
+                if (SUCCEEDED(obj->Get(wprop.c_str(), 0, &val, 0, 0))) {
+                    bool hasValue = false;
+                    string text = variant_to_text(val, hasValue);
+                    if (hasValue) row[prop] = text;
+                }
+                VariantClear(&val);
+            }
+            rows.push_back(move(row));
+            obj->Release();
+        }
+
+        if (enumerator) enumerator->Release();
+        if (needsUninit) CoUninitialize();
+        return ok;
+    }
+
+    void release() override
+    {
+        lock_guard<mutex> lock(connectMutex);
+        for (auto& kv : services) {
+            if (kv.second) kv.second->Release();
+        }
+        services.clear();
+        if (locator) locator->Release();
+        locator = nullptr;
+    }
+};
+
+#endif
+
+// ----------------- Planner + cache -----------------
+
+namespace {
+    struct Target {
+        vector<string> wanted;      // every property asked for, in first-seen order
+        set<string> fetched;        // properties the cached rows were selected with
+        vector<WMIRow> rows;
+        bool ran = false;
+        bool running = false;       // a SELECT for it is in flight (without the lock)
+    };
+
+    mutex wmiMutex;
+    condition_variable wmiDone;     // signalled whenever a running target finishes
+    map<string, Target> targets;    // "ns|class|where" -> plan + cached rows
+    shared_ptr<WMIExecutor> executor;
+    uint64_t generation = 0;        // bumped by clear() / setExecutor() / shutdown()
+
+    shared_ptr<WMIExecutor> activeExecutor()
+    {
+#ifdef _WIN32
+        if (!executor) executor = make_shared<ComWMIExecutor>();
+#endif
+        return executor;
+    }
+
+    string targetKey(const string& ns, const string& cls, const string& where)
+    {
+        return ns + "|" + cls + "|" + where;
+    }
+
+    void addWanted(Target& t, const vector<string>& properties)
+    {
+        for (const auto& prop : properties) {
+            if (find(t.wanted.begin(), t.wanted.end(), prop) == t.wanted.end()) t.wanted.push_back(prop);
+        }
+    }
+
+    // One SELECT; called without wmiMutex held
+    vector<WMIRow> run(WMIExecutor* exec, const string& ns, const string& cls, const string& where,
+        const vector<string>& props)
+    {
+        string wql = WMIQuery::buildQuery(cls, props, where);
+        string encoded = Probe::text("wql:" + ns + ":" + wql, [&]() -> string {
+            vector<WMIRow> rows;
+            if (!exec || !exec->execute(ns, wql, props, rows)) return "";
+            return json(rows).dump(-1, ' ', false, json::error_handler_t::replace);
+        });
+
+        try {
+            if (!encoded.empty()) return json::parse(encoded).get<vector<WMIRow>>();
+        }
+        catch (...) {}
+        return {};
+    }
+
+    // Runs (or re-runs) the target when the cache can't answer for `needed`.
+    // The SELECT itself runs with the lock released, so a slow namespace
+    // (a missing OpenHardwareMonitor, ROOT\WMI thermal zones) doesn't hold
+    // up collectors on other threads; a second caller for the same target
+    // waits for the run in flight instead of starting its own.
+    Target& ensure(unique_lock<mutex>& lock, const string& ns, const string& cls, const string& where,
+        const vector<string>& needed)
+    {
+        string key = targetKey(ns, cls, where);
+        for (;;) {
+            Target& t = targets[key];
+            addWanted(t, needed);
+            if (t.running) {
+                wmiDone.wait(lock);
+                continue;
+            }
+
+            bool stale = !t.ran;
+            for (const auto& prop : needed) {
+                if (!t.fetched.count(prop)) stale = true;
+            }
+            if (!stale) return t;
+
+            // A bare count still needs something to select
+            vector<string> props = t.wanted.empty() ? vector<string>{ "__RELPATH" } : t.wanted;
+            shared_ptr<WMIExecutor> exec = activeExecutor();
+            uint64_t started = generation;
+            t.running = true;
+
+            lock.unlock();
+            vector<WMIRow> rows = run(exec.get(), ns, cls, where, props);
+            lock.lock();
+
+            // Results from before a clear()/shutdown() are dropped; the loop asks again
+            Target& done = targets[key];
+            done.running = false;
+            if (generation == started) {
+                done.rows = move(rows);
+                done.fetched = set<string>(props.begin(), props.end());
+                done.ran = true;
+            }
+            wmiDone.notify_all();
+        }
+    }
+}
+
+void WMIQuery::want(const string& cls, const vector<string>& properties, const string& where, const string& ns)
+{
+    lock_guard<mutex> lock(wmiMutex);
+    addWanted(targets[targetKey(ns, cls, where)], properties);
+}
+
+string WMIQuery::get(const string& cls, const string& property, const string& where, const string& ns)
+{
+    unique_lock<mutex> lock(wmiMutex);
+    Target& t = ensure(lock, ns, cls, where, { property });
+    if (t.rows.empty()) return "Unknown";
+
+    auto it = t.rows.front().find(property);
+    return (it == t.rows.front().end()) ? "Unknown" : it->second;
+}
+
+vector<WMIRow> WMIQuery::rows(const string& cls, const vector<string>& properties, const string& where, const string& ns)
+{
+    unique_lock<mutex> lock(wmiMutex);
+    return ensure(lock, ns, cls, where, properties).rows;
+}
+
+size_t WMIQuery::count(const string& cls, const string& where, const string& ns)
+{
+    unique_lock<mutex> lock(wmiMutex);
+    return ensure(lock, ns, cls, where, {}).rows.size();
+}
+
+void WMIQuery::setExecutor(shared_ptr<WMIExecutor> exec)
+{
+    lock_guard<mutex> lock(wmiMutex);
+    if (executor) executor->release();
+    executor = exec;
+    targets.clear();
+    generation++;
+}
+
+void WMIQuery::clear()
+{
+    lock_guard<mutex> lock(wmiMutex);
+    for (auto& kv : targets) {
+        kv.second.rows.clear();
+        kv.second.fetched.clear();
+        kv.second.ran = false;
+    }
+    generation++;
+}
+
+void WMIQuery::shutdown()
+{
+    lock_guard<mutex> lock(wmiMutex);
+    if (executor) executor->release();
+    executor.reset();
+    targets.clear();
+    generation++;
+}
+
+string WMIQuery::buildQuery(const string& cls, const vector<string>& properties, const string& where)
+{
+    string wql = "SELECT ";
+    for (size_t i = 0; i < properties.size(); ++i) {
+        if (i) wql += ", ";
+        wql += properties[i];
+    }
+    wql += " FROM " + cls;
+    if (!where.empty()) wql += " WHERE " + where;
+    return wql;
+}
@@ -1,25 +1,22 @@
 #include "include\compact_disk_info.h"
-#include <windows.h>
+#include "include\StorageEnumerator.h"
 using namespace std;
 DiskInfo::DiskInfo() {
     // Constructor (empty)
 }
 
-// Calculate used percentage for a single disk (integer)
-int DiskInfo::calculateUsedPercentage(const string& driveLetter) {
-    ULARGE_INTEGER freeBytesAvailable, totalNumberOfBytes, totalNumberOfFreeBytes;
-
-    if (GetDiskFreeSpaceExA(driveLetter.c_str(),
-        &freeBytesAvailable,
-        &totalNumberOfBytes,
-        &totalNumberOfFreeBytes)) {
+// Local and removable volumes only (what compact mode always showed)
+static bool is_compact_volume(const VolumeInfo& v) {
+    return v.kind == VolumeKind::Fixed || v.kind == VolumeKind::Removable;
+}
 
-        if (totalNumberOfBytes.QuadPart > 0) {
-            return static_cast<int>(
-                ((totalNumberOfBytes.QuadPart - totalNumberOfFreeBytes.QuadPart) * 100)
-                / totalNumberOfBytes.QuadPart
-                );
-        }
+// Calculate used percentage for a single disk (integer)
+int DiskInfo::calculateUsedPercentage(const VolumeInfo& volume) {
+    if (volume.stat_ok && volume.total_bytes > 0) {
+        return static_cast<int>(
+            ((volume.total_bytes - volume.free_bytes) * 100)
+            / volume.total_bytes
+            );
     }
 
     return 0;
@@ -29,14 +26,11 @@ int DiskInfo::calculateUsedPercentage(const string& driveLetter) {
 vector<pair<string, int>> DiskInfo::getAllDiskUsage() {
     vector<pair<string, int>> diskList;
 
-    for (char drive = 'A'; drive <= 'Z'; ++drive) {
-        string driveLetter = string(1, drive) + ":\\";
-
-        if (GetDriveTypeA(driveLetter.c_str()) == DRIVE_FIXED ||
-            GetDriveTypeA(driveLetter.c_str()) == DRIVE_REMOVABLE) {
-
-            int used = calculateUsedPercentage(driveLetter);
-            diskList.push_back({ driveLetter, used });
+    // Same snapshot StorageInfo uses: each volume is stat'ed once per run
+    for (const auto& volume : StorageEnumerator::volumes()) {
+        if (is_compact_volume(volume)) {
+            int used = calculateUsedPercentage(volume);
+            diskList.push_back({ volume.root_path, used });
         }
     }
 
@@ -44,32 +38,19 @@ vector<pair<string, int>> DiskInfo::getAllDiskUsage() {
 }
 
 // Helper: calculate capacity in GB
-int DiskInfo::calculateCapacityGB(const string& driveLetter) {
-    ULARGE_INTEGER freeBytesAvailable, totalNumberOfBytes, totalNumberOfFreeBytes;
-
-    if (GetDiskFreeSpaceExA(driveLetter.c_str(),
-        &freeBytesAvailable,
-        &totalNumberOfBytes,
-        &totalNumberOfFreeBytes)) {
-        // Convert bytes to GB
-        return static_cast<int>(totalNumberOfBytes.QuadPart / (1024 * 1024 * 1024));
-    }
-
-    return 0;
+int DiskInfo::calculateCapacityGB(const VolumeInfo& volume) {
+    // Convert bytes to GB
+    return volume.stat_ok ? static_cast<int>(volume.total_bytes / (1024ull * 1024 * 1024)) : 0;
 }
 
 // Get all disk capacities in GB
 vector<pair<string, int>> DiskInfo::getDiskCapacity() {
     vector<pair<string, int>> diskCapList;
 
-    for (char drive = 'A'; drive <= 'Z'; ++drive) {
-        string driveLetter = string(1, drive) + ":\\";
-
-        if (GetDriveTypeA(driveLetter.c_str()) == DRIVE_FIXED ||
-            GetDriveTypeA(driveLetter.c_str()) == DRIVE_REMOVABLE) {
-
-            int capacity = calculateCapacityGB(driveLetter);
-            diskCapList.push_back({ driveLetter, capacity });
+    for (const auto& volume : StorageEnumerator::volumes()) {
+        if (is_compact_volume(volume)) {
+            int capacity = calculateCapacityGB(volume);
+            diskCapList.push_back({ volume.root_path, capacity });
         }
     }
 
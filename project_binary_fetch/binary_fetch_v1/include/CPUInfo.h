@@ -4,6 +4,9 @@ using namespace std;
 
 class CPUInfo {
 public:
+	// registers this module's WMI fields before any collector reads one
+	static void plan_wmi();
+
 	// cpu brand and model
 	string get_cpu_info();
 
@@ -18,6 +21,7 @@ public:
 	int get_cpu_sockets();              // number of sockets
 	int get_cpu_cores();                // physical cores
 	int get_cpu_logical_processors();   // logical processors (threads)
+	string get_cpu_core_types();        // "8P + 16E" on hybrid CPUs, "" otherwise
 
 	// virtualization status
 	string get_cpu_virtualization();
@@ -27,6 +31,9 @@ public:
 	string get_cpu_l2_cache();          // L2 cache size
 	string get_cpu_l3_cache();          // L3 cache size
 
+	// instruction set extensions (SSE4.2, AVX2, AVX-512, AMX)
+	string get_cpu_instruction_sets();
+
 	// system statistics
 	string get_system_uptime();         // system uptime
 	int get_process_count();            // number of processes
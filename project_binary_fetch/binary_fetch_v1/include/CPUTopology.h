@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+/*
+    CPUTopology — sockets, cores, caches and ISA extensions straight from CPUID
+
+    One pass, shared by CPUInfo and CompactCPU (get() runs it once per
+    process). A worker thread is pinned to every logical processor in turn
+    and reads that processor's leaves, because topology and hybrid core type
+    are per-processor answers:
+
+        0x1F / 0xB       x2APIC ID and the bit widths of the SMT and core
+                         levels; the ID above them is the package, between
+                         them the core (0x1F first: it knows about dies)
+        0x1 / 0x80000008 legacy widths when neither of the above exists
+        0x1A             core type on hybrid parts (P = Core, E = Atom)
+        0x4 / 0x8000001D deterministic cache parameters (Intel / AMD); the
+                         "logical processors sharing" width groups the
+                         APIC IDs into cache instances, so every L2 slice
+                         and L3 is counted once with its own size (P and E
+                         clusters differ)
+        0x80000008       physical / linear address bits
+        0x1 / 0x7        SSE4.2, AVX, AVX2, FMA, AVX-512, AMX; the vector
+                         extensions only count when XCR0 says the OS saves
+                         their state
+
+    The raw registers go through Probe as one JSON value ("cpuid:dump"), so
+    --replay decodes the recorded machine and decode() can be fed fixtures.
+    Without CPUID (non-x86 builds) or if no processor could be pinned, ok
+    stays false and the callers use their OS fallbacks.
+*/
+
+enum class CoreType { Unknown, Performance, Efficient };
+
+struct CpuLogicalProcessor {
+    int os = 0;                     // OS processor number (group * 64 + index on Windows)
+    uint32_t apicId = 0;
+    uint32_t package = 0;
+    uint32_t core = 0;              // unique within the package
+    uint32_t thread = 0;            // SMT sibling index
+    CoreType type = CoreType::Unknown;
+};
+
+struct CpuCache {
+    int level = 0;
+    char type = 'U';                // 'D'ata, 'I'nstruction, 'U'nified
+    uint64_t sizeBytes = 0;         // one instance
+    int ways = 0;
+    int lineSize = 0;
+    int sharedBy = 0;               // logical processors per instance (as found)
+    int instances = 0;
+};
+
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+    bool avx512dq = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool avx512vnni = false;
+    bool amxTile = false;
+    bool amxBf16 = false;
+    bool amxInt8 = false;
+    bool hypervisor = false;        // running under one
+    bool vmx = false;               // VT-x capable
+    bool svm = false;               // AMD-V capable
+};
+
+class CPUTopology {
+public:
+    bool ok = false;
+    string vendor;                  // "GenuineIntel", "AuthenticAMD", ...
+    string brand;                   // trimmed brand string
+    int packages = 0;
+    int cores = 0;
+    int logical = 0;
+    int performanceCores = 0;       // both 0 unless hybrid
+    int efficientCores = 0;
+    int physicalAddressBits = 0;
+    int linearAddressBits = 0;
+    vector<CpuLogicalProcessor> processors;
+    vector<CpuCache> caches;        // grouped by level, type and instance size
+    CpuFeatures features;
+
+    // Collected on first use, then shared
+    static const CPUTopology& get();
+
+    // Decodes a "cpuid:dump" value
+    static CPUTopology decode(const string& dump);
+
+    // All instances at this level, instruction and data together
+    uint64_t cacheBytes(int level) const;
+
+    // "SSE4.2 AVX2 FMA AVX-512 (F DQ BW VL VNNI) AMX (BF16 INT8)"
+    string instructionSets() const;
+
+    // OS processor numbers in the order benchmarks should fill them: one
+    // thread per physical core first (P-cores before E-cores), SMT siblings
+    // last. Empty when ok is false.
+    vector<int> pinOrder() const;
+
+    // Pins the calling thread to one OS processor; false if not allowed
+    static bool pinThread(int os);
+
+    // sysfs CPU list ("0-3,8-11") -> 0 1 2 3 8 9 10 11
+    static vector<int> parseCpuList(const string& text);
+
+private:
+    static string dump();
+};
@@ -3,6 +3,7 @@
 using namespace std;
 class CompactGPU {
 public:
+    static void planWmi();              // registers the WMI fields below before any get()
     static string getGPUName();
     static double getVRAMGB();
     static int getGPUUsagePercent();  // Keep this
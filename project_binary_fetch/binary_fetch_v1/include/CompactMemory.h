@@ -6,6 +6,8 @@ using namespace std;
 
 class CompactMemory {
 public:
+    static void plan_wmi();     // registers the WMI fields below before any get()
+
     double get_total_memory();
     double get_free_memory();
     double get_used_memory_percent();
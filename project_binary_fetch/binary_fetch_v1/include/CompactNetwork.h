@@ -8,6 +8,7 @@ public:
     string get_network_ip();    // Local IPv4 address
 
 private:
-    string get_wifi_ssid();     // Helper: returns WiFi SSID
+    string get_wifi_ssid();     // Helper: returns WiFi SSID (cached per network)
+    static string query_wifi_ssid();    // Helper: asks the WLAN API
     string get_ethernet_name(); // Helper: returns Ethernet adapter name
 };
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <windows.h>
+#include "EDIDParser.h"
 using namespace std;
 struct ScreenInfo {
     string name;           // Friendly display name (e.g., "ASUS VG27AQ")
@@ -46,15 +47,6 @@ private:
     bool enrichWithNVAPI();
     bool enrichWithADL();
 
-    // Helper to get friendly name from EDID
-    string getFriendlyNameFromEDID(const wstring& deviceName);
-
-    // Helper to parse EDID for native resolution and name
-    struct EDIDInfo {
-        string friendlyName;
-        int nativeWidth;
-        int nativeHeight;
-        bool valid;
-    };
-    EDIDInfo parseEDID(const unsigned char* edid, size_t size);
+    // Helper to pick the EDID blob (name + native resolution) for a DXGI output
+    EDIDData getEDIDForDevice(const wstring& deviceName, const vector<EDIDBlob>& blobs);
 };
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+using namespace std;
+
+/*
+    ConnectionInfo — TCP socket states, listening ports and TCP health counters
+
+    Socket counts come from one dump per address family instead of the
+    text tables:
+
+        Linux:   NETLINK_SOCK_DIAG, SOCK_DIAG_BY_FAMILY with NLM_F_DUMP over
+                 every TCP state (TIME_WAIT and SYN_RECV included); one
+                 fixed-size inet_diag_msg per socket, no extensions
+                 requested, so the kernel does no per-socket formatting and
+                 we do no string parsing. /proc/net/tcp{,6} is only read if
+                 the netlink socket can't be opened.
+        Windows: GetExtendedTcpTable (IPv4 + IPv6, all states)
+
+    Counters (totals since boot):
+
+        Linux:   /proc/net/snmp  "Tcp:"    RetransSegs, OutSegs, InErrs
+                 /proc/net/netstat "TcpExt:" TCPOFOQueue, ListenOverflows,
+                 ListenDrops, TCPTimeouts
+        Windows: GetTcpStatisticsEx (IPv4 + IPv6); no out-of-order or listen
+                 queue counters, those stay -1
+
+    The socket summary goes through Probe as one JSON value
+    ("sockdiag:tcp" / "iphlp:tcp-table"), the counter files as "file:" keys.
+*/
+
+struct ConnectionStats {
+    bool ok = false;                    // socket counts were read
+    string source;                      // "sock_diag", "/proc/net/tcp", "GetExtendedTcpTable"
+    uint64_t total = 0;                 // TCP sockets in any state
+    vector<pair<string, uint64_t>> states;  // ESTABLISHED, TIME_WAIT, ... (fixed order, zeros kept)
+    vector<int> listeningPorts;         // sorted, unique
+
+    // -1 = not available on this platform
+    int64_t outSegments = -1;
+    int64_t retransSegments = -1;
+    int64_t inErrors = -1;
+    int64_t outOfOrder = -1;            // segments queued out of order
+    int64_t listenOverflows = -1;       // accept queue full
+    int64_t listenDrops = -1;
+    int64_t timeouts = -1;              // RTO expirations
+
+    double retransPercent() const
+    {
+        return outSegments > 0 && retransSegments >= 0 ? 100.0 * retransSegments / outSegments : 0.0;
+    }
+};
+
+class ConnectionInfo {
+public:
+    static ConnectionStats collect();
+
+    // Socket counts the /proc/net/tcp fallback reports for these two tables
+    // (counters left at -1)
+    static ConnectionStats parseProcTcp(string_view tcp, string_view tcp6);
+
+    // "Tcp:" / "TcpExt:" header + value line pairs (/proc/net/snmp, /proc/net/netstat)
+    static map<string, int64_t> parseSnmp(string_view text, const string& prefix);
+
+    // TCP state names in the kernel's numbering (1 = ESTABLISHED ... 11 = CLOSING)
+    static const vector<string>& stateNames();
+};
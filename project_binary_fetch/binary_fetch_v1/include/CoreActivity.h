@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+/*
+    CoreActivity — live per-core utilization and effective clock
+
+    The CPU section's single utilization figure and WMI CurrentClockSpeed
+    hide exactly what matters on big hosts: one pegged core among 63 idle
+    ones, or a socket that is throttling while the other boosts. This
+    samples every logical processor twice and reports each one separately:
+
+        Utilization
+            Linux:   /proc/stat "cpuN" lines (busy = everything but idle
+                     and iowait), read through PseudoFileReader
+            Windows: PDH \Processor Information(*)\% Processor Time
+
+        Effective clock (first source that works)
+            Linux:   APERF / MPERF deltas through /dev/cpu/N/msr (root and
+                     the msr module): MPERF ticks at the TSC rate while the
+                     core is awake and APERF at the clock it really ran at,
+                     so TSC rate * dAPERF / dMPERF is the average clock
+                     over the busy part of the interval, boost and
+                     throttling included
+                     scaling_cur_freq otherwise (the governor's last
+                     request, sampled once at the end of the interval)
+            Windows: Processor Frequency * % Processor Performance / 100
+                     (the figure Task Manager shows)
+
+    Socket membership comes from CPUTopology (sysfs physical_package_id
+    when CPUID isn't usable). Same sampling window as DiskActivity:
+    begin() early, sample(intervalMs) when the section renders.
+
+    The MSR snapshots go through Probe as one JSON value per sample
+    ("msr:aperf-mperf"), the PDH table as "pdh:\Processor Information(*)".
+*/
+
+struct CoreActivityStats {
+    int cpu = 0;                    // OS processor number
+    int package = 0;
+    double utilization = 0.0;       // % of the interval not idle
+    double mhz = 0.0;               // effective clock, 0 if unknown
+};
+
+class CoreActivity {
+public:
+    CoreActivity();
+    ~CoreActivity();
+
+    // Takes the baseline sample
+    void begin();
+
+    // Waits for the rest of intervalMs since begin() (calls begin() itself
+    // if nobody did), takes the second sample and returns one entry per
+    // logical processor, sorted by package then processor number
+    vector<CoreActivityStats> sample(int intervalMs);
+
+    // "APERF/MPERF", "scaling_cur_freq", "PDH" or "" after sample()
+    const string& clockSource() const { return source; }
+
+    // /proc/stat delta between two snapshots, cpu number -> busy %
+    static vector<pair<int, double>> diffStat(string_view before, string_view after);
+
+    // (tsc, aperf, mperf) per cpu at both ends -> effective MHz
+    static double effectiveMhz(const uint64_t before[3], const uint64_t after[3], double seconds);
+
+private:
+    struct Impl;
+    unique_ptr<Impl> impl;
+    chrono::steady_clock::time_point started;
+    string source;
+    bool begun = false;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+/*
+    CpuBenchmark — multi-core scaling of fixed integer and floating-point kernels
+
+    The core and thread counts CPUInfo reports are what the silicon has,
+    not what this process gets. A cgroup quota, a narrow affinity mask, a
+    noisy neighbour or a throttling package all hide behind the same
+    numbers; measured parallelism doesn't.
+
+    Two kernels, each a fixed amount of work per iteration with eight
+    independent lanes so one core runs at full issue width:
+
+        integer  64-bit shift-xor-multiply mixing (one op = one step)
+        float    y = y * a + b on doubles (2 FLOPs per lane)
+
+    Each kernel runs on 1, 2, 4, ... threads, plus the physical core count
+    and the logical processor count, for a fixed duration per step. Worker
+    i is pinned to CPUTopology::pinOrder()[i], so the first steps fill one
+    thread per physical core and SMT siblings only come in past the core
+    count. Unpinned when the topology is unknown.
+
+        throughput  iterations * work per iteration / wall time
+        efficiency  throughput(t) / (t * throughput(1))
+        parallelism best throughput / throughput(1)  ("cores' worth")
+
+    The limits the OS puts on this process are read alongside:
+        Linux:   sched_getaffinity (cgroup cpusets included) against
+                 /sys/devices/system/cpu/online, cgroup v2 cpu.max or v1
+                 cpu.cfs_quota_us / cpu.cfs_period_us
+        Windows: process group affinity against all processor groups,
+                 job object CPU rate control
+*/
+
+struct CpuBenchStep {
+    int threads = 1;
+    bool smt = false;               // more threads than physical cores
+    double intOps = 0.0;            // integer ops per second
+    double flops = 0.0;             // floating-point ops per second
+    double intEfficiency = 0.0;     // 1.0 = perfect scaling from one thread
+    double fpEfficiency = 0.0;
+};
+
+struct CpuBenchConfig {
+    int durationMs = 250;           // per kernel and thread count
+};
+
+struct CpuBenchReport {
+    vector<CpuBenchStep> steps;     // ascending thread counts
+    int physicalCores = 0;          // what the pin order was built from (0 = unknown)
+    int allowedCpus = 0;            // affinity mask
+    int onlineCpus = 0;             // whole machine, whatever the mask
+    double quotaCpus = 0.0;         // cgroup / job CPU limit, 0 = none
+    double intParallelism = 0.0;
+    double fpParallelism = 0.0;
+    bool pinned = false;
+};
+
+class CpuBenchmark {
+public:
+    static CpuBenchReport run(const CpuBenchConfig& config);
+
+    // Thread counts run() steps through for `logical` processors
+    static vector<int> threadCounts(int cores, int logical);
+
+    // Compares measured parallelism with the reported counts and the OS
+    // limits: "matches 16 cores", "limited by cgroup quota (2.0 CPUs)", ...
+    static string assess(const CpuBenchReport& report, int cores, int logical);
+
+    // OS limits on this process (0 = none / unknown)
+    static int allowedCpus();
+    static int onlineCpus();
+    static double quotaCpus();
+};
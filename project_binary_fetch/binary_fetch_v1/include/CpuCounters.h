@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+/*
+    CpuCounters — hardware performance counters over the sampling window
+
+    Utilization says a core was busy, not what it was busy with. The PMU
+    does: a core retiring 3 instructions per cycle is compute-bound, one
+    retiring 0.3 with half its cycles stalled on the back end is waiting
+    for memory.
+
+        Linux:   perf_event_open, one group per online processor, counting
+                 system-wide (pid -1, cpu N) so every process on the core is
+                 included:
+                     cycles (leader), instructions, cache-misses,
+                     branch-instructions, branch-misses,
+                     stalled-cycles-backend
+                 Members the PMU doesn't implement (stalled cycles on most
+                 Intel parts) are left out and read as -1. A group that was
+                 multiplexed is scaled by time_enabled / time_running.
+                 If no group ran at all (time_running 0 everywhere: the
+                 PMU has fewer free counters than the group has members),
+                 sample() counts again with cycles and instructions only,
+                 for at most intervalMs, and note() says so.
+        Windows: no equivalent without a kernel driver; error() says so
+
+    System-wide counting needs perf_event_paranoid <= 0 or CAP_PERFMON.
+    When the kernel refuses, or there is no PMU at all (most VMs), nothing
+    is counted and error() explains why; callers print that instead of
+    numbers. The counters are enabled in begin() and read in sample(), the
+    same window DiskActivity and CoreActivity use.
+
+    The per-cpu totals go through Probe as one JSON value
+    ("perf:counters"), so --replay shows the recorded machine's numbers.
+*/
+
+struct CpuCounterStats {
+    string name;                    // "cpu3", "Socket 0", "All"
+    int cpu = -1;                   // -1 for aggregates
+    int package = 0;
+    double cycles = 0.0;
+    double instructions = 0.0;
+    double cacheMisses = -1.0;      // -1 = event not available
+    double branches = -1.0;
+    double branchMisses = -1.0;
+    double stalledCycles = -1.0;    // back end
+
+    double ipc() const { return cycles > 0 ? instructions / cycles : 0.0; }
+    // Cache misses per thousand instructions
+    double cacheMpki() const { return cacheMisses >= 0 && instructions > 0 ? cacheMisses * 1000.0 / instructions : -1.0; }
+    double branchMissPercent() const { return branchMisses >= 0 && branches > 0 ? branchMisses * 100.0 / branches : -1.0; }
+    double stallPercent() const { return stalledCycles >= 0 && cycles > 0 ? stalledCycles * 100.0 / cycles : -1.0; }
+};
+
+class CpuCounters {
+public:
+    CpuCounters();
+    ~CpuCounters();
+
+    // Opens and starts the counters
+    void begin();
+
+    // Waits for the rest of intervalMs since begin() (calls begin() itself
+    // if nobody did), stops the counters and returns one entry per cpu,
+    // sorted by package then cpu; empty with error() set when unavailable
+    vector<CpuCounterStats> sample(int intervalMs);
+
+    // Why nothing was counted ("" when counting worked)
+    const string& error() const { return failure; }
+
+    // Counted, but with less than asked for ("" normally)
+    const string& note() const { return notice; }
+
+    // Sums per package, plus "All" when there is more than one
+    static vector<CpuCounterStats> bySocket(const vector<CpuCounterStats>& cpus);
+
+private:
+    struct Impl;
+    unique_ptr<Impl> impl;
+    chrono::steady_clock::time_point started;
+    string failure;
+    string notice;
+    bool begun = false;
+};
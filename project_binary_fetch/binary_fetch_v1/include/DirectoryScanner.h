@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+/*
+    DirectoryScanner — "where did the space go" for a list of paths
+
+    Walks each root with a work-stealing pool: every worker pops directories
+    from the back of its own deque and, when that runs dry, steals from the
+    front of someone else's, so one huge subtree doesn't leave the other
+    threads idle. Each directory is listed once:
+
+        Linux:   getdents64 on an O_DIRECTORY fd, statx(AT_STATX_DONT_SYNC)
+                 per entry; sizes are allocated blocks (what du reports)
+        Windows: FindFirstFileEx(FindExInfoBasic, FIND_FIRST_EX_LARGE_FETCH);
+                 sizes are file lengths
+
+    Symlinks and reparse points are not followed and the walk stays on the
+    root's file system (no crossing into other mounts).
+
+    Incremental rescans: per directory the cache stores its mtime, the bytes
+    and files directly inside it and its subdirectory names. A directory
+    whose mtime hasn't changed is not listed again; only its subdirectories
+    are visited (each checks its own mtime). Growth of existing files does
+    not touch the directory mtime, so such changes only show up once
+    something else in that directory changes. In exchange, a rescan of an
+    unchanged tree costs one stat per directory.
+
+        Windows: %LOCALAPPDATA%\BinaryFetch\DirSizeCache.json
+        Linux:   $XDG_CACHE_HOME/binaryfetch/dir_size_cache.json
+*/
+
+struct DirSizeEntry {
+    string path;
+    uint64_t bytes = 0;         // whole subtree
+    uint64_t files = 0;
+};
+
+struct DirScanResult {
+    DirSizeEntry root;
+    vector<DirSizeEntry> largest;   // biggest first, at most topN
+    bool ok = false;                // false = root couldn't be opened
+    uint64_t directories = 0;       // visited this run
+    uint64_t cachedDirectories = 0; // of those, answered from the cache
+};
+
+struct DirScanConfig {
+    vector<string> roots;
+    int topN = 10;
+    int depth = 1;              // rank directories up to this many levels below a root
+    int threads = 0;            // 0 = hardware threads
+    bool useCache = true;
+    string cachePath;           // "" = default location
+};
+
+class DirectoryScanner {
+public:
+    // One result per root, in config order
+    static vector<DirScanResult> scan(const DirScanConfig& config);
+
+    // The user's home directory (default root when none are configured)
+    static string homeDirectory();
+
+    static string defaultCachePath();
+};
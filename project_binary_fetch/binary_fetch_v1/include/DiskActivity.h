@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+using namespace std;
+
+/*
+    DiskActivity — live per-device I/O statistics
+
+    Capacity says nothing about whether a disk is saturated; this samples
+    the kernel's I/O counters twice and reports what happened in between:
+
+        Linux:   /proc/diskstats (whole disks from /sys/block, loop/ram/zram
+                 skipped), read through PseudoFileReader
+        Windows: PDH \PhysicalDisk(*) counters (read/write bytes and
+                 transfers per second, Avg. Disk sec/Transfer, Avg. Disk
+                 Queue Length, % Idle Time), _Total skipped
+
+    Usage follows the shared sampling window: begin() as early as possible,
+    sample(intervalMs) when the section renders. sample() only sleeps for
+    whatever part of the interval hasn't already passed, so the wait
+    overlaps with everything rendered in between. main.cpp runs sample()
+    on a worker instead and waits for it before its own disk I/O (the
+    benchmark, the directory scan), so that I/O stays out of the window.
+
+    Linux derivations (iostat -x equivalents), over the elapsed time t:
+        throughput  = sectors * 512 / t
+        latency     = (ms reading + ms writing) / (reads + writes)
+        queue depth = weighted ms doing I/O / t            (aqu-sz)
+        utilization = ms doing I/O / t, capped at 100%     (%util)
+*/
+
+struct DiskActivityStats {
+    string device;                  // "nvme0n1", "sda" / "0 C:"
+    double readBytesPerSec = 0.0;
+    double writeBytesPerSec = 0.0;
+    double readIops = 0.0;
+    double writeIops = 0.0;
+    double avgLatencyMs = 0.0;      // per completed request, reads and writes together
+    double queueDepth = 0.0;        // average requests in flight
+    double utilization = 0.0;       // % of the interval the device was busy
+};
+
+class DiskActivity {
+public:
+    DiskActivity();
+    ~DiskActivity();
+
+    // Takes the baseline sample
+    void begin();
+
+    // Waits for the rest of intervalMs since begin() (calls begin() itself
+    // if nobody did), takes the second sample and returns the deltas
+    vector<DiskActivityStats> sample(int intervalMs);
+
+    // /proc/diskstats delta between two snapshots; devices missing from
+    // either side are skipped. Exposed for the Linux backend and fixtures.
+    static vector<DiskActivityStats> diff(string_view before, string_view after, double seconds,
+        const vector<string>& devices);
+
+private:
+    struct Impl;
+    unique_ptr<Impl> impl;
+    chrono::steady_clock::time_point started;
+    bool begun = false;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+/*
+    DiskBenchmark — configurable direct-I/O disk benchmark engine
+
+    Runs a list of tests against a temporary file on one volume, each for a
+    fixed duration, with the page cache bypassed:
+
+        SEQ1M Q8T1   sequential 1 MiB, queue depth 8
+        RND4K Q1T1   random 4 KiB, queue depth 1   (latency bound)
+        RND4K Q32T1  random 4 KiB, queue depth 32  (parallelism bound)
+        MIX4K Q32T1  random 4 KiB, 70% read / 30% write
+
+    Every test reports MB/s, IOPS and p50/p99 completion latency.
+
+    I/O engines:
+    - Windows: overlapped ReadFile/WriteFile with FILE_FLAG_NO_BUFFERING |
+      FILE_FLAG_WRITE_THROUGH, up to `queueDepth` requests in flight
+    - Linux:   O_DIRECT through io_uring (IoRing) when built with
+      BINARYFETCH_IO_URING and the kernel allows it, otherwise pread/pwrite
+      where queue depth is emulated with one synchronous worker per slot
+      (the way fio's psync engine scales)
+
+    The test file is filled with incompressible data before the first test
+    and deleted afterwards; preparation time is not part of any result.
+*/
+
+struct DiskBenchTest {
+    string name;            // e.g. "SEQ1M Q8T1"
+    size_t blockSize;       // bytes per request
+    int queueDepth;         // requests in flight per thread
+    bool random;            // random offsets (block aligned) vs sequential
+    int readPercent;        // 100 = read only, 0 = write only, in between = mixed
+};
+
+struct DiskBenchResult {
+    string name;
+    int readPercent = 100;
+    bool random = false;
+    bool ok = false;
+    double mbps = 0.0;      // decimal MB/s (10^6 bytes), as labelled
+    double iops = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    uint64_t ops = 0;
+};
+
+struct DiskBenchConfig {
+    vector<DiskBenchTest> tests;
+    int durationMs = 1000;      // per test
+    int threads = 1;            // workers per test, each with its own queue
+    uint64_t fileSizeMB = 256;  // larger than any controller cache you care about
+};
+
+class DiskBenchmark {
+public:
+    // The four CrystalDiskMark-style patterns above (read + write for the pure ones)
+    static vector<DiskBenchTest> standardTests();
+
+    // What the storage section runs by default: SEQ1M Q8 read + write, short and small
+    static DiskBenchConfig quickConfig();
+
+    // Runs every test in `directory`; results keep the order of config.tests.
+    // Returns an empty vector when the test file can't be created there.
+    static vector<DiskBenchResult> run(const string& directory, const DiskBenchConfig& config);
+
+    // "overlapped", "io_uring" or "psync" (what run() will actually use)
+    static string engineName();
+};
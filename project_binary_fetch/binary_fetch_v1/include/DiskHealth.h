@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+using namespace std;
+
+/*
+    DiskHealth — identity, SMART / health log and thermal telemetry per physical disk
+
+    The raw pages go through Probe (keys "nvme-log:<disk>" / "ata-smart:<disk>"),
+    so a --record snapshot doubles as a fixture for the parsers, which are
+    pure functions over those bytes:
+
+        NVMe: SMART / Health Information log page (02h, 512 bytes)
+        ATA:  SMART READ DATA (B0h / D0h, 512 bytes, 30 attribute slots)
+
+    Reading them:
+
+        Windows: STORAGE_DEVICE_DESCRIPTOR for model / serial / firmware;
+                 IOCTL_STORAGE_QUERY_PROPERTY with the NVMe protocol-specific
+                 log page query, SMART_RCV_DRIVE_DATA for ATA (needs admin)
+        Linux:   sysfs for model / serial / firmware; NVME_IOCTL_ADMIN_CMD
+                 Get Log Page and SG_IO ATA PASS-THROUGH(16) (both need
+                 root). Without root the temperature still comes from the
+                 hwmon node (nvme, drivetemp).
+
+    Thermal throttling on NVMe is reported by the controller itself: the
+    thermal management transition counters (TMT1 = light, TMT2 = heavy
+    throttling) and the time spent in each. ATA has no equivalent, so
+    throttle_events stays -1 there.
+*/
+
+struct DiskHealthData {
+    bool valid = false;             // a health page was read and parsed
+    string protocol;                // "NVMe", "ATA" ("" = unknown bus)
+
+    // Identity
+    string model;
+    string serial;
+    string firmware;
+
+    // Health
+    int temperature_c = -1;         // composite (NVMe) / attribute 194 or 190 (ATA); -1 = unknown
+    int percentage_used = -1;       // endurance used; NVMe may exceed 100; -1 = not reported
+    int available_spare = -1;       // % (NVMe only)
+    unsigned int critical_warning = 0;  // NVMe bitfield (bit 1 = temperature threshold)
+    uint64_t media_errors = 0;      // NVMe media & data integrity errors / ATA reported uncorrectable
+    uint64_t power_on_hours = 0;
+    uint64_t data_written_bytes = 0;    // NVMe only (0 = not reported)
+
+    // Thermal throttling (NVMe only)
+    int64_t throttle_events = -1;   // TMT1 + TMT2 transitions; -1 = not reported
+    uint64_t throttle_seconds = 0;  // time spent in TMT1 + TMT2
+    uint32_t warning_temp_minutes = 0;  // time above the warning composite temperature
+    uint32_t critical_temp_minutes = 0;
+
+    bool overheating() const { return (critical_warning & 0x02) != 0; }
+};
+
+class DiskHealth {
+public:
+    // Pure functions over raw pages: fill the health fields of out (identity is
+    // left alone) and return false on truncated / empty input
+    static bool parseNvmeHealthLog(const unsigned char* page, size_t size, DiskHealthData& out);
+    static bool parseAtaSmartData(const unsigned char* data, size_t size, DiskHealthData& out);
+
+    // Windows: "\\.\PhysicalDrive<N>"   Linux: block device name ("nvme0n1", "sda")
+    // readSmart = false reads the identity only (no log page, no spin-up)
+    static DiskHealthData read(const string& disk, bool readSmart = true);
+};
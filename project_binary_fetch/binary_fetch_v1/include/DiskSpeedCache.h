@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include "DiskBenchmark.h"
+using namespace std;
+
+/*
+    DiskSpeedCache — benchmark results remembered per device
+
+    Benchmarking writes a temp file to every volume and takes seconds per
+    disk, so results are stored in a small JSON file and reused until they
+    are older than the TTL:
+
+        Windows: %LOCALAPPDATA%\BinaryFetch\DiskSpeedCache.json
+        Linux:   $XDG_CACHE_HOME/binaryfetch/disk_speed_cache.json
+                 (~/.cache/binaryfetch/... when XDG_CACHE_HOME is unset)
+
+    Entries are keyed by device identity (model, serial, firmware) plus the
+    file system UUID, so a swapped drive, a firmware update or a reformat
+    all miss the cache. Each test is stored separately, keyed by its name
+    and everything that shapes the number (block size, queue depth, pattern,
+    read mix, duration, threads, file size): turning on the full benchmark
+    later re-runs only the tests that aren't cached yet, and changing a
+    parameter misses instead of showing a figure measured another way.
+
+    Volumes without any stable identity (no serial and no UUID) are never
+    cached. lookup/store are thread-safe (the storage prober is parallel).
+*/
+
+struct DiskIdentity {
+    string model;
+    string serial;
+    string firmware;
+    string fsUuid;
+
+    bool usable() const { return !serial.empty() || !fsUuid.empty(); }
+    string key() const { return model + "|" + serial + "|" + firmware + "|" + fsUuid; }
+};
+
+class DiskSpeedCache {
+public:
+    explicit DiskSpeedCache(const string& path = defaultPath());
+
+    // Missing or unreadable file = empty cache
+    void load();
+    // Writes only when something was stored since load()
+    bool save();
+
+    // One result per test in config.tests, in test order: the cached one when
+    // it is younger than ttlSeconds, otherwise a placeholder (ok = false) whose
+    // index is listed in `missing`. ageSeconds = age of the oldest hit.
+    // Returns the number of hits.
+    size_t lookup(const DiskIdentity& id, const DiskBenchConfig& config, int64_t ttlSeconds,
+        vector<DiskBenchResult>& results, vector<size_t>& missing, int64_t& ageSeconds);
+
+    // Stores the successful results (results[i] belongs to config.tests[i]),
+    // stamped with the current time
+    void store(const DiskIdentity& id, const DiskBenchConfig& config, const vector<DiskBenchResult>& results);
+
+    // Puts results measured for the `missing` tests of a lookup() back into
+    // its `results`, matched by test (name, read share, random) rather than
+    // position; tests left without a measurement keep their placeholder.
+    // Returns the number merged.
+    static size_t merge(const DiskBenchConfig& config, const vector<size_t>& missing,
+        const vector<DiskBenchResult>& measured, vector<DiskBenchResult>& results);
+
+    // Cache key of one test under `config`
+    static string testKey(const DiskBenchTest& test, const DiskBenchConfig& config);
+
+    static string defaultPath();
+
+    // "12s", "5m", "3h", "2d"
+    static string formatAge(int64_t seconds);
+
+private:
+    struct Entry {
+        DiskBenchResult result;
+        int64_t measuredAt = 0;     // unix seconds
+    };
+
+    string path;
+    map<string, map<string, Entry>> entries;    // identity key -> testKey -> result
+    bool dirty = false;
+    mutex lock;
+};
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include "EDIDParser.h"
 using namespace std;
 class DisplayInfo {
 public:
@@ -29,6 +30,17 @@ public:
         // Extra
         string aspect_ratio;     // e.g., "16:9"
         string native_resolution; // e.g., "3840x2160"
+
+        // Panel capabilities (from EDID base + CTA-861 / DisplayID extension blocks)
+        int max_refresh_rate = 0;   // highest advertised refresh, 0 if unknown
+        int vrr_min = 0;            // variable refresh range, 0 if not advertised
+        int vrr_max = 0;
+        int range_min = 0;          // 0xFD vertical range when it isn't a VRR range
+        int range_max = 0;
+        bool hdr_supported = false;
+        string hdr_formats;         // e.g. "HDR10, HLG"
+        string serial;              // panel serial (string descriptor or numeric)
+        string manufacture_date;    // e.g. "Week 12, 2021"
     };
 
     DisplayInfo();
@@ -52,13 +64,6 @@ private:
     bool isNvidiaPresent();
     bool isAMDPresent();
 
-    struct EDIDInfo {
-        string friendlyName;
-        int nativeWidth;
-        int nativeHeight;
-        bool valid;
-    };
-
-    static EDIDInfo parseEDID(const unsigned char* edid, size_t size);
-    string getFriendlyNameFromEDID(const wstring& deviceName);
+    // Picks the EDID blob that belongs to this DXGI output (see EDIDParser)
+    EDIDData getEDIDForDevice(const wstring& deviceName, const vector<EDIDBlob>& blobs);
 };
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// One decoded timing (base block DTD, CTA-861 DTD or DisplayID Type I/VII)
+struct EDIDTiming {
+    int width = 0;
+    int height = 0;
+    double refresh_hz = 0.0;
+    bool interlaced = false;
+};
+
+// Everything we pull out of an EDID blob (base block + extension blocks)
+struct EDIDData {
+    bool valid = false;             // header + base block looked sane
+
+    // Identity (base block bytes 8-17 and the 0xFC / 0xFF descriptors)
+    string manufacturer;            // 3-letter PNP ID, e.g. "DEL"
+    int product_code = 0;
+    unsigned int serial_number = 0; // numeric serial from bytes 12-15 (0 = not set)
+    string serial_string;           // 0xFF descriptor (preferred when present)
+    string friendlyName;            // 0xFC descriptor
+    int manufacture_week = 0;       // 0 = unspecified, 255 = model year
+    int manufacture_year = 0;
+    int version = 0;
+    int revision = 0;
+
+    // Preferred (first detailed) timing == native panel mode
+    int nativeWidth = 0;
+    int nativeHeight = 0;
+    double preferred_refresh = 0.0;
+
+    // Every detailed timing we found, in block order
+    vector<EDIDTiming> timings;
+    double max_refresh_rate = 0.0;  // highest refresh across DTDs, VICs and DisplayID timings
+
+    // Variable refresh range (adaptive-sync 0xFD range limits, HDMI Forum VSDB or DisplayID 0x25)
+    int vrr_min = 0;
+    int vrr_max = 0;
+
+    // Vertical range from the 0xFD descriptor, VRR or not (56-76 on a plain 60 Hz panel)
+    int range_min = 0;
+    int range_max = 0;
+
+    // CTA-861 HDR static metadata data block
+    bool hdr_supported = false;
+    bool hdr10 = false;             // SMPTE ST 2084 EOTF
+    bool hlg = false;
+    double hdr_max_luminance = 0.0; // cd/m2, 0 if not advertised
+
+    int extension_blocks = 0;
+    bool has_cta = false;
+    bool has_displayid = false;
+
+    // Convenience: serial string if present, otherwise the numeric serial
+    string serial() const;
+};
+
+// A raw EDID blob plus the place it came from
+struct EDIDBlob {
+    string source;                  // registry vendor key (Windows) or DRM connector name (Linux)
+    vector<unsigned char> bytes;
+};
+
+class EDIDParser {
+public:
+    // Pure function over raw bytes: safe on truncated / garbage input
+    static EDIDData parse(const unsigned char* edid, size_t size);
+    static EDIDData parse(const vector<unsigned char>& edid) { return parse(edid.data(), edid.size()); }
+
+    // Windows: HKLM\SYSTEM\CurrentControlSet\Enum\DISPLAY\<vendor>\<instance>\Device Parameters\EDID
+    // Linux:   <root>/*/edid (root defaults to /sys/class/drm, override for fixtures)
+    static vector<EDIDBlob> readAll(const string& root = "");
+
+    // Pick the best blob for a monitor: first valid blob whose source starts with
+    // sourcePrefix (case-insensitive), falling back to the first valid blob.
+    static EDIDData findBest(const vector<EDIDBlob>& blobs, const string& sourcePrefix, bool needName = false);
+
+    // The blob for one monitor, by its hardware vendor ID: a named blob from that
+    // vendor key, then any valid one from it, and only then the global fallback
+    // (named first), so another monitor's name can't win over this one's own EDID.
+    static EDIDData forMonitor(const vector<EDIDBlob>& blobs, const string& vendor);
+
+private:
+    static bool parseDetailedTiming(const unsigned char* d, EDIDTiming& out);
+    static void parseDisplayDescriptor(const unsigned char* d, EDIDData& info);
+    static void parseCTABlock(const unsigned char* block, EDIDData& info);
+    static void parseDisplayIDBlock(const unsigned char* block, EDIDData& info);
+    static double vicRefreshRate(int vic);
+    static void noteRefresh(EDIDData& info, double hz);
+};
@@ -16,11 +16,18 @@ struct PowerStatus {
     int batteryPercent;     // Battery charge percentage (0-100)
     bool isACOnline;        // Whether AC power is connected
     bool isCharging;        // Whether battery is currently charging
+    int minutesRemaining = -1;  // Estimated runtime on battery (-1 = unknown)
 };
 
 class ExtraInfo {
 public:
+    // root: prefix for the Linux sysfs/procfs reads (empty = live system, or a fixture tree)
+    explicit ExtraInfo(const string& root = "");
+
     vector<AudioDevice> get_output_devices();  // Get all output devices (speakers/headphones)
     vector<AudioDevice> get_input_devices();   // Get all input devices (microphones)
     PowerStatus get_power_status();            // Get power status information
+
+private:
+    string root;
 };
\ No newline at end of file
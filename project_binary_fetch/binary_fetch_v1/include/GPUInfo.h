@@ -25,6 +25,9 @@ struct gpu_data
 class GPUInfo
 {
 public:
+    // Register the WMI fields below before any collector reads one
+    static void plan_wmi();
+
     // Get all GPU information
     static vector<gpu_data> get_all_gpu_info();
 
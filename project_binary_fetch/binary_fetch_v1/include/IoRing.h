@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+using namespace std;
+
+/*
+    IoRing — minimal io_uring submission/completion queue (Linux)
+
+    Talks to the kernel through io_uring_setup / io_uring_enter and the
+    mmap'ed rings directly, so the batched paths need no liburing. Only
+    what PseudoFileReader and DiskBenchmark use: plain reads and writes
+    at an offset, tagged so completions can be matched up.
+
+        IoRing ring(64);
+        if (ring.ready()) {
+            ring.read(fd, buf, len, 0, tag);    // queued, not yet submitted
+            ring.submit(1);                     // submit all, wait for one
+            uint64_t t; int res;
+            while (ring.peek(t, res)) ...       // res = bytes or -errno
+        }
+
+    Only compiled in with BINARYFETCH_IO_URING (tests/CMakeLists.txt turns
+    it on when <linux/io_uring.h> exists). Elsewhere, or when the kernel
+    refuses (too old, seccomp, kernel.io_uring_disabled), ready() is false
+    and callers keep their synchronous path. Not thread-safe: one ring per
+    thread.
+*/
+class IoRing {
+public:
+    explicit IoRing(unsigned entries);
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    bool ready() const;
+    // Submission queue size the kernel granted (>= entries, power of two)
+    unsigned depth() const;
+
+    // Queue one request; false when the submission queue is full
+    bool read(int fd, void* buf, unsigned len, uint64_t offset, uint64_t tag);
+    bool write(int fd, const void* buf, unsigned len, uint64_t offset, uint64_t tag);
+
+    // Hands every queued request to the kernel and waits until at least
+    // `waitFor` completions are available; requests submitted, or -errno
+    int submit(unsigned waitFor = 0);
+
+    // Next completion: its tag and result (bytes transferred or -errno).
+    // peek() returns false when none is ready, wait() blocks for one.
+    bool peek(uint64_t& tag, int& result);
+    bool wait(uint64_t& tag, int& result);
+
+private:
+    struct Rings;               // mmap'ed kernel state, only defined with BINARYFETCH_IO_URING
+    unique_ptr<Rings> rings;
+
+    bool queue(uint8_t opcode, int fd, uint64_t addr, unsigned len, uint64_t offset, uint64_t tag);
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+/*
+    MemoryBenchmark — load latency per cache level and STREAM bandwidth
+
+    MemoryInfo reports what the DIMMs are rated for; this measures what the
+    cores actually get, which is where a single-channel population or an
+    XMP profile that didn't apply shows up.
+
+    Latency: randomized pointer chasing. The working set is cut into 64-byte
+    lines linked into one random cycle (Sattolo), so every load depends on
+    the previous one and the prefetchers can't guess the next address. One
+    working set per level, sized from the cache instances CPUTopology (and
+    so CPUInfo) reports:
+
+        L1    half of the L1 data cache
+        L2    geometric mean of the L1 and L2 sizes
+        L3    geometric mean of the L2 and L3 sizes
+        DRAM  4x the L3, at least 64 MiB and at most 1 GiB
+
+    A level whose cache wasn't detected is skipped. The chase runs on a
+    worker pinned to the first processor in pinOrder() (a P-core on hybrid
+    parts). DRAM latency includes TLB misses, as random access in real code
+    does.
+
+    Bandwidth: STREAM Copy / Scale / Add / Triad over three double arrays,
+    each 4x the total last-level cache (32..256 MiB) unless configured.
+    Every kernel repeats for the configured duration (at least 3 times)
+    and the best pass counts, in decimal MB/s like STREAM. It runs once on
+    one thread and once on one pinned thread per physical core, each thread
+    first-touching its own slice so NUMA hosts fill local memory. Kernels
+    are AVX-512 or AVX2 when CPUTopology says the OS supports them, plain
+    loops otherwise.
+*/
+
+struct MemLatencyResult {
+    string level;               // "L1", "L2", "L3", "DRAM"
+    uint64_t workingSet = 0;    // bytes chased
+    double ns = 0.0;            // per dependent load
+};
+
+struct MemBandwidthResult {
+    string kernel;              // "Copy", "Scale", "Add", "Triad"
+    int threads = 1;
+    double mbps = 0.0;          // 10^6 bytes per second
+};
+
+struct MemBenchConfig {
+    int durationMs = 300;       // per latency level and per bandwidth kernel
+    uint64_t arrayMB = 0;       // per STREAM array; 0 = derive from the L3
+    bool allCores = true;       // run the bandwidth kernels on every core as well
+};
+
+struct MemBenchReport {
+    vector<MemLatencyResult> latency;
+    vector<MemBandwidthResult> bandwidth;   // single thread first, then all cores
+    uint64_t arrayBytes = 0;
+    string kernels;             // "AVX-512", "AVX2" or "baseline"
+};
+
+class MemoryBenchmark {
+public:
+    static MemBenchReport run(const MemBenchConfig& config);
+
+    // (level, bytes) the latency test will chase, from the detected caches
+    static vector<pair<string, uint64_t>> workingSets();
+
+    // Pointer chase over `bytes` on the calling thread, ns per load
+    static double chase(uint64_t bytes, int durationMs);
+
+    // STREAM kernels on `threads` workers pinned to cpus[i] (unpinned past
+    // the end of cpus); empty if the arrays can't be allocated
+    static vector<MemBandwidthResult> stream(uint64_t arrayBytes, int threads, const vector<int>& cpus, int durationMs);
+
+    // Kernel set stream() uses on this machine
+    static string kernelName();
+};
@@ -22,6 +22,8 @@ private:
 public:
     MemoryInfo();
 
+    static void planWmi();       // registers the WMI fields below before any get()
+
     int getTotal() const;
     int getFree() const;
     int getUsedPercentage() const;
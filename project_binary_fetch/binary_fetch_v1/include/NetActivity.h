@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+/*
+    NetActivity — live per-interface traffic counters
+
+    The speed tests in NetworkInfo generate traffic to find out what the
+    link *could* do; this only reads the kernel's interface counters twice
+    and reports what the box is actually doing:
+
+        Linux:   /proc/net/dev, read through PseudoFileReader; interfaces
+                 from /sys/class/net, "lo" and operstate "down" skipped
+        Windows: GetIfTable2, loopback, filter and non-up interfaces
+                 skipped; rendered into /proc/net/dev layout (one line per
+                 interface alias) so both platforms share diff()
+
+    Usage follows the shared sampling window like DiskActivity: begin() as
+    early as possible, then sample(intervalMs). main takes that second read
+    on its own thread and holds NetworkInfo's speed tests until it is done
+    (hold_transfers), so their traffic never lands in the window.
+
+    Rates are over the elapsed time between the two reads; errors and drops
+    are the totals since the interface came up plus what was added inside
+    the window.
+*/
+
+struct NetActivityStats {
+    string name;                    // "eth0", "wlp2s0" / "Ethernet", "Wi-Fi"
+    double rxBytesPerSec = 0.0;
+    double txBytesPerSec = 0.0;
+    double rxPacketsPerSec = 0.0;
+    double txPacketsPerSec = 0.0;
+    uint64_t errors = 0;            // rx + tx, since the interface came up
+    uint64_t drops = 0;
+    uint64_t newErrors = 0;         // rx + tx, during the window
+    uint64_t newDrops = 0;
+};
+
+class NetActivity {
+public:
+    NetActivity();
+    ~NetActivity();
+
+    // Takes the baseline sample
+    void begin();
+
+    // Waits for the rest of intervalMs since begin() (calls begin() itself
+    // if nobody did), takes the second sample and returns the deltas
+    vector<NetActivityStats> sample(int intervalMs);
+
+    // /proc/net/dev delta between two snapshots; an empty interface list
+    // means every interface present on both sides. Exposed for fixtures.
+    static vector<NetActivityStats> diff(string_view before, string_view after, double seconds,
+        const vector<string>& interfaces);
+
+private:
+    struct Impl;
+    unique_ptr<Impl> impl;
+    chrono::steady_clock::time_point started;
+    bool begun = false;
+};
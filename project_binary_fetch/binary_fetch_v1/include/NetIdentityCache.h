@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <functional>
+using namespace std;
+
+/*
+    NetIdentityCache — network identity facts remembered per network
+
+    The public IP costs an outbound HTTP request and the SSID a WLAN API
+    session on every run, yet both only change when the machine moves to
+    another network. Facts are stored per network fingerprint:
+
+        default route   interface + next hop (lowest metric)
+        gateway MAC     from the neighbour table (/proc/net/arp, GetIpNetEntry2)
+        addresses       on the default-route interface: IPv4 as-is, IPv6 as
+                        the /64 prefix (privacy addresses rotate inside it),
+                        link-local skipped
+        link changes    the kernel's per-interface counter: carrier_changes
+                        on Linux, the interface's last-change tick on Windows
+
+    Roaming, re-plugging or DHCP handing out another address changes the
+    fingerprint, so the next run misses instead of waiting for the TTL;
+    coming back to a known network finds its facts again. Without a default
+    route there is nothing to key on and nothing is cached.
+
+    The fingerprint is taken once, in begin(): nothing watches for route or
+    link changes while the process runs. A network switch in the middle of
+    a run is only noticed by the next run, and until then get() keeps
+    answering from the network the run started on.
+
+        Windows: %LOCALAPPDATA%\BinaryFetch\NetIdentityCache.json
+        Linux:   $XDG_CACHE_HOME/binaryfetch/net_identity_cache.json
+
+    Process-wide like WMIQuery: begin() once early, save() at exit. Until
+    begin() (or in --record / --replay runs, which must see every probe)
+    get() simply calls fetch(). Thread-safe.
+*/
+
+class NetIdentityCache {
+public:
+    // save() keeps at most this many networks and drops the ones nobody has
+    // been on for FORGET_AFTER_SECONDS
+    static const size_t MAX_NETWORKS = 32;
+    static const int64_t FORGET_AFTER_SECONDS = 30LL * 86400;
+
+    // Loads the cache and fingerprints the current network
+    static void begin(int64_t ttlSeconds, const string& path = defaultPath());
+    // Same for a fingerprint taken elsewhere (fixtures); runs in any Probe mode
+    static void begin(int64_t ttlSeconds, const string& path, const string& fingerprint);
+
+    // Writes only when something was stored since begin()
+    static bool save();
+
+    // Fact cached for the current network and younger than the TTL
+    static bool lookup(const string& fact, string& value);
+    static void store(const string& fact, const string& value);
+
+    // Cached value, otherwise fetch() (and store what it returns)
+    static string get(const string& fact, const function<string()>& fetch);
+
+    // "" = no default route (or begin() not called)
+    static string fingerprint();
+
+    // Linux fingerprint parts from /proc text: the lowest-metric default
+    // route's interface and gateway (false without one), and that gateway's
+    // MAC on that interface ("" when the neighbour table doesn't have it)
+    static bool parseDefaultRoute(const string& routeTable, string& iface, string& gateway);
+    static string parseGatewayMac(const string& arpTable, const string& gateway, const string& iface);
+
+    static string defaultPath();
+};
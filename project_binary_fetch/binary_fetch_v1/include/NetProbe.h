@@ -0,0 +1,257 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+using namespace std;
+
+/*
+    NetProbe — every network probe in one event loop
+
+    The public IP lookup and the download / upload speed tests used to open
+    their own blocking WinHttp sessions one after another, against hosts
+    baked into the code. NetProbe::run() takes all of them at once and
+    drives them on non-blocking sockets from a single loop:
+
+        Linux:   epoll
+        Windows: WSAPoll (the closest readiness API Winsock has)
+
+    Host names are resolved first, all in parallel on detached workers (the
+    resolver call itself blocks); then every request connects, sends and
+    receives concurrently. One deadline covers the whole batch, so the
+    probes cost max(probe), not sum(probe), and a dead endpoint can't hold
+    up the others. Requests still running at the deadline come back with
+    timedOut set and whatever they had transferred so far.
+
+    throughput() is the speed test proper. A single short transfer mostly
+    measures the handshake and TCP slow start, so it keeps N parallel
+    streams busy (each one re-requests when its transfer ends), samples
+    the aggregate rate every sampleMs, discards everything until the rate
+    settles (last windowSamples samples within tolerance of each other,
+    after at least warmupMs) and only then measures for measureMs. If the
+    rate never settles within maxDurationMs, the last window is reported
+    with steady = false. maxBytes stops it early once the streams together
+    have moved that much (the window measured so far is reported, capped
+    set), so a fast link isn't saturated for the whole time budget. Upload goodput counts bytes handed to the socket,
+    so the steady-state window is what keeps send buffering out of it.
+
+    latency() measures round trips to a list of targets, all at once on the
+    same kind of loop, one probe per target every intervalMs:
+
+        TCP: time from connect() to the handshake completing (SYN -> SYN/ACK),
+             a fresh connection per sample; refused counts as lost
+        UDP: a 16-byte datagram (magic, sequence, nonce) and its echo; replies
+             that arrive after timeoutMs count as lost
+
+    The raw samples come back in send order; summarize() folds them into an
+    HDR-style histogram for min / p50 / p99 / max, plus jitter (the mean
+    difference between consecutive round trips, RFC 3550's D).
+
+    dns() times name resolution itself. getaddrinfo blocks, hides which
+    server answered and retries on its own schedule, so queries are built
+    and parsed here (RFC 1035, A records, recursion desired) and sent over
+    UDP straight to each resolver: one query per name, every resolver and
+    name at once, one deadline for the lot. The resolvers are the system's
+    (/etc/resolv.conf, the adapters' DNS servers on Windows) unless a list
+    is given; they must be numeric addresses, nothing is resolved to find
+    them. An ICMP port unreachable fails the resolver at once instead of
+    letting its queries run into the deadline.
+
+    Plain HTTP/1.0 only (no TLS, no proxy): enough for ipify-style "what's
+    my IP" services, speed-test endpoints and an internal mirror. Redirects
+    to http:// URLs are followed, up to MAX_REDIRECTS hops inside the same
+    deadline (throughput() restarts on the new URL; 303 turns a POST into a
+    GET). A redirect to https:// fails with an error naming it, so every
+    endpoint has to answer over plain HTTP in the end. NetProbeServer is a
+    stand-in that serves the same endpoints, for tests and air-gapped sites:
+
+        GET  /ip               the caller's address as text/plain
+        GET  /__down?bytes=N   N bytes of filler (capped at MAX_DOWNLOAD_BYTES, 1 GiB)
+        POST /__up             reads and discards the body
+        *    /__redirect?to=U  302 to U, taken verbatim; to itself without to=
+                               (for testing clients)
+
+    and echoes UDP datagrams on the same port number. Datagrams that are DNS
+    queries get a stub answer instead (A 127.0.0.1 / AAAA ::1, NXDOMAIN for
+    names under .invalid), so it stands in for a resolver too.
+*/
+
+struct NetRequest {
+    string url;                     // http://host[:port]/path
+    string method = "GET";          // "GET" or "POST"
+    uint64_t uploadBytes = 0;       // POST body size (generated filler)
+    size_t captureLimit = 4096;     // response body bytes kept in NetResult::body
+};
+
+struct NetResult {
+    bool ok = false;                // complete response with a 2xx status
+    bool timedOut = false;          // still running at the deadline
+    string error;                   // "" on success
+    int status = 0;                 // HTTP status code (0 = no response)
+    string body;                    // first captureLimit bytes of the response body
+    uint64_t bytesSent = 0;         // request body bytes (headers not counted)
+    uint64_t bytesReceived = 0;     // response body bytes
+    int redirects = 0;              // hops followed; the other fields are the last hop's
+    double resolveMs = 0.0;
+    double connectMs = 0.0;         // TCP handshake
+    double firstByteMs = 0.0;       // request start -> response headers (covers the upload for POST)
+    double transferMs = 0.0;        // request start -> last byte (covers the download for GET)
+};
+
+struct ThroughputConfig {
+    string url;                     // download: GET it; upload: POST to it
+    bool upload = false;
+    uint64_t uploadBytes = 100000000;   // body size of each upload request
+    int streams = 4;
+    int sampleMs = 100;             // aggregate rate sampling interval
+    int warmupMs = 500;             // always discarded
+    int windowSamples = 5;          // steady = this many consecutive samples ...
+    double tolerance = 0.10;        // ... within (max - min) / mean of each other
+    int measureMs = 1000;           // measured once steady
+    int maxDurationMs = 5000;       // hard stop, connection setup included
+    uint64_t maxBytes = 0;          // stop once all streams together moved this much (0 = no cap)
+};
+
+struct ThroughputResult {
+    bool ok = false;                // data moved during the measurement window
+    bool steady = false;            // the rate settled before maxDurationMs
+    string error;
+    int streamsConnected = 0;
+    double goodputMbps = 0.0;       // aggregate over the measurement window
+    double warmupMs = 0.0;          // discarded lead-in (start -> steady state)
+    double measuredMs = 0.0;
+    vector<double> streamMbps;      // per stream over the measurement window
+    double streamMinMbps = 0.0;
+    double streamMaxMbps = 0.0;
+    double streamStddevMbps = 0.0;
+    uint64_t totalBytes = 0;        // moved by all streams, warm-up included
+    bool capped = false;            // stopped by maxBytes
+};
+
+struct LatencyTarget {
+    string name;                    // label ("gateway", "resolver")
+    string host;                    // name or address; "gateway" = the default gateway
+    int port = 0;
+    bool udp = false;               // false: TCP connect time; true: UDP echo round trip
+};
+
+struct LatencySamples {
+    string endpoint;                // "tcp 192.168.1.1:80" (as actually probed)
+    string error;                   // "" unless the target couldn't be probed at all
+    vector<double> rttMs;           // in send order; -1 = lost
+};
+
+struct LatencyStats {
+    int sent = 0;
+    int received = 0;
+    double minMs = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double jitterMs = 0.0;
+    double lossPercent() const { return sent ? 100.0 * (sent - received) / sent : 0.0; }
+};
+
+// HDR-style histogram: values (in microseconds) are bucketed per power of two,
+// each power split into 128 linear sub-buckets, so every value keeps better
+// than 1% precision from 1 us to hours with a few KiB of counters
+class LatencyHistogram {
+public:
+    void record(double ms);
+    uint64_t count() const { return total; }
+    double lowestMs() const;
+    double highestMs() const;
+    double percentileMs(double percentile) const;   // 0 - 100
+
+private:
+    vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t lowest = UINT64_MAX;   // exact extremes, in us
+    uint64_t highest = 0;
+};
+
+struct DnsQueryResult {
+    string name;
+    double ms = -1.0;               // -1 = no reply before the deadline
+    int rcode = -1;                 // 0 NOERROR, 2 SERVFAIL, 3 NXDOMAIN, 5 REFUSED; -2 = name not encodable
+    int answers = 0;                // address records in the answer section
+    bool truncated = false;         // TC set (the reply still counts, no TCP retry)
+};
+
+struct DnsResolverResult {
+    string resolver;                // "1.1.1.1:53"
+    string error;                   // "" unless the resolver couldn't be queried at all
+    vector<DnsQueryResult> queries; // one per name, in order
+};
+
+// What dns() reads back out of a packet (and the stub responder out of a query)
+struct DnsMessage {
+    uint16_t id = 0;
+    bool response = false;          // QR
+    bool truncated = false;         // TC
+    int rcode = 0;
+    string name;                    // first question, lower case, no trailing dot
+    uint16_t type = 0;
+    int answers = 0;                // A / AAAA records
+    size_t questionEnd = 0;         // offset just past the first question
+};
+
+class NetProbe {
+public:
+    static const int MAX_REDIRECTS = 5;
+
+    // Runs every request concurrently; results come back in request order
+    static vector<NetResult> run(const vector<NetRequest>& requests, int timeoutMs);
+
+    // Multi-stream steady-state throughput test (one direction)
+    static ThroughputResult throughput(const ThroughputConfig& config);
+
+    // samples probes per target, intervalMs apart; all targets run concurrently
+    static vector<LatencySamples> latency(const vector<LatencyTarget>& targets, int samples, int intervalMs, int timeoutMs);
+
+    // Lost samples (< 0) count towards sent only
+    static LatencyStats summarize(const vector<double>& rttMs);
+
+    // One A query per name to every resolver, all concurrently under timeoutMs
+    static vector<DnsResolverResult> dns(const vector<string>& resolvers, const vector<string>& names, int timeoutMs);
+
+    // Numeric resolver addresses the system is configured with
+    static vector<string> systemResolvers();
+
+    // Wire format: "" if the name can't be encoded (empty or oversized labels)
+    static string dnsQuery(uint16_t id, const string& name, uint16_t type = 1);
+    static bool parseDns(const string& packet, DnsMessage& message);
+
+    // IPv4 next hop of the default route ("" = none)
+    static string defaultGateway();
+
+    // Throughput in megabits per second (0 when nothing was moved)
+    static double megabitsPerSecond(uint64_t bytes, double milliseconds);
+
+private:
+    // One pass of run() / throughput(); the redirect targets come back for the next hop
+    static vector<NetResult> runBatch(const vector<NetRequest>& requests, int timeoutMs, vector<string>& redirects);
+    static ThroughputResult measure(const ThroughputConfig& config, string& redirect);
+};
+
+class NetProbeServer {
+public:
+    NetProbeServer();
+    ~NetProbeServer();
+
+    // Largest /__down body; bigger requests get this many bytes
+    static const uint64_t MAX_DOWNLOAD_BYTES;
+
+    // Binds and starts serving on a background thread; port 0 = any free port.
+    // Loopback unless told otherwise: every endpoint is unauthenticated
+    bool start(const string& bindAddress = "127.0.0.1", int port = 0);
+    void stop();
+
+    int port() const;
+    string baseUrl() const;         // "http://127.0.0.1:<port>"
+
+private:
+    struct Impl;
+    unique_ptr<Impl> impl;
+};
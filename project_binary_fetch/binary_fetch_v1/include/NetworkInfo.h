@@ -1,7 +1,53 @@
 #pragma once
 #include <string>
+#include <future>
+#include <vector>
+#include "NetProbe.h"
 using namespace std;
 
+// Where the network probes go (defaults = the public services used so far).
+// Plain HTTP: http:// redirects are followed, one to https:// is an error.
+struct NetProbeEndpoints {
+	string public_ip_url = "http://api.ipify.org/";
+	string download_url = "http://speed.cloudflare.com/__down?bytes=10000000";
+	string upload_url = "http://speed.cloudflare.com/__up";
+	uint64_t upload_bytes = 10000000;   // per upload request (streams re-request)
+	int timeout_ms = 5000;      // public IP lookup
+	int streams = 4;            // parallel streams per speed test
+	int warmup_ms = 500;        // discarded before looking for a steady rate
+	int max_test_ms = 4000;     // cap per speed test direction
+	uint64_t max_test_bytes = 20000000; // cap per direction, all streams together (0 = none)
+};
+
+// Where the latency probes go and how many samples each takes
+struct LatencyProbeConfig {
+	vector<LatencyTarget> targets;
+	int samples = 20;
+	int interval_ms = 50;
+	int timeout_ms = 1000;      // per sample
+};
+
+struct LatencyReport {
+	string name;
+	string endpoint;            // "tcp 192.168.1.1:80"
+	string error;               // "" = probed (samples may still be lost)
+	LatencyStats stats;
+};
+
+// Which resolvers the DNS probe asks, and for what
+struct DnsProbeConfig {
+	vector<string> resolvers;   // numeric, optional ":port"; empty = the system's
+	vector<string> names = { "example.com", "wikipedia.org", "github.com" };
+	int timeout_ms = 2000;      // shared by every query
+};
+
+struct DnsReport {
+	string resolver;            // "1.1.1.1:53"
+	string error;               // "" = queried (queries may still time out)
+	vector<DnsQueryResult> queries;
+	LatencyStats stats;         // over the replies; timeouts count as lost
+};
+
 class NetworkInfo {
 public:
 	string get_local_ip();      //returns local IPv4 with subnet mask (e.g., "192.168.0.9/24")
@@ -11,4 +57,47 @@ public:
 	string get_network_upload_speed(); //Rturns connected network's upload speed
 	string get_network_download_speed();//Returns connected network's download speed
 	string get_public_ip();     //Returns public ip (if it's available)
-};  
\ No newline at end of file
+
+	// Starts the public IP / download / upload probes in the background, all at
+	// once (NetProbe); the three getters above wait for them. A getter whose
+	// probe wasn't started here runs it on its own.
+	void begin_probes(const NetProbeEndpoints& endpoints, bool publicIp = true, bool download = true, bool upload = true);
+
+	// Starts the latency probes in the background; call before begin_probes,
+	// whose speed tests wait for them (RTT is measured on an idle link)
+	void begin_latency(const LatencyProbeConfig& config);
+	vector<LatencyReport> get_latency();  // one per target, in config order
+
+	// Starts the DNS probe in the background; like the latency probes, the
+	// speed tests wait for it
+	void begin_dns(const DnsProbeConfig& config);
+	vector<DnsReport> get_dns();          // one per resolver
+
+	// The speed tests wait for this too (e.g. a traffic sampling window that
+	// must not see their transfers); call before begin_probes
+	void hold_transfers(shared_future<void> until);
+
+private:
+	struct ProbeResults {
+		string public_ip = "Unknown";
+		string download = "Unknown";
+		string upload = "Unknown";
+	};
+
+	NetProbeEndpoints probe_endpoints;
+	bool probing_ip = false;
+	bool probing_download = false;
+	bool probing_upload = false;
+	shared_future<ProbeResults> probes;
+	LatencyProbeConfig latency_config;
+	shared_future<vector<LatencyReport>> latency;
+	DnsProbeConfig dns_config;
+	shared_future<vector<DnsReport>> dns;
+	shared_future<void> transfer_gate;
+
+	shared_future<void> idle_link() const;  // done once the latency and DNS probes and the transfer gate are
+	static ProbeResults run_probes(const NetProbeEndpoints& endpoints, bool publicIp, bool download, bool upload, shared_future<void> idle_first);
+	static vector<LatencyReport> run_latency(const LatencyProbeConfig& config);
+	static vector<DnsReport> run_dns(const DnsProbeConfig& config);
+	static string query_network_name();   // WLAN API, "" = not on WiFi
+};
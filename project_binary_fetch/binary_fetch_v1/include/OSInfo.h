@@ -5,6 +5,8 @@ class OSInfo {
 public:
     OSInfo() = default;
 
+    static void plan_wmi();         // registers the WMI fields below before any get()
+
     string GetOSVersion();          // Windows version + build
     string GetOSArchitecture();     // 32-bit or 64-bit
     string GetOSName();             // Home / Pro / Enterprise
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+using namespace std;
+
+/*
+    Probe — record/replay layer for raw collector inputs
+
+    Every raw input a collector reads (a WQL property, a PDH counter value,
+    a procfs/sysfs file, an EDID blob, a DXGI adapter description) can be
+    routed through Probe with a stable key:
+
+        wql:<namespace>:<query>     pdh:<counter path>
+        file:<path>                 dir:<path>
+        edid:blobs                  dxgi:adapter<N>
+
+    Live    -> fetch() runs, nothing is stored (an atomic load and a branch)
+    Record  -> fetch() runs and every result is appended to the snapshot
+    Replay  -> fetch() is never called; values come back from the snapshot
+               in the order they were recorded (so a counter sampled twice
+               replays both samples). Unknown keys return empty values.
+
+    The snapshot is one JSON file (--record <file> / --replay <file>).
+    Values that aren't valid UTF-8 are stored hex-encoded, so raw text
+    replays byte for byte.
+
+    Where the raw inputs are dozens of small Win32 calls per item (DXGI
+    outputs, storage IOCTLs) the collector records its decoded result as one
+    JSON value instead (dxgi:displays, ioctl:storage-type:<root>, ...).
+
+    Collectors that still read the live machine directly call unrouted()
+    first. Replay can't reproduce those, so instead of quietly mixing live
+    values into a recorded run it collects their names; main() prints them
+    and exits non-zero once the output is done.
+*/
+class Probe {
+public:
+    enum class Mode { Live, Record, Replay };
+
+    // Replay loads the snapshot immediately; returns false if it can't be read
+    static bool begin(Mode mode, const string& path);
+    // Record writes the snapshot; no-op in the other modes
+    static bool end();
+
+    static Mode mode();
+    static bool replaying() { return mode() == Mode::Replay; }
+
+    static string text(const string& key, const function<string()>& fetch);
+    static double number(const string& key, const function<double()>& fetch);
+    static vector<unsigned char> bytes(const string& key, const function<vector<unsigned char>()>& fetch);
+    static vector<string> list(const string& key, const function<vector<string>()>& fetch);
+
+    // A live read that doesn't go through Probe (no-op unless replaying)
+    static void unrouted(const string& source);
+    // Sources that read the live machine during this replay, sorted
+    static vector<string> unroutedSources();
+
+    // Convenience wrappers for pseudo-files (whole content / sorted directory entries)
+    static string file(const string& path);
+    static vector<string> dir(const string& path);
+
+    // Hex helpers used to keep binary inputs JSON-safe
+    static string toHex(const vector<unsigned char>& data);
+    static vector<unsigned char> fromHex(const string& hex);
+};
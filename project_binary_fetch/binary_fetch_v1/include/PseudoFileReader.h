@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+using namespace std;
+
+/*
+    PseudoFileReader — batched, fd-reusing reader for procfs / sysfs
+
+    Linux backends read lots of tiny pseudo-files per refresh (per-core
+    cpufreq, hwmon inputs, per-device stats). open/read/close per value costs
+    three syscalls and a heap allocation each time. PseudoFileReader instead:
+
+    - opens every registered path once and keeps the fd across refreshes
+    - re-reads with pread(fd, ..., 0) into one reusable arena
+    - submits the whole batch through io_uring (IoRing) when built with
+      BINARYFETCH_IO_URING, falling back to a pread loop
+    - parses numbers with from_chars (no locale, no allocation)
+
+        PseudoFileReader reader;
+        int temp = reader.add("/sys/class/hwmon/hwmon0/temp1_input");
+        int stat = reader.add("/proc/stat", 4096);
+        reader.refresh();                       // one batch
+        long long milli = reader.number(temp);
+        string_view text = reader.text(stat);   // valid until the next refresh
+
+    A file that outgrows its slot gets a bigger one and is re-read in the
+    same refresh. A failed read closes the fd so the next refresh re-opens
+    it, which covers hot-unplugged devices.
+
+    In --record / --replay runs every read goes through Probe ("file:<path>")
+    so snapshots stay interchangeable with Probe::file. On Windows there are
+    no pseudo-files; reads fall back to a plain open/read and simply fail.
+*/
+class PseudoFileReader {
+public:
+    explicit PseudoFileReader(bool useIoUring = true);
+    ~PseudoFileReader();
+
+    PseudoFileReader(const PseudoFileReader&) = delete;
+    PseudoFileReader& operator=(const PseudoFileReader&) = delete;
+
+    // Registers a path (same path -> same handle); sizeHint is the initial slot size
+    int add(const string& path, size_t sizeHint = 128);
+    size_t size() const { return slots.size(); }
+    const string& path(int handle) const { return slots[handle].path; }
+
+    // Re-reads every registered file / only the given handles; false if any read failed
+    bool refresh();
+    bool refresh(const vector<int>& handles);
+
+    // Results of the last refresh
+    bool ok(int handle) const;
+    string_view text(int handle) const;                          // whole content
+    string_view line(int handle) const;                          // first line, trailing whitespace stripped
+    long long number(int handle, long long fallback = -1) const; // first integer in the file
+
+    // Drops every fd (they are re-opened lazily on the next refresh)
+    void close();
+
+    // True once a batch went through io_uring and the ring is still usable
+    bool batching() const;
+
+    // from_chars helpers shared with callers that split content themselves
+    static bool parseNumber(string_view text, long long& out);
+    // Every whitespace-separated integer token in order (non-numeric tokens are skipped)
+    static size_t parseNumbers(string_view text, vector<long long>& out);
+
+private:
+    struct Slot {
+        string path;
+        int fd = -1;
+        size_t offset = 0;      // into arena
+        size_t capacity = 0;
+        size_t length = 0;
+        bool ok = false;
+    };
+
+    struct Ring;                // io_uring state, created on the first batch
+
+    vector<Slot> slots;
+    vector<char> arena;
+    unique_ptr<Ring> ring;
+    bool useIoUring;
+
+    void grow(int handle, size_t capacity);
+    bool openSlot(Slot& slot);
+    void closeSlot(Slot& slot);
+    void readSync(int handle);
+    void readBatch(const vector<int>& handles);
+    void store(int handle, const string& content);
+};
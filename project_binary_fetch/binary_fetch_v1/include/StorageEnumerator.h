@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+using namespace std;
+
+/*
+    StorageEnumerator — the one place that walks volumes
+
+    StorageInfo (detailed storage) and DiskInfo (compact_disk) used to walk
+    the drive letters separately and call GetDiskFreeSpaceEx per field.
+    Both now read the snapshot taken here: every volume is enumerated and
+    stat'ed once per run, then shared.
+
+        Windows: GetLogicalDrives (with GetLogicalDriveStrings / C:-D: probing
+                 as fallbacks), GetDriveType, GetDiskFreeSpaceEx,
+                 GetVolumeInformation
+        Linux:   /proc/self/mountinfo (block-device and network mounts), statvfs
+
+    Mounts are classified local / remote from the drive type (DRIVE_REMOTE)
+    or the mountinfo file system type and source ("host:/export",
+    "//server/share"). A dead NFS server or a disconnected mapped drive can
+    block a stat call for a minute, so every stat runs on its own detached
+    worker and all of them share one deadline (MountOptions::statTimeoutMs).
+    A volume that misses it is delivered with timed_out set and its worker
+    is abandoned; nothing else waits for it.
+
+    Volumes are streamed to each() in order as their stats come in on the
+    first pass, so a caller can render the cheap fields right away; later
+    calls replay the snapshot. Consumers apply their own filters (kind,
+    size, stat failure). Thread-safe; the snapshot lives until
+    invalidate(). Callbacks must not call back into the enumerator while
+    the first pass is streaming.
+*/
+
+enum class VolumeKind { Fixed, Removable, Remote, Optical, RamDisk, Unknown };
+
+struct VolumeInfo {
+    string root_path;           // "C:\" / "/home"
+    string device;              // "" on Windows, "/dev/nvme0n1p2", "server:/export"
+    VolumeKind kind = VolumeKind::Unknown;
+    bool remote() const { return kind == VolumeKind::Remote; }
+    bool stat_ok = false;       // false = space / file system fields are empty
+    bool timed_out = false;     // stat didn't answer before the deadline (stat_ok is false)
+    uint64_t total_bytes = 0;
+    uint64_t free_bytes = 0;    // free for everyone (not just the caller's quota)
+    string file_system;         // "NTFS", "ext4", ... ("" when unknown)
+};
+
+struct MountOptions {
+    int statTimeoutMs = 2000;   // shared deadline for all stats; <= 0 waits forever
+    bool skipRemote = false;    // leave network mounts out entirely (never stat'ed)
+};
+
+class StorageEnumerator {
+public:
+    // Takes effect on the next enumeration (drops the current snapshot)
+    static void configure(const MountOptions& options);
+
+    // Every volume in drive-letter / mount-table order
+    static vector<VolumeInfo> volumes();
+
+    // Streams volumes in order, stat'ing them on the first pass
+    static void each(const function<void(const VolumeInfo&)>& onVolume);
+
+    // Forget the snapshot; the next call enumerates again
+    static void invalidate();
+};
@@ -3,6 +3,10 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
+#include "DiskBenchmark.h"
+#include "DiskSpeedCache.h"
+#include "DiskHealth.h"
 using namespace std;
 
 struct storage_data {
@@ -12,21 +16,60 @@ struct storage_data {
     int used_percentage;
     string file_system;
     bool is_external;
+    bool is_remote = false;             // network share / mount
+    bool unreachable = false;           // stat timed out: no space, type or speed figures
     string storage_type;
-    string serial_number;
+    string serial_number;               // from the device descriptor ("---" when it has none)
+    DiskHealthData health;              // model / firmware, SMART or NVMe health log
     string read_speed;
     string write_speed;
     string predicted_read_speed;
     string predicted_write_speed;
+    vector<DiskBenchResult> benchmark;  // every test that ran, in config order
+    int64_t speed_age_seconds = -1;     // -1 = all measured this run, else age of the oldest cached result used
+};
+
+// Staged delivery: each callback fires per drive, in drive-letter order,
+// once that drive's fields up to the stage are filled in
+struct StorageCallbacks {
+    function<void(const storage_data&)> on_basic;      // space, file system, external
+    function<void(const storage_data&)> on_type;       // + storage type, predicted speeds
+    function<void(const storage_data&)> on_health;     // + serial, health (only read when this or on_complete is set)
+    function<void(const storage_data&)> on_complete;   // + benchmark results (only runs when set)
 };
 
 class StorageInfo {
 public:
     vector<storage_data> get_all_storage_info();
 
-    // NEW: Process disks one-by-one with callback
+    // Fully probed disks, streamed in drive-letter order (= on_complete)
     void process_storage_info(function<void(const storage_data&)> callback);
 
+    // Staged: cheap fields first, benchmarks (parallel per physical disk) last
+    void process_storage_info(const StorageCallbacks& callbacks);
+
+    // Which tests / how long; defaults to DiskBenchmark::quickConfig()
+    void set_benchmark_config(const DiskBenchConfig& config);
+
+    // Reuse results younger than ttlSeconds (rebench = measure anyway and refresh
+    // the cache); nullptr = always measure. The cache is saved after each pass.
+    void set_speed_cache(shared_ptr<DiskSpeedCache> cache, int64_t ttlSeconds, bool rebench = false);
+
+    // Benchmark network shares too (off by default: they're skipped)
+    void set_remote_benchmark(bool enabled);
+
+    // false = identity only (no SMART / health log read, which can wake a sleeping HDD)
+    void set_health_enabled(bool enabled);
+
 private:
-    string get_storage_type(const string& drive_letter, const string& root_path, bool is_external);
+    DiskBenchConfig bench_config = DiskBenchmark::quickConfig();
+    shared_ptr<DiskSpeedCache> speed_cache;
+    int64_t cache_ttl_seconds = 0;
+    bool force_rebench = false;
+    bool bench_remote = false;
+    bool read_health = true;
+
+    void detect_type(const string& root_path, int disk_number, storage_data& disk);
+    void benchmark_volume(const string& root_path, int disk_number, storage_data& disk);
+    string get_storage_type(const string& root_path, int disk_number);
 };
\ No newline at end of file
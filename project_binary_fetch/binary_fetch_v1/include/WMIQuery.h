@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+using namespace std;
+
+/*
+    WMIQuery — coalescing WQL planner + per-run result cache
+
+    Modules used to open their own locator/connection and run one SELECT per
+    field ("SELECT MaxClockSpeed FROM Win32_Processor", then again for
+    CurrentClockSpeed, ...). WMIQuery collects every (class, property) a run
+    asks for and serves them from one SELECT per class over a shared
+    connection:
+
+        WMIQuery::want("Win32_Processor", { "MaxClockSpeed", "CurrentClockSpeed" });
+        string base = WMIQuery::get("Win32_Processor", "MaxClockSpeed");   // runs the SELECT
+        string now  = WMIQuery::get("Win32_Processor", "CurrentClockSpeed"); // cached
+
+    A target is (namespace, class, WHERE clause). Asking for a property the
+    cached result doesn't carry re-runs that target once with the union of
+    everything wanted so far. To avoid those re-runs each module that reads
+    WMI has a plan_wmi() / planWmi() that only calls want(); main() runs them
+    all before the first collector.
+
+    The planner lock is not held while a SELECT runs: queries for different
+    targets proceed in parallel, and a caller asking for a target that is
+    already being fetched waits for that result instead of running it twice.
+    Executors must therefore accept concurrent execute() calls.
+
+    Values come back as text: strings as UTF-8, numbers in decimal, booleans
+    as "True"/"False". NULL or missing properties read as "Unknown".
+
+    The planner/cache is platform-neutral. The live COM executor only exists
+    on Windows; elsewhere every query comes back empty unless another
+    executor is plugged in with setExecutor(). Results go through Probe
+    (key "wql:<namespace>:<query>") so --record / --replay capture them.
+*/
+
+// One result row: property name -> value rendered as text
+typedef map<string, string> WMIRow;
+
+// Runs one complete WQL SELECT against a namespace
+class WMIExecutor {
+public:
+    virtual ~WMIExecutor() = default;
+
+    // Returns false if the namespace or query could not be reached at all
+    virtual bool execute(const string& ns, const string& wql,
+        const vector<string>& properties, vector<WMIRow>& rows) = 0;
+
+    // Drop cached connections (called from WMIQuery::shutdown)
+    virtual void release() {}
+};
+
+class WMIQuery {
+public:
+    static const char* const CIMV2;   // "ROOT\\CIMV2"
+
+    // Declare properties up front so the first fetch of a target carries all of them
+    static void want(const string& cls, const vector<string>& properties,
+        const string& where = "", const string& ns = CIMV2);
+
+    // Value of `property` in the first row, or "Unknown"
+    static string get(const string& cls, const string& property,
+        const string& where = "", const string& ns = CIMV2);
+
+    // Every row of the target (each carries at least `properties`)
+    static vector<WMIRow> rows(const string& cls, const vector<string>& properties,
+        const string& where = "", const string& ns = CIMV2);
+
+    // Number of instances (WQL has no COUNT(*), so this counts rows)
+    static size_t count(const string& cls, const string& where = "", const string& ns = CIMV2);
+
+    // Plug a different executor; nullptr restores the live one
+    static void setExecutor(shared_ptr<WMIExecutor> executor);
+
+    // Forget cached results but keep the plan and connections
+    static void clear();
+
+    // Forget everything and release connections (call before CoUninitialize)
+    static void shutdown();
+
+    // "SELECT a, b FROM cls WHERE ..." — exposed so callers/tests see the exact text
+    static string buildQuery(const string& cls, const vector<string>& properties, const string& where);
+};
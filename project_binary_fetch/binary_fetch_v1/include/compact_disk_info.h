@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include "StorageEnumerator.h"
 using namespace std;
 
 class DiskInfo {
@@ -15,8 +16,8 @@ public:
 
 private:
     // Helper: calculate used percentage
-    int calculateUsedPercentage(const string& driveLetter);
+    int calculateUsedPercentage(const VolumeInfo& volume);
 
     // Helper: calculate total capacity in GB
-    int calculateCapacityGB(const string& driveLetter);
+    int calculateCapacityGB(const VolumeInfo& volume);
 };
@@ -12,6 +12,7 @@
 #include <fstream>        // File stream operations (reading/writing files) 
 #include <string>         // Standard string class and methods 
 #include <regex>          // Regular expressions for pattern matching 
+#include <algorithm>      // min_element / max_element over sampled values
 #include <windows.h>      // Core Windows API functions (handles, processes) 
 #include <shlobj.h>       // Shell object functions (folder paths, UI) 
 #include <direct.h>       // Directory and file handling functions (_mkdir, _chdir) 
@@ -51,7 +52,19 @@
 #include "include\CompactUser.h"        // Lightweight user info
 #include "include\CompactNetwork.h"     // Lightweight network info
 #include "include\compact_disk_info.h"  // Lightweight storage/disk info (compact mode)
+#include "include\StorageEnumerator.h"  // Shared volume walk (mount options)
+#include "include\DiskActivity.h"       // Live per-device I/O rates
+#include "include\CoreActivity.h"       // Live per-core utilization and effective clock
+#include "include\CpuCounters.h"        // IPC / miss rates from perf_event_open
+#include "include\MemoryBenchmark.h"    // Cache/DRAM latency and STREAM bandwidth (bench memory)
+#include "include\CpuBenchmark.h"       // Multi-core scaling of fixed kernels (bench cpu)
+#include "include\NetActivity.h"        // Live per-interface traffic counters
+#include "include\NetIdentityCache.h"   // Public IP / SSID cached per network fingerprint
+#include "include\ConnectionInfo.h"     // TCP socket states, listening ports, retransmits
+#include "include\DirectoryScanner.h"   // Largest directories under configured paths
 #include "include\TimeInfo.h"           //returns current time info (second, minute, hour, day, week, month, year, leap year, etc)
+#include "include\Probe.h"              // --record / --replay of raw collector inputs
+#include "include\WMIQuery.h"           // Shared WMI connection + per-run query cache
 
 
 
@@ -96,7 +109,76 @@ it is a sign that the logic should be moved into a new module.
 
 //Initialize Global Variables (if any) here ------ (end)
 
-int main(){
+int main(int argc, char* argv[]){
+
+    // Record / replay of raw collector inputs (see Probe.h)
+    //   --record <file>  run normally and save every WQL/PDH/EDID/DXGI/sysfs read
+    //   --replay <file>  feed those reads back instead of touching the machine; exits 3
+    //                    (listing them on stderr) if any source still had to be read live
+    //   --rebench        ignore cached disk speeds, measure again and refresh the cache
+    //   --serve-probes [port [address]]  run the stand-in for the network probe
+    //                    endpoints (public IP, download, upload) until Enter is
+    //                    pressed; port 8080, address 127.0.0.1 unless given
+    //                    (0.0.0.0 serves other machines too)
+    //   bench memory     measure cache/DRAM latency and bandwidth and show the
+    //                    Memory Benchmark section (see MemoryBenchmark.h)
+    //   bench cpu        measure multi-core scaling and show the CPU Benchmark
+    //                    section (see CpuBenchmark.h)
+    bool rebench = false;
+    bool bench_memory = false;
+    bool bench_cpu = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--rebench") {
+            rebench = true;
+        }
+        else if (arg == "bench") {
+            string what = (i + 1 < argc) ? argv[++i] : "";
+            if (what == "memory") {
+                bench_memory = true;
+            }
+            else if (what == "cpu") {
+                bench_cpu = true;
+            }
+            else {
+                cout << "Unknown benchmark: " << what << " (available: memory, cpu)" << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--serve-probes") {
+            int port = (i + 1 < argc) ? atoi(argv[i + 1]) : 0;
+            string address = (i + 2 < argc) ? argv[i + 2] : "127.0.0.1";
+            NetProbeServer server;
+            if (!server.start(address, port > 0 ? port : 8080)) {
+                cout << "Failed to start the probe server on " << address << endl;
+                return 1;
+            }
+            if (address != "127.0.0.1" && address != "::1") {
+                cout << "Warning: listening on " << address << ", reachable beyond this machine (no authentication)" << endl;
+            }
+            cout << "Serving network probe endpoints on " << address << " port " << server.port() << ":" << endl
+                << "  public_ip_url : " << server.baseUrl() << "/ip" << endl
+                << "  download_url  : " << server.baseUrl() << "/__down?bytes=10000000" << endl
+                << "  upload_url    : " << server.baseUrl() << "/__up" << endl
+                << "  UDP echo      : port " << server.port() << " (network_latency)" << endl
+                << "  DNS stub      : udp port " << server.port() << " (dns_latency resolvers)" << endl
+                << "Press Enter to stop." << endl;
+            cin.get();
+            server.stop();
+            return 0;
+        }
+        else if ((arg == "--record" || arg == "--replay") && i + 1 < argc) {
+            Probe::Mode mode = (arg == "--record") ? Probe::Mode::Record : Probe::Mode::Replay;
+            if (!Probe::begin(mode, argv[++i])) {
+                cout << "Failed to load snapshot: " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--record" || arg == "--replay") {
+            cout << arg << " needs a snapshot file: " << arg << " <file>" << endl;
+            return 1;
+        }
+    }
 
     // Initialize COM 
     /*
@@ -125,6 +207,16 @@ int main(){
         return 1;
     }
 
+    // WMI planning pass: every module registers the fields it will read, so
+    // the first get() of a class already selects all of them (one SELECT per
+    // class instead of a re-run each time a later module asks for more)
+    CPUInfo::plan_wmi();
+    OSInfo::plan_wmi();
+    MemoryInfo::planWmi();
+    CompactMemory::plan_wmi();
+    GPUInfo::plan_wmi();
+    CompactGPU::planWmi();
+
 
 
     
@@ -208,6 +300,18 @@ int main(){
         cout << "Warning: Could not open config file: " << configPath << endl;
     }
 
+    // Volume stats are shared by compact_disk and detailed_storage; a dead network
+    // mount gets stat_timeout_ms and then shows as "unreachable" instead of hanging
+    {
+        MountOptions mount_options;
+        if (config_loaded && config.contains("detailed_storage") && config["detailed_storage"].contains("mounts")) {
+            const json& m = config["detailed_storage"]["mounts"];
+            mount_options.statTimeoutMs = m.value("stat_timeout_ms", mount_options.statTimeoutMs);
+            mount_options.skipRemote = m.value("skip_remote", mount_options.skipRemote);
+        }
+        StorageEnumerator::configure(mount_options);
+    }
+
 	// Color map (for ANSI escape codes) 
     // for beginners, we're simply assign colors like how we 
     // assin vaules in variables 
@@ -254,6 +358,14 @@ int main(){
         if (!config_loaded || !config.contains(section)) return true;
         return config[section].value(key, true);
         };
+    // sections that cost run time (sampling windows, benchmarks) stay off
+    // unless the config has them and turns them on
+    // (a key instead of "enabled" makes it a sub-module that defaults off,
+    // for things like serial numbers that shouldn't appear by surprise)
+    auto isOptIn = [&](const string& section, const string& key = "enabled") -> bool {
+        if (!config_loaded || !config.contains(section)) return false;
+        return config[section].value(key, false);
+        };
     // checks whether a specific section inside a module is enabled or not
      // example:
      // module  -> "network"
@@ -326,6 +438,130 @@ int main(){
     DiskInfo disk;
     TimeInfo time;
 
+    // Shared sampling window: rate-based sections take their first sample here
+    // and their second when they render, so they all overlap one interval
+    int sampling_interval_ms = 500;
+    if (config_loaded && config.contains("sampling")) {
+        sampling_interval_ms = config["sampling"].value("interval_ms", sampling_interval_ms);
+    }
+
+    // Benchmarks run before any background probe starts, so nothing else
+    // competes for the cores, the caches or the memory bus while they measure
+    bool show_memory_bench = bench_memory || isOptIn("memory_benchmark");
+    MemBenchReport memory_bench;
+    if (show_memory_bench) {
+        MemBenchConfig bench_config;
+        if (config_loaded && config.contains("memory_benchmark")) {
+            const json& b = config["memory_benchmark"];
+            bench_config.durationMs = b.value("duration_ms", bench_config.durationMs);
+            bench_config.arrayMB = b.value("array_mb", bench_config.arrayMB);
+            bench_config.allCores = b.value("all_cores", bench_config.allCores);
+        }
+        memory_bench = MemoryBenchmark::run(bench_config);
+    }
+    bool show_cpu_bench = bench_cpu || isOptIn("cpu_benchmark");
+    CpuBenchReport cpu_bench;
+    if (show_cpu_bench) {
+        CpuBenchConfig bench_config;
+        if (config_loaded && config.contains("cpu_benchmark")) {
+            bench_config.durationMs = config["cpu_benchmark"].value("duration_ms", bench_config.durationMs);
+        }
+        cpu_bench = CpuBenchmark::run(bench_config);
+    }
+
+    // Network identity cache: public IP and SSID are reused while the network
+    // fingerprint (route, gateway MAC, addresses, link changes) stays the same
+    bool use_network_cache = true;
+    int64_t network_cache_ttl_minutes = 60;
+    if (config_loaded && config.contains("network_cache")) {
+        use_network_cache = config["network_cache"].value("enabled", use_network_cache);
+        network_cache_ttl_minutes = config["network_cache"].value("ttl_minutes", network_cache_ttl_minutes);
+    }
+    if (use_network_cache) NetIdentityCache::begin(network_cache_ttl_minutes * 60);
+
+    CoreActivity core_activity;
+    if (isOptIn("core_activity")) core_activity.begin();
+    CpuCounters cpu_counters;
+    if (isOptIn("cpu_counters")) cpu_counters.begin();
+    // The disk window closes before the benchmark and the directory scan below
+    // touch a disk, or the section would mostly show BinaryFetch's own I/O
+    DiskActivity disk_activity;
+    shared_future<vector<DiskActivityStats>> disk_activity_window;
+    if (isOptIn("disk_activity")) {
+        disk_activity.begin();
+        disk_activity_window = async(launch::async, [&disk_activity, sampling_interval_ms]() {
+            return disk_activity.sample(sampling_interval_ms);
+            }).share();
+    }
+    // Both interface reads happen before the speed tests below start, or the
+    // section would mostly show BinaryFetch's own transfers
+    NetActivity net_activity;
+    shared_future<vector<NetActivityStats>> net_activity_window;
+    if (isOptIn("network_activity")) {
+        net_activity.begin();
+        net_activity_window = async(launch::async, [&net_activity, sampling_interval_ms]() {
+            return net_activity.sample(sampling_interval_ms);
+            }).share();
+        net.hold_transfers(async(launch::deferred, [w = net_activity_window]() { w.wait(); }).share());
+    }
+
+    // Latency probes go first: the speed tests below wait for them so the
+    // round trips are measured on an idle link
+    if (isOptIn("network_latency")) {
+        const json& l = config["network_latency"];
+        LatencyProbeConfig latency;
+        latency.samples = l.value("samples", latency.samples);
+        latency.interval_ms = l.value("interval_ms", latency.interval_ms);
+        latency.timeout_ms = l.value("timeout_ms", latency.timeout_ms);
+        if (l.contains("targets") && l["targets"].is_array()) {
+            for (const auto& t : l["targets"]) {
+                LatencyTarget target;
+                target.host = t.value("host", "");
+                target.name = t.value("name", target.host);
+                target.port = t.value("port", 0);
+                target.udp = t.value("protocol", "tcp") == "udp";
+                latency.targets.push_back(target);
+            }
+        }
+        net.begin_latency(latency);
+    }
+    if (isOptIn("dns_latency")) {
+        const json& d = config["dns_latency"];
+        DnsProbeConfig dns;
+        dns.timeout_ms = d.value("timeout_ms", dns.timeout_ms);
+        if (d.contains("resolvers") && d["resolvers"].is_array()) {
+            for (const auto& r : d["resolvers"]) if (r.is_string()) dns.resolvers.push_back(r.get<string>());
+        }
+        if (d.contains("names") && d["names"].is_array() && !d["names"].empty()) {
+            dns.names.clear();
+            for (const auto& n : d["names"]) if (n.is_string()) dns.names.push_back(n.get<string>());
+        }
+        net.begin_dns(dns);
+    }
+
+    // Network probes (public IP, download, upload) run in the background from
+    // here on; the network section waits for them when it renders
+    if (isEnabled("network_info")) {
+        bool want_ip = isSubEnabled("network_info", "show_public_ip");
+        bool want_download = isSubEnabled("network_info", "show_download");
+        bool want_upload = isSubEnabled("network_info", "show_upload");
+
+        NetProbeEndpoints endpoints;
+        if (config_loaded && config.contains("network_info") && config["network_info"].contains("probes")) {
+            const json& p = config["network_info"]["probes"];
+            endpoints.public_ip_url = p.value("public_ip_url", endpoints.public_ip_url);
+            endpoints.download_url = p.value("download_url", endpoints.download_url);
+            endpoints.upload_url = p.value("upload_url", endpoints.upload_url);
+            endpoints.upload_bytes = p.value("upload_bytes", endpoints.upload_bytes);
+            endpoints.timeout_ms = p.value("timeout_ms", endpoints.timeout_ms);
+            endpoints.streams = p.value("streams", endpoints.streams);
+            endpoints.warmup_ms = p.value("warmup_ms", endpoints.warmup_ms);
+            endpoints.max_test_ms = p.value("max_test_ms", endpoints.max_test_ms);
+            endpoints.max_test_bytes = p.value("max_test_bytes", endpoints.max_test_bytes);
+        }
+        if (want_ip || want_download || want_upload) net.begin_probes(endpoints, want_ip, want_download, want_upload);
+    }
+
 
 
 
@@ -978,6 +1214,165 @@ int main(){
             }
         }
 
+        // ----------------- MEMORY BENCHMARK SECTION ----------------- //
+        // Shown for "bench memory" or when enabled in the config
+        if (show_memory_bench) {
+            lp.push(""); // blank line
+
+            // ---------- HEADER ----------
+            if (isSectionEnabled("memory_benchmark", "header")) {
+                ostringstream ss;
+                ss << getColor("memory_benchmark", ">>~", "white") << ">>~ " << r
+                    << getColor("memory_benchmark", "header_title", "white") << "Memory Benchmark" << r
+                    << getColor("memory_benchmark", "-------------------------*", "white") << " -------------------------*" << r;
+                lp.push(ss.str());
+            }
+
+            auto size_text = [](uint64_t bytes) {
+                ostringstream tmp;
+                if (bytes >= 1024ULL * 1024ULL) tmp << bytes / (1024ULL * 1024ULL) << " MB";
+                else tmp << bytes / 1024ULL << " KB";
+                return tmp.str();
+                };
+
+            auto line = [&](const string& label) {
+                ostringstream tmp;
+                tmp << getColor("memory_benchmark", "~", "white") << "~ " << r
+                    << getColor("memory_benchmark", "label", "white") << left << setw(22) << label << right << r
+                    << getColor("memory_benchmark", " : ", "white") << ": " << r;
+                return tmp.str();
+                };
+
+            // ---------- LATENCY (one line per level) ----------
+            if (isSectionEnabled("memory_benchmark", "latency")) {
+                for (const auto& l : memory_bench.latency) {
+                    ostringstream ss;
+                    ss << line("Latency " + l.level)
+                        << getColor("memory_benchmark", "value", "white") << fixed << setprecision(1) << setw(6) << l.ns << r
+                        << getColor("memory_benchmark", "unit", "white") << " ns " << r
+                        << getColor("memory_benchmark", "brackets", "white") << "(" << r
+                        << getColor("memory_benchmark", "note", "white") << size_text(l.workingSet) << r
+                        << getColor("memory_benchmark", "brackets", "white") << ")" << r;
+                    lp.push(ss.str());
+                }
+            }
+
+            // ---------- BANDWIDTH (single thread, then all cores) ----------
+            if (isSectionEnabled("memory_benchmark", "bandwidth")) {
+                for (size_t start = 0; start < memory_bench.bandwidth.size(); start += 4) {
+                    int threads = memory_bench.bandwidth[start].threads;
+                    ostringstream ss;
+                    ss << line("Bandwidth " + to_string(threads) + (threads == 1 ? " thread" : " threads"));
+                    for (size_t i = start; i < memory_bench.bandwidth.size() && i < start + 4; ++i) {
+                        if (i > start) ss << getColor("memory_benchmark", "separator", "white") << " | " << r;
+                        ss << getColor("memory_benchmark", "label", "white") << memory_bench.bandwidth[i].kernel << " " << r
+                            << getColor("memory_benchmark", "value", "white") << fixed << setprecision(1)
+                            << memory_bench.bandwidth[i].mbps / 1000.0 << r;
+                    }
+                    ss << getColor("memory_benchmark", "unit", "white") << " GB/s" << r;
+                    lp.push(ss.str());
+                }
+            }
+
+            // ---------- KERNELS / ARRAY SIZE ----------
+            if (isSectionEnabled("memory_benchmark", "details") && !memory_bench.bandwidth.empty()) {
+                ostringstream ss;
+                ss << line("Kernels")
+                    << getColor("memory_benchmark", "value", "white") << memory_bench.kernels << r
+                    << getColor("memory_benchmark", "note", "white") << ", 3 x " << size_text(memory_bench.arrayBytes) << " arrays" << r;
+                lp.push(ss.str());
+            }
+        }
+
+        // ----------------- CPU BENCHMARK SECTION ----------------- //
+        // Shown for "bench cpu" or when enabled in the config
+        if (show_cpu_bench) {
+            lp.push(""); // blank line
+
+            // ---------- HEADER ----------
+            if (isSectionEnabled("cpu_benchmark", "header")) {
+                ostringstream ss;
+                ss << getColor("cpu_benchmark", ">>~", "white") << ">>~ " << r
+                    << getColor("cpu_benchmark", "header_title", "white") << "CPU Benchmark" << r
+                    << getColor("cpu_benchmark", "-------------------------*", "white") << " -------------------------*" << r;
+                lp.push(ss.str());
+            }
+
+            auto line = [&](const string& label) {
+                ostringstream tmp;
+                tmp << getColor("cpu_benchmark", "~", "white") << "~ " << r
+                    << getColor("cpu_benchmark", "label", "white") << left << setw(16) << label << right << r
+                    << getColor("cpu_benchmark", " : ", "white") << ": " << r;
+                return tmp.str();
+                };
+
+            // Efficiency under 75% on physical cores is flagged; past the core
+            // count SMT siblings share a core, so it is only marked
+            auto efficiency = [&](const CpuBenchStep& step, double value) {
+                ostringstream tmp;
+                string color = (!step.smt && value < 0.75) ? getColor("cpu_benchmark", "warning", "red") : getColor("cpu_benchmark", "value", "white");
+                tmp << getColor("cpu_benchmark", "brackets", "white") << " (" << r
+                    << color << fixed << setprecision(0) << value * 100.0 << "%" << r
+                    << getColor("cpu_benchmark", "brackets", "white") << ")" << r;
+                return tmp.str();
+                };
+
+            // ---------- SCALING (one line per thread count) ----------
+            if (isSectionEnabled("cpu_benchmark", "scaling")) {
+                for (const auto& step : cpu_bench.steps) {
+                    ostringstream ss;
+                    ss << line("Threads " + to_string(step.threads) + (step.smt ? " SMT" : ""))
+                        << getColor("cpu_benchmark", "label", "white") << "int " << r
+                        << getColor("cpu_benchmark", "value", "white") << fixed << setprecision(2) << setw(7) << step.intOps / 1e9 << r
+                        << getColor("cpu_benchmark", "unit", "white") << " Gop/s" << r
+                        << efficiency(step, step.intEfficiency)
+                        << getColor("cpu_benchmark", "separator", "white") << " | " << r
+                        << getColor("cpu_benchmark", "label", "white") << "fp " << r
+                        << getColor("cpu_benchmark", "value", "white") << fixed << setprecision(2) << setw(7) << step.flops / 1e9 << r
+                        << getColor("cpu_benchmark", "unit", "white") << " GFLOPS" << r
+                        << efficiency(step, step.fpEfficiency);
+                    lp.push(ss.str());
+                }
+            }
+
+            // ---------- MEASURED VS REPORTED ----------
+            int reported_cores = cpu.get_cpu_cores();
+            int reported_threads = cpu.get_cpu_logical_processors();
+            if (isSectionEnabled("cpu_benchmark", "parallelism")) {
+                ostringstream ss;
+                ss << line("Parallelism")
+                    << getColor("cpu_benchmark", "value", "white") << fixed << setprecision(1)
+                    << cpu_bench.intParallelism << "x" << r
+                    << getColor("cpu_benchmark", "unit", "white") << " int" << r
+                    << getColor("cpu_benchmark", "separator", "white") << " | " << r
+                    << getColor("cpu_benchmark", "value", "white") << cpu_bench.fpParallelism << "x" << r
+                    << getColor("cpu_benchmark", "unit", "white") << " fp" << r
+                    << getColor("cpu_benchmark", "separator", "white") << " | " << r
+                    << getColor("cpu_benchmark", "note", "white") << reported_cores << " cores / "
+                    << reported_threads << " threads reported" << r;
+                if (cpu_bench.allowedCpus > 0) {
+                    ss << getColor("cpu_benchmark", "separator", "white") << " | " << r
+                        << getColor("cpu_benchmark", "note", "white") << cpu_bench.allowedCpus << " allowed" << r;
+                }
+                if (cpu_bench.quotaCpus > 0.0) {
+                    ss << getColor("cpu_benchmark", "separator", "white") << " | " << r
+                        << getColor("cpu_benchmark", "note", "white") << "quota " << setprecision(1) << cpu_bench.quotaCpus << r;
+                }
+                lp.push(ss.str());
+            }
+
+            if (isSectionEnabled("cpu_benchmark", "verdict")) {
+                string verdict = CpuBenchmark::assess(cpu_bench, reported_cores, reported_threads);
+                bool matches = verdict.compare(0, 7, "matches") == 0;
+                ostringstream ss;
+                ss << line("Verdict")
+                    << (matches ? getColor("cpu_benchmark", "value", "white") : getColor("cpu_benchmark", "warning", "red"))
+                    << verdict << r;
+                if (!cpu_bench.pinned) ss << getColor("cpu_benchmark", "note", "white") << " (threads not pinned)" << r;
+                lp.push(ss.str());
+            }
+        }
+
 
         // ----------------- DETAILED STORAGE SECTION (FIXED) ----------------- //
         if (isEnabled("detailed_storage")) {
@@ -1055,8 +1450,42 @@ int main(){
 
             vector<storage_data> all_disks_captured;
 
+            // Disk benchmark settings: the full suite only runs when its section is on,
+            // otherwise just SEQ1M read/write for the Read/Write columns
+            DiskBenchConfig bench = DiskBenchmark::quickConfig();
+            if (getNestedBool("sections.disk_benchmark", false)) bench.tests = DiskBenchmark::standardTests();
+            if (config_loaded && config.contains("detailed_storage") && config["detailed_storage"].contains("benchmark")) {
+                const json& b = config["detailed_storage"]["benchmark"];
+                bench.durationMs = b.value("duration_ms", bench.durationMs);
+                bench.threads = b.value("threads", bench.threads);
+                bench.fileSizeMB = b.value("file_size_mb", bench.fileSizeMB);
+            }
+            storage.set_benchmark_config(bench);
+
+            // Disk speed cache: reuse results per device until they're older than the TTL
+            bool use_speed_cache = true;
+            int64_t cache_ttl_hours = 168;
+            if (config_loaded && config.contains("detailed_storage") && config["detailed_storage"].contains("benchmark")) {
+                const json& b = config["detailed_storage"]["benchmark"];
+                use_speed_cache = b.value("cache", use_speed_cache);
+                cache_ttl_hours = b.value("cache_ttl_hours", cache_ttl_hours);
+                storage.set_remote_benchmark(b.value("include_remote", false));
+            }
+            if (use_speed_cache) {
+                auto speed_cache = make_shared<DiskSpeedCache>();
+                speed_cache->load();
+                storage.set_speed_cache(speed_cache, cache_ttl_hours * 3600, rebench);
+            }
+            storage.set_health_enabled(getNestedBool("sections.disk_health", true));
+
             // STORAGE SUMMARY SECTION
-            if (getNestedBool("sections.storage_summary", true)) {
+            // Drives stream through StorageInfo in stages: summary lines render as soon as
+            // space + type are known, benchmarks only run if a section below shows them
+            bool show_summary = getNestedBool("sections.storage_summary", true);
+            bool need_speeds = getNestedBool("sections.disk_performance", true) || getNestedBool("sections.disk_benchmark", false);
+            StorageCallbacks storage_callbacks;
+
+            if (show_summary) {
 
                 // Header
                 if (getNestedBool("storage_summary.header.show_header", true)) {
@@ -1068,9 +1497,7 @@ int main(){
                 }
 
                 // Process each disk
-                storage.process_storage_info([&](const storage_data& d) {
-                    all_disks_captured.push_back(d);
-
+                storage_callbacks.on_type = [&](const storage_data& d) {
                     ostringstream ss;
 
                     // Storage type
@@ -1086,6 +1513,14 @@ int main(){
                     // Opening bracket
                     ss << getNestedColor("storage_summary.[", "white") << " [" << r;
 
+                    // Mount didn't answer in time: nothing else to show for it
+                    if (d.unreachable) {
+                        ss << " " << getNestedColor("storage_summary.unreachable_color", "white") << "unreachable" << r
+                            << getNestedColor("storage_summary.]", "white") << " ]" << r;
+                        lp.push(ss.str());
+                        return;
+                    }
+
                     // (Used) label
                     if (getNestedBool("storage_summary.show_used_label", true)) {
                         ss << getNestedColor("storage_summary.(", "white") << " (" << r
@@ -1158,9 +1593,20 @@ int main(){
                     ss << getNestedColor("storage_summary.]", "white") << " ]" << r;
 
                     lp.push(ss.str());
-                    });
+                    };
             }
 
+            // Everything below reads the captured drives (serial + health at least)
+            auto capture = [&](const storage_data& d) { all_disks_captured.push_back(d); };
+            if (need_speeds) {
+                storage_callbacks.on_complete = capture;
+            }
+            else {
+                storage_callbacks.on_health = capture;
+            }
+            if (need_speeds && disk_activity_window.valid()) disk_activity_window.wait();
+            storage.process_storage_info(storage_callbacks);
+
             // DISK PERFORMANCE SECTION
             if (!all_disks_captured.empty() && getNestedBool("sections.disk_performance", true)) {
 
@@ -1185,29 +1631,46 @@ int main(){
 
                     ss << getNestedColor("storage_summary.[", "white") << " [" << r << " ";
 
-                    // Read speed
-                    if (getNestedBool("disk_performance.show_read_speed", true)) {
-                        ss << getNestedColor("disk_performance.read_label_color", "white") << "Read:" << r << " "
-                            << getNestedColor("disk_performance.read_speed_color", "white") << fmt_speed(d.read_speed) << r;
+                    if (d.unreachable) {
+                        ss << getNestedColor("disk_performance.unreachable_color", "white") << "unreachable" << r << " "
+                            << getNestedColor("disk_performance.|", "white") << "|" << r << " ";
                     }
+                    else if (d.is_remote && d.benchmark.empty()) {
+                        // Shares aren't benchmarked unless benchmark.include_remote is set
+                        ss << getNestedColor("disk_performance.unreachable_color", "white") << "network, not measured" << r << " "
+                            << getNestedColor("disk_performance.|", "white") << "|" << r << " ";
+                    }
+                    else {
+                        // Read speed
+                        if (getNestedBool("disk_performance.show_read_speed", true)) {
+                            ss << getNestedColor("disk_performance.read_label_color", "white") << "Read:" << r << " "
+                                << getNestedColor("disk_performance.read_speed_color", "white") << fmt_speed(d.read_speed) << r;
+                        }
 
-                    ss << getNestedColor("disk_performance.speed_unit_color", "white") << " MB/s " << r
-                        << getNestedColor("disk_performance.|", "white") << "|" << r << " ";
+                        ss << getNestedColor("disk_performance.speed_unit_color", "white") << " MB/s " << r
+                            << getNestedColor("disk_performance.|", "white") << "|" << r << " ";
 
-                    // Write speed
-                    if (getNestedBool("disk_performance.show_write_speed", true)) {
-                        ss << getNestedColor("disk_performance.write_label_color", "white") << "Write:" << r << " "
-                            << getNestedColor("disk_performance.write_speed_color", "white") << fmt_speed(d.write_speed) << r;
-                    }
+                        // Write speed
+                        if (getNestedBool("disk_performance.show_write_speed", true)) {
+                            ss << getNestedColor("disk_performance.write_label_color", "white") << "Write:" << r << " "
+                                << getNestedColor("disk_performance.write_speed_color", "white") << fmt_speed(d.write_speed) << r;
+                        }
 
-                    ss << getNestedColor("disk_performance.speed_unit_color", "white") << " MB/s " << r
-                        << getNestedColor("disk_performance.|", "white") << "|" << r << " ";
+                        ss << getNestedColor("disk_performance.speed_unit_color", "white") << " MB/s " << r
+                            << getNestedColor("disk_performance.|", "white") << "|" << r << " ";
+                    }
 
                     // Serial number
                     if (getNestedBool("disk_performance.show_serial_number", true)) {
                         ss << getNestedColor("disk_performance.serial_number_color", "white") << d.serial_number << r;
                     }
 
+                    // Age of cached speeds (nothing when measured this run)
+                    if (d.speed_age_seconds >= 0 && getNestedBool("disk_performance.show_cache_age", true)) {
+                        ss << " " << getNestedColor("disk_performance.cache_age_color", "white")
+                            << "(cached " << DiskSpeedCache::formatAge(d.speed_age_seconds) << " ago)" << r;
+                    }
+
                     // External/Internal status
                     if (getNestedBool("disk_performance.show_external_status", true)) {
                         if (d.is_external) {
@@ -1224,6 +1687,140 @@ int main(){
                 }
             }
 
+            // DISK BENCHMARK (every test: MB/s, IOPS, p50/p99 latency)
+            if (!all_disks_captured.empty() && getNestedBool("sections.disk_benchmark", false)) {
+
+                lp.push("");
+
+                // Header
+                if (getNestedBool("disk_benchmark.header.show_header", true)) {
+                    ostringstream ss;
+                    ss << getNestedColor("disk_benchmark.header.line_color", "white") << "-------------------- " << r
+                        << getNestedColor("disk_benchmark.header.title_color", "white") << "DISK BENCHMARK (" << DiskBenchmark::engineName() << ")" << r
+                        << getNestedColor("disk_benchmark.header.line_color", "white") << " --------------------" << r;
+                    lp.push(ss.str());
+                }
+
+                auto fmt_latency = [](double us) -> string {
+                    ostringstream tmp;
+                    if (us >= 1000.0) tmp << fixed << setprecision(2) << (us / 1000.0) << "ms";
+                    else tmp << fixed << setprecision(0) << us << "us";
+                    string val = tmp.str();
+                    int padding = 8 - (int)val.size();
+                    if (padding < 0) padding = 0;
+                    return string(padding, ' ') + val;
+                    };
+
+                for (const auto& d : all_disks_captured) {
+                    for (const auto& b : d.benchmark) {
+                        ostringstream ss;
+                        ss << getNestedColor("disk_benchmark.drive_letter_color", "white") << d.drive_letter << r
+                            << getNestedColor("disk_benchmark.[", "white") << " [ " << r
+                            << getNestedColor("disk_benchmark.test_color", "white") << left << setw(18) << b.name << right << r;
+
+                        if (!b.ok) {
+                            ss << getNestedColor("disk_benchmark.failed_color", "white") << "failed" << r;
+                        }
+                        else {
+                            ss << getNestedColor("disk_benchmark.|", "white") << "| " << r
+                                << getNestedColor("disk_benchmark.speed_color", "white") << setw(8) << fixed << setprecision(1) << b.mbps << r
+                                << getNestedColor("disk_benchmark.unit_color", "white") << " MB/s " << r
+                                << getNestedColor("disk_benchmark.|", "white") << "| " << r
+                                << getNestedColor("disk_benchmark.iops_color", "white") << setw(7) << (long long)b.iops << r
+                                << getNestedColor("disk_benchmark.unit_color", "white") << " IOPS " << r
+                                << getNestedColor("disk_benchmark.|", "white") << "| " << r
+                                << getNestedColor("disk_benchmark.latency_label_color", "white") << "p50" << r
+                                << getNestedColor("disk_benchmark.latency_color", "white") << fmt_latency(b.p50_us) << r << " "
+                                << getNestedColor("disk_benchmark.latency_label_color", "white") << "p99" << r
+                                << getNestedColor("disk_benchmark.latency_color", "white") << fmt_latency(b.p99_us) << r;
+                        }
+
+                        ss << getNestedColor("disk_benchmark.]", "white") << " ]" << r;
+
+                        lp.push(ss.str());
+                    }
+                }
+            }
+
+            // DISK HEALTH (SMART / NVMe health log: temperature, wear, media errors, throttling)
+            if (!all_disks_captured.empty() && getNestedBool("sections.disk_health", true)) {
+
+                lp.push("");
+
+                // Header
+                if (getNestedBool("disk_health.header.show_header", true)) {
+                    ostringstream ss;
+                    ss << getNestedColor("disk_health.header.line_color", "white") << "-------------------- " << r
+                        << getNestedColor("disk_health.header.title_color", "white") << "DISK HEALTH" << r
+                        << getNestedColor("disk_health.header.line_color", "white") << " -----------------------------" << r;
+                    lp.push(ss.str());
+                }
+
+                int hot_temperature = 70;
+                if (config_loaded && config.contains("detailed_storage") && config["detailed_storage"].contains("disk_health")) {
+                    hot_temperature = config["detailed_storage"]["disk_health"].value("hot_temperature_c", hot_temperature);
+                }
+
+                for (const auto& d : all_disks_captured) {
+                    const DiskHealthData& h = d.health;
+                    if (d.is_remote || d.unreachable) continue;
+
+                    ostringstream ss;
+                    ss << getNestedColor("disk_health.drive_letter_color", "white") << d.drive_letter << r
+                        << getNestedColor("disk_health.[", "white") << " [ " << r;
+
+                    if (getNestedBool("disk_health.show_model", true)) {
+                        ss << getNestedColor("disk_health.model_color", "white") << (h.model.empty() ? "Unknown" : h.model) << r;
+                        if (!h.protocol.empty()) ss << getNestedColor("disk_health.label_color", "white") << " (" << h.protocol << ")" << r;
+                        ss << getNestedColor("disk_health.|", "white") << " | " << r;
+                    }
+
+                    if (!h.valid && h.temperature_c < 0) {
+                        // Typically SATA without admin rights, or a USB bridge that doesn't pass SMART through
+                        ss << getNestedColor("disk_health.na_color", "white") << "health not available" << r;
+                    }
+                    else {
+                        if (getNestedBool("disk_health.show_temperature", true)) {
+                            bool hot = h.overheating() || h.temperature_c >= hot_temperature;
+                            ss << getNestedColor("disk_health.label_color", "white") << "Temp " << r;
+                            if (h.temperature_c < 0) ss << getNestedColor("disk_health.na_color", "white") << "n/a" << r;
+                            else ss << getNestedColor(hot ? "disk_health.warning_color" : "disk_health.value_color", "white") << h.temperature_c << " C" << r;
+                            ss << getNestedColor("disk_health.|", "white") << " | " << r;
+                        }
+
+                        if (getNestedBool("disk_health.show_percentage_used", true)) {
+                            ss << getNestedColor("disk_health.label_color", "white") << "Used " << r;
+                            if (h.percentage_used < 0) ss << getNestedColor("disk_health.na_color", "white") << "n/a" << r;
+                            else ss << getNestedColor(h.percentage_used >= 90 ? "disk_health.warning_color" : "disk_health.value_color", "white") << h.percentage_used << "%" << r;
+                            ss << getNestedColor("disk_health.|", "white") << " | " << r;
+                        }
+
+                        if (getNestedBool("disk_health.show_media_errors", true)) {
+                            ss << getNestedColor("disk_health.label_color", "white") << "Media Err " << r;
+                            if (!h.valid) ss << getNestedColor("disk_health.na_color", "white") << "n/a" << r;
+                            else ss << getNestedColor(h.media_errors > 0 ? "disk_health.warning_color" : "disk_health.value_color", "white") << h.media_errors << r;
+                            ss << getNestedColor("disk_health.|", "white") << " | " << r;
+                        }
+
+                        if (getNestedBool("disk_health.show_throttle", true)) {
+                            ss << getNestedColor("disk_health.label_color", "white") << "Throttle " << r;
+                            if (h.throttle_events < 0) {
+                                ss << getNestedColor("disk_health.na_color", "white") << "n/a" << r;
+                            }
+                            else {
+                                ss << getNestedColor(h.throttle_events > 0 ? "disk_health.warning_color" : "disk_health.value_color", "white") << h.throttle_events << r;
+                                if (h.throttle_seconds > 0) {
+                                    ss << getNestedColor("disk_health.label_color", "white") << " (" << DiskSpeedCache::formatAge((int64_t)h.throttle_seconds) << ")" << r;
+                                }
+                            }
+                        }
+                    }
+
+                    ss << getNestedColor("disk_health.]", "white") << " ]" << r;
+                    lp.push(ss.str());
+                }
+            }
+
             // DISK PERFORMANCE PREDICTED
             if (!all_disks_captured.empty() && getNestedBool("sections.disk_performance_predicted", true)) {
 
@@ -1287,6 +1884,76 @@ int main(){
                 }
             }
 
+            // LARGEST DIRECTORIES (parallel walk of the configured paths, mtime-keyed cache)
+            if (getNestedBool("sections.largest_directories", false)) {
+
+                DirScanConfig scan;
+                if (config_loaded && config.contains("detailed_storage") && config["detailed_storage"].contains("largest_directories")) {
+                    const json& ld = config["detailed_storage"]["largest_directories"];
+                    if (ld.contains("paths") && ld["paths"].is_array()) {
+                        for (const auto& p : ld["paths"]) {
+                            if (p.is_string() && !p.get<string>().empty()) scan.roots.push_back(p.get<string>());
+                        }
+                    }
+                    scan.topN = ld.value("top_n", scan.topN);
+                    scan.depth = ld.value("depth", scan.depth);
+                    scan.threads = ld.value("threads", scan.threads);
+                    scan.useCache = ld.value("cache", scan.useCache);
+                }
+                if (scan.roots.empty()) scan.roots.push_back(DirectoryScanner::homeDirectory());
+
+                lp.push("");
+
+                // Header
+                if (getNestedBool("largest_directories.header.show_header", true)) {
+                    ostringstream ss;
+                    ss << getNestedColor("largest_directories.header.line_color", "white") << "-------------------- " << r
+                        << getNestedColor("largest_directories.header.title_color", "white") << "LARGEST DIRECTORIES" << r
+                        << getNestedColor("largest_directories.header.line_color", "white") << " --------------------" << r;
+                    lp.push(ss.str());
+                }
+
+                auto fmt_gib = [](uint64_t bytes) -> string {
+                    ostringstream tmp;
+                    tmp << fixed << setprecision(2) << (bytes / (1024.0 * 1024.0 * 1024.0));
+                    string val = tmp.str();
+                    int padding = 8 - (int)val.size();
+                    if (padding < 0) padding = 0;
+                    return string(padding, ' ') + val;
+                    };
+
+                if (disk_activity_window.valid()) disk_activity_window.wait();
+                for (const auto& res : DirectoryScanner::scan(scan)) {
+                    ostringstream head;
+                    head << getNestedColor("largest_directories.root_color", "white") << res.root.path << r
+                        << getNestedColor("largest_directories.[", "white") << " [ " << r;
+                    if (!res.ok) {
+                        head << getNestedColor("largest_directories.root_color", "white") << "not readable" << r;
+                    }
+                    else {
+                        head << getNestedColor("largest_directories.size_color", "white") << fmt_gib(res.root.bytes) << r
+                            << getNestedColor("largest_directories.unit_color", "white") << " GiB " << r
+                            << getNestedColor("largest_directories.|", "white") << "| " << r
+                            << getNestedColor("largest_directories.unit_color", "white") << res.root.files << " files" << r;
+                    }
+                    head << getNestedColor("largest_directories.]", "white") << " ]" << r;
+                    lp.push(head.str());
+
+                    for (const auto& e : res.largest) {
+                        double pct = res.root.bytes > 0 ? (e.bytes * 100.0 / res.root.bytes) : 0.0;
+                        ostringstream ss;
+                        ss << getNestedColor("largest_directories.[", "white") << "  [ " << r
+                            << getNestedColor("largest_directories.size_color", "white") << fmt_gib(e.bytes) << r
+                            << getNestedColor("largest_directories.unit_color", "white") << " GiB " << r
+                            << getNestedColor("largest_directories.|", "white") << "| " << r
+                            << getNestedColor("largest_directories.percent_color", "white") << setw(5) << fixed << setprecision(1) << pct << "%" << r
+                            << getNestedColor("largest_directories.]", "white") << " ] " << r
+                            << getNestedColor("largest_directories.path_color", "white") << e.path << r;
+                        lp.push(ss.str());
+                    }
+                }
+            }
+
             // No drives detected
             if (all_disks_captured.empty()) {
                 lp.push("No drives detected.");
@@ -1409,6 +2076,294 @@ int main(){
                 }
             }
 
+            // Network Activity (live interface counters over the sampling window)
+            if (isOptIn("network_activity")) {
+                lp.push("");
+
+                // Header
+                if (isSubEnabled("network_activity", "show_header")) {
+                    ostringstream ss;
+                    ss << getColor("network_activity", "#-", "white") << "#- " << r
+                        << getColor("network_activity", "header_text_color", "white") << "Network Activity " << r
+                        << getColor("network_activity", "separator_line", "white")
+                        << "-----------------------------------------------#" << r;
+                    lp.push(ss.str());
+                }
+
+                // Bits per second with the unit scaled to fit
+                auto rate = [](double bytesPerSec) {
+                    double bits = bytesPerSec * 8.0;
+                    const char* unit = " Kb/s";
+                    double v = bits / 1e3;
+                    if (bits >= 1e9) { v = bits / 1e9; unit = " Gb/s"; }
+                    else if (bits >= 1e6) { v = bits / 1e6; unit = " Mb/s"; }
+                    ostringstream tmp;
+                    tmp << fixed << setprecision(1) << setw(6) << v;
+                    return make_pair(tmp.str(), string(unit));
+                    };
+
+                for (const auto& n : net_activity_window.get()) {
+                    ostringstream ss;
+                    ss << getColor("network_activity", "~", "white") << "~ " << r
+                        << getColor("network_activity", "interface_color", "white") << left << setw(12) << n.name << right << r
+                        << getColor("network_activity", ":", "white") << ": " << r;
+
+                    if (isSubEnabled("network_activity", "show_throughput")) {
+                        auto rx = rate(n.rxBytesPerSec);
+                        auto tx = rate(n.txBytesPerSec);
+                        ss << getColor("network_activity", "label_color", "white") << "RX" << r
+                            << getColor("network_activity", "throughput_color", "white") << rx.first << r
+                            << getColor("network_activity", "unit_color", "white") << rx.second << " " << r
+                            << getColor("network_activity", "label_color", "white") << "TX" << r
+                            << getColor("network_activity", "throughput_color", "white") << tx.first << r
+                            << getColor("network_activity", "unit_color", "white") << tx.second << " " << r;
+                    }
+                    if (isSubEnabled("network_activity", "show_packets")) {
+                        ss << getColor("network_activity", "|", "white") << "| " << r
+                            << getColor("network_activity", "packets_color", "white") << fixed << setprecision(0)
+                            << n.rxPacketsPerSec << "/" << n.txPacketsPerSec << r
+                            << getColor("network_activity", "unit_color", "white") << " pkt/s " << r;
+                    }
+                    // Totals since the interface came up; (+n) = new during the window
+                    if (isSubEnabled("network_activity", "show_errors")) {
+                        ss << getColor("network_activity", "|", "white") << "| " << r
+                            << getColor("network_activity", "label_color", "white") << "err " << r
+                            << getColor("network_activity", n.newErrors ? "alert_color" : "counter_color", "white") << n.errors;
+                        if (n.newErrors) ss << " (+" << n.newErrors << ")";
+                        ss << r << " ";
+                    }
+                    if (isSubEnabled("network_activity", "show_drops")) {
+                        ss << getColor("network_activity", "|", "white") << "| " << r
+                            << getColor("network_activity", "label_color", "white") << "drop " << r
+                            << getColor("network_activity", n.newDrops ? "alert_color" : "counter_color", "white") << n.drops;
+                        if (n.newDrops) ss << " (+" << n.newDrops << ")";
+                        ss << r;
+                    }
+
+                    lp.push(ss.str());
+                }
+            }
+
+            // Network Latency (round trips to the configured targets)
+            if (isOptIn("network_latency")) {
+                lp.push("");
+
+                // Header
+                if (isSubEnabled("network_latency", "show_header")) {
+                    ostringstream ss;
+                    ss << getColor("network_latency", "#-", "white") << "#- " << r
+                        << getColor("network_latency", "header_text_color", "white") << "Network Latency " << r
+                        << getColor("network_latency", "separator_line", "white")
+                        << "------------------------------------------------#" << r;
+                    lp.push(ss.str());
+                }
+
+                auto ms = [](double v) {
+                    ostringstream tmp;
+                    tmp << fixed << setprecision(v < 10.0 ? 2 : 1) << v;
+                    return tmp.str();
+                    };
+
+                for (const auto& t : net.get_latency()) {
+                    ostringstream ss;
+                    ss << getColor("network_latency", "~", "white") << "~ " << r
+                        << getColor("network_latency", "name_color", "white") << left << setw(10) << t.name << right << r
+                        << getColor("network_latency", ":", "white") << ": " << r;
+                    if (isSubEnabled("network_latency", "show_endpoint")) {
+                        ss << getColor("network_latency", "endpoint_color", "white") << left << setw(24) << t.endpoint << right << r;
+                    }
+
+                    if (!t.error.empty() || t.stats.received == 0) {
+                        ss << getColor("network_latency", "error_color", "white")
+                            << (t.error.empty() ? "no reply" : t.error) << r;
+                        lp.push(ss.str());
+                        continue;
+                    }
+
+                    const pair<const char*, double> points[] = {
+                        { "min ", t.stats.minMs }, { "p50 ", t.stats.p50Ms }, { "p99 ", t.stats.p99Ms }, { "max ", t.stats.maxMs } };
+                    for (size_t i = 0; i < 4; i++) {
+                        if (i) ss << getColor("network_latency", "|", "white") << " | " << r;
+                        ss << getColor("network_latency", "label_color", "white") << points[i].first << r
+                            << getColor("network_latency", "value_color", "white") << ms(points[i].second) << r;
+                    }
+                    ss << getColor("network_latency", "unit_color", "white") << " ms" << r;
+
+                    if (isSubEnabled("network_latency", "show_jitter")) {
+                        ss << getColor("network_latency", "|", "white") << " | " << r
+                            << getColor("network_latency", "label_color", "white") << "jitter " << r
+                            << getColor("network_latency", "value_color", "white") << ms(t.stats.jitterMs) << r
+                            << getColor("network_latency", "unit_color", "white") << " ms" << r;
+                    }
+                    if (isSubEnabled("network_latency", "show_loss")) {
+                        ss << getColor("network_latency", "|", "white") << " | " << r
+                            << getColor("network_latency", "label_color", "white") << "loss " << r
+                            << getColor("network_latency", t.stats.received < t.stats.sent ? "loss_color" : "value_color", "white")
+                            << fixed << setprecision(0) << t.stats.lossPercent() << r
+                            << getColor("network_latency", "%", "white") << "%" << r;
+                    }
+                    lp.push(ss.str());
+                }
+            }
+
+            // DNS Latency (raw queries to each resolver)
+            if (isOptIn("dns_latency")) {
+                lp.push("");
+
+                // Header
+                if (isSubEnabled("dns_latency", "show_header")) {
+                    ostringstream ss;
+                    ss << getColor("dns_latency", "#-", "white") << "#- " << r
+                        << getColor("dns_latency", "header_text_color", "white") << "DNS Latency " << r
+                        << getColor("dns_latency", "separator_line", "white")
+                        << "----------------------------------------------------#" << r;
+                    lp.push(ss.str());
+                }
+
+                auto ms = [](double v) {
+                    ostringstream tmp;
+                    tmp << fixed << setprecision(v < 10.0 ? 2 : 1) << v;
+                    return tmp.str();
+                    };
+                auto rcode_name = [](int rcode) {
+                    switch (rcode) {
+                    case 1: return string("FORMERR");
+                    case 2: return string("SERVFAIL");
+                    case 3: return string("NXDOMAIN");
+                    case 4: return string("NOTIMP");
+                    case 5: return string("REFUSED");
+                    default: return "rcode " + to_string(rcode);
+                    }
+                    };
+
+                vector<DnsReport> resolvers = net.get_dns();
+                if (resolvers.empty()) {
+                    ostringstream ss;
+                    ss << getColor("dns_latency", "~", "white") << "~ " << r
+                        << getColor("dns_latency", "error_color", "white") << "no resolvers configured" << r;
+                    lp.push(ss.str());
+                }
+
+                for (const auto& d : resolvers) {
+                    ostringstream ss;
+                    ss << getColor("dns_latency", "~", "white") << "~ " << r
+                        << getColor("dns_latency", "resolver_color", "white") << left << setw(24) << d.resolver << right << r
+                        << getColor("dns_latency", ":", "white") << ": " << r;
+
+                    if (!d.error.empty() || d.stats.received == 0) {
+                        ss << getColor("dns_latency", "error_color", "white")
+                            << (d.error.empty() ? "no reply" : d.error) << r;
+                        lp.push(ss.str());
+                        continue;
+                    }
+
+                    const pair<const char*, double> points[] = {
+                        { "min ", d.stats.minMs }, { "p50 ", d.stats.p50Ms }, { "max ", d.stats.maxMs } };
+                    for (size_t i = 0; i < 3; i++) {
+                        if (i) ss << getColor("dns_latency", "|", "white") << " | " << r;
+                        ss << getColor("dns_latency", "label_color", "white") << points[i].first << r
+                            << getColor("dns_latency", "value_color", "white") << ms(points[i].second) << r;
+                    }
+                    ss << getColor("dns_latency", "unit_color", "white") << " ms" << r;
+
+                    // Timeouts and anything but NOERROR, by name
+                    if (isSubEnabled("dns_latency", "show_failures")) {
+                        int failed = 0;
+                        string detail;
+                        for (const auto& q : d.queries) {
+                            if (q.rcode == 0) continue;
+                            failed++;
+                            if (!detail.empty()) detail += ", ";
+                            detail += q.name + " " + (q.rcode == -1 ? "timeout" : q.rcode == -2 ? "invalid name" : rcode_name(q.rcode));
+                        }
+                        ss << getColor("dns_latency", "|", "white") << " | " << r
+                            << getColor("dns_latency", "label_color", "white") << "ok " << r
+                            << getColor("dns_latency", failed ? "failure_color" : "value_color", "white")
+                            << (d.queries.size() - failed) << "/" << d.queries.size() << r;
+                        if (failed) ss << getColor("dns_latency", "failure_color", "white") << " (" << detail << ")" << r;
+                    }
+                    lp.push(ss.str());
+                }
+            }
+
+            // Connections (TCP socket states + counters since boot)
+            if (isOptIn("connections")) {
+                lp.push("");
+
+                // Header
+                if (isSubEnabled("connections", "show_header")) {
+                    ostringstream ss;
+                    ss << getColor("connections", "#-", "white") << "#- " << r
+                        << getColor("connections", "header_text_color", "white") << "Connections " << r
+                        << getColor("connections", "separator_line", "white")
+                        << "----------------------------------------------------#" << r;
+                    lp.push(ss.str());
+                }
+
+                ConnectionStats conn = ConnectionInfo::collect();
+                auto line = [&](const char* label) {
+                    ostringstream ss;
+                    ss << getColor("connections", "~", "white") << "~ " << r
+                        << getColor("connections", "label_color", "white") << left << setw(12) << label << right << r
+                        << getColor("connections", ":", "white") << ": " << r;
+                    return ss.str();
+                    };
+
+                if (!conn.ok) {
+                    lp.push(line("TCP sockets") + getColor("connections", "error_color", "white") + "unavailable" + r);
+                }
+
+                // Total, then every non-empty state
+                if (conn.ok && isSubEnabled("connections", "show_states")) {
+                    ostringstream ss;
+                    ss << line("TCP sockets")
+                        << getColor("connections", "value_color", "white") << conn.total << r;
+                    for (const auto& st : conn.states) {
+                        if (st.second == 0) continue;
+                        ss << getColor("connections", "|", "white") << " | " << r
+                            << getColor("connections", "state_color", "white") << st.first << " " << r
+                            << getColor("connections", "value_color", "white") << st.second << r;
+                    }
+                    lp.push(ss.str());
+                }
+
+                if (conn.ok && isSubEnabled("connections", "show_listening")) {
+                    int limit = config["connections"].value("max_ports", 12);
+                    ostringstream ss;
+                    ss << line("Listening");
+                    if (conn.listeningPorts.empty()) ss << getColor("connections", "value_color", "white") << "none" << r;
+                    for (size_t i = 0; i < conn.listeningPorts.size() && (int)i < limit; i++) {
+                        if (i) ss << getColor("connections", "|", "white") << " " << r;
+                        ss << getColor("connections", "port_color", "white") << conn.listeningPorts[i] << r;
+                    }
+                    if ((int)conn.listeningPorts.size() > limit) {
+                        ss << getColor("connections", "label_color", "white") << " +" << (conn.listeningPorts.size() - limit) << " more" << r;
+                    }
+                    lp.push(ss.str());
+                }
+
+                // Counters the platform doesn't keep (-1) are left out
+                if (isSubEnabled("connections", "show_counters") && conn.retransSegments >= 0) {
+                    ostringstream ss;
+                    ss << line("Retransmits")
+                        << getColor("connections", conn.retransPercent() >= 1.0 ? "alert_color" : "value_color", "white")
+                        << fixed << setprecision(2) << conn.retransPercent() << r
+                        << getColor("connections", "%", "white") << "%" << r
+                        << getColor("connections", "unit_color", "white") << " of " << conn.outSegments << " sent" << r;
+
+                    const pair<const char*, int64_t> counters[] = {
+                        { "out-of-order ", conn.outOfOrder }, { "listen drops ", conn.listenDrops },
+                        { "timeouts ", conn.timeouts }, { "in errors ", conn.inErrors } };
+                    for (const auto& c : counters) {
+                        if (c.second < 0) continue;
+                        ss << getColor("connections", "|", "white") << " | " << r
+                            << getColor("connections", "label_color", "white") << c.first << r
+                            << getColor("connections", "value_color", "white") << c.second << r;
+                    }
+                    lp.push(ss.str());
+                }
+            }
+
        
         
             // Network Info (Compact + Extra) (dummy)
@@ -1684,6 +2639,16 @@ int main(){
                 lp.push(ss.str());
             }
 
+            // Core Types (hybrid CPUs only)
+            if (isSubEnabled("cpu_info", "show_core_types") && !cpu.get_cpu_core_types().empty()) {
+                ostringstream ss;
+                ss << getColor("cpu_info", "~", "white") << "~ " << r
+                    << getColor("cpu_info", "core_types_label_color", "white") << "Core Types                " << r
+                    << getColor("cpu_info", ":", "white") << ": " << r
+                    << getColor("cpu_info", "core_types_value_color", "white") << cpu.get_cpu_core_types() << r;
+                lp.push(ss.str());
+            }
+
             // Logical Processors
             if (isSubEnabled("cpu_info", "show_logical_processors")) {
                 ostringstream ss;
@@ -1743,6 +2708,16 @@ int main(){
                     << getColor("cpu_info", "l3_cache_value_color", "white") << cpu.get_cpu_l3_cache() << r;
                 lp.push(ss.str());
             }
+
+            // Instruction Sets
+            if (isSubEnabled("cpu_info", "show_instruction_sets")) {
+                ostringstream ss;
+                ss << getColor("cpu_info", "~", "white") << "~ " << r
+                    << getColor("cpu_info", "instruction_sets_label_color", "white") << "Instruction Sets          " << r
+                    << getColor("cpu_info", ":", "white") << ": " << r
+                    << getColor("cpu_info", "instruction_sets_value_color", "white") << cpu.get_cpu_instruction_sets() << r;
+                lp.push(ss.str());
+            }
         }
 
         //end of the CPU info section////////////////////////////////////////////////
@@ -2025,6 +3000,79 @@ int main(){
                     lp.push(ss.str());
                 }
 
+                // ---------- Max Refresh (EDID) ----------
+                if (isSubEnabled("display_info", "show_max_refresh") && s.max_refresh_rate > 0) {
+                    ostringstream ss;
+                    ss << getColor("display_info", "|->", "cyan") << "|-> " << r
+                        << getColor("display_info", "max_refresh_label_color", "blue")
+                        << "Max Refresh            " << r
+                        << getColor("display_info", ":", "blue") << ": " << r
+                        << getColor("display_info", "max_refresh_value_color", "cyan")
+                        << s.max_refresh_rate
+                        << getColor("display_info", "hz_color", "red") << "Hz" << r;
+                    lp.push(ss.str());
+                }
+
+                // ---------- VRR Range (EDID) ----------
+                // A plain range-limits descriptor is only a refresh range, not VRR
+                if (isSubEnabled("display_info", "show_vrr")) {
+                    bool vrr = s.vrr_max > 0;
+                    ostringstream ss;
+                    ss << getColor("display_info", "|->", "cyan") << "|-> " << r
+                        << getColor("display_info", "vrr_label_color", "blue")
+                        << (vrr || s.range_max == 0 ? "VRR Range              " : "Refresh Range          ") << r
+                        << getColor("display_info", ":", "blue") << ": " << r
+                        << getColor("display_info", "vrr_value_color", "cyan");
+                    if (vrr || s.range_max > 0) {
+                        ss << (vrr ? s.vrr_min : s.range_min) << "-" << (vrr ? s.vrr_max : s.range_max)
+                            << getColor("display_info", "hz_color", "red") << "Hz" << r;
+                    }
+                    else {
+                        ss << "Not advertised" << r;
+                    }
+                    lp.push(ss.str());
+                }
+
+                // ---------- HDR (EDID) ----------
+                if (isSubEnabled("display_info", "show_hdr")) {
+                    ostringstream ss;
+                    ss << getColor("display_info", "|->", "cyan") << "|-> " << r
+                        << getColor("display_info", "hdr_label_color", "blue")
+                        << "HDR                    " << r
+                        << getColor("display_info", ":", "blue") << ": " << r
+                        << getColor("display_info", "hdr_value_color", "cyan")
+                        << (s.hdr_supported ? "Supported" : "Not supported") << r;
+                    if (s.hdr_supported && !s.hdr_formats.empty()) {
+                        ss << getColor("display_info", "dsr_brackets_color", "blue") << " (" << r
+                            << getColor("display_info", "hdr_value_color", "cyan") << s.hdr_formats << r
+                            << getColor("display_info", "dsr_brackets_color", "blue") << ")" << r;
+                    }
+                    lp.push(ss.str());
+                }
+
+                // ---------- Serial / Manufacture date (EDID) ----------
+                if (isOptIn("display_info", "show_serial") && !s.serial.empty()) {
+                    lp.push(
+                        getColor("display_info", "|->", "cyan") + "|-> " + r +
+                        getColor("display_info", "serial_label_color", "blue")
+                        + "Serial                 " + r +
+                        getColor("display_info", ":", "blue") + ": " + r +
+                        getColor("display_info", "serial_value_color", "cyan")
+                        + s.serial + r
+                    );
+                }
+
+                if (isOptIn("display_info", "show_manufacture_date") && !s.manufacture_date.empty()) {
+                    lp.push(
+                        getColor("display_info", "|->", "cyan") + "|-> " + r +
+                        getColor("display_info", "manufacture_label_color", "blue")
+                        + "Manufactured           " + r +
+                        getColor("display_info", ":", "blue") + ": " + r +
+                        getColor("display_info", "manufacture_value_color", "cyan")
+                        + s.manufacture_date + r
+                    );
+                }
+
                 lp.push("");
             }
         }
@@ -2218,6 +3266,251 @@ int main(){
 
 		// end of the Performance info section////////////////////////////////////////
 
+        // Core Activity (per-core load and clock heatmap, one row per socket)
+        if (isOptIn("core_activity")) {
+            lp.push("");
+            const json& ca = config["core_activity"];
+
+            // Header
+            if (isSubEnabled("core_activity", "show_header")) {
+                ostringstream ss;
+                ss << getColor("core_activity", "#-", "white") << "#- " << r
+                    << getColor("core_activity", "header_text_color", "white") << "Core Activity " << r
+                    << getColor("core_activity", "separator_line", "white")
+                    << "--------------------------------------------------#" << r;
+                lp.push(ss.str());
+            }
+
+            vector<CoreActivityStats> cores = core_activity.sample(sampling_interval_ms);
+            int cells_per_row = ca.value("cells_per_row", 64);
+            if (cells_per_row < 8) cells_per_row = 8;
+            double warm = ca.value("warm_threshold", 50.0);
+            double hot = ca.value("hot_threshold", 85.0);
+
+            // One cell per logical processor: '.' under 10%, 1-9 per tenth, '#' from 95%
+            auto cell = [&](double percent) {
+                string color = percent >= hot ? getColor("core_activity", "hot_color", "red")
+                    : percent >= warm ? getColor("core_activity", "warm_color", "yellow")
+                    : getColor("core_activity", "cool_color", "green");
+                char glyph = percent >= 95.0 ? '#' : percent < 10.0 ? '.' : static_cast<char>('0' + static_cast<int>(percent / 10.0));
+                return color + glyph + r;
+            };
+
+            // Label column, then the cells wrapped at cells_per_row
+            auto heat_rows = [&](const string& label, const vector<double>& percents, const string& tail) {
+                for (size_t start = 0; start < percents.size(); start += cells_per_row) {
+                    ostringstream ss;
+                    ss << getColor("core_activity", "~", "white") << "~ " << r
+                        << getColor("core_activity", "label_color", "white") << left << setw(15) << (start == 0 ? label : "") << right << r
+                        << getColor("core_activity", ":", "white") << ": " << r;
+                    for (size_t i = start; i < percents.size() && i < start + cells_per_row; i++) ss << cell(percents[i]);
+                    if (start + cells_per_row >= percents.size()) ss << " " << tail;
+                    lp.push(ss.str());
+                }
+            };
+
+            double top_mhz = 0.0;
+            for (const auto& c : cores) {
+                if (c.mhz > top_mhz) top_mhz = c.mhz;
+            }
+
+            size_t begin_at = 0;
+            while (begin_at < cores.size()) {
+                size_t end_at = begin_at;
+                while (end_at < cores.size() && cores[end_at].package == cores[begin_at].package) end_at++;
+
+                vector<double> load, clock;
+                double load_sum = 0.0, mhz_sum = 0.0;
+                int mhz_count = 0;
+                for (size_t i = begin_at; i < end_at; i++) {
+                    load.push_back(cores[i].utilization);
+                    load_sum += cores[i].utilization;
+                    // Clock cells are relative to the fastest processor on the host
+                    clock.push_back(top_mhz > 0.0 ? 100.0 * cores[i].mhz / top_mhz : 0.0);
+                    if (cores[i].mhz > 0.0) {
+                        mhz_sum += cores[i].mhz;
+                        mhz_count++;
+                    }
+                }
+                string socket = "Socket " + to_string(cores[begin_at].package);
+
+                if (isSubEnabled("core_activity", "show_load")) {
+                    ostringstream tail;
+                    tail << getColor("core_activity", "value_color", "white") << fixed << setprecision(0)
+                        << load_sum / load.size() << r
+                        << getColor("core_activity", "%", "white") << "%" << r;
+                    heat_rows(socket + " load", load, tail.str());
+                }
+                if (isSubEnabled("core_activity", "show_clock") && mhz_count > 0) {
+                    ostringstream tail;
+                    tail << getColor("core_activity", "value_color", "white") << fixed << setprecision(2)
+                        << mhz_sum / mhz_count / 1000.0 << r
+                        << getColor("core_activity", "unit_color", "white") << " GHz" << r;
+                    heat_rows(socket + " clock", clock, tail.str());
+                }
+                begin_at = end_at;
+            }
+
+            // Busiest / idlest processor and the clock range behind the cells
+            if (isSubEnabled("core_activity", "show_summary") && !cores.empty()) {
+                auto busiest = max_element(cores.begin(), cores.end(),
+                    [](const CoreActivityStats& a, const CoreActivityStats& b) { return a.utilization < b.utilization; });
+                auto idlest = min_element(cores.begin(), cores.end(),
+                    [](const CoreActivityStats& a, const CoreActivityStats& b) { return a.utilization < b.utilization; });
+
+                ostringstream ss;
+                ss << getColor("core_activity", "~", "white") << "~ " << r
+                    << getColor("core_activity", "label_color", "white") << left << setw(15) << "Spread" << right << r
+                    << getColor("core_activity", ":", "white") << ": " << r
+                    << getColor("core_activity", "value_color", "white") << fixed << setprecision(0)
+                    << idlest->utilization << "-" << busiest->utilization << r
+                    << getColor("core_activity", "%", "white") << "% " << r
+                    << getColor("core_activity", "unit_color", "white") << "(busiest cpu" << busiest->cpu << ")" << r;
+
+                double low_mhz = 0.0;
+                for (const auto& c : cores) {
+                    if (c.mhz > 0.0 && (low_mhz == 0.0 || c.mhz < low_mhz)) low_mhz = c.mhz;
+                }
+                if (top_mhz > 0.0) {
+                    ss << " " << getColor("core_activity", "|", "white") << "| " << r
+                        << getColor("core_activity", "value_color", "white") << fixed << setprecision(2)
+                        << low_mhz / 1000.0 << "-" << top_mhz / 1000.0 << r
+                        << getColor("core_activity", "unit_color", "white") << " GHz (" << core_activity.clockSource() << ")" << r;
+                }
+                lp.push(ss.str());
+            }
+        }
+
+        // CPU Counters (IPC and miss rates over the sampling window)
+        if (isOptIn("cpu_counters")) {
+            lp.push("");
+
+            // Header
+            if (isSubEnabled("cpu_counters", "show_header")) {
+                ostringstream ss;
+                ss << getColor("cpu_counters", "#-", "white") << "#- " << r
+                    << getColor("cpu_counters", "header_text_color", "white") << "CPU Counters " << r
+                    << getColor("cpu_counters", "separator_line", "white")
+                    << "---------------------------------------------------#" << r;
+                lp.push(ss.str());
+            }
+
+            vector<CpuCounterStats> counters = cpu_counters.sample(sampling_interval_ms);
+            if (!config["cpu_counters"].value("per_cpu", false)) counters = CpuCounters::bySocket(counters);
+
+            auto label = [&](const string& text) {
+                ostringstream tmp;
+                tmp << getColor("cpu_counters", "~", "white") << "~ " << r
+                    << getColor("cpu_counters", "label_color", "white") << left << setw(12) << text << right << r
+                    << getColor("cpu_counters", ":", "white") << ": " << r;
+                return tmp.str();
+                };
+
+            // Kernel refused or no PMU: say why instead of printing zeros
+            if (!cpu_counters.error().empty()) {
+                ostringstream ss;
+                ss << label("Unavailable")
+                    << getColor("cpu_counters", "error_color", "white") << cpu_counters.error() << r;
+                lp.push(ss.str());
+            }
+            // Counted, but only part of the group fit on the PMU
+            if (!cpu_counters.note().empty()) {
+                ostringstream ss;
+                ss << label("Note")
+                    << getColor("cpu_counters", "error_color", "white") << cpu_counters.note() << r;
+                lp.push(ss.str());
+            }
+
+            for (const auto& c : counters) {
+                ostringstream ss;
+                ss << label(c.name);
+
+                if (isSubEnabled("cpu_counters", "show_ipc")) {
+                    ss << getColor("cpu_counters", "unit_color", "white") << "IPC " << r
+                        << getColor("cpu_counters", "value_color", "white") << fixed << setprecision(2) << c.ipc() << r << " ";
+                }
+                if (isSubEnabled("cpu_counters", "show_cache_misses") && c.cacheMpki() >= 0) {
+                    ss << getColor("cpu_counters", "|", "white") << "| " << r
+                        << getColor("cpu_counters", "unit_color", "white") << "cache miss " << r
+                        << getColor("cpu_counters", "value_color", "white") << fixed << setprecision(1) << c.cacheMpki() << r
+                        << getColor("cpu_counters", "unit_color", "white") << " MPKI " << r;
+                }
+                if (isSubEnabled("cpu_counters", "show_branch_misses") && c.branchMissPercent() >= 0) {
+                    ss << getColor("cpu_counters", "|", "white") << "| " << r
+                        << getColor("cpu_counters", "unit_color", "white") << "branch miss " << r
+                        << getColor("cpu_counters", "value_color", "white") << fixed << setprecision(2) << c.branchMissPercent() << r
+                        << getColor("cpu_counters", "%", "white") << "% " << r;
+                }
+                if (isSubEnabled("cpu_counters", "show_stalls") && c.stallPercent() >= 0) {
+                    ss << getColor("cpu_counters", "|", "white") << "| " << r
+                        << getColor("cpu_counters", "unit_color", "white") << "stalled " << r
+                        << getColor("cpu_counters", "value_color", "white") << fixed << setprecision(0) << c.stallPercent() << r
+                        << getColor("cpu_counters", "%", "white") << "%" << r;
+                }
+                lp.push(ss.str());
+            }
+        }
+
+        // Disk Activity (live I/O rates over the sampling window)
+        if (isOptIn("disk_activity")) {
+            lp.push("");
+
+            // Header
+            if (isSubEnabled("disk_activity", "show_header")) {
+                ostringstream ss;
+                ss << getColor("disk_activity", "#-", "white") << "#- " << r
+                    << getColor("disk_activity", "header_text_color", "white") << "Disk Activity " << r
+                    << getColor("disk_activity", "separator_line", "white")
+                    << "--------------------------------------------------#" << r;
+                lp.push(ss.str());
+            }
+
+            auto mbps = [](double bytes) {
+                ostringstream tmp;
+                tmp << fixed << setprecision(1) << setw(7) << bytes / 1e6;
+                return tmp.str();
+                };
+
+            for (const auto& d : disk_activity_window.get()) {
+                ostringstream ss;
+                ss << getColor("disk_activity", "~", "white") << "~ " << r
+                    << getColor("disk_activity", "device_color", "white") << left << setw(12) << d.device << right << r
+                    << getColor("disk_activity", ":", "white") << ": " << r;
+
+                if (isSubEnabled("disk_activity", "show_throughput")) {
+                    ss << getColor("disk_activity", "label_color", "white") << "R" << r
+                        << getColor("disk_activity", "throughput_color", "white") << mbps(d.readBytesPerSec) << r
+                        << getColor("disk_activity", "unit_color", "white") << " MB/s " << r
+                        << getColor("disk_activity", "label_color", "white") << "W" << r
+                        << getColor("disk_activity", "throughput_color", "white") << mbps(d.writeBytesPerSec) << r
+                        << getColor("disk_activity", "unit_color", "white") << " MB/s " << r;
+                }
+                if (isSubEnabled("disk_activity", "show_iops")) {
+                    ss << getColor("disk_activity", "|", "white") << "| " << r
+                        << getColor("disk_activity", "iops_color", "white") << fixed << setprecision(0)
+                        << d.readIops << "/" << d.writeIops << r
+                        << getColor("disk_activity", "unit_color", "white") << " IOPS " << r;
+                }
+                if (isSubEnabled("disk_activity", "show_latency")) {
+                    ss << getColor("disk_activity", "|", "white") << "| " << r
+                        << getColor("disk_activity", "latency_color", "white") << fixed << setprecision(2) << d.avgLatencyMs << r
+                        << getColor("disk_activity", "unit_color", "white") << " ms " << r;
+                }
+                if (isSubEnabled("disk_activity", "show_queue_depth")) {
+                    ss << getColor("disk_activity", "|", "white") << "| " << r
+                        << getColor("disk_activity", "label_color", "white") << "QD " << r
+                        << getColor("disk_activity", "queue_color", "white") << fixed << setprecision(2) << d.queueDepth << r << " ";
+                }
+                if (isSubEnabled("disk_activity", "show_utilization")) {
+                    ss << getColor("disk_activity", "|", "white") << "| " << r
+                        << getColor("disk_activity", "utilization_color", "white") << fixed << setprecision(0) << d.utilization << r
+                        << getColor("disk_activity", "%", "white") << "%" << r;
+                }
+
+                lp.push(ss.str());
+            }
+        }
+
  
         // Audio & Power Info (JSON Driven)
         if (isEnabled("audio_power_info")) {
@@ -2371,8 +3664,26 @@ int main(){
 
     cout << endl;
 
+    NetIdentityCache::save();
 
+    // Flush the snapshot when --record was given (no-op otherwise)
+    if (!Probe::end()) {
+        cout << "Failed to write snapshot" << endl;
+    }
+
+
+
+
+    // A replay that had to read the live machine is not a faithful replay;
+    // say which sources did, and fail so scripted comparisons notice
+    vector<string> unrouted = Probe::unroutedSources();
+    if (!unrouted.empty()) {
+        cerr << "Replay not hermetic: these sources were read live, not from the snapshot:" << endl;
+        for (const auto& source : unrouted) cerr << "  " << source << endl;
+    }
 
+    // Release the shared WMI connections before COM goes away
+    WMIQuery::shutdown();
 
     // End of CoUninitialize 
     CoUninitialize(); 
@@ -2381,7 +3692,7 @@ int main(){
     // state. Should be called once for every successful CoInitialize() 
     // or CoInitializeEx() call to avoid memory/resource leaks.
 
-    return 0;
+    return unrouted.empty() ? 0 : 3;
 }
 
 
@@ -2633,7 +3944,7 @@ IX. KEY DATA STRUCTURES:
 
 A. storage_data (StorageInfo.h):
    - drive_letter, total_space, used_space, used_percentage
-   - file_system, is_external, serial_number
+   - file_system, is_external, serial_number, health (DiskHealthData)
    - read_speed, write_speed, predicted_read/write_speed
    - storage_type
 
@@ -2753,6 +4064,8 @@ FUNCTIONS:
 9. get_cpu_l1_cache() - Returns L1 cache size
 10. get_cpu_l2_cache() - Returns L2 cache size
 11. get_cpu_l3_cache() - Returns L3 cache size
+12. get_cpu_core_types() - Returns hybrid P/E core split ("" if not hybrid)
+13. get_cpu_instruction_sets() - Returns SSE4.2/AVX/AVX2/AVX-512/AMX support
 
 CLASS: MemoryInfo
 OBJECT: ram
@@ -2796,7 +4109,8 @@ STRUCT: storage_data (passed to callback)
 - used_percentage - Usage percentage
 - file_system - File system type
 - is_external - Boolean for external/internal
-- serial_number - Disk serial number
+- serial_number - Disk serial number (device descriptor, "---" when missing)
+- health - Model, firmware, temperature, wear, media errors, throttling
 - read_speed - Read speed in MB/s
 - write_speed - Write speed in MB/s
 - predicted_read_speed - Predicted read speed
@@ -0,0 +1,228 @@
+#include "include\CPUTopology.h"
+#include "Check.h"
+
+#include <map>
+#include <set>
+#include <tuple>
+#include <cstdlib>
+
+/*
+    Each fixture is a "cpuid:dump" value (cpuid.json) next to the Linux
+    sysfs files for the same processors: cpuN/topology/ and every
+    cpuN/cache/indexM/ directory. The decoded topology has to agree with
+    what the kernel derived from the same CPUID leaves.
+*/
+
+struct SysCache {
+    int level = 0;
+    char type = 'U';
+    uint64_t sizeBytes = 0;
+    int ways = 0;
+    int lineSize = 0;
+    set<int> shared;
+};
+
+static string sysValue(const string& path)
+{
+    string s = readFile(path);
+    while (!s.empty() && isspace(static_cast<unsigned char>(s.back()))) s.pop_back();
+    return s;
+}
+
+// "0-3,8,10-11"
+static set<int> cpuList(const string& text)
+{
+    set<int> cpus;
+    stringstream in(text);
+    string range;
+    while (getline(in, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        int first = atoi(range.c_str());
+        int last = dash == string::npos ? first : atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; cpu++) cpus.insert(cpu);
+    }
+    return cpus;
+}
+
+// "48K", "2048K", "12M"
+static uint64_t cacheSize(const string& text)
+{
+    uint64_t n = strtoull(text.c_str(), nullptr, 10);
+    if (text.find('K') != string::npos) n <<= 10;
+    if (text.find('M') != string::npos) n <<= 20;
+    return n;
+}
+
+static vector<SysCache> sysCaches(const string& cpuDir)
+{
+    vector<SysCache> caches;
+    for (const auto& index : listDir(cpuDir + "/cache")) {
+        if (index.compare(0, 5, "index") != 0) continue;
+        string dir = cpuDir + "/cache/" + index + "/";
+        SysCache c;
+        c.level = atoi(sysValue(dir + "level").c_str());
+        string type = sysValue(dir + "type");
+        c.type = type == "Data" ? 'D' : type == "Instruction" ? 'I' : 'U';
+        c.sizeBytes = cacheSize(sysValue(dir + "size"));
+        c.ways = atoi(sysValue(dir + "ways_of_associativity").c_str());
+        c.lineSize = atoi(sysValue(dir + "coherency_line_size").c_str());
+        c.shared = cpuList(sysValue(dir + "shared_cpu_list"));
+        caches.push_back(c);
+    }
+    return caches;
+}
+
+// Packages, cores and every cache line of the decoded topology against the
+// sysfs tree under sysDir. Only the processors in the dump count: a live run
+// may have been restricted to part of the machine.
+static void crossCheck(const CPUTopology& t, const string& sysDir)
+{
+    set<int> present;
+    for (const auto& p : t.processors) present.insert(p.os);
+
+    map<int, string> package;
+    map<int, set<int>> siblings;
+    for (int os : present) {
+        string dir = sysDir + "/cpu" + to_string(os) + "/topology/";
+        package[os] = sysValue(dir + "physical_package_id");
+        set<int> all = cpuList(sysValue(dir + "thread_siblings_list"));
+        for (int cpu : all) if (present.count(cpu)) siblings[os].insert(cpu);
+    }
+
+    // Same partitions: the kernel numbers packages and cores its own way
+    for (const auto& a : t.processors) {
+        for (const auto& b : t.processors) {
+            bool samePackage = a.package == b.package;
+            bool sameCore = samePackage && a.core == b.core;
+            CHECK_EQ(samePackage, package[a.os] == package[b.os]);
+            CHECK_EQ(sameCore, siblings[a.os].count(b.os) == 1);
+        }
+    }
+
+    // One instance per distinct sharing set, grouped like decode() groups them
+    map<tuple<int, char, set<int>>, SysCache> instances;
+    for (int os : present) {
+        for (auto c : sysCaches(sysDir + "/cpu" + to_string(os))) {
+            set<int> shared;
+            for (int cpu : c.shared) if (present.count(cpu)) shared.insert(cpu);
+            c.shared = shared;
+            instances[make_tuple(c.level, c.type, shared)] = c;
+        }
+    }
+    map<tuple<int, int, uint64_t, int>, CpuCache> grouped;
+    const string typeOrder = "DIU";
+    for (const auto& kv : instances) {
+        const SysCache& s = kv.second;
+        int sharedBy = static_cast<int>(s.shared.size());
+        auto key = make_tuple(s.level, static_cast<int>(typeOrder.find(s.type)), s.sizeBytes, sharedBy);
+        CpuCache& g = grouped[key];
+        if (g.instances == 0) {
+            g.level = s.level;
+            g.type = s.type;
+            g.sizeBytes = s.sizeBytes;
+            g.ways = s.ways;
+            g.lineSize = s.lineSize;
+            g.sharedBy = sharedBy;
+        }
+        g.instances++;
+    }
+
+    CHECK_EQ(t.caches.size(), grouped.size());
+    auto expected = grouped.begin();
+    for (size_t i = 0; i < t.caches.size() && expected != grouped.end(); i++, ++expected) {
+        const CpuCache& c = t.caches[i];
+        const CpuCache& e = expected->second;
+        CHECK_EQ(c.level, e.level);
+        CHECK_EQ(c.type, e.type);
+        CHECK_EQ(c.sizeBytes, e.sizeBytes);
+        CHECK_EQ(c.ways, e.ways);
+        CHECK_EQ(c.lineSize, e.lineSize);
+        CHECK_EQ(c.sharedBy, e.sharedBy);
+        CHECK_EQ(c.instances, e.instances);
+    }
+}
+
+static CPUTopology load(const string& name)
+{
+    CPUTopology t = CPUTopology::decode(readFile(fixture("cputopology/" + name + "/cpuid.json")));
+    crossCheck(t, fixture("cputopology/" + name));
+    return t;
+}
+
+static void xeonVm()
+{
+    // Recorded on a one-vCPU KVM guest (leaf 0x1F, Sapphire Rapids cache leaves)
+    CPUTopology t = load("xeon_vm");
+    CHECK(t.ok);
+    CHECK_EQ(t.vendor, string("GenuineIntel"));
+    CHECK_EQ(t.brand, string("Intel(R) Xeon(R) Processor"));
+    CHECK_EQ(t.packages, 1);
+    CHECK_EQ(t.cores, 1);
+    CHECK_EQ(t.logical, 1);
+    CHECK_EQ(t.performanceCores, 0);
+    CHECK(t.features.hypervisor);
+    CHECK_EQ(t.cacheBytes(1), uint64_t(80) << 10);
+    CHECK_EQ(t.cacheBytes(3), uint64_t(105) << 20);
+}
+
+static void hybrid()
+{
+    // 2 P-cores with HT + a 4-core E cluster sharing one L2 (i3-1215U layout)
+    CPUTopology t = load("hybrid_2p4e");
+    CHECK(t.ok);
+    CHECK_EQ(t.brand, string("12th Gen Intel(R) Core(TM) i3-1215U"));
+    CHECK_EQ(t.packages, 1);
+    CHECK_EQ(t.cores, 6);
+    CHECK_EQ(t.logical, 8);
+    CHECK_EQ(t.performanceCores, 2);
+    CHECK_EQ(t.efficientCores, 4);
+    CHECK_EQ(t.cacheBytes(2), uint64_t(2 * 1280 + 2048) << 10);
+    CHECK_EQ(t.cacheBytes(3), uint64_t(10) << 20);
+    CHECK(t.features.avx2);
+    CHECK(!t.features.avx512f);
+    CHECK(t.pinOrder() == vector<int>({ 0, 2, 4, 5, 6, 7, 1, 3 }));
+}
+
+static void legacyAmd()
+{
+    // No leaf 0xB: widths from leaf 1 / 0x80000008 / 0x8000001E, caches from 0x8000001D
+    CPUTopology t = load("ryzen_4c8t");
+    CHECK(t.ok);
+    CHECK_EQ(t.vendor, string("AuthenticAMD"));
+    CHECK_EQ(t.cores, 4);
+    CHECK_EQ(t.logical, 8);
+    CHECK_EQ(t.cacheBytes(2), uint64_t(2) << 20);
+    CHECK_EQ(t.cacheBytes(3), uint64_t(16) << 20);
+    CHECK(t.features.svm);
+    CHECK(t.pinOrder() == vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+}
+
+static void garbage()
+{
+    CHECK(!CPUTopology::decode("").ok);
+    CHECK(!CPUTopology::decode("{\"cpus\":[]}").ok);
+    CHECK(!CPUTopology::decode("not json").ok);
+}
+
+static void live()
+{
+    // This machine against its own sysfs, where both exist
+    const string sys = "/sys/devices/system/cpu";
+    const CPUTopology& t = CPUTopology::get();
+    if (!t.ok || sysValue(sys + "/cpu0/cache/index0/level").empty()) {
+        cout << "live: skipped (no CPUID or no sysfs cache info)\n";
+        return;
+    }
+    crossCheck(t, sys);
+}
+
+int main()
+{
+    xeonVm();
+    hybrid();
+    legacyAmd();
+    garbage();
+    live();
+    return finish();
+}
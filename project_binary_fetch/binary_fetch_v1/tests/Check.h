@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <dirent.h>
+using namespace std;
+
+/*
+    Check — the few assertions the test executables need
+
+    A failed CHECK prints where and what, and the test keeps going so one
+    run shows every broken expectation. main() ends with `return finish();`,
+    which prints the tally and makes ctest see the failure count.
+
+    FIXTURES is the tests/fixtures directory (set by CMakeLists.txt).
+*/
+
+inline int& checkFailures() { static int failures = 0; return failures; }
+inline int& checkCount() { static int count = 0; return count; }
+
+#define CHECK(cond) do { \
+        checkCount()++; \
+        if (!(cond)) { checkFailures()++; cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+        checkCount()++; \
+        auto a_ = (actual); auto e_ = (expected); \
+        if (!(a_ == e_)) { \
+            checkFailures()++; \
+            cerr << __FILE__ << ":" << __LINE__ << ": " #actual " == " << a_ << ", expected " << e_ << "\n"; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do { \
+        checkCount()++; \
+        double a_ = (actual), e_ = (expected); \
+        if (!(fabs(a_ - e_) <= (tolerance))) { \
+            checkFailures()++; \
+            cerr << __FILE__ << ":" << __LINE__ << ": " #actual " == " << a_ << ", expected " << e_ << " +- " << (tolerance) << "\n"; \
+        } \
+    } while (0)
+
+inline int finish()
+{
+    cout << checkCount() - checkFailures() << "/" << checkCount() << " checks passed\n";
+    return checkFailures() == 0 ? 0 : 1;
+}
+
+// Whole file, "" if missing
+inline string readFile(const string& path)
+{
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+inline string fixture(const string& relative) { return string(FIXTURES) + "/" + relative; }
+
+// Sorted file names in a directory (no . entries)
+inline vector<string> listDir(const string& path)
+{
+    vector<string> names;
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+    sort(names.begin(), names.end());
+    return names;
+}
@@ -0,0 +1,96 @@
+#include "include\ConnectionInfo.h"
+#include "Check.h"
+
+static uint64_t count(const ConnectionStats& s, const string& state)
+{
+    for (const auto& kv : s.states) {
+        if (kv.first == state) return kv.second;
+    }
+    return ~0ULL;
+}
+
+static void procTcp()
+{
+    ConnectionStats s = ConnectionInfo::parseProcTcp(readFile(fixture("connections/tcp")), readFile(fixture("connections/tcp6")));
+    CHECK(s.ok);
+    CHECK_EQ(s.source, string("/proc/net/tcp"));
+    CHECK_EQ(s.states.size(), size_t(11));              // every state, zeros kept
+    CHECK_EQ(count(s, "ESTABLISHED"), uint64_t(3));
+    CHECK_EQ(count(s, "SYN_SENT"), uint64_t(1));
+    CHECK_EQ(count(s, "TIME_WAIT"), uint64_t(1));
+    CHECK_EQ(count(s, "CLOSE_WAIT"), uint64_t(1));
+    CHECK_EQ(count(s, "LISTEN"), uint64_t(4));
+    CHECK_EQ(count(s, "CLOSING"), uint64_t(0));
+    CHECK_EQ(s.total, uint64_t(10));                    // the garbage row isn't counted
+
+    // Port 22 listens on both families: once in the list, sorted
+    CHECK_EQ(s.listeningPorts.size(), size_t(3));
+    if (s.listeningPorts.size() == 3) {
+        CHECK_EQ(s.listeningPorts[0], 22);
+        CHECK_EQ(s.listeningPorts[1], 631);
+        CHECK_EQ(s.listeningPorts[2], 8080);
+    }
+    CHECK_EQ(s.outSegments, int64_t(-1));
+
+    // No IPv6 table (ipv6.disable=1) still gives the v4 half
+    ConnectionStats v4 = ConnectionInfo::parseProcTcp(readFile(fixture("connections/tcp")), "");
+    CHECK_EQ(v4.total, uint64_t(6));
+    CHECK_EQ(v4.listeningPorts.size(), size_t(2));
+
+    // Header only: ok with nothing in it
+    ConnectionStats empty = ConnectionInfo::parseProcTcp("  sl  local_address rem_address   st\n", "");
+    CHECK(empty.ok);
+    CHECK_EQ(empty.total, uint64_t(0));
+    CHECK(empty.listeningPorts.empty());
+}
+
+static void snmp()
+{
+    auto tcp = ConnectionInfo::parseSnmp(readFile(fixture("connections/snmp")), "Tcp");
+    CHECK_EQ(tcp.size(), size_t(15));
+    CHECK_EQ(tcp["OutSegs"], int64_t(7960612));
+    CHECK_EQ(tcp["RetransSegs"], int64_t(5673));
+    CHECK_EQ(tcp["InErrs"], int64_t(12));
+    CHECK_EQ(tcp["MaxConn"], int64_t(-1));
+    CHECK(tcp.find("InDatagrams") == tcp.end());        // Udp: is another prefix
+
+    // "TcpExt:" isn't "Tcp:", and the other way round
+    auto ext = ConnectionInfo::parseSnmp(readFile(fixture("connections/netstat")), "TcpExt");
+    CHECK_EQ(ext["ListenOverflows"], int64_t(17));
+    CHECK_EQ(ext["ListenDrops"], int64_t(19));
+    CHECK_EQ(ext["TCPTimeouts"], int64_t(341));
+    CHECK_EQ(ext["TCPOFOQueue"], int64_t(2907));
+    CHECK(ConnectionInfo::parseSnmp(readFile(fixture("connections/netstat")), "Tcp").empty());
+    CHECK(ConnectionInfo::parseSnmp(readFile(fixture("connections/snmp")), "TcpExt").empty());
+
+    // A short value line fills what it has; a header without values gives nothing
+    auto shortLine = ConnectionInfo::parseSnmp("Tcp: A B C\nTcp: 1 2\n", "Tcp");
+    CHECK_EQ(shortLine.size(), size_t(2));
+    CHECK_EQ(shortLine["B"], int64_t(2));
+    CHECK(ConnectionInfo::parseSnmp("Tcp: A B C\n", "Tcp").empty());
+    CHECK(ConnectionInfo::parseSnmp("", "Tcp").empty());
+
+    // No trailing newline, CRLF
+    auto crlf = ConnectionInfo::parseSnmp("Tcp: A B\r\nTcp: 5 6", "Tcp");
+    CHECK_EQ(crlf["A"], int64_t(5));
+    CHECK_EQ(crlf["B"], int64_t(6));
+}
+
+static void retransPercent()
+{
+    ConnectionStats s;
+    CHECK_EQ(s.retransPercent(), 0.0);
+    s.outSegments = 2000;
+    s.retransSegments = 30;
+    CHECK_NEAR(s.retransPercent(), 1.5, 1e-12);
+    s.outSegments = 0;
+    CHECK_EQ(s.retransPercent(), 0.0);
+}
+
+int main()
+{
+    procTcp();
+    snmp();
+    retransPercent();
+    return finish();
+}
@@ -0,0 +1,99 @@
+#include "include\CoreActivity.h"
+#include "Check.h"
+
+#include <map>
+#include <limits>
+
+static map<int, double> busy(const string& before, const string& after)
+{
+    map<int, double> out;
+    for (const auto& b : CoreActivity::diffStat(before, after)) out[b.first] = b.second;
+    return out;
+}
+
+static void utilization()
+{
+    //         user nice system idle iowait irq softirq steal guest guest_nice
+    string before =
+        "cpu  400 0 100 4000 100 0 0 0 0 0\n"
+        "cpu0 100 0 50 1000 50 0 0 0 0 0\n"
+        "cpu1 100 0 0 1000 0 0 0 0 0 0\n";
+    string after =
+        "cpu  900 0 200 4800 100 0 0 0 0 0\n"
+        "cpu0 400 0 100 1150 50 0 0 0 300 0\n"     // guest is already in user
+        "cpu1 100 0 0 1400 0 0 0 0 0 0\n";
+    map<int, double> b = busy(before, after);
+    CHECK_EQ(b.size(), size_t(2));                  // the aggregate line is skipped
+    CHECK_NEAR(b[0], 100.0 * 350 / 500, 1e-9);
+    CHECK_NEAR(b[1], 0.0, 1e-9);
+
+    // Old kernels: only user nice system idle
+    b = busy("cpu0 10 0 10 80\n", "cpu0 30 0 10 140\n");
+    CHECK_NEAR(b[0], 25.0, 1e-9);
+}
+
+static void iowaitBackwards()
+{
+    // iowait drops by 500 while 100 ticks of user time pass: the drop is
+    // no time, not negative idle and not a shrunken total
+    map<int, double> b = busy("cpu0 100 0 0 1000 500 0 0 0\n", "cpu0 200 0 0 1010 0 0 0 0\n");
+    CHECK_NEAR(b[0], 100.0 * 100 / 110, 1e-9);
+
+    // Smaller drop, same rule
+    b = busy("cpu0 100 0 0 1000 50 0 0 0\n", "cpu0 200 0 0 1100 40 0 0 0\n");
+    CHECK_NEAR(b[0], 50.0, 1e-9);
+    for (const auto& kv : b) CHECK(kv.second >= 0.0 && kv.second <= 100.0);
+}
+
+static void hotplug()
+{
+    // cpu2 came online, cpu1 went offline in between: neither has a delta
+    map<int, double> b = busy(
+        "cpu0 100 0 0 100 0 0 0 0\ncpu1 100 0 0 100 0 0 0 0\n",
+        "cpu0 200 0 0 200 0 0 0 0\ncpu2 5 0 0 5 0 0 0 0\n");
+    CHECK_EQ(b.size(), size_t(1));
+    CHECK_NEAR(b[0], 50.0, 1e-9);
+
+    // Offlined and back: counters restart below the baseline, read as idle
+    b = busy("cpu3 5000 0 0 9000 0 0 0 0\n", "cpu3 10 0 0 20 0 0 0 0\n");
+    CHECK_EQ(b.size(), size_t(1));
+    CHECK_NEAR(b[3], 0.0, 1e-9);
+
+    // Nothing elapsed, empty and garbage input
+    b = busy("cpu0 1 0 0 1 0 0 0 0\n", "cpu0 1 0 0 1 0 0 0 0\n");
+    CHECK_NEAR(b[0], 0.0, 1e-9);
+    CHECK(busy("", "").empty());
+    CHECK(busy("cpufreq 1 2 3 4\ncpuX 1 2 3 4\ncpu0 1 2\n", "cpufreq 1 2 3 4\ncpuX 1 2 3 4\ncpu0 1 2\n").empty());
+}
+
+static void effectiveClock()
+{
+    // 3 GHz TSC over one second, ran at 4.2 GHz while awake
+    uint64_t before[3] = { 1000, 5000, 7000 };
+    uint64_t after[3] = { 1000 + 3000000000ULL, 5000 + 1400000000ULL, 7000 + 1000000000ULL };
+    CHECK_NEAR(CoreActivity::effectiveMhz(before, after, 1.0), 4200.0, 1e-6);
+    CHECK_NEAR(CoreActivity::effectiveMhz(before, after, 2.0), 2100.0, 1e-6);
+
+    // Asleep the whole interval: no MPERF ticks, no clock
+    uint64_t asleep[3] = { after[0], before[1], before[2] };
+    CHECK_EQ(CoreActivity::effectiveMhz(before, asleep, 1.0), 0.0);
+    CHECK_EQ(CoreActivity::effectiveMhz(before, after, 0.0), 0.0);
+    CHECK_EQ(CoreActivity::effectiveMhz(before, after, -1.0), 0.0);
+    uint64_t noTsc[3] = { before[0], after[1], after[2] };
+    CHECK_EQ(CoreActivity::effectiveMhz(before, noTsc, 1.0), 0.0);
+
+    // Every counter wraps between the samples: unsigned deltas still hold
+    const uint64_t top = numeric_limits<uint64_t>::max();
+    uint64_t nearTop[3] = { top - 999999999ULL, top - 699999999ULL, top - 499999999ULL };
+    uint64_t wrapped[3] = { 2000000000ULL, 700000000ULL, 500000000ULL };
+    CHECK_NEAR(CoreActivity::effectiveMhz(nearTop, wrapped, 1.0), 3000.0 * 1.4, 1e-6);
+}
+
+int main()
+{
+    utilization();
+    iowaitBackwards();
+    hotplug();
+    effectiveClock();
+    return finish();
+}
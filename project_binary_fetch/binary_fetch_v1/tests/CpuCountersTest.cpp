@@ -0,0 +1,125 @@
+#include "include\CpuCounters.h"
+#include "include\CPUTopology.h"
+#include "include\Probe.h"
+#include "Check.h"
+
+static void cpuLists()
+{
+    CHECK(CPUTopology::parseCpuList("0-3,8-11\n") == vector<int>({ 0, 1, 2, 3, 8, 9, 10, 11 }));
+    CHECK(CPUTopology::parseCpuList("0") == vector<int>({ 0 }));
+    CHECK(CPUTopology::parseCpuList("5,7") == vector<int>({ 5, 7 }));
+    CHECK(CPUTopology::parseCpuList("0-0") == vector<int>({ 0 }));
+    CHECK(CPUTopology::parseCpuList("").empty());
+    CHECK(CPUTopology::parseCpuList("\n").empty());
+    // Empty and non-numeric ranges are skipped, not read as cpu 0
+    CHECK(CPUTopology::parseCpuList("1,,3") == vector<int>({ 1, 3 }));
+    CHECK(CPUTopology::parseCpuList("x,2") == vector<int>({ 2 }));
+    // A backwards range names nothing
+    CHECK(CPUTopology::parseCpuList("4-2").empty());
+}
+
+static CpuCounterStats cpu(int id, int package, double cycles, double instructions, double misses, double stalled)
+{
+    CpuCounterStats s;
+    s.cpu = id;
+    s.name = "cpu" + to_string(id);
+    s.package = package;
+    s.cycles = cycles;
+    s.instructions = instructions;
+    s.cacheMisses = misses;
+    s.branches = 100.0;
+    s.branchMisses = 5.0;
+    s.stalledCycles = stalled;
+    return s;
+}
+
+static void sockets()
+{
+    // Stalled cycles are missing on cpu2 only: socket 1 and "All" lose them, socket 0 keeps them
+    vector<CpuCounterStats> cpus = {
+        cpu(0, 0, 100.0, 200.0, 1.0, 10.0),
+        cpu(1, 0, 300.0, 200.0, 3.0, 30.0),
+        cpu(2, 1, 400.0, 400.0, 4.0, -1.0),
+        cpu(3, 1, 100.0, 100.0, 1.0, 20.0),
+    };
+    vector<CpuCounterStats> out = CpuCounters::bySocket(cpus);
+    CHECK_EQ(out.size(), size_t(3));
+    if (out.size() != 3) return;
+
+    CHECK_EQ(out[0].name, string("Socket 0"));
+    CHECK_EQ(out[0].cpu, -1);
+    CHECK_NEAR(out[0].cycles, 400.0, 1e-9);
+    CHECK_NEAR(out[0].ipc(), 1.0, 1e-9);
+    CHECK_NEAR(out[0].cacheMisses, 4.0, 1e-9);
+    CHECK_NEAR(out[0].stalledCycles, 40.0, 1e-9);
+    CHECK_NEAR(out[0].stallPercent(), 10.0, 1e-9);
+    CHECK_NEAR(out[0].branchMissPercent(), 5.0, 1e-9);
+
+    CHECK_EQ(out[1].name, string("Socket 1"));
+    CHECK_EQ(out[1].package, 1);
+    CHECK_NEAR(out[1].instructions, 500.0, 1e-9);
+    CHECK_EQ(out[1].stalledCycles, -1.0);
+    CHECK_EQ(out[1].stallPercent(), -1.0);
+    CHECK_NEAR(out[1].cacheMpki(), 10.0, 1e-9);
+
+    CHECK_EQ(out[2].name, string("All"));
+    CHECK_NEAR(out[2].cycles, 900.0, 1e-9);
+    CHECK_NEAR(out[2].instructions, 900.0, 1e-9);
+    CHECK_EQ(out[2].stalledCycles, -1.0);
+    CHECK_NEAR(out[2].branches, 400.0, 1e-9);
+
+    // A missing event on the first member stays missing, whatever follows
+    vector<CpuCounterStats> first = { cpu(0, 0, 100.0, 100.0, -1.0, 10.0), cpu(1, 0, 100.0, 100.0, 2.0, 10.0) };
+    out = CpuCounters::bySocket(first);
+    CHECK_EQ(out.size(), size_t(1));        // one socket: no "All"
+    if (!out.empty()) {
+        CHECK_EQ(out[0].cacheMisses, -1.0);
+        CHECK_EQ(out[0].cacheMpki(), -1.0);
+        CHECK_NEAR(out[0].stalledCycles, 20.0, 1e-9);
+    }
+
+    CHECK(CpuCounters::bySocket({}).empty());
+}
+
+static void replayed()
+{
+    // Rows arrive in read order; sample() sorts by package then cpu, with the
+    // packages from sysfs (no "cpuid:dump" in the snapshot)
+    CHECK(Probe::begin(Probe::Mode::Replay, fixture("cpucounters/two_sockets.json")));
+    CpuCounters counters;
+    vector<CpuCounterStats> stats = counters.sample(1000);
+    CHECK_EQ(counters.error(), string(""));
+    CHECK_EQ(counters.note(), string(""));
+    CHECK_EQ(stats.size(), size_t(4));
+    if (stats.size() == 4) {
+        CHECK_EQ(stats[0].name, string("cpu0"));
+        CHECK_EQ(stats[1].cpu, 1);
+        CHECK_EQ(stats[2].cpu, 2);
+        CHECK_EQ(stats[2].package, 1);
+        CHECK_EQ(stats[3].cpu, 3);
+        CHECK_NEAR(stats[0].ipc(), 3.0, 1e-9);
+        CHECK_EQ(stats[3].stalledCycles, -1.0);
+    }
+    vector<CpuCounterStats> bySocket = CpuCounters::bySocket(stats);
+    CHECK_EQ(bySocket.size(), size_t(3));
+    if (bySocket.size() == 3) {
+        CHECK_NEAR(bySocket[0].stalledCycles, 3.0e8, 1.0);
+        CHECK_EQ(bySocket[1].stalledCycles, -1.0);
+    }
+
+    // Refused by the kernel: no rows, the reason passed through
+    CHECK(Probe::begin(Probe::Mode::Replay, fixture("cpucounters/no_access.json")));
+    CpuCounters refused;
+    CHECK(refused.sample(1000).empty());
+    CHECK(refused.error().find("perf_event_paranoid is 2") == 0);
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+}
+
+int main()
+{
+    cpuLists();
+    sockets();
+    replayed();
+    return finish();
+}
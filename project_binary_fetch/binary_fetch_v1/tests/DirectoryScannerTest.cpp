@@ -0,0 +1,99 @@
+#include "include\DirectoryScanner.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>
+
+static string tree()
+{
+    return "/tmp/DirectoryScannerTest." + to_string(getpid());
+}
+
+static void writeFile(const string& path, size_t bytes)
+{
+    ofstream(path, ios::binary) << string(bytes, 'x');
+}
+
+// big/ (2 files + deep/ with 1), small/ (1 file), empty/
+static void makeTree()
+{
+    string root = tree();
+    filesystem::create_directories(root + "/big/deep");
+    filesystem::create_directories(root + "/small");
+    filesystem::create_directories(root + "/empty");
+    writeFile(root + "/big/a", 256 * 1024);
+    writeFile(root + "/big/b", 128 * 1024);
+    writeFile(root + "/big/deep/c", 64 * 1024);
+    writeFile(root + "/small/d", 100);
+}
+
+static DirScanConfig config(int threads, bool cache)
+{
+    DirScanConfig c;
+    c.roots = { tree() };
+    c.topN = 10;
+    c.depth = 1;
+    c.threads = threads;
+    c.useCache = cache;
+    c.cachePath = tree() + ".cache.json";
+    return c;
+}
+
+static void sizesAndOrder()
+{
+    vector<DirScanResult> results = DirectoryScanner::scan(config(4, false));
+    CHECK_EQ(results.size(), size_t(1));
+    if (results.size() != 1) return;
+    const DirScanResult& r = results[0];
+    CHECK(r.ok);
+    CHECK_EQ(r.directories, uint64_t(5));
+    CHECK_EQ(r.root.files, uint64_t(4));
+    CHECK_EQ(r.largest.size(), size_t(3));
+    if (r.largest.size() == 3) {
+        CHECK_EQ(r.largest[0].path, tree() + "/big");
+        CHECK_EQ(r.largest[0].files, uint64_t(3));
+        CHECK(r.largest[0].bytes >= 448u * 1024u);
+        CHECK_EQ(r.largest[1].path, tree() + "/small");
+        CHECK_EQ(r.largest[2].bytes, uint64_t(0));
+        CHECK_EQ(r.root.bytes, r.largest[0].bytes + r.largest[1].bytes);
+    }
+}
+
+static void idleWorkersFinish()
+{
+    // More workers than directories: most only ever wait, and all must wake up at the end
+    for (int run = 0; run < 200; run++) {
+        for (int threads : { 1, 2, 16 }) {
+            vector<DirScanResult> results = DirectoryScanner::scan(config(threads, false));
+            CHECK(results.size() == 1 && results[0].directories == 5);
+        }
+    }
+}
+
+static void cacheRescan()
+{
+    DirectoryScanner::scan(config(4, true));
+    vector<DirScanResult> results = DirectoryScanner::scan(config(4, true));
+    CHECK(results.size() == 1 && results[0].cachedDirectories == results[0].directories);
+
+    // A new file changes its directory's mtime, so just that one is listed again
+    writeFile(tree() + "/small/e", 100);
+    results = DirectoryScanner::scan(config(4, true));
+    if (results.size() == 1) {
+        CHECK_EQ(results[0].cachedDirectories + 1, results[0].directories);
+        CHECK_EQ(results[0].root.files, uint64_t(5));
+    }
+}
+
+int main()
+{
+    makeTree();
+    sizesAndOrder();
+    idleWorkersFinish();
+    cacheRescan();
+    filesystem::remove_all(tree());
+    remove((tree() + ".cache.json").c_str());
+    return finish();
+}
@@ -0,0 +1,56 @@
+#include "include\DiskBenchmark.h"
+#include "include\IoRing.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Runs a tiny configuration for real: whichever engine engineName() reports
+// has to complete I/O in both directions, sequential and random
+int main()
+{
+    string dir = "/tmp/DiskBenchmarkTest." + to_string(getpid());
+    mkdir(dir.c_str(), 0700);
+
+#ifdef BINARYFETCH_IO_URING
+    CHECK_EQ(DiskBenchmark::engineName(), string(IoRing(1).ready() ? "io_uring" : "psync"));
+#else
+    CHECK_EQ(DiskBenchmark::engineName(), string("psync"));
+#endif
+    cout << "engine: " << DiskBenchmark::engineName() << "\n";
+
+    DiskBenchConfig config;
+    config.tests = {
+        { "SEQ64K Q4T1 Read", 64 * 1024, 4, false, 100 },
+        { "RND4K Q8T1 Write", 4096, 8, true, 0 },
+        { "MIX4K Q8T2", 4096, 8, true, 70 },
+    };
+    config.durationMs = 100;
+    config.threads = 1;
+    config.fileSizeMB = 16;
+
+    vector<DiskBenchResult> results = DiskBenchmark::run(dir, config);
+    if (results.empty()) {
+        cout << "run: skipped (no direct-I/O test file in " << dir << ")\n";
+    }
+    else {
+        CHECK_EQ(results.size(), config.tests.size());
+        for (size_t i = 0; i < results.size() && i < config.tests.size(); ++i) {
+            const DiskBenchResult& r = results[i];
+            CHECK_EQ(r.name, config.tests[i].name);
+            CHECK(r.ok);
+            CHECK(r.ops > 0);
+            CHECK(r.mbps > 0.0);
+            // Decimal MB/s, the unit the sections print
+            CHECK_NEAR(r.mbps, r.iops * config.tests[i].blockSize / 1e6, r.mbps * 1e-9);
+            CHECK(r.iops > 0.0);
+            CHECK(r.p50_us > 0.0 && r.p50_us <= r.p99_us);
+        }
+    }
+
+    // The test file is gone afterwards
+    CHECK(listDir(dir).empty());
+    rmdir(dir.c_str());
+    return finish();
+}
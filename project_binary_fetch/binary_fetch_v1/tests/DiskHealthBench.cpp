@@ -0,0 +1,64 @@
+#include "include\DiskHealth.h"
+#include "include\Probe.h"
+#include "Check.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+/*
+    DiskHealthBench — throughput of the NVMe / ATA health page parsers
+
+        DiskHealthBench <fixture dir> [passes]
+
+    Parses every page in the directory `passes` times (nvme_*.hex through
+    parseNvmeHealthLog, ata_*.hex through parseAtaSmartData) and prints
+    pages/s and us/page. Pages are parsed once per disk per refresh, so
+    what matters is that it stays far below the cost of the IOCTL itself.
+*/
+
+struct Page {
+    bool nvme;
+    vector<unsigned char> bytes;
+};
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <fixture dir> [passes]\n", argv[0]);
+        return 2;
+    }
+    string dir = argv[1];
+    int passes = argc > 2 ? atoi(argv[2]) : 100000;
+
+    vector<Page> corpus;
+    for (const auto& name : listDir(dir)) {
+        bool nvme = name.rfind("nvme_", 0) == 0;
+        if (!nvme && name.rfind("ata_", 0) != 0) continue;
+        string hex = readFile(dir + "/" + name);
+        while (!hex.empty() && isspace(static_cast<unsigned char>(hex.back()))) hex.pop_back();
+        corpus.push_back({ nvme, Probe::fromHex(hex) });
+    }
+    CHECK(!corpus.empty());
+    if (corpus.empty()) return finish();
+
+    size_t valid = 0;
+    auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (const auto& page : corpus) {
+            DiskHealthData d;
+            bool ok = page.nvme ? DiskHealth::parseNvmeHealthLog(page.bytes.data(), page.bytes.size(), d)
+                : DiskHealth::parseAtaSmartData(page.bytes.data(), page.bytes.size(), d);
+            if (ok) valid++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Every fixture is a good page, every pass
+    CHECK_EQ(valid, corpus.size() * passes);
+
+    double pages = static_cast<double>(corpus.size()) * passes;
+    printf("%zu pages x %d passes: %.0f pages/s, %.3f us/page\n",
+        corpus.size(), passes, pages / seconds, seconds * 1e6 / pages);
+    return finish();
+}
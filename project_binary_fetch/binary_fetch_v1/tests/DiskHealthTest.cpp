@@ -0,0 +1,118 @@
+#include "include\DiskHealth.h"
+#include "include\Probe.h"
+#include "Check.h"
+
+#include <cctype>
+
+// Raw 512-byte pages as hex text, the bytes Probe records under nvme-log: / ata-smart:
+static vector<unsigned char> page(const string& name)
+{
+    string hex = readFile(fixture("diskhealth/" + name + ".hex"));
+    while (!hex.empty() && isspace(static_cast<unsigned char>(hex.back()))) hex.pop_back();
+    return Probe::fromHex(hex);
+}
+
+static void nvmeHealthy()
+{
+    vector<unsigned char> p = page("nvme_healthy");
+    CHECK_EQ(p.size(), size_t(512));
+    DiskHealthData d;
+    CHECK(DiskHealth::parseNvmeHealthLog(p.data(), p.size(), d));
+    CHECK(d.valid);
+    CHECK_EQ(d.protocol, string("NVMe"));
+    CHECK_EQ(d.temperature_c, 41);                          // 314 K
+    CHECK_EQ(d.available_spare, 100);
+    CHECK_EQ(d.percentage_used, 2);
+    CHECK_EQ(d.critical_warning, 0u);
+    CHECK(!d.overheating());
+    CHECK_EQ(d.data_written_bytes, uint64_t(47851170) * 512000);
+    CHECK_EQ(d.power_on_hours, uint64_t(6021));
+    CHECK_EQ(d.media_errors, uint64_t(0));
+    CHECK_EQ(d.throttle_events, int64_t(3));
+    CHECK_EQ(d.throttle_seconds, uint64_t(41));
+    CHECK_EQ(d.warning_temp_minutes, 0u);
+}
+
+static void nvmeThrottled()
+{
+    vector<unsigned char> p = page("nvme_throttled");
+    DiskHealthData d;
+    CHECK(DiskHealth::parseNvmeHealthLog(p.data(), p.size(), d));
+    CHECK_EQ(d.temperature_c, 85);                          // 358 K
+    CHECK(d.overheating());                                 // critical warning bit 1
+    CHECK_EQ(d.available_spare, 96);
+    CHECK_EQ(d.percentage_used, 17);
+    CHECK_EQ(d.media_errors, uint64_t(3));
+    CHECK_EQ(d.power_on_hours, uint64_t(18234));
+    CHECK_EQ(d.throttle_events, int64_t(1542 + 37));        // TMT1 + TMT2 transitions
+    CHECK_EQ(d.throttle_seconds, uint64_t(8130 + 512));
+    CHECK_EQ(d.warning_temp_minutes, 95u);
+    CHECK_EQ(d.critical_temp_minutes, 4u);
+}
+
+static void nvmeRejects()
+{
+    vector<unsigned char> p = page("nvme_healthy");
+    DiskHealthData d;
+    CHECK(!DiskHealth::parseNvmeHealthLog(p.data(), 231, d));      // truncated
+    CHECK(!DiskHealth::parseNvmeHealthLog(nullptr, 512, d));
+    vector<unsigned char> zeroed(512, 0);                           // USB bridge "answer"
+    CHECK(!DiskHealth::parseNvmeHealthLog(zeroed.data(), zeroed.size(), d));
+    CHECK(!d.valid);
+    CHECK_EQ(d.temperature_c, -1);
+
+    // 128-bit counters with the high half set saturate
+    p[128 + 8] = 1;
+    CHECK(DiskHealth::parseNvmeHealthLog(p.data(), p.size(), d));
+    CHECK_EQ(d.power_on_hours, UINT64_MAX);
+}
+
+static void ataSsd()
+{
+    vector<unsigned char> p = page("ata_ssd");
+    DiskHealthData d;
+    d.protocol = "SATA";                                    // already set by the caller: kept
+    CHECK(DiskHealth::parseAtaSmartData(p.data(), p.size(), d));
+    CHECK(d.valid);
+    CHECK_EQ(d.protocol, string("SATA"));
+    CHECK_EQ(d.temperature_c, 34);                          // 194 low byte, not min / max above it
+    CHECK_EQ(d.power_on_hours, uint64_t(8734));
+    CHECK_EQ(d.media_errors, uint64_t(0));                  // 187
+    CHECK_EQ(d.percentage_used, 7);                         // 177 normalized 93
+    CHECK_EQ(d.throttle_events, int64_t(-1));               // ATA has no throttle counters
+    CHECK_EQ(d.available_spare, -1);
+}
+
+static void ataHdd()
+{
+    vector<unsigned char> p = page("ata_hdd");
+    DiskHealthData d;
+    CHECK(DiskHealth::parseAtaSmartData(p.data(), p.size(), d));
+    CHECK_EQ(d.protocol, string("ATA"));
+    CHECK_EQ(d.temperature_c, 37);                          // no 194: airflow temperature 190
+    CHECK_EQ(d.power_on_hours, uint64_t(33456));            // vendor bytes above bit 31 dropped
+    CHECK_EQ(d.media_errors, uint64_t(8));                  // no 187: offline uncorrectable 198
+    CHECK_EQ(d.percentage_used, -1);                        // no wear attribute on a spinning disk
+}
+
+static void ataRejects()
+{
+    vector<unsigned char> p = page("ata_ssd");
+    DiskHealthData d;
+    CHECK(!DiskHealth::parseAtaSmartData(p.data(), 2 + 30 * 12 - 1, d));
+    vector<unsigned char> empty(512, 0);
+    empty[0] = 0x10;                                        // revision only, no attributes
+    CHECK(!DiskHealth::parseAtaSmartData(empty.data(), empty.size(), d));
+    CHECK(!d.valid);
+}
+
+int main()
+{
+    nvmeHealthy();
+    nvmeThrottled();
+    nvmeRejects();
+    ataSsd();
+    ataHdd();
+    ataRejects();
+    return finish();
+}
@@ -0,0 +1,177 @@
+#include "include\DiskSpeedCache.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <unistd.h>
+
+static string cachePath()
+{
+    return "/tmp/DiskSpeedCacheTest." + to_string(getpid()) + ".json";
+}
+
+static DiskIdentity drive()
+{
+    DiskIdentity id;
+    id.model = "Test SSD";
+    id.serial = "S123";
+    id.firmware = "1.0";
+    id.fsUuid = "0000-1111";
+    return id;
+}
+
+static DiskBenchResult measured(const DiskBenchTest& test, double mbps)
+{
+    DiskBenchResult r;
+    r.name = test.name;
+    r.readPercent = test.readPercent;
+    r.random = test.random;
+    r.ok = true;
+    r.mbps = mbps;
+    return r;
+}
+
+static void partialHit()
+{
+    // Quick config cached; the full run only misses the tests it adds
+    DiskBenchConfig quick = DiskBenchmark::quickConfig();
+    DiskSpeedCache cache(cachePath());
+    cache.store(drive(), quick, { measured(quick.tests[0], 3000.0), measured(quick.tests[1], 2000.0) });
+
+    DiskBenchConfig full = quick;
+    full.tests.push_back({ "RND4K Q1T1 Read", 4096, 1, true, 100 });
+    vector<DiskBenchResult> results;
+    vector<size_t> missing;
+    int64_t age = -1;
+    CHECK_EQ(cache.lookup(drive(), full, 3600, results, missing, age), size_t(2));
+    CHECK_EQ(results.size(), size_t(3));
+    CHECK_EQ(missing.size(), size_t(1));
+    if (results.size() == 3 && missing.size() == 1) {
+        CHECK_EQ(results[0].mbps, 3000.0);
+        CHECK_EQ(results[1].mbps, 2000.0);
+        CHECK_EQ(missing[0], size_t(2));
+        CHECK(!results[2].ok);
+        CHECK_EQ(results[2].name, string("RND4K Q1T1 Read"));
+    }
+    CHECK(age >= 0 && age <= 1);
+}
+
+static void parametersAreKeyed()
+{
+    DiskBenchConfig quick = DiskBenchmark::quickConfig();
+    DiskSpeedCache cache(cachePath());
+    cache.store(drive(), quick, { measured(quick.tests[0], 3000.0), measured(quick.tests[1], 2000.0) });
+
+    // Same test names, measured another way: nothing may match
+    vector<DiskBenchConfig> changed(4, quick);
+    changed[0].durationMs *= 2;
+    changed[1].fileSizeMB *= 2;
+    changed[2].threads = 4;
+    changed[3].tests[0].queueDepth = 32;
+    changed[3].tests[1].blockSize = 4096;
+    for (const auto& config : changed) {
+        vector<DiskBenchResult> results;
+        vector<size_t> missing;
+        int64_t age = 0;
+        CHECK_EQ(cache.lookup(drive(), config, 3600, results, missing, age), size_t(0));
+        CHECK_EQ(missing.size(), size_t(2));
+    }
+
+    // Another drive misses too, and failed results are never stored
+    DiskIdentity other = drive();
+    other.serial = "S999";
+    vector<DiskBenchResult> results;
+    vector<size_t> missing;
+    int64_t age = 0;
+    CHECK_EQ(cache.lookup(other, quick, 3600, results, missing, age), size_t(0));
+    DiskBenchResult failed = measured(quick.tests[0], 1.0);
+    failed.ok = false;
+    cache.store(other, quick, { failed });
+    CHECK_EQ(cache.lookup(other, quick, 3600, results, missing, age), size_t(0));
+}
+
+static void mergeByTest()
+{
+    DiskBenchConfig full = DiskBenchmark::quickConfig();
+    full.tests.push_back({ "RND4K Q1T1 Read", 4096, 1, true, 100 });
+    full.tests.push_back({ "RND4K Q1T1 Write", 4096, 1, true, 0 });
+    DiskSpeedCache cache(cachePath());
+    cache.store(drive(), full, { measured(full.tests[0], 3000.0), {}, measured(full.tests[2], 60.0) });
+
+    vector<DiskBenchResult> results;
+    vector<size_t> missing;
+    int64_t age = 0;
+    CHECK_EQ(cache.lookup(drive(), full, 3600, results, missing, age), size_t(2));
+    CHECK_EQ(missing.size(), size_t(2));
+
+    // Fewer results than tests, out of order: each lands on its own test
+    CHECK_EQ(DiskSpeedCache::merge(full, missing, { measured(full.tests[3], 150.0) }, results), size_t(1));
+    if (results.size() == 4) {
+        CHECK_EQ(results[0].mbps, 3000.0);
+        CHECK(!results[1].ok);
+        CHECK_EQ(results[1].name, full.tests[1].name);
+        CHECK_EQ(results[2].mbps, 60.0);
+        CHECK_EQ(results[3].mbps, 150.0);
+    }
+
+    // Nothing measured (no test file) keeps the cached hits and the placeholders
+    CHECK_EQ(DiskSpeedCache::merge(full, missing, {}, results), size_t(0));
+    CHECK_EQ(results.size(), size_t(4));
+
+    // A result for a test that wasn't missing isn't taken
+    CHECK_EQ(DiskSpeedCache::merge(full, missing, { measured(full.tests[0], 1.0) }, results), size_t(0));
+    if (results.size() == 4) CHECK_EQ(results[0].mbps, 3000.0);
+}
+
+static void saveAndLoad()
+{
+    string path = cachePath();
+    DiskBenchConfig quick = DiskBenchmark::quickConfig();
+    {
+        DiskSpeedCache cache(path);
+        cache.store(drive(), quick, { measured(quick.tests[0], 3000.0), measured(quick.tests[1], 2000.0) });
+        CHECK(cache.save());
+    }
+
+    DiskSpeedCache reloaded(path);
+    reloaded.load();
+    vector<DiskBenchResult> results;
+    vector<size_t> missing;
+    int64_t age = 0;
+    CHECK_EQ(reloaded.lookup(drive(), quick, 3600, results, missing, age), size_t(2));
+    if (results.size() == 2) {
+        CHECK_EQ(results[0].name, quick.tests[0].name);
+        CHECK_EQ(results[1].mbps, 2000.0);
+        CHECK(results[1].ok);
+    }
+
+    // A version 1 file (keyed by test name alone) is dropped, not misread
+    ofstream(path) << "{ \"version\": 1, \"devices\": { \"" << drive().key() << "\": { \"" << quick.tests[0].name
+        << "\": { \"mbps\": 1.0, \"measured_at\": " << time(nullptr) << " } } } }";
+    reloaded.load();
+    CHECK_EQ(reloaded.lookup(drive(), quick, 3600, results, missing, age), size_t(0));
+
+    // So is a version 2 file (MiB/s figures)
+    {
+        DiskSpeedCache cache(path);
+        cache.store(drive(), quick, { measured(quick.tests[0], 3000.0) });
+        CHECK(cache.save());
+    }
+    string text = readFile(path);
+    size_t v = text.find("\"version\": 3");
+    CHECK(v != string::npos);
+    if (v != string::npos) ofstream(path) << text.replace(v, 14, "\"version\": 2");
+    reloaded.load();
+    CHECK_EQ(reloaded.lookup(drive(), quick, 3600, results, missing, age), size_t(0));
+    remove(path.c_str());
+}
+
+int main()
+{
+    partialHit();
+    parametersAreKeyed();
+    mergeByTest();
+    saveAndLoad();
+    return finish();
+}
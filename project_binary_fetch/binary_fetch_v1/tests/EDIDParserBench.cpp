@@ -0,0 +1,55 @@
+#include "include\EDIDParser.h"
+#include "include\Probe.h"
+#include "Check.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+/*
+    EDIDParserBench — corpus throughput of EDIDParser::parse
+
+        EDIDParserBench <corpus dir> [passes]
+
+    Parses every blob in the corpus `passes` times and prints blobs/s and
+    MB/s. The parser runs once per monitor at startup, so the number to
+    watch is that it stays in the microseconds, not the exact figure.
+*/
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <corpus dir> [passes]\n", argv[0]);
+        return 2;
+    }
+    string dir = argv[1];
+    int passes = argc > 2 ? atoi(argv[2]) : 100000;
+
+    vector<vector<unsigned char>> corpus;
+    size_t corpusBytes = 0;
+    for (const auto& name : listDir(dir)) {
+        string hex = readFile(dir + "/" + name);
+        while (!hex.empty() && isspace(static_cast<unsigned char>(hex.back()))) hex.pop_back();
+        corpus.push_back(Probe::fromHex(hex));
+        corpusBytes += corpus.back().size();
+    }
+    CHECK(!corpus.empty());
+    if (corpus.empty()) return finish();
+
+    size_t valid = 0;
+    auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (const auto& blob : corpus) {
+            if (EDIDParser::parse(blob).valid) valid++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Every fixture is a good EDID, every pass
+    CHECK_EQ(valid, corpus.size() * passes);
+
+    double blobs = static_cast<double>(corpus.size()) * passes;
+    printf("%zu blobs x %d passes: %.0f blobs/s, %.1f MB/s, %.2f us/blob\n",
+        corpus.size(), passes, blobs / seconds, corpusBytes * passes / seconds / 1e6, seconds * 1e6 / blobs);
+    return finish();
+}
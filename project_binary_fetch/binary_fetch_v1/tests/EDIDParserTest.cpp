@@ -0,0 +1,179 @@
+#include "include\EDIDParser.h"
+#include "include\Probe.h"
+#include "Check.h"
+
+// Fixtures are one hex line per blob (base block + extensions)
+static vector<unsigned char> edid(const string& name)
+{
+    string hex = readFile(fixture("edid/" + name + ".hex"));
+    while (!hex.empty() && isspace(static_cast<unsigned char>(hex.back()))) hex.pop_back();
+    return Probe::fromHex(hex);
+}
+
+static void fixedRefreshMonitor()
+{
+    EDIDData d = EDIDParser::parse(edid("fixed_60hz"));
+    CHECK(d.valid);
+    CHECK_EQ(d.manufacturer, string("DEL"));
+    CHECK_EQ(d.friendlyName, string("DELL P2419H"));
+    CHECK_EQ(d.serial(), string("CFV9N99B0ABL"));
+    CHECK_EQ(d.manufacture_week, 12);
+    CHECK_EQ(d.manufacture_year, 2021);
+    CHECK_EQ(d.nativeWidth, 1920);
+    CHECK_EQ(d.nativeHeight, 1080);
+    CHECK_NEAR(d.preferred_refresh, 60.0, 0.01);
+    CHECK_EQ(d.extension_blocks, 0);
+
+    // Default-GTF range limits are a refresh range, not VRR
+    CHECK_EQ(d.range_min, 56);
+    CHECK_EQ(d.range_max, 76);
+    CHECK_EQ(d.vrr_min, 0);
+    CHECK_EQ(d.vrr_max, 0);
+}
+
+static void adaptiveSyncMonitor()
+{
+    EDIDData d = EDIDParser::parse(edid("freesync_144hz"));
+    CHECK(d.valid);
+    CHECK(d.has_cta);
+    CHECK_EQ(d.nativeWidth, 2560);
+    CHECK_EQ(d.nativeHeight, 1440);
+    CHECK_NEAR(d.preferred_refresh, 144.0, 0.05);
+    CHECK_NEAR(d.max_refresh_rate, 144.0, 0.05);
+
+    // "Range limits only" with a wide span is how adaptive sync is advertised
+    CHECK_EQ(d.vrr_min, 48);
+    CHECK_EQ(d.vrr_max, 144);
+
+    CHECK(d.hdr_supported);
+    CHECK(d.hdr10);
+    CHECK(d.hlg);
+    CHECK_NEAR(d.hdr_max_luminance, 400.0, 0.5);
+    CHECK_EQ(d.serial_number, 0u);
+    CHECK_EQ(d.serial(), string("L9LMQS068712"));
+}
+
+static void interlacedTelevision()
+{
+    EDIDData d = EDIDParser::parse(edid("tv_1080i_hdmi_vrr"));
+    CHECK(d.valid);
+
+    // 1080i60: 540-line fields at ~60 Hz, reported as a 1080-line frame at the field rate
+    CHECK_EQ(d.nativeWidth, 1920);
+    CHECK_EQ(d.nativeHeight, 1080);
+    CHECK_NEAR(d.preferred_refresh, 60.05, 0.01);
+    CHECK_EQ(d.timings.size(), size_t(2));
+    if (d.timings.size() == 2) {
+        CHECK(d.timings[1].interlaced);
+        CHECK_EQ(d.timings[1].height, 1080);
+        CHECK_NEAR(d.timings[1].refresh_hz, 50.05, 0.01);
+    }
+    // Interlaced modes must not inflate the maximum (VICs 5 and 16 are 60 Hz too)
+    CHECK_NEAR(d.max_refresh_rate, 60.05, 0.01);
+
+    // Model-year EDID, numeric serial only
+    CHECK_EQ(d.manufacture_week, 255);
+    CHECK_EQ(d.serial(), to_string(0x01000E00u));
+
+    // VRR comes from the HDMI Forum VSDB; the base range limits stay a plain range
+    CHECK_EQ(d.vrr_min, 40);
+    CHECK_EQ(d.vrr_max, 120);
+    CHECK_EQ(d.range_min, 24);
+    CHECK_EQ(d.range_max, 75);
+}
+
+static void displayIdExtension()
+{
+    EDIDData d = EDIDParser::parse(edid("displayid_4k120"));
+    CHECK(d.valid);
+    CHECK(d.has_displayid);
+    CHECK_NEAR(d.max_refresh_rate, 120.0, 0.01);
+    CHECK_EQ(d.vrr_min, 48);
+    CHECK_EQ(d.vrr_max, 120);
+
+    // Base DTD + Type VII + Type I
+    CHECK_EQ(d.timings.size(), size_t(3));
+    if (d.timings.size() == 3) {
+        CHECK_EQ(d.timings[1].width, 3840);
+        CHECK_EQ(d.timings[1].height, 2160);
+        CHECK_NEAR(d.timings[1].refresh_hz, 120.0, 0.01);
+        CHECK(d.timings[2].interlaced);
+        CHECK_EQ(d.timings[2].height, 1080);
+        CHECK_NEAR(d.timings[2].refresh_hz, 60.05, 0.01);
+    }
+}
+
+static void damagedInput()
+{
+    vector<unsigned char> good = edid("freesync_144hz");
+
+    // Too short, wrong header, and extensions declared but cut off
+    CHECK(!EDIDParser::parse(good.data(), 127).valid);
+    vector<unsigned char> header = good;
+    header[1] = 0x00;
+    CHECK(!EDIDParser::parse(header).valid);
+    EDIDData cut = EDIDParser::parse(good.data(), 128);
+    CHECK(cut.valid);
+    CHECK_EQ(cut.extension_blocks, 0);
+    CHECK(!cut.hdr_supported);
+
+    CHECK(!EDIDParser::parse(nullptr, 0).valid);
+}
+
+static void bestBlob()
+{
+    vector<EDIDBlob> blobs = {
+        { "GSM7750", edid("displayid_4k120") },
+        { "DELA0C4", edid("fixed_60hz") },
+        { "broken", vector<unsigned char>(128, 0) },
+    };
+    CHECK_EQ(EDIDParser::findBest(blobs, "dela0c4").manufacturer, string("DEL"));
+    CHECK_EQ(EDIDParser::findBest(blobs, "").manufacturer, string("GSM"));
+    CHECK_EQ(EDIDParser::findBest(blobs, "nothing").manufacturer, string("GSM"));
+}
+
+// Drop the 0xFC monitor-name descriptor from a base block
+static vector<unsigned char> unnamed(vector<unsigned char> e)
+{
+    for (size_t i = 54; i + 18 <= 126; i += 18) {
+        if (e[i] == 0 && e[i + 1] == 0 && e[i + 3] == 0xFC) e[i + 3] = 0x10;
+    }
+    return e;
+}
+
+static void twoMonitors()
+{
+    // The GSM panel's own EDID has no name; the Dell next to it does
+    vector<EDIDBlob> blobs = {
+        { "DELA0C4", edid("fixed_60hz") },
+        { "GSM7750", unnamed(edid("freesync_144hz")) },
+    };
+    CHECK(EDIDParser::parse(blobs[1].bytes).friendlyName.empty());
+
+    EDIDData gsm = EDIDParser::forMonitor(blobs, "GSM7750");
+    CHECK(gsm.valid);
+    CHECK_EQ(gsm.nativeWidth, 2560);
+    CHECK(gsm.friendlyName.empty());
+    CHECK_EQ(EDIDParser::forMonitor(blobs, "dela0c4").friendlyName, string("DELL P2419H"));
+
+    // No key of its own: the global fallback, named blobs first
+    CHECK_EQ(EDIDParser::forMonitor(blobs, "SAM0F99").friendlyName, string("DELL P2419H"));
+    CHECK_EQ(EDIDParser::forMonitor(blobs, "").friendlyName, string("DELL P2419H"));
+
+    // An own key with only a broken blob falls through as well
+    blobs.push_back({ "ACR0001", vector<unsigned char>(128, 0) });
+    CHECK_EQ(EDIDParser::forMonitor(blobs, "ACR0001").manufacturer, string("DEL"));
+    CHECK(!EDIDParser::forMonitor({}, "GSM7750").valid);
+}
+
+int main()
+{
+    fixedRefreshMonitor();
+    adaptiveSyncMonitor();
+    interlacedTelevision();
+    displayIdExtension();
+    damagedInput();
+    bestBlob();
+    twoMonitors();
+    return finish();
+}
@@ -0,0 +1,78 @@
+#include "include\ExtraInfo.h"
+#include "Check.h"
+
+// Each fixture is a tree with the sys/ and proc/ paths ExtraInfo reads
+static ExtraInfo machine(const string& name) { return ExtraInfo(fixture("extrainfo/" + name)); }
+
+static void energyBattery()
+{
+    PowerStatus p = machine("laptop_energy").get_power_status();
+    CHECK(p.hasBattery);
+    CHECK(!p.isACOnline);
+    CHECK(!p.isCharging);
+    CHECK_EQ(p.batteryPercent, 50);
+    CHECK_EQ(p.minutesRemaining, 120);      // 30 Wh at 15 W
+}
+
+static void chargeOnlyBattery()
+{
+    // charge_now / current_now only, no voltage, current reported negative
+    PowerStatus p = machine("laptop_charge").get_power_status();
+    CHECK(p.hasBattery);
+    CHECK_EQ(p.batteryPercent, 40);
+    CHECK_EQ(p.minutesRemaining, 120);      // 2 Ah at 1 A
+}
+
+static void mixedBatteries()
+{
+    // Energy battery + charge battery with voltage_now; the mouse battery is ignored
+    PowerStatus p = machine("dual_mixed").get_power_status();
+    CHECK(p.hasBattery);
+    CHECK_EQ(p.batteryPercent, 50);         // (20 + 12) / (40 + 24) Wh
+    CHECK_EQ(p.minutesRemaining, 120);      // 32 Wh at 16 W
+}
+
+static void desktop()
+{
+    ExtraInfo info = machine("desktop");
+    PowerStatus p = info.get_power_status();
+    CHECK(!p.hasBattery);
+    CHECK(p.isACOnline);
+    CHECK_EQ(p.minutesRemaining, -1);
+
+    vector<AudioDevice> out = info.get_output_devices();
+    CHECK_EQ(out.size(), size_t(2));
+    if (out.size() == 2) {
+        CHECK_EQ(out[0].name, string("ALC892 Analog (HDA Intel PCH)"));
+        CHECK(out[0].isActive);
+        CHECK(out[0].isOutput);
+        CHECK_EQ(out[1].name, string("HDMI 0 (HDA Intel PCH)"));
+        CHECK(!out[1].isActive);
+    }
+
+    vector<AudioDevice> in = info.get_input_devices();
+    CHECK_EQ(in.size(), size_t(1));
+    if (in.size() == 1) {
+        CHECK(!in[0].isActive);
+        CHECK(!in[0].isOutput);
+    }
+}
+
+static void missingTree()
+{
+    ExtraInfo info = machine("does-not-exist");
+    PowerStatus p = info.get_power_status();
+    CHECK(!p.hasBattery);
+    CHECK(!p.isACOnline);
+    CHECK(info.get_output_devices().empty());
+}
+
+int main()
+{
+    energyBattery();
+    chargeOnlyBattery();
+    mixedBatteries();
+    desktop();
+    missingTree();
+    return finish();
+}
@@ -0,0 +1,185 @@
+#include "include\NetIdentityCache.h"
+#include "Check.h"
+
+#include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+
+static string cachePath()
+{
+    return "/tmp/NetIdentityCacheTest." + to_string(getpid()) + ".json";
+}
+
+// Fingerprint of a fixture network, built the way the Linux backend does
+// from its route and neighbour tables
+static string network(const string& name)
+{
+    string iface, gateway;
+    if (!NetIdentityCache::parseDefaultRoute(readFile(fixture("netidentity/" + name + "/route")), iface, gateway)) return "";
+    string mac = NetIdentityCache::parseGatewayMac(readFile(fixture("netidentity/" + name + "/arp")), gateway, iface);
+    return "if=" + iface + "|gw=" + gateway + "|mac=" + mac + "|link=1|addr=";
+}
+
+// Cache file with one "public_ip" fact per network, stored `age` seconds ago
+static void writeCache(const vector<pair<string, int64_t>>& networks)
+{
+    int64_t now = time(nullptr);
+    json nets = json::object();
+    for (const auto& n : networks) {
+        nets[n.first] = { { "public_ip", { { "value", "ip-" + n.first }, { "stored_at", now - n.second } } } };
+    }
+    ofstream(cachePath()) << json{ { "version", 1 }, { "networks", nets } }.dump();
+}
+
+static json savedNetworks()
+{
+    try {
+        return json::parse(readFile(cachePath())).value("networks", json::object());
+    }
+    catch (...) {
+        return json::object();
+    }
+}
+
+static void routes()
+{
+    string iface, gateway;
+    CHECK(NetIdentityCache::parseDefaultRoute(readFile(fixture("netidentity/home/route")), iface, gateway));
+    CHECK_EQ(iface, string("wlan0"));
+    CHECK_EQ(gateway, string("192.168.0.1"));
+    CHECK_EQ(NetIdentityCache::parseGatewayMac(readFile(fixture("netidentity/home/arp")), gateway, iface),
+        string("a4:91:b1:00:11:22"));
+
+    // Lowest metric among the routes that are up; the neighbour entry on that interface
+    CHECK(NetIdentityCache::parseDefaultRoute(readFile(fixture("netidentity/office/route")), iface, gateway));
+    CHECK_EQ(iface, string("enp3s0"));
+    CHECK_EQ(gateway, string("10.0.0.1"));
+    CHECK_EQ(NetIdentityCache::parseGatewayMac(readFile(fixture("netidentity/office/arp")), gateway, iface),
+        string("00:0c:29:de:ad:01"));
+
+    CHECK(!NetIdentityCache::parseDefaultRoute(readFile(fixture("netidentity/no_route/route")), iface, gateway));
+    CHECK(iface.empty() && gateway.empty());
+    CHECK(!NetIdentityCache::parseDefaultRoute("", iface, gateway));
+    CHECK_EQ(NetIdentityCache::parseGatewayMac(readFile(fixture("netidentity/no_route/arp")), "10.0.0.1", "enp3s0"), string());
+}
+
+static void keyedByNetwork()
+{
+    remove(cachePath().c_str());
+    string home = network("home"), office = network("office");
+    CHECK(home != office);
+
+    NetIdentityCache::begin(3600, cachePath(), home);
+    CHECK_EQ(NetIdentityCache::fingerprint(), home);
+    int fetched = 0;
+    auto fetch = [&]() { fetched++; return string("203.0.113.7"); };
+    CHECK_EQ(NetIdentityCache::get("public_ip", fetch), string("203.0.113.7"));
+    CHECK_EQ(NetIdentityCache::get("public_ip", fetch), string("203.0.113.7"));
+    CHECK_EQ(fetched, 1);
+    CHECK(NetIdentityCache::save());
+
+    // Another network misses and keeps its own value
+    NetIdentityCache::begin(3600, cachePath(), office);
+    string value;
+    CHECK(!NetIdentityCache::lookup("public_ip", value));
+    NetIdentityCache::store("public_ip", "198.51.100.1");
+    CHECK(NetIdentityCache::save());
+
+    // Coming back home finds the home value again
+    NetIdentityCache::begin(3600, cachePath(), home);
+    CHECK(NetIdentityCache::lookup("public_ip", value));
+    CHECK_EQ(value, string("203.0.113.7"));
+    CHECK_EQ(savedNetworks().size(), size_t(2));
+
+    // No default route: nothing is cached, every get() fetches
+    NetIdentityCache::begin(3600, cachePath(), network("no_route"));
+    CHECK(NetIdentityCache::fingerprint().empty());
+    fetched = 0;
+    NetIdentityCache::get("public_ip", fetch);
+    NetIdentityCache::get("public_ip", fetch);
+    CHECK_EQ(fetched, 2);
+    CHECK(!NetIdentityCache::lookup("public_ip", value));
+}
+
+static void ttl()
+{
+    string home = network("home");
+    writeCache({ { home, 7200 } });
+    string value;
+
+    NetIdentityCache::begin(3600, cachePath(), home);
+    CHECK(!NetIdentityCache::lookup("public_ip", value));
+    NetIdentityCache::begin(10800, cachePath(), home);
+    CHECK(NetIdentityCache::lookup("public_ip", value));
+    CHECK_EQ(value, "ip-" + home);
+
+    // Stored in the future (clock went backwards) counts as stale
+    writeCache({ { home, -600 } });
+    NetIdentityCache::begin(10800, cachePath(), home);
+    CHECK(!NetIdentityCache::lookup("public_ip", value));
+}
+
+static void eviction()
+{
+    // 40 networks, net0 the most recently used; plus the current one on save
+    vector<pair<string, int64_t>> networks;
+    for (int i = 0; i < 40; i++) networks.push_back({ "net" + to_string(i), 60 + i * 60 });
+    writeCache(networks);
+
+    NetIdentityCache::begin(3600, cachePath(), network("home"));
+    NetIdentityCache::store("public_ip", "203.0.113.7");
+    CHECK(NetIdentityCache::save());
+
+    json saved = savedNetworks();
+    CHECK_EQ(saved.size(), NetIdentityCache::MAX_NETWORKS);
+    CHECK(saved.contains(network("home")));
+    CHECK(saved.contains("net0"));
+    CHECK(saved.contains("net" + to_string(NetIdentityCache::MAX_NETWORKS - 2)));
+    CHECK(!saved.contains("net" + to_string(NetIdentityCache::MAX_NETWORKS - 1)));
+    CHECK(!saved.contains("net39"));
+}
+
+static void forget()
+{
+    const int64_t day = 86400;
+    writeCache({ { "recent", 29 * day }, { "stale", NetIdentityCache::FORGET_AFTER_SECONDS + day } });
+    NetIdentityCache::begin(3600, cachePath(), network("office"));
+
+    // Nothing stored: save() leaves the file alone
+    CHECK(NetIdentityCache::save());
+    CHECK(savedNetworks().contains("stale"));
+
+    NetIdentityCache::store("ssid", "Office");
+    CHECK(NetIdentityCache::save());
+    json saved = savedNetworks();
+    CHECK(saved.contains("recent"));
+    CHECK(!saved.contains("stale"));
+    CHECK(saved.contains(network("office")));
+}
+
+static void corrupt()
+{
+    ofstream(cachePath()) << "{ not json";
+    NetIdentityCache::begin(3600, cachePath(), network("home"));
+    string value;
+    CHECK(!NetIdentityCache::lookup("public_ip", value));
+    NetIdentityCache::store("public_ip", "203.0.113.7");
+    CHECK(NetIdentityCache::save());
+    CHECK_EQ(savedNetworks().size(), size_t(1));
+}
+
+int main()
+{
+    routes();
+    keyedByNetwork();
+    ttl();
+    eviction();
+    forget();
+    corrupt();
+    remove(cachePath().c_str());
+    return finish();
+}
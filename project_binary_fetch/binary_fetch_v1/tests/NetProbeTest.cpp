@@ -0,0 +1,302 @@
+#include "include\NetProbe.h"
+#include "Check.h"
+
+// Everything runs against a NetProbeServer on loopback: no outside network needed
+
+static void requests(NetProbeServer& server)
+{
+    string base = server.baseUrl();
+    CHECK_EQ(base.compare(0, 17, "http://127.0.0.1:"), 0);
+
+    NetRequest ip;
+    ip.url = base + "/ip";
+    NetRequest down;
+    down.url = base + "/__down?bytes=300000";
+    down.captureLimit = 16;
+    NetRequest up;
+    up.url = base + "/__up";
+    up.method = "POST";
+    up.uploadBytes = 500000;
+    NetRequest missing;
+    missing.url = base + "/nothing-here";
+    NetRequest refused;
+    refused.url = "http://127.0.0.1:1/ip";
+
+    vector<NetResult> r = NetProbe::run({ ip, down, up, missing, refused }, 5000);
+    CHECK_EQ(r.size(), size_t(5));
+    if (r.size() != 5) return;
+
+    CHECK(r[0].ok);
+    CHECK_EQ(r[0].status, 200);
+    CHECK_EQ(r[0].body, string("127.0.0.1"));
+
+    CHECK(r[1].ok);
+    CHECK_EQ(r[1].bytesReceived, uint64_t(300000));
+    CHECK_EQ(r[1].body.size(), size_t(16));                 // capture limit, not the body
+
+    CHECK(r[2].ok);
+    CHECK_EQ(r[2].bytesSent, uint64_t(500000));
+    CHECK_EQ(r[2].body, string("ok"));
+
+    CHECK(!r[3].ok);
+    CHECK_EQ(r[3].status, 404);
+
+    CHECK(!r[4].ok);
+    CHECK(!r[4].error.empty());
+    CHECK(!r[4].timedOut);
+}
+
+static void downloadCap(NetProbeServer& server)
+{
+    // Asking for more than the cap gets exactly the cap
+    NetRequest huge;
+    huge.url = server.baseUrl() + "/__down?bytes=" + to_string(NetProbeServer::MAX_DOWNLOAD_BYTES * 64);
+    huge.captureLimit = 0;
+    vector<NetResult> r = NetProbe::run({ huge }, 60000);
+    CHECK(r.size() == 1 && r[0].ok);
+    if (r.size() == 1) CHECK_EQ(r[0].bytesReceived, NetProbeServer::MAX_DOWNLOAD_BYTES);
+}
+
+static ThroughputConfig quickThroughput(const string& url, bool upload)
+{
+    ThroughputConfig c;
+    c.url = url;
+    c.upload = upload;
+    c.uploadBytes = 20000000;
+    c.streams = 4;
+    c.sampleMs = 50;
+    c.warmupMs = 200;
+    c.windowSamples = 3;
+    c.tolerance = 0.5;              // loopback on a busy test machine is noisy
+    c.measureMs = 300;
+    c.maxDurationMs = 3000;
+    return c;
+}
+
+static void throughputBothWays(NetProbeServer& server)
+{
+    for (bool upload : { false, true }) {
+        string url = server.baseUrl() + (upload ? "/__up" : "/__down?bytes=50000000");
+        ThroughputResult t = NetProbe::throughput(quickThroughput(url, upload));
+        CHECK(t.ok);
+        CHECK(t.error.empty());
+        CHECK_EQ(t.streamsConnected, 4);
+        CHECK_EQ(t.streamMbps.size(), size_t(4));
+        CHECK(t.goodputMbps > 0.0);
+        CHECK(t.measuredMs > 0.0 && t.measuredMs < 3000.0);
+        CHECK(t.warmupMs >= 200.0);
+
+        // The aggregate is the streams added up, and every stream moved data
+        double sum = 0.0;
+        for (double mbps : t.streamMbps) sum += mbps;
+        CHECK_NEAR(sum, t.goodputMbps, t.goodputMbps * 0.05);
+        CHECK(t.streamMinMbps > 0.0);
+        CHECK(t.streamMinMbps <= t.streamMaxMbps);
+        CHECK(!t.capped);
+        CHECK(t.totalBytes > 0);
+    }
+}
+
+static void throughputByteCap(NetProbeServer& server)
+{
+    // Loopback would run for the whole 3 s; the byte budget ends it first
+    for (bool upload : { false, true }) {
+        ThroughputConfig c = quickThroughput(server.baseUrl() + (upload ? "/__up" : "/__down?bytes=50000000"), upload);
+        c.maxBytes = 8000000;
+        c.measureMs = 3000;
+        ThroughputResult t = NetProbe::throughput(c);
+        CHECK(t.ok);
+        CHECK(t.capped);
+        CHECK(t.totalBytes >= c.maxBytes);
+        CHECK(t.totalBytes < c.maxBytes + 64000000);        // one poll round past the budget at most
+        CHECK(t.goodputMbps > 0.0);
+    }
+}
+
+static void redirects(NetProbeServer& server)
+{
+    string base = server.baseUrl();
+    NetRequest absolute;
+    absolute.url = base + "/__redirect?to=" + base + "/ip";
+    NetRequest twice;
+    twice.url = base + "/__redirect?to=/__redirect?to=/__down?bytes=1000";
+    NetRequest post;
+    post.url = base + "/__redirect?to=/__up";
+    post.method = "POST";
+    post.uploadBytes = 1000;
+    NetRequest tls;
+    tls.url = base + "/__redirect?to=https://127.0.0.1/ip";
+    NetRequest loop;
+    loop.url = base + "/__redirect";
+
+    vector<NetResult> r = NetProbe::run({ absolute, twice, post, tls, loop }, 5000);
+    CHECK_EQ(r.size(), size_t(5));
+    if (r.size() != 5) return;
+
+    CHECK(r[0].ok);
+    CHECK_EQ(r[0].body, string("127.0.0.1"));
+    CHECK_EQ(r[0].redirects, 1);
+
+    CHECK(r[1].ok);
+    CHECK_EQ(r[1].bytesReceived, uint64_t(1000));
+    CHECK_EQ(r[1].redirects, 2);
+
+    CHECK(r[2].ok);                                         // 302 keeps the POST
+    CHECK_EQ(r[2].body, string("ok"));
+    CHECK_EQ(r[2].bytesSent, uint64_t(1000));
+
+    CHECK(!r[3].ok);                                        // no TLS: says where it was sent
+    CHECK_EQ(r[3].status, 302);
+    CHECK(r[3].error.find("https://127.0.0.1/ip") != string::npos);
+
+    CHECK(!r[4].ok);
+    CHECK_EQ(r[4].redirects, NetProbe::MAX_REDIRECTS);
+    CHECK_EQ(r[4].error.compare(0, 31, "stopped following redirects at "), 0);
+
+    // The speed test restarts on the target
+    for (bool upload : { false, true }) {
+        string url = base + "/__redirect?to=" + (upload ? "/__up" : "/__down?bytes=50000000");
+        ThroughputResult t = NetProbe::throughput(quickThroughput(url, upload));
+        CHECK(t.ok);
+        CHECK_EQ(t.streamsConnected, 4);
+    }
+    ThroughputResult toTls = NetProbe::throughput(quickThroughput(base + "/__redirect?to=https://127.0.0.1/__down", false));
+    CHECK(!toTls.ok);
+    CHECK(toTls.error.find("https://127.0.0.1/__down") != string::npos);
+}
+
+static void throughputFailures()
+{
+    ThroughputResult bad = NetProbe::throughput(quickThroughput("https://127.0.0.1/", false));
+    CHECK(!bad.ok);
+    CHECK_EQ(bad.error, string("unsupported URL"));
+
+    ThroughputResult refused = NetProbe::throughput(quickThroughput("http://127.0.0.1:1/__down", false));
+    CHECK(!refused.ok);
+    CHECK_EQ(refused.streamsConnected, 0);
+    CHECK(!refused.error.empty());
+}
+
+static void latencyTargets(NetProbeServer& server)
+{
+    int port = server.port();
+    vector<LatencyTarget> targets = {
+        { "tcp", "127.0.0.1", port, false },
+        { "udp", "127.0.0.1", port, true },
+        { "refused", "127.0.0.1", 1, false },
+        { "noport", "127.0.0.1", 0, false },
+    };
+    vector<LatencySamples> r = NetProbe::latency(targets, 5, 20, 500);
+    CHECK_EQ(r.size(), size_t(4));
+    if (r.size() != 4) return;
+
+    string where = "127.0.0.1:" + to_string(port);
+    CHECK_EQ(r[0].endpoint, "tcp " + where);
+    CHECK_EQ(r[1].endpoint, "udp " + where);
+    for (int i : { 0, 1 }) {
+        CHECK(r[i].error.empty());
+        CHECK_EQ(r[i].rttMs.size(), size_t(5));
+        LatencyStats s = NetProbe::summarize(r[i].rttMs);
+        CHECK_EQ(s.sent, 5);
+        CHECK_EQ(s.received, 5);
+        CHECK(s.minMs > 0.0 && s.maxMs < 500.0);
+    }
+
+    // Refused counts as lost, a target without a port isn't probed at all
+    CHECK_EQ(r[2].rttMs.size(), size_t(5));
+    CHECK_EQ(NetProbe::summarize(r[2].rttMs).lossPercent(), 100.0);
+    CHECK_EQ(r[3].error, string("no port"));
+    CHECK(r[3].rttMs.empty());
+}
+
+static void latencySummary()
+{
+    // 100 samples of 1..100 ms with every tenth lost
+    vector<double> rtt;
+    for (int i = 1; i <= 100; i++) rtt.push_back(i % 10 == 0 ? -1.0 : i);
+    LatencyStats s = NetProbe::summarize(rtt);
+    CHECK_EQ(s.sent, 100);
+    CHECK_EQ(s.received, 90);
+    CHECK_NEAR(s.lossPercent(), 10.0, 1e-9);
+    CHECK_EQ(s.minMs, 1.0);
+    CHECK_EQ(s.maxMs, 99.0);
+    CHECK_NEAR(s.p50Ms, 50.0, 1.0);
+    CHECK_NEAR(s.p99Ms, 99.0, 1.0);
+    // Consecutive received samples differ by 1, or 2 across a lost one (9 of 89 gaps)
+    CHECK_NEAR(s.jitterMs, (80 * 1.0 + 9 * 2.0) / 89, 1e-9);
+
+    // Histogram keeps better than 1% from microseconds to minutes
+    for (double ms : { 0.013, 0.75, 42.0, 1234.5, 98765.0 }) {
+        LatencyHistogram h;
+        h.record(ms);
+        CHECK_NEAR(h.percentileMs(50.0), ms, ms * 0.01 + 0.001);
+    }
+
+    LatencyStats none = NetProbe::summarize({ -1.0, -1.0 });
+    CHECK_EQ(none.received, 0);
+    CHECK_EQ(none.lossPercent(), 100.0);
+}
+
+static void dnsResolvers(NetProbeServer& server)
+{
+    // The server's UDP port answers DNS queries as a stub resolver
+    string stub = "127.0.0.1:" + to_string(server.port());
+    vector<string> names = { "example.com", "nothing.invalid", string(64, 'a') + ".com" };
+    vector<DnsResolverResult> r = NetProbe::dns({ stub, "127.0.0.1:1", "dns.example" }, names, 1000);
+    CHECK_EQ(r.size(), size_t(3));
+    if (r.size() != 3) return;
+
+    CHECK_EQ(r[0].resolver, stub);
+    CHECK(r[0].error.empty());
+    CHECK_EQ(r[0].queries.size(), size_t(3));
+    if (r[0].queries.size() == 3) {
+        CHECK_EQ(r[0].queries[0].rcode, 0);
+        CHECK_EQ(r[0].queries[0].answers, 1);
+        CHECK(r[0].queries[0].ms >= 0.0 && r[0].queries[0].ms < 1000.0);
+        CHECK_EQ(r[0].queries[1].rcode, 3);                 // NXDOMAIN
+        CHECK_EQ(r[0].queries[1].answers, 0);
+        CHECK_EQ(r[0].queries[2].rcode, -2);                // 64-byte label: never sent
+    }
+
+    // Port unreachable fails the resolver at once; names are never resolved to find one
+    CHECK_EQ(r[1].error, string("refused"));
+    CHECK_EQ(r[2].error, string("not a numeric address"));
+}
+
+static void dnsWireFormat()
+{
+    string query = NetProbe::dnsQuery(0x1234, "Example.COM.", 28);
+    DnsMessage m;
+    CHECK(NetProbe::parseDns(query, m));
+    CHECK_EQ(m.id, uint16_t(0x1234));
+    CHECK(!m.response);
+    CHECK_EQ(m.name, string("example.com"));
+    CHECK_EQ(m.type, uint16_t(28));
+    CHECK_EQ(m.questionEnd, query.size());
+
+    CHECK(NetProbe::dnsQuery(1, "").empty());
+    CHECK(NetProbe::dnsQuery(1, "a.." + string(300, 'b')).empty());
+    CHECK(!NetProbe::parseDns(query.substr(0, 11), m));         // shorter than the header
+    CHECK(!NetProbe::parseDns(query.substr(0, query.size() - 3), m));
+}
+
+int main()
+{
+    NetProbeServer server;
+    CHECK(server.start());
+    CHECK(server.port() > 0);
+
+    requests(server);
+    downloadCap(server);
+    throughputBothWays(server);
+    throughputFailures();
+    throughputByteCap(server);
+    redirects(server);
+    latencyTargets(server);
+    latencySummary();
+    dnsResolvers(server);
+    dnsWireFormat();
+
+    server.stop();
+    return finish();
+}
@@ -0,0 +1,190 @@
+#include "include\Probe.h"
+#include "include\StorageEnumerator.h"
+#include "include\DiskActivity.h"
+#include "include\NetActivity.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <unistd.h>
+#include <thread>
+
+static string snapshotPath()
+{
+    return "/tmp/ProbeTest." + to_string(getpid()) + ".json";
+}
+
+static void recordThenReplay()
+{
+    string path = snapshotPath();
+    CHECK(Probe::begin(Probe::Mode::Record, path));
+    CHECK_EQ(Probe::text("test:text", []() { return string("first"); }), string("first"));
+    CHECK_EQ(Probe::text("test:text", []() { return string("second"); }), string("second"));
+    CHECK_NEAR(Probe::number("test:number", []() { return 0.1 + 0.2; }), 0.3, 1e-12);
+    vector<string> list = Probe::list("test:list", []() { return vector<string>{ "a", "", "c", "" }; });
+    CHECK_EQ(list.size(), size_t(4));
+    Probe::unrouted("ignored while recording");
+    CHECK(Probe::end());
+
+    // Replay hands values back per key, in order, without calling fetch
+    CHECK(Probe::begin(Probe::Mode::Replay, path));
+    bool fetched = false;
+    auto live = [&]() { fetched = true; return string("live"); };
+    CHECK_EQ(Probe::text("test:text", live), string("first"));
+    CHECK_EQ(Probe::text("test:text", live), string("second"));
+    CHECK_EQ(Probe::text("test:text", live), string("second"));    // exhausted: last value again
+    CHECK_EQ(Probe::number("test:number", []() { return -1.0; }), 0.1 + 0.2);
+    CHECK(Probe::list("test:list", []() { return vector<string>{ "live" }; }) == list);
+    CHECK_EQ(Probe::text("test:missing", live), string(""));
+    CHECK(!fetched);
+    CHECK(Probe::unroutedSources().empty());
+
+    // Unrouted reads are collected (once each, sorted) only while replaying
+    Probe::unrouted("ZetaSource");
+    Probe::unrouted("AlphaSource");
+    Probe::unrouted("ZetaSource");
+    vector<string> sources = Probe::unroutedSources();
+    CHECK_EQ(sources.size(), size_t(2));
+    if (sources.size() == 2) {
+        CHECK_EQ(sources[0], string("AlphaSource"));
+        CHECK_EQ(sources[1], string("ZetaSource"));
+    }
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+    CHECK(Probe::unroutedSources().empty());
+    remove(path.c_str());
+}
+
+static void nonUtf8RoundTrip()
+{
+    // Raw sysfs / registry / EDID text replays byte for byte, not U+FFFD-replaced
+    const vector<string> values = {
+        string("caf\xc3\xa9 \xe2\x82\xac"),     // valid: stays a JSON string
+        string("\xff\xfe" "L\0a", 5),            // latin-1 / UTF-16 bytes, embedded NUL
+        string("\xc0\xaf"),                       // overlong '/'
+        string("\xe2\x82"),                       // truncated
+        string("\xed\xa0\x80"),                  // surrogate
+    };
+    string path = snapshotPath();
+    CHECK(Probe::begin(Probe::Mode::Record, path));
+    for (const auto& v : values) Probe::text("test:raw", [&]() { return v; });
+    CHECK(Probe::end());
+
+    string saved = readFile(path);
+    CHECK(saved.find("caf\xc3\xa9") != string::npos);
+    CHECK(saved.find("\"hex\": \"fffe4c0061\"") != string::npos);
+
+    CHECK(Probe::begin(Probe::Mode::Replay, path));
+    for (const auto& v : values) CHECK(Probe::text("test:raw", []() { return string(); }) == v);
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+    remove(path.c_str());
+}
+
+static void missingSnapshot()
+{
+    CHECK(!Probe::begin(Probe::Mode::Replay, "/nonexistent/ProbeTest.json"));
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+}
+
+static void storageReplay()
+{
+    // The mount list and every stat result come back from the snapshot
+    string path = snapshotPath();
+    CHECK(Probe::begin(Probe::Mode::Record, path));
+    StorageEnumerator::invalidate();
+    vector<VolumeInfo> recorded = StorageEnumerator::volumes();
+    CHECK(Probe::end());
+
+    CHECK(Probe::begin(Probe::Mode::Replay, path));
+    StorageEnumerator::invalidate();
+    vector<VolumeInfo> replayed = StorageEnumerator::volumes();
+    CHECK_EQ(replayed.size(), recorded.size());
+    for (size_t i = 0; i < replayed.size() && i < recorded.size(); i++) {
+        CHECK_EQ(replayed[i].root_path, recorded[i].root_path);
+        CHECK_EQ(replayed[i].stat_ok, recorded[i].stat_ok);
+        CHECK_EQ(replayed[i].timed_out, recorded[i].timed_out);
+        CHECK_EQ(replayed[i].total_bytes, recorded[i].total_bytes);
+        CHECK_EQ(replayed[i].free_bytes, recorded[i].free_bytes);
+    }
+    CHECK(Probe::unroutedSources().empty());
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+    StorageEnumerator::invalidate();
+    remove(path.c_str());
+}
+
+static void diskActivityReplay()
+{
+    // Rates come from the recorded window, however long the replay takes
+    string path = snapshotPath();
+    CHECK(Probe::begin(Probe::Mode::Record, path));
+    vector<DiskActivityStats> recorded;
+    {
+        DiskActivity activity;
+        activity.begin();
+        recorded = activity.sample(50);
+    }
+    CHECK(Probe::end());
+
+    CHECK(Probe::begin(Probe::Mode::Replay, path));
+    vector<DiskActivityStats> replayed;
+    {
+        DiskActivity activity;
+        activity.begin();
+        this_thread::sleep_for(chrono::milliseconds(120));
+        replayed = activity.sample(50);
+    }
+    CHECK_EQ(replayed.size(), recorded.size());
+    for (size_t i = 0; i < replayed.size() && i < recorded.size(); i++) {
+        CHECK_EQ(replayed[i].device, recorded[i].device);
+        CHECK_EQ(replayed[i].readBytesPerSec, recorded[i].readBytesPerSec);
+        CHECK_EQ(replayed[i].writeIops, recorded[i].writeIops);
+        CHECK_EQ(replayed[i].utilization, recorded[i].utilization);
+    }
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+    remove(path.c_str());
+}
+
+static void netActivityReplay()
+{
+    // Same for interface counters: traffic in the recording, replayed slower
+    string path = snapshotPath();
+    CHECK(Probe::begin(Probe::Mode::Record, path));
+    vector<NetActivityStats> recorded;
+    {
+        NetActivity activity;
+        activity.begin();
+        recorded = activity.sample(50);
+    }
+    CHECK(Probe::end());
+
+    CHECK(Probe::begin(Probe::Mode::Replay, path));
+    vector<NetActivityStats> replayed;
+    {
+        NetActivity activity;
+        activity.begin();
+        this_thread::sleep_for(chrono::milliseconds(120));
+        replayed = activity.sample(50);
+    }
+    CHECK_EQ(replayed.size(), recorded.size());
+    for (size_t i = 0; i < replayed.size() && i < recorded.size(); i++) {
+        CHECK_EQ(replayed[i].name, recorded[i].name);
+        CHECK_EQ(replayed[i].rxBytesPerSec, recorded[i].rxBytesPerSec);
+        CHECK_EQ(replayed[i].txPacketsPerSec, recorded[i].txPacketsPerSec);
+    }
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+    remove(path.c_str());
+}
+
+int main()
+{
+    recordThenReplay();
+    nonUtf8RoundTrip();
+    missingSnapshot();
+    storageReplay();
+    diskActivityReplay();
+    netActivityReplay();
+    return finish();
+}
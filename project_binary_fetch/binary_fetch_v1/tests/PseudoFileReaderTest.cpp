@@ -0,0 +1,203 @@
+#include "include\PseudoFileReader.h"
+#include "include\IoRing.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static string scratch()
+{
+    static const string dir = "/tmp/PseudoFileReaderTest." + to_string(getpid());
+    mkdir(dir.c_str(), 0700);
+    return dir;
+}
+
+static string write(const string& name, const string& content)
+{
+    string path = scratch() + "/" + name;
+    ofstream(path, ios::binary | ios::trunc) << content;
+    return path;
+}
+
+static void numbers()
+{
+    long long v = 0;
+    CHECK(!PseudoFileReader::parseNumber("", v));
+    CHECK(!PseudoFileReader::parseNumber(" \t\n", v));
+    CHECK(!PseudoFileReader::parseNumber("abc", v));
+    CHECK(!PseudoFileReader::parseNumber("+", v));
+    CHECK(!PseudoFileReader::parseNumber("- 5", v));
+    CHECK(!PseudoFileReader::parseNumber("9223372036854775808", v));    // overflow
+    CHECK(PseudoFileReader::parseNumber("+42", v) && v == 42);
+    CHECK(PseudoFileReader::parseNumber("-7", v) && v == -7);
+    CHECK(PseudoFileReader::parseNumber(" 12\n", v) && v == 12);
+    CHECK(PseudoFileReader::parseNumber("12abc", v) && v == 12);        // first integer, like sysfs "1200 kHz"
+    CHECK(PseudoFileReader::parseNumber("-9223372036854775808", v) && v == -9223372036854775807LL - 1);
+
+    // Whole tokens only; appends and returns how many were added
+    vector<long long> out = { 99 };
+    CHECK_EQ(PseudoFileReader::parseNumbers("cpu0 1 +2 -3 4x\t5\n\n6 + 99999999999999999999", out), size_t(5));
+    CHECK_EQ(out.size(), size_t(6));
+    if (out.size() == 6) {
+        CHECK_EQ(out[0], 99LL);
+        CHECK_EQ(out[1], 1LL);
+        CHECK_EQ(out[2], 2LL);
+        CHECK_EQ(out[3], -3LL);
+        CHECK_EQ(out[4], 5LL);
+        CHECK_EQ(out[5], 6LL);
+    }
+    CHECK_EQ(PseudoFileReader::parseNumbers("", out), size_t(0));
+    CHECK_EQ(PseudoFileReader::parseNumbers("   ", out), size_t(0));
+}
+
+static void growth(bool useIoUring)
+{
+    string big(1000, 'x');
+    string exact(16, 'y');
+    string a = write("a", "17\n");
+    string b = write("b", big);
+    string c = write("c", exact);
+    string d = write("d", "neighbour\n");
+
+    PseudoFileReader reader(useIoUring);
+    int ha = reader.add(a, 16);
+    int hb = reader.add(b, 16);
+    int hc = reader.add(c, 16);
+    int hd = reader.add(d, 16);
+    CHECK_EQ(reader.add(a), ha);
+
+    CHECK(reader.refresh());
+    CHECK_EQ(reader.number(ha), 17LL);
+    CHECK_EQ(string(reader.text(hb)), big);        // outgrew its slot: grown and re-read
+    CHECK_EQ(string(reader.text(hc)), exact);      // exactly at capacity can't be told from truncated
+    CHECK_EQ(reader.line(hd), string_view("neighbour"));
+
+    // Growing one slot again keeps the others' content from this refresh
+    write("b", big + big + big);
+    CHECK(reader.refresh({ hb }));
+    CHECK_EQ(reader.text(hb).size(), size_t(3000));
+    CHECK_EQ(reader.number(ha), 17LL);
+    CHECK_EQ(string(reader.text(hc)), exact);
+    CHECK_EQ(reader.line(hd), string_view("neighbour"));
+
+    // Shrinking content is seen as-is
+    write("b", "1");
+    CHECK(reader.refresh());
+    CHECK_EQ(reader.number(hb), 1LL);
+}
+
+static void missingThenCreated(bool useIoUring)
+{
+    string path = scratch() + "/late";
+    remove(path.c_str());
+    string other = write("other", "5");
+
+    PseudoFileReader reader(useIoUring);
+    int h = reader.add(path);
+    int o = reader.add(other);
+    CHECK(!reader.refresh());
+    CHECK(!reader.ok(h));
+    CHECK_EQ(reader.number(h), -1LL);
+    CHECK_EQ(reader.number(h, 0), 0LL);
+    CHECK(reader.text(h).empty());
+    CHECK_EQ(reader.number(o), 5LL);
+
+    write("late", "123\n");
+    CHECK(reader.refresh());
+    CHECK_EQ(reader.number(h), 123LL);
+    CHECK(!reader.ok(-1));
+    CHECK(!reader.ok(static_cast<int>(reader.size())));
+}
+
+// More files than one ring submission holds: read in chunks
+static void manyFiles(bool useIoUring)
+{
+    PseudoFileReader reader(useIoUring);
+    vector<int> handles;
+    for (int i = 0; i < 150; ++i) handles.push_back(reader.add(write("n" + to_string(i), to_string(i * 3)), 8));
+    CHECK(reader.refresh());
+    bool all = true;
+    for (int i = 0; i < 150; ++i) all = all && reader.number(handles[i]) == i * 3;
+    CHECK(all);
+
+    // The fds are kept: rewriting in place is seen without re-adding
+    write("n149", "7");
+    CHECK(reader.refresh({ handles[0], handles[149] }));
+    CHECK_EQ(reader.number(handles[149]), 7LL);
+    CHECK_EQ(reader.number(handles[0]), 0LL);
+}
+
+static void ring()
+{
+#ifdef BINARYFETCH_IO_URING
+    IoRing ring(8);
+    if (!ring.ready()) {
+        cout << "io_uring: skipped (kernel refused a ring)\n";
+        return;
+    }
+    CHECK(ring.depth() >= 8);
+
+    string path = write("ring", "hello ring");
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    CHECK(fd >= 0);
+    char first[5] = {}, second[4] = {};
+    CHECK(ring.read(fd, first, sizeof(first), 0, 1));
+    CHECK(ring.read(fd, second, sizeof(second), 6, 2));
+    CHECK(ring.read(-1, first, 1, 0, 3));
+    CHECK_EQ(ring.submit(3), 3);
+
+    int seen = 0;
+    for (int i = 0; i < 3; ++i) {
+        uint64_t tag = 0;
+        int res = 0;
+        CHECK(ring.wait(tag, res));
+        if (tag == 1) CHECK_EQ(res, 5);
+        if (tag == 2) CHECK_EQ(res, 4);
+        if (tag == 3) CHECK(res < 0);      // -EBADF comes back as a completion
+        seen |= 1 << tag;
+    }
+    CHECK_EQ(seen, 0xE);
+    CHECK_EQ(string(first, 5), string("hello"));
+    CHECK_EQ(string(second, 4), string("ring"));
+    uint64_t tag;
+    int res;
+    CHECK(!ring.peek(tag, res));
+    ::close(fd);
+
+    // A full submission queue refuses more until submitted
+    unsigned queued = 0;
+    while (ring.read(-1, first, 1, 0, queued) && queued < 1000) queued++;
+    CHECK_EQ(queued, ring.depth());
+    CHECK_EQ(ring.submit(queued), static_cast<int>(queued));
+    while (ring.peek(tag, res)) {}
+
+    // The reader's batches go through it
+    PseudoFileReader reader(true);
+    reader.add(write("r1", "1"));
+    reader.add(write("r2", "2"));
+    CHECK(reader.refresh());
+    CHECK(reader.batching());
+    CHECK(!PseudoFileReader(false).batching());
+#else
+    CHECK(!IoRing(8).ready());
+    cout << "io_uring: skipped (built without BINARYFETCH_IO_URING)\n";
+#endif
+}
+
+int main()
+{
+    numbers();
+    for (bool useIoUring : { true, false }) {
+        growth(useIoUring);
+        missingThenCreated(useIoUring);
+        manyFiles(useIoUring);
+    }
+    ring();
+    string dir = scratch();
+    for (const auto& name : listDir(dir)) remove((dir + "/" + name).c_str());
+    rmdir(dir.c_str());
+    return finish();
+}
@@ -0,0 +1,263 @@
+#include "include\WMIQuery.h"
+#include "include\Probe.h"
+#include "Check.h"
+
+#include <mutex>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <unistd.h>
+
+// Stands in for COM: answers from a fixed table and logs every SELECT it runs
+class FakeExecutor : public WMIExecutor {
+public:
+    map<string, vector<WMIRow>> tables;     // class -> every property of every instance
+    vector<string> queries;                 // WQL text, in the order it ran
+    vector<string> namespaces;
+    bool reachable = true;
+    int released = 0;
+
+    bool execute(const string& ns, const string& wql,
+        const vector<string>& properties, vector<WMIRow>& rows) override
+    {
+        queries.push_back(wql);
+        namespaces.push_back(ns);
+        if (!reachable) return false;
+
+        string cls = wql.substr(wql.find(" FROM ") + 6);
+        cls = cls.substr(0, cls.find(' '));
+        for (const auto& instance : tables[cls]) {
+            if (wql.find(" WHERE Name = 'b'") != string::npos && instance.at("Name") != "b") continue;
+            WMIRow row;
+            for (const auto& prop : properties) {
+                auto it = instance.find(prop);
+                if (it != instance.end()) row[prop] = it->second;   // NULL: left out, like COM
+            }
+            rows.push_back(row);
+        }
+        return true;
+    }
+
+    void release() override { released++; }
+};
+
+static shared_ptr<FakeExecutor> install()
+{
+    auto fake = make_shared<FakeExecutor>();
+    fake->tables["Win32_Processor"] = {
+        { { "Name", "cpu0" }, { "MaxClockSpeed", "3600" }, { "CurrentClockSpeed", "4100" }, { "L2CacheSize", "8192" } },
+    };
+    fake->tables["Win32_PhysicalMemory"] = {
+        { { "Name", "a" }, { "Capacity", "17179869184" }, { "Speed", "3200" } },
+        { { "Name", "b" }, { "Capacity", "17179869184" } },
+    };
+    WMIQuery::setExecutor(fake);
+    return fake;
+}
+
+static void queryText()
+{
+    CHECK_EQ(WMIQuery::buildQuery("Win32_Processor", { "Name" }, ""), string("SELECT Name FROM Win32_Processor"));
+    CHECK_EQ(WMIQuery::buildQuery("Win32_Process", { "A", "B" }, "Name = '_Total'"),
+        string("SELECT A, B FROM Win32_Process WHERE Name = '_Total'"));
+}
+
+static void wantedUpFrontIsOneSelect()
+{
+    auto fake = install();
+    WMIQuery::want("Win32_Processor", { "MaxClockSpeed", "CurrentClockSpeed" });
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed"), string("3600"));
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "CurrentClockSpeed"), string("4100"));
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed"), string("3600"));
+
+    CHECK_EQ(fake->queries.size(), size_t(1));
+    if (!fake->queries.empty()) {
+        CHECK_EQ(fake->queries[0], string("SELECT MaxClockSpeed, CurrentClockSpeed FROM Win32_Processor"));
+        CHECK_EQ(fake->namespaces[0], string(WMIQuery::CIMV2));
+    }
+}
+
+static void lateAskRerunsWithUnion()
+{
+    auto fake = install();
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed"), string("3600"));
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "L2CacheSize"), string("8192"));
+    // Everything asked so far is cached now
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed"), string("3600"));
+
+    CHECK_EQ(fake->queries.size(), size_t(2));
+    if (fake->queries.size() == 2) {
+        CHECK_EQ(fake->queries[0], string("SELECT MaxClockSpeed FROM Win32_Processor"));
+        CHECK_EQ(fake->queries[1], string("SELECT MaxClockSpeed, L2CacheSize FROM Win32_Processor"));
+    }
+}
+
+static void targetsAreSeparate()
+{
+    auto fake = install();
+    vector<WMIRow> all = WMIQuery::rows("Win32_PhysicalMemory", { "Capacity", "Speed" });
+    CHECK_EQ(all.size(), size_t(2));
+    if (all.size() == 2) {
+        CHECK_EQ(all[0].at("Speed"), string("3200"));
+        CHECK(all[1].find("Speed") == all[1].end());    // NULL stays absent in rows()
+    }
+
+    // Same class, different WHERE: its own SELECT; NULL reads as "Unknown" through get()
+    CHECK_EQ(WMIQuery::get("Win32_PhysicalMemory", "Speed", "Name = 'b'"), string("Unknown"));
+    CHECK_EQ(WMIQuery::get("Win32_PhysicalMemory", "Capacity", "Name = 'b'"), string("17179869184"));
+    CHECK_EQ(fake->queries.size(), size_t(3));
+
+    // Another namespace is another target too
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed", "", "ROOT\\WMI"), string("3600"));
+    CHECK_EQ(fake->namespaces.back(), string("ROOT\\WMI"));
+}
+
+static void countSelectsSomething()
+{
+    auto fake = install();
+    CHECK_EQ(WMIQuery::count("Win32_PhysicalMemory"), size_t(2));
+    CHECK_EQ(fake->queries.size(), size_t(1));
+    if (!fake->queries.empty()) CHECK_EQ(fake->queries[0], string("SELECT __RELPATH FROM Win32_PhysicalMemory"));
+
+    // A later property ask on the same target still re-runs for it
+    CHECK_EQ(WMIQuery::rows("Win32_PhysicalMemory", { "Capacity" }).size(), size_t(2));
+    CHECK_EQ(fake->queries.size(), size_t(2));
+    CHECK_EQ(WMIQuery::count("Win32_PhysicalMemory"), size_t(2));
+    CHECK_EQ(fake->queries.size(), size_t(2));
+}
+
+static void unreachable()
+{
+    auto fake = install();
+    fake->reachable = false;
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed"), string("Unknown"));
+    CHECK(WMIQuery::rows("Win32_Processor", { "MaxClockSpeed" }).empty());
+    CHECK_EQ(WMIQuery::count("Win32_Processor"), size_t(0));
+    // A failed target is cached like any other; it isn't retried every call
+    CHECK_EQ(fake->queries.size(), size_t(1));
+}
+
+static void clearKeepsThePlan()
+{
+    auto fake = install();
+    WMIQuery::want("Win32_Processor", { "Name", "MaxClockSpeed" });
+    WMIQuery::get("Win32_Processor", "Name");
+    WMIQuery::clear();
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "Name"), string("cpu0"));
+    CHECK_EQ(fake->queries.size(), size_t(2));
+    if (fake->queries.size() == 2) CHECK_EQ(fake->queries[1], fake->queries[0]);
+
+    // shutdown() releases the executor and forgets the plan
+    WMIQuery::shutdown();
+    CHECK_EQ(fake->released, 1);
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "Name"), string("Unknown"));  // no live executor off Windows
+    CHECK_EQ(fake->queries.size(), size_t(2));
+}
+
+// Holds every SELECT against ROOT\Slow until the gate is set
+class GatedExecutor : public WMIExecutor {
+public:
+    mutex lock;
+    vector<string> queries;
+    promise<void> gate;
+    shared_future<void> opened = gate.get_future().share();
+    promise<void> entered;                  // the first slow SELECT has started
+
+    bool execute(const string& ns, const string& wql,
+        const vector<string>&, vector<WMIRow>& rows) override
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            queries.push_back(wql);
+            if (ns == "ROOT\\Slow" && count(queries.begin(), queries.end(), wql) == 1) entered.set_value();
+        }
+        if (ns == "ROOT\\Slow") opened.wait();
+        rows.push_back({ { "Value", ns == "ROOT\\Slow" ? "slow" : "fast" } });
+        return true;
+    }
+
+    size_t ran(const string& wql)
+    {
+        lock_guard<mutex> guard(lock);
+        return count(queries.begin(), queries.end(), wql);
+    }
+};
+
+static void slowTargetDoesNotBlockOthers()
+{
+    auto gated = make_shared<GatedExecutor>();
+    WMIQuery::setExecutor(gated);
+
+    auto first = async(launch::async, []() { return WMIQuery::get("Sensor", "Value", "", "ROOT\\Slow"); });
+    gated->entered.get_future().wait();
+
+    // Another target answers while the slow SELECT is still in flight
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "Value"), string("fast"));
+
+    // A second caller for the slow target waits for the first run instead of starting one
+    auto second = async(launch::async, []() { return WMIQuery::rows("Sensor", { "Value" }, "", "ROOT\\Slow").size(); });
+    this_thread::sleep_for(chrono::milliseconds(50));
+    gated->gate.set_value();
+
+    CHECK_EQ(first.get(), string("slow"));
+    CHECK_EQ(second.get(), size_t(1));
+    CHECK_EQ(gated->ran("SELECT Value FROM Sensor"), size_t(1));
+    CHECK_EQ(gated->ran("SELECT Value FROM Win32_Processor"), size_t(1));
+    WMIQuery::setExecutor(nullptr);
+}
+
+static void clearDuringQueryRefetches()
+{
+    auto gated = make_shared<GatedExecutor>();
+    WMIQuery::setExecutor(gated);
+
+    auto first = async(launch::async, []() { return WMIQuery::get("Sensor", "Value", "", "ROOT\\Slow"); });
+    gated->entered.get_future().wait();
+    WMIQuery::clear();
+    gated->gate.set_value();
+
+    // The result from before clear() isn't cached; the caller gets a fresh run
+    CHECK_EQ(first.get(), string("slow"));
+    CHECK_EQ(gated->ran("SELECT Value FROM Sensor"), size_t(2));
+    WMIQuery::setExecutor(nullptr);
+}
+
+static void recordAndReplay()
+{
+    string path = "/tmp/WMIQueryTest." + to_string(getpid()) + ".json";
+    auto fake = install();
+    CHECK(Probe::begin(Probe::Mode::Record, path));
+    WMIQuery::want("Win32_Processor", { "MaxClockSpeed", "CurrentClockSpeed" });
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "CurrentClockSpeed"), string("4100"));
+    CHECK(Probe::end());
+
+    // Replay answers the same SELECT from the snapshot; the executor is never asked
+    fake = install();
+    fake->reachable = false;
+    CHECK(Probe::begin(Probe::Mode::Replay, path));
+    WMIQuery::want("Win32_Processor", { "MaxClockSpeed", "CurrentClockSpeed" });
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "MaxClockSpeed"), string("3600"));
+    CHECK_EQ(WMIQuery::get("Win32_Processor", "CurrentClockSpeed"), string("4100"));
+    CHECK(fake->queries.empty());
+
+    CHECK(Probe::begin(Probe::Mode::Live, ""));
+    remove(path.c_str());
+}
+
+int main()
+{
+    queryText();
+    wantedUpFrontIsOneSelect();
+    lateAskRerunsWithUnion();
+    targetsAreSeparate();
+    countSelectsSomething();
+    unreachable();
+    clearKeepsThePlan();
+    slowTargetDoesNotBlockOthers();
+    clearDuringQueryRefetches();
+    recordAndReplay();
+    WMIQuery::shutdown();
+    return finish();
+}